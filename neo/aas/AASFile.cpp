@@ -582,6 +582,11 @@ idAASFileLocal::idAASFileLocal() {
 	portals.SetGranularity( AAS_LIST_GRANULARITY );
 	portalIndex.SetGranularity( AAS_INDEX_GRANULARITY );
 	clusters.SetGranularity( AAS_LIST_GRANULARITY );
+	gridBounds.Clear();
+	gridSize[0] = gridSize[1] = gridSize[2] = 0;
+	gridCellSize = 0.0f;
+	gridInvCellSize = 0.0f;
+	gridNumLeafCells = 0;
 }
 
 /*
@@ -618,6 +623,8 @@ void idAASFileLocal::Clear() {
 	portals.Clear();
 	portalIndex.Clear();
 	clusters.Clear();
+	gridNodes.Clear();
+	gridNumLeafCells = 0;
 }
 
 /*
@@ -1192,6 +1199,8 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 		src.Error( "idAASFileLocal::Load: tree depth = %d", depth );
 	}
 
+	BuildAreaGrid();
+
 	common->UpdateLevelLoadPacifier();
 
 	common->Printf( "done.\n" );
@@ -1218,6 +1227,7 @@ int idAASFileLocal::MemorySize() const {
 	size += portals.Size();
 	size += portalIndex.Size();
 	size += clusters.Size();
+	size += gridNodes.Size();
 	size += sizeof( idReachability_Walk ) * NumReachabilities();
 
 	assert(size <= std::numeric_limits<int>::max());
@@ -1234,6 +1244,7 @@ void idAASFileLocal::PrintInfo() const {
 	common->Printf( "%6d KB file size\n", MemorySize() >> 10 );
 	common->Printf( "%6d areas\n", areas.Num() );
 	common->Printf( "%6d max tree depth\n", MaxTreeDepth() );
+	common->Printf( "%6d area grid cells (%dx%dx%d, %d units), %d map to a single area\n", gridNodes.Num(), gridSize[0], gridSize[1], gridSize[2], (int)gridCellSize, gridNumLeafCells );
 	ReportRoutingEfficiency();
 }
 
@@ -326,6 +326,7 @@ public:
 	virtual int					PointAreaNum( const idVec3 &origin ) const = 0;
 	virtual int					PointReachableAreaNum( const idVec3 &origin, const idBounds &searchBounds, const int areaFlags, const int excludeTravelFlags ) const = 0;
 	virtual int					BoundsReachableAreaNum( const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const = 0;
+	virtual int					BoundsNodeNum( const idBounds &bounds ) const = 0;
 	virtual void				PushPointIntoAreaNum( int areaNum, idVec3 &point ) const = 0;
 	virtual bool				Trace( aasTrace_t &trace, const idVec3 &start, const idVec3 &end ) const = 0;
 	virtual void				PrintInfo() const = 0;
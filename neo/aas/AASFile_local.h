@@ -57,6 +57,7 @@ public:
 	virtual int					PointAreaNum( const idVec3 &origin ) const;
 	virtual int					PointReachableAreaNum( const idVec3 &origin, const idBounds &searchBounds, const int areaFlags, const int excludeTravelFlags ) const;
 	virtual int					BoundsReachableAreaNum( const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const;
+	virtual int					BoundsNodeNum( const idBounds &bounds ) const;
 	virtual void				PushPointIntoAreaNum( int areaNum, idVec3 &point ) const;
 	virtual bool				Trace( aasTrace_t &trace, const idVec3 &start, const idVec3 &end ) const;
 	virtual void				PrintInfo() const;
@@ -70,6 +71,7 @@ public:
 	void						Optimize();
 	void						LinkReversedReachability();
 	void						FinishAreas();
+	void						BuildAreaGrid();
 
 	void						Clear();
 	void						DeleteReachabilities();
@@ -89,11 +91,20 @@ private:
 
 private:
 	int							BoundsReachableAreaNum_r( int nodeNum, const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const;
+	int							GridNodeNum( const idVec3 &mins, const idVec3 &maxs ) const;
 	void						MaxTreeDepth_r( int nodeNum, int &depth, int &maxDepth ) const;
 	int							MaxTreeDepth() const;
 	int							AreaContentsTravelFlags( int areaNum ) const;
 	idVec3						AreaReachableGoal( int areaNum ) const;
 	int							NumReachabilities() const;
+
+private:
+	idBounds					gridBounds;			// bounds covered by the area grid
+	int							gridSize[3];		// number of grid cells along each axis
+	float						gridCellSize;		// size of a grid cell
+	float						gridInvCellSize;	// 1 / gridCellSize
+	idList<int, TAG_AAS>		gridNodes;			// per cell the smallest subtree containing the cell, -areaNum or 0 for solid
+	int							gridNumLeafCells;	// number of cells that map straight to an area or solid
 };
 
 #endif /* !__AASFILELOCAL_H__ */
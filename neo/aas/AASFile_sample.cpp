@@ -33,6 +33,12 @@ If you have questions concerning this license or the applicable additional terms
 #include "AASFile.h"
 #include "AASFile_local.h"
 
+idCVar aas_areaGrid( "aas_areaGrid", "1", CVAR_SYSTEM | CVAR_BOOL, "start AAS point and bounds queries from the tree node stored in a uniform grid cell instead of the tree root" );
+
+const int	AAS_GRID_MAX_CELLS			= 65536;
+const float	AAS_GRID_MIN_CELL_SIZE		= 64.0f;
+const float	AAS_GRID_CELL_EPSILON		= 2.0f * ON_EPSILON;
+
 
 //===============================================================
 //
@@ -196,6 +202,128 @@ idBounds idAASFileLocal::AreaBounds( int areaNum ) const {
 	return bounds;
 }
 
+/*
+============
+idAASFileLocal::BuildAreaGrid
+
+  Stores for each cell of a uniform grid over the areas the deepest tree node
+  whose subspace fully contains the cell. Cells that fit in a single leaf store
+  the area number negated, or zero for solid. The cells are classified slightly
+  expanded so any point or bounds inside a cell would take the same path down
+  the tree as it does from the root.
+============
+*/
+void idAASFileLocal::BuildAreaGrid() {
+	int i, x, y, z, nodeNum, res;
+	idVec3 size;
+	idBounds cellBounds;
+	const aasNode_t *node;
+
+	gridNodes.Clear();
+	gridNumLeafCells = 0;
+	gridBounds.Clear();
+	gridSize[0] = gridSize[1] = gridSize[2] = 0;
+	gridCellSize = 0.0f;
+	gridInvCellSize = 0.0f;
+
+	if ( nodes.Num() <= 1 ) {
+		return;
+	}
+
+	for ( i = 1; i < areas.Num(); i++ ) {
+		gridBounds += areas[i].bounds;
+	}
+	if ( gridBounds.IsCleared() ) {
+		return;
+	}
+	gridBounds.ExpandSelf( 1.0f );
+
+	size = gridBounds[1] - gridBounds[0];
+	gridCellSize = Max( AAS_GRID_MIN_CELL_SIZE, idMath::Pow( size.x * size.y * size.z / AAS_GRID_MAX_CELLS, 1.0f / 3.0f ) );
+	while( 1 ) {
+		for ( i = 0; i < 3; i++ ) {
+			gridSize[i] = Max( 1, (int)idMath::Ceil( size[i] / gridCellSize ) );
+		}
+		if ( gridSize[0] * gridSize[1] * gridSize[2] <= AAS_GRID_MAX_CELLS ) {
+			break;
+		}
+		gridCellSize *= 1.25f;
+	}
+	gridInvCellSize = 1.0f / gridCellSize;
+
+	gridNodes.SetNum( gridSize[0] * gridSize[1] * gridSize[2] );
+
+	for ( z = 0; z < gridSize[2]; z++ ) {
+		for ( y = 0; y < gridSize[1]; y++ ) {
+			for ( x = 0; x < gridSize[0]; x++ ) {
+				cellBounds[0].Set( x * gridCellSize, y * gridCellSize, z * gridCellSize );
+				cellBounds[0] += gridBounds[0];
+				cellBounds[1] = cellBounds[0] + idVec3( gridCellSize, gridCellSize, gridCellSize );
+				cellBounds.ExpandSelf( AAS_GRID_CELL_EPSILON );
+
+				nodeNum = 1;
+				while( nodeNum > 0 ) {
+					node = &nodes[nodeNum];
+					res = cellBounds.PlaneSide( planeList[node->planeNum] );
+					if ( res == PLANESIDE_BACK ) {
+						nodeNum = node->children[1];
+					}
+					else if ( res == PLANESIDE_FRONT ) {
+						nodeNum = node->children[0];
+					}
+					else {
+						break;
+					}
+				}
+				if ( nodeNum <= 0 ) {
+					gridNumLeafCells++;
+				}
+				gridNodes[( z * gridSize[1] + y ) * gridSize[0] + x] = nodeNum;
+			}
+		}
+	}
+}
+
+/*
+============
+idAASFileLocal::GridNodeNum
+
+  Returns the tree node to start a query for the given bounds from.
+============
+*/
+int idAASFileLocal::GridNodeNum( const idVec3 &mins, const idVec3 &maxs ) const {
+	int i, cell[3];
+
+	if ( gridNodes.Num() == 0 || !aas_areaGrid.GetBool() ) {
+		return 1;
+	}
+
+	for ( i = 0; i < 3; i++ ) {
+		// also catches invalid floats
+		if ( !( mins[i] >= gridBounds[0][i] && maxs[i] <= gridBounds[1][i] ) ) {
+			return 1;
+		}
+		cell[i] = (int)( ( mins[i] - gridBounds[0][i] ) * gridInvCellSize );
+		if ( cell[i] != (int)( ( maxs[i] - gridBounds[0][i] ) * gridInvCellSize ) ) {
+			return 1;
+		}
+		if ( cell[i] >= gridSize[i] ) {
+			cell[i] = gridSize[i] - 1;
+		}
+	}
+
+	return gridNodes[( cell[2] * gridSize[1] + cell[1] ) * gridSize[0] + cell[0]];
+}
+
+/*
+============
+idAASFileLocal::BoundsNodeNum
+============
+*/
+int idAASFileLocal::BoundsNodeNum( const idBounds &bounds ) const {
+	return GridNodeNum( bounds[0], bounds[1] );
+}
+
 /*
 ============
 idAASFileLocal::PointAreaNum
@@ -205,7 +333,10 @@ int idAASFileLocal::PointAreaNum( const idVec3 &origin ) const {
 	int nodeNum;
 	const aasNode_t *node;
 
-	nodeNum = 1;
+	nodeNum = GridNodeNum( origin, origin );
+	if ( nodeNum <= 0 ) {
+		return -nodeNum;
+	}
 	do {
 		node = &nodes[nodeNum];
 		if ( planeList[node->planeNum].Side( origin ) == PLANESIDE_BACK ) {
@@ -328,7 +459,7 @@ idAASFileLocal::BoundsReachableAreaNum
 */
 int idAASFileLocal::BoundsReachableAreaNum( const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const {
 
-	return BoundsReachableAreaNum_r( 1, bounds, areaFlags, excludeTravelFlags );
+	return BoundsReachableAreaNum_r( GridNodeNum( bounds[0], bounds[1] ), bounds, areaFlags, excludeTravelFlags );
 }
 
 /*
@@ -416,6 +416,7 @@ idEntity::idEntity():
 	snapshotBits = 0;
 
 	thinkFlags		= 0;
+	lastThinkTime	= 0;
 	dormantStart	= 0;
 	cinematic		= false;
 	renderView		= NULL;
@@ -613,7 +614,10 @@ idEntity::~idEntity() {
 	if ( thinkFlags ) {
 		BecomeInactive( thinkFlags );
 	}
-	activeNode.Remove();
+	if ( activeNode.InList() ) {
+		activeNode.Remove();
+		gameLocal.activeEntityListDirty = true;
+	}
 
 	Signal( SIG_REMOVED );
 
@@ -983,7 +987,7 @@ void idEntity::BecomeActive( int flags ) {
 	thinkFlags |= flags;
 	if ( thinkFlags ) {
 		if ( !IsActive() ) {
-			activeNode.AddToEnd( gameLocal.activeEntities );
+			gameLocal.AddActiveEntity( this );
 		} else if ( !oldFlags ) {
 			// we became inactive this frame, so we have to decrease the count of entities to deactivate
 			gameLocal.numEntitiesToDeactivate--;
@@ -5073,6 +5077,24 @@ idEntity::WriteToSnapshot
 void idEntity::WriteToSnapshot( idBitMsg &msg ) const {
 }
 
+/*
+================
+idEntity::GetSnapshotSchema
+================
+*/
+const idNetSchema * idEntity::GetSnapshotSchema() const {
+	return NULL;
+}
+
+/*
+================
+idEntity::GetSnapshotImportance
+================
+*/
+float idEntity::GetSnapshotImportance() const {
+	return 1.0f;
+}
+
 /*
 ================
 idEntity::ReadFromSnapshot
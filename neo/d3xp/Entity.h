@@ -182,6 +182,7 @@ public:
 	idScriptObject			scriptObject;			// contains all script defined data for this entity
 
 	int						thinkFlags;				// TH_? flags
+	int						lastThinkTime;			// game time of the last think, used to step entities with a reduced think rate
 	int						dormantStart;			// time that the entity was first closed off from player
 	bool					cinematic;				// during cinematics, entity will only think if cinematic is set
 
@@ -421,6 +422,10 @@ public:
 
 	virtual void			ClientPredictionThink();
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	// Field block that WriteToSnapshot writes first, if any, lets the snapshot send field deltas
+	virtual const idNetSchema *	GetSnapshotSchema() const;
+	// How much clients care about this entity's changes, scales its priority when the snapshot bandwidth is short
+	virtual float			GetSnapshotImportance() const;
 	void					ReadFromSnapshot_Ex( const idBitMsg &msg );
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 	virtual bool			ServerReceiveEvent( int event, int time, const idBitMsg &msg );
@@ -95,11 +95,15 @@ public:
 	// Loads a map and spawns all the entities.
 	virtual void				InitFromNewMap( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, int gameMode, int randseed ) = 0;
 
-	// Loads a map from a savegame file.
-	virtual bool				InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile *saveGameFile, idFile *stringTableFile, int saveGameVersion ) = 0;
+	// Loads a map from a savegame file, deltaSaveFile is the delta autosave made against it if there is one.
+	virtual bool				InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile *saveGameFile, idFile *stringTableFile, idFile *deltaSaveFile, int saveGameVersion ) = 0;
 
 	// Saves the current game state, common may have written some data to the file already.
-	virtual void				SaveGame( idFile *saveGameFile, idFile *stringTableFile ) = 0;
+	// Autosaves may be written as a delta against the previous full autosave, returns true if it was.
+	virtual bool				SaveGame( idFile *saveGameFile, idFile *stringTableFile, bool autoSave ) = 0;
+
+	// Common calls this once the files written by SaveGame were stored, or failed to be.
+	virtual void				SaveGameWritten( bool succeeded ) = 0;
 
 	// Pulls the current player location from the game information
 	virtual void				GetSaveGameDetails( idSaveGameDetails & gameDetails ) = 0;
@@ -308,7 +312,7 @@ extern idGameEdit *				gameEdit;
 ===============================================================================
 */
 
-constexpr int GAME_API_VERSION		= 8;
+constexpr int GAME_API_VERSION		= 9;
 
 typedef struct {
 
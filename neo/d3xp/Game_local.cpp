@@ -208,6 +208,9 @@ void idGameLocal::Clear() {
 	num_entities = 0;
 	spawnedEntities.Clear();
 	activeEntities.Clear();
+	activeEntityList.Clear();
+	activeEntityListDirty = true;
+	thinkBucketStats.Clear();
 	numEntitiesToDeactivate = 0;
 	sortPushers = false;
 	sortTeamMasters = false;
@@ -445,9 +448,10 @@ idGameLocal::SaveGame
 
 save the current player state, level name, and level state
 the session may have written some data to the file already
+returns true if an autosave was written as a delta against the last full autosave
 ============
 */
-void idGameLocal::SaveGame( idFile *f, idFile *strings ) {
+bool idGameLocal::SaveGame( idFile *f, idFile *strings, bool autoSave ) {
 	int i;
 	idEntity *ent;
 	idEntity *link;
@@ -460,7 +464,7 @@ void idGameLocal::SaveGame( idFile *f, idFile *strings ) {
 		}
 	}
 
-	idSaveGame savegame( f, strings, BUILD_NUMBER );
+	idSaveGame savegame( f, strings, BUILD_NUMBER, autoSave );
 
 	if ( g_flushSave.GetBool( ) == true ) { 
 		// force flushing with each write... for tracking down
@@ -634,12 +638,29 @@ void idGameLocal::SaveGame( idFile *f, idFile *strings ) {
 	savegame.Close();
 
 	int endTimeMs = Sys_Milliseconds();
-	idLib::Printf( "Save time: %dms\n", ( endTimeMs - startTimeMs ) );
+	idLib::Printf( "Save time: %dms%s\n", ( endTimeMs - startTimeMs ), savegame.WroteDelta() ? " (delta)" : "" );
 
 	if ( g_recordSaveGameTrace.GetBool() ) {
 		EndTraceRecording();
 		g_recordSaveGameTrace.SetBool( false );
 	}
+
+	return savegame.WroteDelta();
+}
+
+/*
+===========
+idGameLocal::SaveGameWritten
+
+a new delta base is only used once the full autosave it was taken from is stored
+============
+*/
+void idGameLocal::SaveGameWritten( bool succeeded ) {
+	if ( succeeded ) {
+		saveGameDeltaBase.written = true;
+	} else if ( !saveGameDeltaBase.written ) {
+		saveGameDeltaBase.Clear();
+	}
 }
 
 /*
@@ -913,6 +934,9 @@ void idGameLocal::LoadMap( const char * mapName, int randseed ) {
 	
 	spawnedEntities.Clear();
 	activeEntities.Clear();
+	activeEntityList.Clear();
+	activeEntityListDirty = true;
+	thinkBucketStats.Clear();
 	aimAssistEntities.Clear();
 	numEntitiesToDeactivate = 0;
 	sortTeamMasters = false;
@@ -1210,7 +1234,7 @@ void idGameLocal::InitFromNewMap( const char *mapName, idRenderWorld *renderWorl
 idGameLocal::InitFromSaveGame
 =================
 */
-bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile * saveGameFile, idFile * stringTableFile, int saveGameVersion ) {
+bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile * saveGameFile, idFile * stringTableFile, idFile * deltaSaveFile, int saveGameVersion ) {
 	int i;
 	int num;
 	idEntity *ent;
@@ -1232,9 +1256,31 @@ bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWo
 	// load the map needed for this savegame
 	LoadMap( mapName, 0 );
 
+	const int startTimeMs = Sys_Milliseconds();
+
 	idFile_SaveGamePipelined * pipelineFile = new (TAG_SAVEGAMES) idFile_SaveGamePipelined();
 	pipelineFile->OpenForReading( saveGameFile );
-	idRestoreGame savegame( pipelineFile, stringTableFile, saveGameVersion );
+	idFile_SaveGamePipelined * deltaPipelineFile = NULL;
+	if ( deltaSaveFile != NULL ) {
+		deltaPipelineFile = new (TAG_SAVEGAMES) idFile_SaveGamePipelined();
+		deltaPipelineFile->OpenForReading( deltaSaveFile );
+	}
+	idRestoreGame savegame( pipelineFile, stringTableFile, saveGameVersion, deltaPipelineFile );
+	int compressedBytes = saveGameFile->Length();
+	size_t deltaBytes = 0;
+	if ( deltaPipelineFile != NULL ) {
+		compressedBytes += deltaSaveFile->Length();
+		deltaBytes = deltaPipelineFile->GetUncompressedLength();
+	}
+	delete deltaPipelineFile;
+
+	if ( !savegame.IsValid() ) {
+		// the full autosave a delta was made against is missing or was replaced,
+		// let the session go back to the menu instead of restoring a broken game
+		Warning( "idGameLocal::InitFromSaveGame: couldn't restore the delta autosave" );
+		delete pipelineFile;
+		return false;
+	}
 
 	// Create the list of all objects in the game
 	savegame.CreateObjects();
@@ -1315,6 +1361,7 @@ bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWo
 			ent->activeNode.AddToEnd( activeEntities );
 		}
 	}
+	activeEntityListDirty = true;
 
 	savegame.ReadInt( numEntitiesToDeactivate );
 	savegame.ReadBool( sortPushers );
@@ -1441,6 +1488,10 @@ bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWo
 
 	gamestate = GAMESTATE_ACTIVE;
 
+	// decompression runs on the pipeline threads while the objects are read, so it is part of the total
+	Printf( "Restore time: %dms including decompression, %d kB compressed, %d kB serialized\n", Sys_Milliseconds() - startTimeMs,
+		compressedBytes >> 10, (int)( ( pipelineFile->GetUncompressedLength() + deltaBytes ) >> 10 ) );
+
 	Printf( "--------------------------------------\n" );
 
 	delete pipelineFile;
@@ -1528,6 +1579,7 @@ void idGameLocal::MapShutdown() {
 
 	clip.Shutdown();
 	idClipModel::ClearTraceModelCache();
+	idAI::FreeObstacleAvoidanceNodes();
 
 	common->UpdateLevelLoadPacifier();
 
@@ -2187,10 +2239,160 @@ void idGameLocal::SortActiveEntityList() {
 		}
 	}
 
+	if ( sortTeamMasters || sortPushers ) {
+		activeEntityListDirty = true;
+	}
+
 	sortTeamMasters = false;
 	sortPushers = false;
 }
 
+/*
+================
+idGameLocal::BuildActiveEntityList
+
+  Flattens the active entity list into a contiguous array of entity numbers
+  and spawn ids.  Entries are validated on access so entities removed while
+  the list is walked are skipped.
+================
+*/
+void idGameLocal::BuildActiveEntityList() {
+	activeEntityList.SetNum( 0, false );
+	for ( idEntity *ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( ent->entityNumber == ENTITYNUM_NONE ) {
+			continue;
+		}
+		activeEntity_t &entry = activeEntityList.Alloc();
+		entry.entityNum = ent->entityNumber;
+		entry.spawnId = spawnIds[ ent->entityNumber ];
+	}
+	activeEntityListDirty = false;
+}
+
+/*
+================
+idGameLocal::AddActiveEntity
+
+  Entities that become active while the list is walked are appended so they
+  still think in the current frame, just like with the linked list.
+================
+*/
+void idGameLocal::AddActiveEntity( idEntity *ent ) {
+	ent->activeNode.AddToEnd( activeEntities );
+	ent->lastThinkTime = 0;
+
+	if ( activeEntityListDirty || ent->entityNumber < 0 || ent->entityNumber >= MAX_GENTITIES || m_entities[ ent->entityNumber ] != ent ) {
+		activeEntityListDirty = true;
+		return;
+	}
+	activeEntity_t &entry = activeEntityList.Alloc();
+	entry.entityNum = ent->entityNumber;
+	entry.spawnId = spawnIds[ ent->entityNumber ];
+}
+
+/*
+================
+idGameLocal::GetActiveEntity
+
+  Returns NULL if the entity at the given index has been removed since the list was built.
+================
+*/
+idEntity *idGameLocal::GetActiveEntity( int index ) const {
+	const activeEntity_t &entry = activeEntityList[ index ];
+	idEntity *ent = m_entities[ entry.entityNum ];
+	if ( ent == NULL || spawnIds[ entry.entityNum ] != entry.spawnId || !ent->activeNode.InList() ) {
+		return NULL;
+	}
+	return ent;
+}
+
+/*
+================
+idGameLocal::GetThinkBucket
+
+  Distant and out of PVS idle monsters think at a reduced rate in single player.
+  Each bucket doubles the think interval, starting at g_thinkLodDistance and doubling
+  the distance for every following bucket.  Movers and other parametric pushers always
+  think at the full rate, stepping them over several frames moves lifts and doors in
+  visible jumps and changes what they push.  The slowest bucket is limited so that
+  physics never steps over more than g_thinkLodMaxStep milliseconds at once.
+================
+*/
+int idGameLocal::GetThinkBucket( idEntity *ent ) {
+	if ( !g_thinkLod.GetBool() || common->IsMultiplayer() || inCinematic ) {
+		return THINK_BUCKET_FULL;
+	}
+	if ( ent->entityNumber < MAX_CLIENTS || ent->fl.neverDormant || ent->cinematic || ent->GetBindMaster() != NULL ) {
+		return THINK_BUCKET_FULL;
+	}
+	if ( !ent->IsType( idAI::Type ) || ent->GetPhysics()->IsType( idPhysics_Parametric::Type ) ) {
+		return THINK_BUCKET_FULL;
+	}
+	// monsters that are fighting always think at the full rate
+	if ( static_cast<idAI *>( ent )->GetEnemy() != NULL ) {
+		return THINK_BUCKET_FULL;
+	}
+
+	int maxBucket = THINK_BUCKET_FULL;
+	while ( maxBucket < NUM_THINK_BUCKETS - 1 && FRAME_TO_MSEC( 1 << ( maxBucket + 1 ) ) <= g_thinkLodMaxStep.GetInteger() ) {
+		maxBucket++;
+	}
+	if ( maxBucket == THINK_BUCKET_FULL ) {
+		return THINK_BUCKET_FULL;
+	}
+
+	const idPlayer *player = GetLocalPlayer();
+	if ( player == NULL ) {
+		return THINK_BUCKET_FULL;
+	}
+
+	const float distSqr = ( ent->GetPhysics()->GetOrigin() - player->GetPhysics()->GetOrigin() ).LengthSqr();
+	float lodDist = g_thinkLodDistance.GetFloat();
+	int bucket = THINK_BUCKET_FULL;
+	while ( bucket < maxBucket && distSqr > Square( lodDist ) ) {
+		bucket++;
+		lodDist *= 2.0f;
+	}
+
+	if ( playerPVS.i != -1 && !pvs.InCurrentPVS( playerPVS, ent->GetPVSAreas(), ent->GetNumPVSAreas() ) ) {
+		bucket = Min( bucket + 1, maxBucket );
+	}
+
+	return bucket;
+}
+
+/*
+================
+idGameLocal::RunThrottledEntityThink
+
+  Runs the entity think if its think bucket is due this frame.  The previous time is
+  temporarily moved back to the last think so physics and animation step over the
+  whole interval that was skipped.
+================
+*/
+void idGameLocal::RunThrottledEntityThink( idEntity & ent, idUserCmdMgr & userCmdMgr ) {
+	const int bucket = GetThinkBucket( &ent );
+	thinkBucketStats.active[ bucket ]++;
+
+	const int interval = 1 << bucket;
+	if ( ( ( framenum + ent.entityNumber ) & ( interval - 1 ) ) != 0 && ent.lastThinkTime > 0 ) {
+		return;
+	}
+	thinkBucketStats.ran[ bucket ]++;
+
+	// never step over more than the think interval, the last think may be stale
+	// if the entity was run by the cinematic loop or the time was stopped
+	const int savedPreviousTime = previousTime;
+	const int maxStep = FRAME_TO_MSEC( framenum ) - FRAME_TO_MSEC( framenum - interval );
+	if ( ent.lastThinkTime > 0 && ent.lastThinkTime < previousTime && time - ent.lastThinkTime <= maxStep ) {
+		previousTime = ent.lastThinkTime;
+	}
+
+	RunEntityThink( ent, userCmdMgr );
+
+	previousTime = savedPreviousTime;
+}
+
 
 
 /*
@@ -2218,8 +2420,9 @@ void idGameLocal::RunTimeGroup2( idUserCmdMgr & userCmdMgr ) {
 
 	SelectTimeGroup( true );
 
-	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
-		if ( ent->timeGroup != TIME_GROUP2 ) {
+	for( int i = 0; i < activeEntityList.Num(); i++ ) {
+		ent = GetActiveEntity( i );
+		if ( ent == NULL || ent->timeGroup != TIME_GROUP2 ) {
 			continue;
 		}
 		RunEntityThink( *ent, userCmdMgr );
@@ -2235,6 +2438,8 @@ idGameLocal::RunEntityThink
 ================
 */
 void idGameLocal::RunEntityThink( idEntity & ent, idUserCmdMgr & userCmdMgr ) {
+	ent.lastThinkTime = time;
+
 	if ( ent.entityNumber < MAX_PLAYERS ) {
 		// Players may run more than one think per frame in MP,
 		// if there is a large buffer of usercmds from the network.
@@ -2350,13 +2555,23 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		// sort the active entity list
 		SortActiveEntityList();
 
+		// flatten the active entity list for the think loops
+		if ( activeEntityListDirty ) {
+			BuildActiveEntityList();
+		}
+		thinkBucketStats.Clear();
+
 		timer_think.Clear();
 		timer_think.Start();
 
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
-			for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+			for( int i = 0; i < activeEntityList.Num(); i++ ) {
+				ent = GetActiveEntity( i );
+				if ( ent == NULL ) {
+					continue;
+				}
 				if ( g_cinematic.GetBool() && inCinematic && !ent->cinematic ) {
 					ent->GetPhysics()->UpdateTime( time );
 					continue;
@@ -2374,7 +2589,11 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		} else {
 			if ( inCinematic ) {
 				num = 0;
-				for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+				for( int i = 0; i < activeEntityList.Num(); i++ ) {
+					ent = GetActiveEntity( i );
+					if ( ent == NULL ) {
+						continue;
+					}
 					if ( g_cinematic.GetBool() && !ent->cinematic ) {
 						ent->GetPhysics()->UpdateTime( time );
 						continue;
@@ -2384,12 +2603,15 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 				}
 			} else {
 				num = 0;
-				for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
-					if ( ent->timeGroup != TIME_GROUP1 ) {
+				for( int i = 0; i < activeEntityList.Num(); i++ ) {
+					ent = GetActiveEntity( i );
+					if ( ent == NULL || ent->timeGroup != TIME_GROUP1 ) {
 						continue;
 					}
-					RunEntityThink( *ent, cmdMgr );
-					num++;
+					RunThrottledEntityThink( *ent, cmdMgr );
+				}
+				for ( int i = 0; i < NUM_THINK_BUCKETS; i++ ) {
+					num += thinkBucketStats.ran[ i ];
 				}
 			}
 		}
@@ -2419,6 +2641,9 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 			}
 			//assert( numEntitiesToDeactivate == c );
 			numEntitiesToDeactivate = 0;
+			if ( c > 0 ) {
+				activeEntityListDirty = true;
+			}
 		}
 
 		timer_think.Stop();
@@ -2441,6 +2666,11 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		// do multiplayer related stuff
 		if ( common->IsMultiplayer() ) {
 			mpGame.Run();
+
+			// remember where the players are for lag compensated hit detection
+			if ( g_lagCompensation.GetBool() ) {
+				clip.SaveHistory( GetServerGameTimeMs() );
+			}
 		}
 
 		// display how long it took to calculate the current game frame
@@ -230,6 +230,28 @@ struct timeState_t {
 	void				Restore( idRestoreGame *savefile )	{ savefile->ReadInt( time ); savefile->ReadInt( previousTime ); savefile->ReadInt( realClientTime ); }
 };
 
+// think frequency buckets, entities in bucket N think every ( 1 << N ) game frames
+enum thinkBucket_t {
+	THINK_BUCKET_FULL,
+	THINK_BUCKET_HALF,
+	THINK_BUCKET_QUARTER,
+	THINK_BUCKET_EIGHTH,
+	NUM_THINK_BUCKETS
+};
+
+// entry in the contiguous active entity list, validated against spawnIds before use
+struct activeEntity_t {
+	int					entityNum;
+	int					spawnId;
+};
+
+struct thinkBucketStats_t {
+	int					active[ NUM_THINK_BUCKETS ];	// active entities assigned to each bucket
+	int					ran[ NUM_THINK_BUCKETS ];		// entities that actually thought in each bucket
+
+	void				Clear() { memset( this, 0, sizeof( *this ) ); }
+};
+
 enum slowmoState_t {
 	SLOWMO_STATE_OFF,
 	SLOWMO_STATE_RAMPUP,
@@ -256,6 +278,9 @@ public:
 	idWorldspawn *			world;					// world entity
 	idLinkList<idEntity>	spawnedEntities;		// all spawned entities
 	idLinkList<idEntity>	activeEntities;			// all thinking entities (idEntity::thinkFlags != 0)
+	idList<activeEntity_t>	activeEntityList;		// contiguous copy of activeEntities walked by RunFrame
+	bool					activeEntityListDirty;	// true if activeEntityList has to be rebuilt from activeEntities
+	thinkBucketStats_t		thinkBucketStats;		// think bucket counts for the last game frame
 	idLinkList<idEntity>	aimAssistEntities;		// all aim Assist entities
 	int						numEntitiesToDeactivate;// number of entities that became inactive in current frame
 	bool					sortPushers;			// true if active lists needs to be reordered to place pushers at the front
@@ -345,8 +370,9 @@ public:
 	virtual const idDict &	GetPersistentPlayerInfo( int clientNum );
 	virtual void			SetPersistentPlayerInfo( int clientNum, const idDict &playerInfo );
 	virtual void			InitFromNewMap( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, int gameType, int randSeed );
-	virtual bool			InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile * saveGameFile, idFile * stringTableFile, int saveGameVersion );
-	virtual void			SaveGame( idFile *saveGameFile, idFile *stringTableFile );
+	virtual bool			InitFromSaveGame( const char *mapName, idRenderWorld *renderWorld, idSoundWorld *soundWorld, idFile * saveGameFile, idFile * stringTableFile, idFile * deltaSaveFile, int saveGameVersion );
+	virtual bool			SaveGame( idFile *saveGameFile, idFile *stringTableFile, bool autoSave );
+	virtual void			SaveGameWritten( bool succeeded );
 	virtual void			GetSaveGameDetails( idSaveGameDetails & gameDetails );
 	virtual void			MapShutdown();
 	virtual void			CacheDictionaryMedia( const idDict *dict );
@@ -355,6 +381,9 @@ public:
 	void					RunAllUserCmdsForPlayer( idUserCmdMgr & cmdMgr, const int playerNumber );
 	void					RunSingleUserCmd( usercmd_t & cmd, idPlayer & player );
 	void					RunEntityThink( idEntity & ent, idUserCmdMgr & userCmdMgr );
+	void					AddActiveEntity( idEntity *ent );
+	idEntity *				GetActiveEntity( int index ) const;
+	int						GetThinkBucket( idEntity *ent );
 	virtual bool			Draw( int clientNum );
 	virtual bool			HandlePlayerGuiEvent( const sysEvent_t * ev );
 	virtual void			ServerWriteSnapshot( idSnapShot & ss );
@@ -610,6 +639,8 @@ private:
 	void					FreePlayerPVS();
 	void					UpdateGravity();
 	void					SortActiveEntityList();
+	void					BuildActiveEntityList();
+	void					RunThrottledEntityThink( idEntity & ent, idUserCmdMgr & userCmdMgr );
 	void					ShowTargets();
 	void					RunDebugInfo();
 
@@ -348,13 +348,19 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot & ss ) {
 	}
 
 	// Build PVS data for each player and write their player state to the snapshot as well
+	// The lobby sends the snapshot to every peer with the peer's visIndex, so the view origin and PVS bit
+	// of a player are keyed by the peer it plays on, players sharing a peer share its bit
+	compile_time_assert( MAX_PLAYERS < idSnapShot::MAX_VIEWERS );
+	idLobbyBase & lobby = session->GetActingGameStateLobbyBase();
 	pvsHandle_t pvsHandles[ MAX_PLAYERS ];
+	int visIndices[ MAX_PLAYERS ];
 	for ( int i = 0; i < MAX_PLAYERS; i++ ) {
 		idPlayer * player = static_cast<idPlayer *>( m_entities[ i ] );
 		if ( player == NULL ) {
 			pvsHandles[i].i = -1;
 			continue;
 		}
+		visIndices[i] = idSnapShot::VisIndexForPeer( lobby.PeerIndexFromLobbyUser( lobbyUserIDs[i] ) );
 		idPlayer * spectated = player;
 		if ( player->spectating && player->spectator != i && m_entities[ player->spectator ] ) {
 			spectated = static_cast< idPlayer * >( m_entities[ player->spectator ] );
@@ -363,6 +369,7 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot & ss ) {
 		msg.InitWrite( buffer, sizeof( buffer ) );
 		spectated->WritePlayerStateToSnapshot( msg );
 		ss.S_AddObject( SNAP_PLAYERSTATE + i, ~0U, msg, "Player State" );
+		ss.SetViewOrigin( visIndices[i], spectated->GetEyePosition() );
 
 		int sourceAreas[ idEntity::MAX_PVS_AREAS ];
 		int numSourceAreas = gameRenderWorld->BoundsInAreas( spectated->GetPlayerPhysics()->GetAbsBounds(), sourceAreas, idEntity::MAX_PVS_AREAS );
@@ -397,12 +404,31 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot & ss ) {
 		
 		msg.WriteBits( ent->GetPredictedKey(), 32 );
 
+		const idNetSchema * schema = NULL;
+		int schemaOffset = 0;
+
 		if ( ent->fl.networkSync ) {
+			// the field block starts byte aligned at the start of the class specific data
+			schema = ent->GetSnapshotSchema();
+			schemaOffset = ( msg.GetNumBitsWritten() + 7 ) >> 3;
+
 			// write the class specific data to the snapshot
 			ent->WriteToSnapshot( msg );
 		}
 
-		ss.S_AddObject( SNAP_ENTITIES + ent->entityNumber, ~0U, msg, ent->GetName() );
+		idSnapShot::objectState_t * state = ss.S_AddObject( SNAP_ENTITIES + ent->entityNumber, ~0U, msg, ent->GetName() );
+		state->schema = schema;
+		state->schemaOffset = schemaOffset;
+
+		// interest management: the snapshot processor of every peer weighs the changes by distance and PVS
+		state->importance = ent->GetSnapshotImportance();
+		state->origin = ent->GetPhysics()->GetOrigin();
+		state->pvsMask = 0;
+		for ( int i = 0; i < MAX_PLAYERS; i++ ) {
+			if ( pvsHandles[i].i >= 0 && pvs.InCurrentPVS( pvsHandles[i], ent->GetPVSAreas(), ent->GetNumPVSAreas() ) ) {
+				state->pvsMask |= (uint32)BIT( visIndices[i] );
+			}
+		}
 	}
 
 	// Free PVS handles for all the players
@@ -197,6 +197,7 @@ public:
 	static idEntity	*		DropItem( const char *classname, const idVec3 &origin, const idMat3 &axis, const idVec3 &velocity, int activateDelay, int removeDelay );
 
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	virtual const idNetSchema *	GetSnapshotSchema() const { return idPhysics_RigidBody::GetSnapshotSchema(); }
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 
 protected:
@@ -235,6 +236,7 @@ public:
 
 	// networking
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	virtual const idNetSchema *	GetSnapshotSchema() const { return NULL; }		// team state is written before the physics
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 
 public:
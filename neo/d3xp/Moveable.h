@@ -62,6 +62,7 @@ public:
 	virtual bool			Collide( const trace_t &collision, const idVec3 &velocity );
 	virtual void			Killed( idEntity *inflictor, idEntity *attacker, int damage, const idVec3 &dir, int location );
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	virtual const idNetSchema *	GetSnapshotSchema() const { return idPhysics_RigidBody::GetSnapshotSchema(); }
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 
 	void					SetAttacker( idEntity *ent );
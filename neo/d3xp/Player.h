@@ -606,6 +606,8 @@ public:
 
 	virtual void			ClientThink( const int curTime, const float fraction, const bool predict );
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	virtual const idNetSchema *	GetSnapshotSchema() const { return idPhysics_Player::GetSnapshotSchema(); }
+	virtual float			GetSnapshotImportance() const { return 4.0f; }
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 	void					WritePlayerStateToSnapshot( idBitMsg &msg ) const;
 	void					ReadPlayerStateFromSnapshot( const idBitMsg &msg );
@@ -424,7 +424,9 @@ void idProjectile::Launch( const idVec3 &start, const idVec3 &dir, const idVec3
 	if ( !common->IsClient() || fl.skipReplication ) {
 		if ( fuse <= 0 ) {
 			// run physics for 1 second
-			RunPhysics();
+			if ( !LagCompensatedCollide() ) {
+				RunPhysics();
+			}
 			PostEventMS( &EV_Remove, spawnArgs.GetInt( "remove_time", "1500" ) );
 		} else if ( spawnArgs.GetBool( "detonate_on_fuse" ) ) {
 			fuse -= timeSinceFire;
@@ -546,6 +548,44 @@ void idProjectile::AddParticlesAndLight() {
 	}
 }
 
+/*
+=================
+idProjectile::LagCompensatedCollide
+
+Instant hit projectiles fired by a remote player are traced on the server against
+the players where the shooter saw them when firing. Returns true if a player was
+hit, otherwise the projectile flies as usual.
+=================
+*/
+bool idProjectile::LagCompensatedCollide() {
+	if ( !g_lagCompensation.GetBool() || !common->IsMultiplayer() || common->IsClient() || !spawnArgs.GetBool( "net_instanthit" ) ) {
+		return false;
+	}
+
+	idEntity *ownerEnt = owner.GetEntity();
+	if ( ownerEnt == NULL || !ownerEnt->IsType( idPlayer::Type ) || static_cast<idPlayer *>( ownerEnt )->IsLocallyControlled() ) {
+		return false;
+	}
+
+	const int serverTime = gameLocal.GetServerGameTimeMs();
+	const int rewindTime = idMath::ClampInt( serverTime - g_lagCompensationMaxMs.GetInteger(), serverTime, static_cast<idPlayer *>( ownerEnt )->usercmd.serverGameMilliseconds );
+
+	// trace as far as the projectile can fly before it is removed
+	const idVec3 &start = physicsObj.GetOrigin();
+	const idVec3 velocity = physicsObj.GetLinearVelocity();
+	const idVec3 end = start + velocity * MS2SEC( spawnArgs.GetInt( "remove_time", "1500" ) );
+
+	trace_t tr;
+	gameLocal.clip.TranslationAtTime( tr, start, end, NULL, mat3_identity, physicsObj.GetClipMask(), this, rewindTime );
+	if ( tr.fraction >= 1.0f || tr.c.entityNum >= MAX_CLIENTS ) {
+		return false;
+	}
+
+	physicsObj.SetOrigin( tr.endpos );
+	Collide( tr, velocity );
+	return true;
+}
+
 /*
 =================
 idProjectile::Collide
@@ -84,6 +84,7 @@ public :
 	virtual void			ClientPredictionThink();
 	virtual void			ClientThink( const int curTime, const float fraction, const bool predict );
 	virtual void			WriteToSnapshot( idBitMsg &msg ) const;
+	virtual float			GetSnapshotImportance() const { return 2.0f; }
 	virtual void			ReadFromSnapshot( const idBitMsg &msg );
 	virtual bool			ClientReceiveEvent( int event, int time, const idBitMsg &msg );
 
@@ -154,6 +155,7 @@ private:
 
 	void					AddDefaultDamageEffect( const trace_t &collision, const idVec3 &velocity );
 	void					AddParticlesAndLight();
+	bool					LagCompensatedCollide();
 
 	void					Event_Explode();
 	void					Event_Fizzle();
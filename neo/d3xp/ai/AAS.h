@@ -136,6 +136,10 @@ public:
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const = 0;
 								// Find the nearest goal which satisfies the callback.
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const = 0;
+								// Time routing of a number of agents at random areas towards the goal area.
+	virtual void				RouteBenchmark( int goalAreaNum, int numAgents ) = 0;
+								// Time area lookups at a number of positions with and without the area grid.
+	virtual void				AreaNumBenchmark( int numPoints ) const = 0;
 };
 
 #endif /* !__AAS_H__ */
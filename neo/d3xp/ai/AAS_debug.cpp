@@ -505,4 +505,182 @@ void idAASLocal::Test( const idVec3 &origin ) {
 	if ( aas_showPushIntoArea.GetBool() ) {
 		ShowPushIntoArea( origin );
 	}
+	if ( aas_showCacheStats.GetBool() ) {
+		UpdateCacheStatsFrame();
+		if ( lastFrameCacheStats.frameNum == gameLocal.framenum - 1 ) {
+			PrintCacheStats( va( "frame %d", lastFrameCacheStats.frameNum ), lastFrameCacheStats );
+		}
+	}
+}
+
+/*
+============
+idAASLocal::RouteBenchmark
+
+  Simulates a group of agents at random areas walking towards the same goal area,
+  once using the hierarchical routing cache only and once with goal flow fields.
+============
+*/
+void idAASLocal::RouteBenchmark( int goalAreaNum, int numAgents ) {
+	const int numFrames = 32;
+	const int travelFlags = TFL_WALK|TFL_AIR;
+	idRandom random( 0 );
+	idList<int> startAreas;
+	idList<int> agentAreas;
+	idList<idVec3> agentOrigins;
+	idTimer timer;
+	aasPath_t path;
+	idReachability *reach;
+	int i, j, frame, pass, travelTime, numRoutes;
+
+	if ( !file ) {
+		return;
+	}
+
+	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RouteBenchmark: goalAreaNum %d out of range\n", goalAreaNum );
+		return;
+	}
+
+	for ( i = 0; i < numAgents; i++ ) {
+		for ( j = 0; j < 64; j++ ) {
+			int areaNum = 1 + random.RandomInt( file->GetNumAreas() - 1 );
+			if ( file->GetArea( areaNum ).flags & AREA_REACHABLE_WALK ) {
+				startAreas.Append( areaNum );
+				break;
+			}
+		}
+	}
+
+	const bool flowFieldsEnabled = aas_flowFields.GetBool();
+
+	for ( pass = 0; pass < 2; pass++ ) {
+
+		// start without any routing cache
+		for ( i = 0; i < file->GetNumClusters(); i++ ) {
+			DeleteClusterCache( i );
+		}
+		DeletePortalCache();
+		DeleteFlowFields();
+
+		aas_flowFields.SetBool( pass != 0 );
+
+		agentAreas = startAreas;
+		agentOrigins.SetNum( startAreas.Num() );
+		for ( i = 0; i < startAreas.Num(); i++ ) {
+			agentOrigins[i] = AreaCenter( startAreas[i] );
+		}
+
+		numRoutes = 0;
+		timer.Clear();
+		timer.Start();
+
+		for ( frame = 0; frame < numFrames; frame++ ) {
+			for ( i = 0; i < agentAreas.Num(); i++ ) {
+				if ( agentAreas[i] == goalAreaNum ) {
+					continue;
+				}
+				if ( !WalkPathToGoal( path, agentAreas[i], agentOrigins[i], goalAreaNum, AreaCenter( goalAreaNum ), travelFlags ) ) {
+					continue;
+				}
+				// step the agent into the next area along the route
+				if ( RouteToGoalArea( agentAreas[i], agentOrigins[i], goalAreaNum, travelFlags, travelTime, &reach ) && reach ) {
+					agentAreas[i] = reach->toAreaNum;
+					agentOrigins[i] = reach->end;
+				}
+				numRoutes++;
+			}
+		}
+
+		timer.Stop();
+
+		gameLocal.Printf( "%-12s %d agents, %d frames, %d routes in %.2f ms, %d KB cache\n", pass ? "flow field:" : "hierarchy:",
+							startAreas.Num(), numFrames, numRoutes, timer.Milliseconds(), totalCacheMemory >> 10 );
+	}
+
+	aas_flowFields.SetBool( flowFieldsEnabled );
+}
+
+/*
+============
+idAASLocal::AreaNumBenchmark
+
+  Times point and bounds area lookups once descending the tree from the root and
+  once starting from the node stored in the area grid. The positions are the
+  origins of all entities in the map and random points inside the areas.
+============
+*/
+void idAASLocal::AreaNumBenchmark( int numPoints ) const {
+	const int numRepeats = 16;
+	idRandom random( 0 );
+	idList<idVec3> points;
+	idList<int> areaNums[2];
+	idTimer timer;
+	idBounds bounds;
+	int i, j, pass, numMismatches;
+	double pointTime[2], boundsTime[2];
+
+	if ( !file || file->GetNumAreas() <= 1 ) {
+		return;
+	}
+
+	for ( idEntity *ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		points.Append( ent->GetPhysics()->GetOrigin() );
+	}
+	while( points.Num() < numPoints ) {
+		const idBounds &areaBounds = file->GetArea( 1 + random.RandomInt( file->GetNumAreas() - 1 ) ).bounds;
+		idVec3 point;
+		for ( i = 0; i < 3; i++ ) {
+			point[i] = areaBounds[0][i] + ( areaBounds[1][i] - areaBounds[0][i] ) * random.RandomFloat();
+		}
+		points.Append( point );
+	}
+
+	const idBounds &boundingBox = file->GetSettings().boundingBoxes[0];
+	const bool areaGridEnabled = cvarSystem->GetCVarBool( "aas_areaGrid" );
+
+	for ( pass = 0; pass < 2; pass++ ) {
+
+		cvarSystem->SetCVarBool( "aas_areaGrid", pass != 0 );
+
+		areaNums[pass].SetNum( points.Num() * 2 );
+
+		timer.Clear();
+		timer.Start();
+		for ( j = 0; j < numRepeats; j++ ) {
+			for ( i = 0; i < points.Num(); i++ ) {
+				areaNums[pass][i] = file->PointAreaNum( points[i] );
+			}
+		}
+		timer.Stop();
+		pointTime[pass] = timer.Milliseconds();
+
+		timer.Clear();
+		timer.Start();
+		for ( j = 0; j < numRepeats; j++ ) {
+			for ( i = 0; i < points.Num(); i++ ) {
+				bounds[0] = points[i] + boundingBox[0];
+				bounds[1] = points[i] + boundingBox[1];
+				areaNums[pass][points.Num() + i] = file->BoundsReachableAreaNum( bounds, AREA_REACHABLE_WALK, TFL_INVALID );
+			}
+		}
+		timer.Stop();
+		boundsTime[pass] = timer.Milliseconds();
+	}
+
+	cvarSystem->SetCVarBool( "aas_areaGrid", areaGridEnabled );
+
+	numMismatches = 0;
+	for ( i = 0; i < areaNums[0].Num(); i++ ) {
+		if ( areaNums[0][i] != areaNums[1][i] ) {
+			numMismatches++;
+		}
+	}
+
+	gameLocal.Printf( "%d positions, %d repeats\n", points.Num(), numRepeats );
+	gameLocal.Printf( "tree:  %6.2f ms point, %6.2f ms bounds\n", pointTime[0], boundsTime[0] );
+	gameLocal.Printf( "grid:  %6.2f ms point, %6.2f ms bounds\n", pointTime[1], boundsTime[1] );
+	if ( numMismatches ) {
+		gameLocal.Warning( "AreaNumBenchmark: %d lookups differ between the tree and the grid", numMismatches );
+	}
 }
@@ -48,6 +48,7 @@ private:
 	int							cluster;				// cluster of the cache
 	int							areaNum;				// area of the cache
 	int							travelFlags;			// combinations of the travel flags
+	bool						dirty;					// travel times must be recalculated before the cache is used
 	idRoutingCache *			next;					// next in list
 	idRoutingCache *			prev;					// previous in list
 	idRoutingCache *			time_next;				// next in time based list
@@ -73,6 +74,43 @@ private:
 };
 
 
+class idRoutingFlowField {
+	friend class idAASLocal;
+
+public:
+								idRoutingFlowField( int size );
+								~idRoutingFlowField();
+
+	int							Size() const;
+
+private:
+	int							goalAreaNum;			// area all routes in the flow field lead to
+	int							travelFlags;			// combinations of the travel flags
+	int							lastUsedFrame;			// game frame the flow field was last sampled
+	bool						dirty;					// travel times must be recalculated before the flow field is used
+	int							size;					// number of areas in the flow field
+	unsigned char *				reachabilities;			// reachability to take from every area towards the goal
+	unsigned short *			travelTimes;			// travel time from every area to the goal, zero if unreachable
+};
+
+
+typedef struct flowFieldRequest_s {
+	int							goalAreaNum;			// goal area requested
+	int							travelFlags;			// travel flags requested
+	int							count;					// number of routes requested towards the goal this frame
+} flowFieldRequest_t;
+
+
+typedef struct routingCacheStats_s {
+	int							frameNum;				// game frame the counters are for
+	int							numInvalidated;			// caches marked dirty because an area they use changed
+	int							numKept;				// caches left untouched because they do not use the changed area
+	int							numRepaired;			// dirty caches recalculated
+	int							numBuilt;				// new caches calculated
+	int							updateTime;				// microseconds spent calculating travel times
+} routingCacheStats_t;
+
+
 class idRoutingObstacle {
 	friend class idAASLocal;
 								idRoutingObstacle() { }
@@ -118,6 +156,8 @@ public:
 	virtual void				ShowWalkPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const;
+	virtual void				RouteBenchmark( int goalAreaNum, int numAgents );
+	virtual void				AreaNumBenchmark( int numPoints ) const;
 
 private:
 	idAASFile *					file;
@@ -137,6 +177,14 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle *, TAG_AAS>	obstacleList;			// list with obstacles
+	mutable idList<idRoutingFlowField *, TAG_AAS>	flowFields;		// per goal travel times shared by all routes towards the goal
+	mutable idList<flowFieldRequest_t, TAG_AAS>	flowFieldRequests;	// routes requested per goal in the current frame
+	mutable int					flowFieldRequestFrame;	// game frame the flow field requests were counted in
+	mutable int					numFlowFieldBuilds;		// number of flow fields built since the routing was setup
+	mutable int					numFlowFieldSamples;	// number of routes read from flow fields
+	mutable routingCacheStats_t	frameCacheStats;		// cache invalidation and rebuild counters for the current frame
+	mutable routingCacheStats_t	lastFrameCacheStats;	// counters for the previous frame a cache changed
+	mutable routingCacheStats_t	totalCacheStats;		// counters since the routing was setup
 
 private:	// routing
 	bool						SetupRouting();
@@ -159,6 +207,18 @@ private:	// routing
 	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
+	bool						AreaInCluster( int clusterNum, int areaNum ) const;
+	bool						AreaCacheUsesArea( const idRoutingCache *cache, int areaNum ) const;
+	bool						PortalCacheUsesCluster( const idRoutingCache *cache, int clusterNum ) const;
+	bool						FlowFieldUsesArea( const idRoutingFlowField *flowField, int areaNum ) const;
+	void						InvalidateClusterCache( int clusterNum, int areaNum );
+	void						InvalidatePortalCache( int clusterNum );
+	void						InvalidateFlowFields( int areaNum );
+	void						UpdateCacheStatsFrame() const;
+	void						PrintCacheStats( const char *name, const routingCacheStats_t &stats ) const;
+	void						UpdateFlowField( idRoutingFlowField *flowField ) const;
+	idRoutingFlowField *		GetFlowField( int goalAreaNum, int travelFlags ) const;
+	void						DeleteFlowFields();
 	void						DisableArea( int areaNum );
 	void						EnableArea( int areaNum );
 	bool						SetAreaState_r( int nodeNum, const idBounds &bounds, const int areaContents, bool disabled );
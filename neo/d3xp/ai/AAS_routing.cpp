@@ -40,6 +40,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #define LEDGE_TRAVELTIME_PANALTY	250
 
+#define MAX_FLOW_FIELDS				16
+#define MAX_FLOW_FIELD_REQUESTS		64
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -51,6 +54,7 @@ idRoutingCache::idRoutingCache( int size ) {
 	next = prev = NULL;
 	time_next = time_prev = NULL;
 	travelFlags = 0;
+	dirty = false;
 	startTravelTime = 0;
 	type = 0;
 	this->size = size;
@@ -79,6 +83,42 @@ int idRoutingCache::Size() const {
 	return sizeof( idRoutingCache ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] );
 }
 
+/*
+============
+idRoutingFlowField::idRoutingFlowField
+============
+*/
+idRoutingFlowField::idRoutingFlowField( int size ) {
+	goalAreaNum = 0;
+	travelFlags = 0;
+	lastUsedFrame = 0;
+	dirty = false;
+	this->size = size;
+	reachabilities = new (TAG_AAS) byte[size];
+	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
+	travelTimes = new (TAG_AAS) unsigned short[size];
+	memset( travelTimes, 0, size * sizeof( travelTimes[0] ) );
+}
+
+/*
+============
+idRoutingFlowField::~idRoutingFlowField
+============
+*/
+idRoutingFlowField::~idRoutingFlowField() {
+	delete [] reachabilities;
+	delete [] travelTimes;
+}
+
+/*
+============
+idRoutingFlowField::Size
+============
+*/
+int idRoutingFlowField::Size() const {
+	return sizeof( idRoutingFlowField ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] );
+}
+
 /*
 ============
 idAASLocal::AreaTravelTime
@@ -213,6 +253,16 @@ void idAASLocal::SetupRoutingCache() {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+
+	flowFieldRequests.Clear();
+	flowFieldRequestFrame = -1;
+	numFlowFieldBuilds = 0;
+	numFlowFieldSamples = 0;
+
+	memset( &frameCacheStats, 0, sizeof( frameCacheStats ) );
+	memset( &lastFrameCacheStats, 0, sizeof( lastFrameCacheStats ) );
+	memset( &totalCacheStats, 0, sizeof( totalCacheStats ) );
+	frameCacheStats.frameNum = -1;
 }
 
 /*
@@ -264,6 +314,7 @@ void idAASLocal::ShutdownRoutingCache() {
 	}
 
 	DeletePortalCache();
+	DeleteFlowFields();
 
 	Mem_Free( areaCacheIndex );
 	areaCacheIndex = NULL;
@@ -331,6 +382,221 @@ void idAASLocal::RoutingStats() const {
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
+
+	int totalFlowFieldMemory = 0;
+	for ( int i = 0; i < flowFields.Num(); i++ ) {
+		totalFlowFieldMemory += flowFields[i]->Size();
+	}
+	gameLocal.Printf( "%6d flow fields (%d KB)\n", flowFields.Num(), totalFlowFieldMemory >> 10 );
+	gameLocal.Printf( "%6d flow field builds, %d routes read from flow fields\n", numFlowFieldBuilds, numFlowFieldSamples );
+
+	UpdateCacheStatsFrame();
+	PrintCacheStats( "last frame", lastFrameCacheStats );
+	PrintCacheStats( "total", totalCacheStats );
+}
+
+/*
+============
+idAASLocal::UpdateCacheStatsFrame
+
+  Moves the cache counters of the previous frame into the totals once a new frame starts.
+============
+*/
+void idAASLocal::UpdateCacheStatsFrame() const {
+	if ( frameCacheStats.frameNum == gameLocal.framenum ) {
+		return;
+	}
+	if ( frameCacheStats.numInvalidated || frameCacheStats.numRepaired || frameCacheStats.numBuilt ) {
+		lastFrameCacheStats = frameCacheStats;
+	}
+	totalCacheStats.numInvalidated += frameCacheStats.numInvalidated;
+	totalCacheStats.numKept += frameCacheStats.numKept;
+	totalCacheStats.numRepaired += frameCacheStats.numRepaired;
+	totalCacheStats.numBuilt += frameCacheStats.numBuilt;
+	totalCacheStats.updateTime += frameCacheStats.updateTime;
+	memset( &frameCacheStats, 0, sizeof( frameCacheStats ) );
+	frameCacheStats.frameNum = gameLocal.framenum;
+}
+
+/*
+============
+idAASLocal::PrintCacheStats
+============
+*/
+void idAASLocal::PrintCacheStats( const char *name, const routingCacheStats_t &stats ) const {
+	gameLocal.Printf( "%s: %d invalidated, %d kept, %d repaired, %d built, %.2f ms\n", name,
+						stats.numInvalidated, stats.numKept, stats.numRepaired, stats.numBuilt, stats.updateTime * 0.001f );
+}
+
+/*
+============
+idAASLocal::AreaInCluster
+
+  Returns true if the area is part of the cluster or one of its portals.
+============
+*/
+bool idAASLocal::AreaInCluster( int clusterNum, int areaNum ) const {
+	int areaCluster;
+
+	areaCluster = file->GetArea( areaNum ).cluster;
+	if ( areaCluster > 0 ) {
+		return ( areaCluster == clusterNum );
+	}
+	const aasPortal_t &portal = file->GetPortal( -areaCluster );
+	return ( portal.clusters[0] == clusterNum || portal.clusters[1] == clusterNum );
+}
+
+/*
+============
+idAASLocal::AreaCacheUsesArea
+
+  Returns true if the travel times in the area cache may change when the travel flags
+  of the area or of the reachabilities leading into the area change. Routes can only
+  run through the area if the cache reached the area, and the area can only open up a
+  new route if the cache reached one of the areas it has a reachability towards.
+============
+*/
+bool idAASLocal::AreaCacheUsesArea( const idRoutingCache *cache, int areaNum ) const {
+	int clusterAreaNum, numReachableAreas;
+	const idReachability *reach;
+
+	numReachableAreas = file->GetCluster( cache->cluster ).numReachableAreas;
+
+	if ( AreaInCluster( cache->cluster, areaNum ) ) {
+		clusterAreaNum = ClusterAreaNum( cache->cluster, areaNum );
+		if ( clusterAreaNum < numReachableAreas && cache->travelTimes[clusterAreaNum] ) {
+			return true;
+		}
+	}
+
+	for ( reach = file->GetArea( areaNum ).reach; reach; reach = reach->next ) {
+		if ( !AreaInCluster( cache->cluster, reach->toAreaNum ) ) {
+			continue;
+		}
+		clusterAreaNum = ClusterAreaNum( cache->cluster, reach->toAreaNum );
+		if ( clusterAreaNum < numReachableAreas && cache->travelTimes[clusterAreaNum] ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+============
+idAASLocal::PortalCacheUsesCluster
+
+  The portal cache only routes through a cluster if it starts in the cluster
+  or reached one of the portals of the cluster.
+============
+*/
+bool idAASLocal::PortalCacheUsesCluster( const idRoutingCache *cache, int clusterNum ) const {
+	int i;
+	const aasCluster_t *cluster;
+
+	if ( cache->cluster == clusterNum ) {
+		return true;
+	}
+
+	cluster = &file->GetCluster( clusterNum );
+	for ( i = 0; i < cluster->numPortals; i++ ) {
+		if ( cache->travelTimes[file->GetPortalIndex( cluster->firstPortal + i )] ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+============
+idAASLocal::FlowFieldUsesArea
+============
+*/
+bool idAASLocal::FlowFieldUsesArea( const idRoutingFlowField *flowField, int areaNum ) const {
+	const idReachability *reach;
+
+	if ( flowField->travelTimes[areaNum] ) {
+		return true;
+	}
+	for ( reach = file->GetArea( areaNum ).reach; reach; reach = reach->next ) {
+		if ( flowField->travelTimes[reach->toAreaNum] ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+============
+idAASLocal::InvalidateClusterCache
+
+  Marks the area cache in the cluster dirty if it may be affected by a change to the area.
+  The cache keeps its memory and is recalculated the next time it is used.
+============
+*/
+void idAASLocal::InvalidateClusterCache( int clusterNum, int areaNum ) {
+	int i;
+	idRoutingCache *cache;
+
+	for ( i = 0; i < file->GetCluster( clusterNum ).numReachableAreas; i++ ) {
+		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = cache->next ) {
+			if ( cache->dirty ) {
+				continue;
+			}
+			if ( AreaCacheUsesArea( cache, areaNum ) ) {
+				cache->dirty = true;
+				frameCacheStats.numInvalidated++;
+			} else {
+				frameCacheStats.numKept++;
+			}
+		}
+	}
+}
+
+/*
+============
+idAASLocal::InvalidatePortalCache
+============
+*/
+void idAASLocal::InvalidatePortalCache( int clusterNum ) {
+	int i;
+	idRoutingCache *cache;
+
+	for ( i = 0; i < file->GetNumAreas(); i++ ) {
+		for ( cache = portalCacheIndex[i]; cache; cache = cache->next ) {
+			if ( cache->dirty ) {
+				continue;
+			}
+			if ( PortalCacheUsesCluster( cache, clusterNum ) ) {
+				cache->dirty = true;
+				frameCacheStats.numInvalidated++;
+			} else {
+				frameCacheStats.numKept++;
+			}
+		}
+	}
+}
+
+/*
+============
+idAASLocal::InvalidateFlowFields
+============
+*/
+void idAASLocal::InvalidateFlowFields( int areaNum ) {
+	int i;
+	idRoutingFlowField *flowField;
+
+	for ( i = 0; i < flowFields.Num(); i++ ) {
+		flowField = flowFields[i];
+		if ( flowField->dirty ) {
+			continue;
+		}
+		if ( FlowFieldUsesArea( flowField, areaNum ) ) {
+			flowField->dirty = true;
+			frameCacheStats.numInvalidated++;
+		} else {
+			frameCacheStats.numKept++;
+		}
+	}
 }
 
 /*
@@ -342,6 +608,26 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
 	int clusterNum;
 
 	clusterNum = file->GetArea( areaNum ).cluster;
+
+	if ( aas_incrementalCache.GetBool() ) {
+		UpdateCacheStatsFrame();
+
+		// only mark the cache that may route through or into the area dirty
+		if ( clusterNum > 0 ) {
+			InvalidateClusterCache( clusterNum, areaNum );
+			InvalidatePortalCache( clusterNum );
+		}
+		else {
+			const aasPortal_t &portal = file->GetPortal( -clusterNum );
+			InvalidateClusterCache( portal.clusters[0], areaNum );
+			InvalidateClusterCache( portal.clusters[1], areaNum );
+			InvalidatePortalCache( portal.clusters[0] );
+			InvalidatePortalCache( portal.clusters[1] );
+		}
+		InvalidateFlowFields( areaNum );
+		return;
+	}
+
 	if ( clusterNum > 0 ) {
 		// remove all the cache in the cluster the area is in
 		DeleteClusterCache( clusterNum );
@@ -352,6 +638,7 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
 	}
 	DeletePortalCache();
+	DeleteFlowFields();
 }
 
 /*
@@ -444,7 +731,7 @@ bool idAASLocal::SetAreaState( const idBounds &bounds, const int areaContents, b
 	expBounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
 
 	// find all areas within or touching the bounds with the given contents and disable/enable them for routing
-	return SetAreaState_r( 1, expBounds, areaContents, disabled );
+	return SetAreaState_r( file->BoundsNodeNum( expBounds ), expBounds, areaContents, disabled );
 }
 
 /*
@@ -545,7 +832,7 @@ aasHandle_t idAASLocal::AddObstacle( const idBounds &bounds ) {
 	obstacle = new (TAG_AAS) idRoutingObstacle;
 	obstacle->bounds[0] = bounds[0] - file->GetSettings().boundingBoxes[0][1];
 	obstacle->bounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
-	GetBoundsAreas_r( 1, obstacle->bounds, obstacle->areas );
+	GetBoundsAreas_r( file->BoundsNodeNum( obstacle->bounds ), obstacle->bounds, obstacle->areas );
 	SetObstacleState( obstacle, true );
 
 	obstacleList.Append( obstacle );
@@ -830,6 +1117,9 @@ idAASLocal::GetAreaRoutingCache
 idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const {
 	int clusterAreaNum;
 	idRoutingCache *cache, *clusterCache;
+	uint64 startTime;
+
+	UpdateCacheStatsFrame();
 
 	// number of the area in the cluster
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
@@ -855,7 +1145,20 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 			clusterCache->prev = cache;
 		}
 		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
+		startTime = Sys_Microseconds();
+		UpdateAreaRoutingCache( cache );
+		frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+		frameCacheStats.numBuilt++;
+	}
+	else if ( cache->dirty ) {
+		// repair the travel times in place
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		cache->dirty = false;
+		startTime = Sys_Microseconds();
 		UpdateAreaRoutingCache( cache );
+		frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+		frameCacheStats.numRepaired++;
 	}
 	LinkCache( cache );
 	return cache;
@@ -960,6 +1263,9 @@ idAASLocal::GetPortalRoutingCache
 */
 idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const {
 	idRoutingCache *cache;
+	uint64 startTime;
+
+	UpdateCacheStatsFrame();
 
 	// check if cache without undesired travel flags already exists
 	for ( cache = portalCacheIndex[areaNum]; cache; cache = cache->next ) {
@@ -981,12 +1287,233 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 			portalCacheIndex[areaNum]->prev = cache;
 		}
 		portalCacheIndex[areaNum] = cache;
+		startTime = Sys_Microseconds();
 		UpdatePortalRoutingCache( cache );
+		frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+		frameCacheStats.numBuilt++;
+	}
+	else if ( cache->dirty ) {
+		// repair the travel times in place
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		cache->dirty = false;
+		startTime = Sys_Microseconds();
+		UpdatePortalRoutingCache( cache );
+		frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+		frameCacheStats.numRepaired++;
 	}
 	LinkCache( cache );
 	return cache;
 }
 
+/*
+============
+idAASLocal::UpdateFlowField
+
+  Floods the reversed reachabilities from the goal area over the whole map, storing for
+  every area the travel time to the goal and the reachability to take towards it.
+============
+*/
+void idAASLocal::UpdateFlowField( idRoutingFlowField *flowField ) const {
+	int i, nextAreaNum, badTravelFlags;
+	unsigned short t, startAreaTravelTimes[MAX_REACH_PER_AREA];
+	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
+	idReachability *reach;
+	const aasArea_t *nextArea;
+
+	memset( flowField->reachabilities, 0, flowField->size * sizeof( flowField->reachabilities[0] ) );
+	memset( flowField->travelTimes, 0, flowField->size * sizeof( flowField->travelTimes[0] ) );
+
+	flowField->travelTimes[flowField->goalAreaNum] = 1;
+	badTravelFlags = ~flowField->travelFlags;
+	memset( startAreaTravelTimes, 0, sizeof( startAreaTravelTimes ) );
+
+	// initialize first update
+	curUpdate = &areaUpdate[flowField->goalAreaNum];
+	curUpdate->areaNum = flowField->goalAreaNum;
+	curUpdate->areaTravelTimes = startAreaTravelTimes;
+	curUpdate->tmpTravelTime = 1;
+	curUpdate->next = NULL;
+	curUpdate->prev = NULL;
+	updateListStart = curUpdate;
+	updateListEnd = curUpdate;
+
+	// while there are updates in the list
+	while( updateListStart ) {
+
+		curUpdate = updateListStart;
+		if ( curUpdate->next ) {
+			curUpdate->next->prev = NULL;
+		}
+		else {
+			updateListEnd = NULL;
+		}
+		updateListStart = curUpdate->next;
+
+		curUpdate->isInList = false;
+
+		for ( i = 0, reach = file->GetArea( curUpdate->areaNum ).rev_reach; reach; reach = reach->rev_next, i++ ) {
+
+			// if the reachability uses an undesired travel type
+			if ( reach->travelType & badTravelFlags ) {
+				continue;
+			}
+
+			// next area the reversed reachability leads to
+			nextAreaNum = reach->fromAreaNum;
+			nextArea = &file->GetArea( nextAreaNum );
+
+			// if traveling through the next area requires an undesired travel flag
+			if ( nextArea->travelFlags & badTravelFlags ) {
+				continue;
+			}
+
+			// time already travelled plus the traveltime through the current area
+			// plus the travel time of the reachability towards the next area
+			t = curUpdate->tmpTravelTime + curUpdate->areaTravelTimes[i] + reach->travelTime;
+
+			if ( !flowField->travelTimes[nextAreaNum] || t < flowField->travelTimes[nextAreaNum] ) {
+
+				flowField->travelTimes[nextAreaNum] = t;
+				flowField->reachabilities[nextAreaNum] = reach->number; // reversed reachability used to get into this area
+				nextUpdate = &areaUpdate[nextAreaNum];
+				nextUpdate->areaNum = nextAreaNum;
+				nextUpdate->tmpTravelTime = t;
+				nextUpdate->areaTravelTimes = reach->areaTravelTimes;
+
+				// if we are not allowed to fly
+				if ( badTravelFlags & TFL_FLY ) {
+					// avoid areas near ledges
+					if ( nextArea->flags & AREA_LEDGE ) {
+						nextUpdate->tmpTravelTime += LEDGE_TRAVELTIME_PANALTY;
+					}
+				}
+
+				if ( !nextUpdate->isInList ) {
+					nextUpdate->next = NULL;
+					nextUpdate->prev = updateListEnd;
+					if ( updateListEnd ) {
+						updateListEnd->next = nextUpdate;
+					}
+					else {
+						updateListStart = nextUpdate;
+					}
+					updateListEnd = nextUpdate;
+					nextUpdate->isInList = true;
+				}
+			}
+		}
+	}
+
+	// the goal area itself has no reachability towards the goal
+	flowField->travelTimes[flowField->goalAreaNum] = 1;
+	flowField->reachabilities[flowField->goalAreaNum] = 0;
+}
+
+/*
+============
+idAASLocal::GetFlowField
+
+  Returns the flow field towards the goal area. A flow field is only built once enough
+  routes towards the same goal are requested within a single frame, for instance when
+  a group of monsters chases the player. Flow fields stay valid until the routing
+  changes and the least recently used one is recycled when there are too many.
+============
+*/
+idRoutingFlowField *idAASLocal::GetFlowField( int goalAreaNum, int travelFlags ) const {
+	int i;
+	idRoutingFlowField *flowField;
+	flowFieldRequest_t *request;
+	uint64 startTime;
+
+	if ( !aas_flowFields.GetBool() ) {
+		return NULL;
+	}
+
+	UpdateCacheStatsFrame();
+
+	for ( i = 0; i < flowFields.Num(); i++ ) {
+		flowField = flowFields[i];
+		if ( flowField->goalAreaNum == goalAreaNum && flowField->travelFlags == travelFlags ) {
+			if ( flowField->dirty ) {
+				flowField->dirty = false;
+				startTime = Sys_Microseconds();
+				UpdateFlowField( flowField );
+				frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+				numFlowFieldBuilds++;
+				frameCacheStats.numRepaired++;
+			}
+			flowField->lastUsedFrame = gameLocal.framenum;
+			numFlowFieldSamples++;
+			return flowField;
+		}
+	}
+
+	// count the routes requested towards this goal in the current frame
+	if ( flowFieldRequestFrame != gameLocal.framenum ) {
+		flowFieldRequests.SetNum( 0, false );
+		flowFieldRequestFrame = gameLocal.framenum;
+	}
+
+	request = NULL;
+	for ( i = 0; i < flowFieldRequests.Num(); i++ ) {
+		if ( flowFieldRequests[i].goalAreaNum == goalAreaNum && flowFieldRequests[i].travelFlags == travelFlags ) {
+			request = &flowFieldRequests[i];
+			break;
+		}
+	}
+	if ( request == NULL ) {
+		if ( flowFieldRequests.Num() >= MAX_FLOW_FIELD_REQUESTS ) {
+			return NULL;
+		}
+		request = &flowFieldRequests.Alloc();
+		request->goalAreaNum = goalAreaNum;
+		request->travelFlags = travelFlags;
+		request->count = 0;
+	}
+
+	if ( ++request->count < aas_flowFieldRequests.GetInteger() ) {
+		return NULL;
+	}
+
+	// recycle the least recently used flow field if there are too many
+	if ( flowFields.Num() >= MAX_FLOW_FIELDS ) {
+		flowField = flowFields[0];
+		for ( i = 1; i < flowFields.Num(); i++ ) {
+			if ( flowFields[i]->lastUsedFrame < flowField->lastUsedFrame ) {
+				flowField = flowFields[i];
+			}
+		}
+	} else {
+		flowField = new (TAG_AAS) idRoutingFlowField( file->GetNumAreas() );
+		flowFields.Append( flowField );
+	}
+
+	flowField->goalAreaNum = goalAreaNum;
+	flowField->travelFlags = travelFlags;
+	flowField->lastUsedFrame = gameLocal.framenum;
+	flowField->dirty = false;
+	startTime = Sys_Microseconds();
+	UpdateFlowField( flowField );
+	frameCacheStats.updateTime += (int)( Sys_Microseconds() - startTime );
+	frameCacheStats.numBuilt++;
+
+	numFlowFieldBuilds++;
+	numFlowFieldSamples++;
+
+	return flowField;
+}
+
+/*
+============
+idAASLocal::DeleteFlowFields
+============
+*/
+void idAASLocal::DeleteFlowFields() {
+	flowFields.DeleteContents( true );
+	flowFieldRequests.SetNum( 0, false );
+}
+
 /*
 ============
 idAASLocal::RouteToGoalArea
@@ -1020,6 +1547,17 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		return false;
 	}
 
+	// read the route from the flow field if many routes lead towards the same goal
+	const idRoutingFlowField *flowField = GetFlowField( goalAreaNum, travelFlags );
+	if ( flowField ) {
+		if ( !flowField->travelTimes[areaNum] ) {
+			return false;
+		}
+		*reach = GetAreaReachability( areaNum, flowField->reachabilities[areaNum] );
+		travelTime = flowField->travelTimes[areaNum] + AreaTravelTime( areaNum, origin, (*reach)->start );
+		return true;
+	}
+
 	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
 		DeleteOldestCache();
 	}
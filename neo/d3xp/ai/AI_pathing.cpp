@@ -47,6 +47,10 @@ If you have questions concerning this license or the applicable additional terms
 	- the path tree is pruned and optimized
 	- the shortest path is chosen for navigation
 
+	All AI avoiding obstacles in the same frame share a snapshot with the projected
+	windings of the dynamic obstacles, so the clip model queries and the silhouette
+	projections are done only once per frame instead of once per AI.
+
 ===============================================================================
 */
 
@@ -90,6 +94,308 @@ void pathNode_s::Init() {
 
 idBlockAlloc<pathNode_t, 128>	pathNodeAllocator;
 
+typedef struct obstacleBounds_s {
+	float				minX[MAX_OBSTACLES];
+	float				minY[MAX_OBSTACLES];
+	float				maxX[MAX_OBSTACLES];
+	float				maxY[MAX_OBSTACLES];
+
+	void				Set( const int index, const idVec2 bounds[2] );
+} obstacleBounds_t;
+
+void obstacleBounds_s::Set( const int index, const idVec2 bounds[2] ) {
+	minX[index] = bounds[0].x;
+	minY[index] = bounds[0].y;
+	maxX[index] = bounds[1].x;
+	maxY[index] = bounds[1].y;
+}
+
+/*
+============
+CullBounds2D
+
+  Stores the indices of all the bounds that touch the given bounds.
+============
+*/
+int CullBounds2D( const float *minX, const float *minY, const float *maxX, const float *maxY, const int numBounds, const int skipIndex, const idVec2 bounds[2], int *indices ) {
+	int i, numIndices;
+
+	numIndices = 0;
+	i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vBoundsMinX = _mm_set1_ps( bounds[0].x );
+	const __m128 vBoundsMinY = _mm_set1_ps( bounds[0].y );
+	const __m128 vBoundsMaxX = _mm_set1_ps( bounds[1].x );
+	const __m128 vBoundsMaxY = _mm_set1_ps( bounds[1].y );
+
+	for ( ; i + 4 <= numBounds; i += 4 ) {
+		const __m128 vMinX = _mm_loadu_ps( minX + i );
+		const __m128 vMinY = _mm_loadu_ps( minY + i );
+		const __m128 vMaxX = _mm_loadu_ps( maxX + i );
+		const __m128 vMaxY = _mm_loadu_ps( maxY + i );
+
+		const __m128 vOutside0 = _mm_or_ps( _mm_cmpgt_ps( vBoundsMinX, vMaxX ), _mm_cmpgt_ps( vBoundsMinY, vMaxY ) );
+		const __m128 vOutside1 = _mm_or_ps( _mm_cmplt_ps( vBoundsMaxX, vMinX ), _mm_cmplt_ps( vBoundsMaxY, vMinY ) );
+		const int inside = _mm_movemask_ps( _mm_or_ps( vOutside0, vOutside1 ) ) ^ 15;
+
+		if ( inside == 0 ) {
+			continue;
+		}
+		for ( int j = 0; j < 4; j++ ) {
+			if ( ( inside & ( 1 << j ) ) != 0 && i + j != skipIndex ) {
+				indices[numIndices++] = i + j;
+			}
+		}
+	}
+
+#endif
+
+	for ( ; i < numBounds; i++ ) {
+		if ( i == skipIndex ) {
+			continue;
+		}
+		if ( bounds[0].x > maxX[i] || bounds[0].y > maxY[i] || bounds[1].x < minX[i] || bounds[1].y < minY[i] ) {
+			continue;
+		}
+		indices[numIndices++] = i;
+	}
+
+	return numIndices;
+}
+
+/*
+===============================================================================
+
+	idObstacleSnapshot
+
+===============================================================================
+*/
+
+typedef struct snapshotObstacle_s {
+	idEntityPtr<idEntity>	entity;				// entity the clip model belongs to
+	const idPhysics *	physics;				// physics of the entity
+	int					contents;				// contents of the clip model
+	bool				isActor;				// true if the entity is an actor
+	idVec3				velocity;				// linear velocity of the entity
+	idBounds			absBounds;				// absolute bounds of the clip model
+	idWinding2D			winding;				// projection of the obstacle onto the floor plane
+	idVec2				expandedFor[2];			// box the expanded winding was created for
+	idWinding2D			expandedWinding;		// projection expanded for collision with a 2D box
+	idVec2				expandedBounds[2];		// bounds of the expanded winding
+} snapshotObstacle_t;
+
+class idObstacleSnapshot {
+public:
+						idObstacleSnapshot();
+
+	void				Clear();
+						// Gets all obstacles touching the clip bounds which the AI cannot step over.
+	int					GetObstacles( const idPhysics *physics, const idEntity *ignore, const idBounds &clipBounds, const float stepHeight, const float headHeight,
+										const idVec2 expBounds[2], const float debugHeight, obstacle_t *obstacles, obstacleBounds_t &obstacleBounds, int maxObstacles );
+
+private:
+	int					frameNum;				// game frame the snapshot was created
+	int					time;					// game time the snapshot was created
+	idVec3				gravityNormal;			// gravity normal used to project the obstacles
+	idList<snapshotObstacle_t, TAG_AI>	snapshotObstacles;
+	idList<float, TAG_AI>	minX;				// bounds of the unexpanded obstacle windings
+	idList<float, TAG_AI>	minY;
+	idList<float, TAG_AI>	maxX;
+	idList<float, TAG_AI>	maxY;
+	idList<int, TAG_AI>	candidates;
+
+	void				Update( const idVec3 &gravityNormal );
+};
+
+idObstacleSnapshot	obstacleSnapshot;
+
+/*
+============
+idObstacleSnapshot::idObstacleSnapshot
+============
+*/
+idObstacleSnapshot::idObstacleSnapshot() {
+	frameNum = -1;
+	time = -1;
+	gravityNormal.Zero();
+}
+
+/*
+============
+idObstacleSnapshot::Clear
+============
+*/
+void idObstacleSnapshot::Clear() {
+	frameNum = -1;
+	time = -1;
+	snapshotObstacles.Clear();
+	minX.Clear();
+	minY.Clear();
+	maxX.Clear();
+	maxY.Clear();
+	candidates.Clear();
+}
+
+/*
+============
+idObstacleSnapshot::Update
+
+  Projects the trace models of all living actors and moveables onto the floor plane.
+============
+*/
+void idObstacleSnapshot::Update( const idVec3 &gravityNormal ) {
+	int i, numVerts;
+	idVec3 silVerts[32];
+	idVec2 bounds[2];
+	idBox box;
+
+	this->frameNum = gameLocal.framenum;
+	this->time = gameLocal.time;
+	this->gravityNormal = gravityNormal;
+
+	snapshotObstacles.SetNum( 0, false );
+	minX.SetNum( 0, false );
+	minY.SetNum( 0, false );
+	maxX.SetNum( 0, false );
+	maxY.SetNum( 0, false );
+
+	for ( idEntity *ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+
+		const bool isActor = ent->IsType( idActor::Type );
+		if ( !isActor && !ent->IsType( idMoveable::Type ) ) {
+			continue;
+		}
+		// dead bodies are no obstacles
+		if ( isActor && ent->health <= 0 ) {
+			continue;
+		}
+
+		const idPhysics *phys = ent->GetPhysics();
+		for ( i = 0; i < phys->GetNumClipModels(); i++ ) {
+			const idClipModel *clipModel = phys->GetClipModel( i );
+
+			if ( clipModel == NULL || !clipModel->IsTraceModel() || !clipModel->IsLinked() || !clipModel->IsEnabled() ) {
+				continue;
+			}
+
+			// project a box containing the obstacle onto the floor plane
+			box = idBox( clipModel->GetBounds(), clipModel->GetOrigin(), clipModel->GetAxis() );
+			numVerts = box.GetParallelProjectionSilhouetteVerts( gravityNormal, silVerts );
+
+			snapshotObstacle_t &obstacle = snapshotObstacles.Alloc();
+			obstacle.entity = ent;
+			obstacle.physics = phys;
+			obstacle.contents = clipModel->GetContents();
+			obstacle.isActor = isActor;
+			obstacle.velocity = phys->GetLinearVelocity();
+			obstacle.absBounds = clipModel->GetAbsBounds();
+			obstacle.winding.Clear();
+			for ( int j = 0; j < numVerts; j++ ) {
+				obstacle.winding.AddPoint( silVerts[j].ToVec2() );
+			}
+			obstacle.expandedFor[0].Zero();
+			obstacle.expandedFor[1].Zero();
+			obstacle.expandedWinding.Clear();
+
+			obstacle.winding.GetBounds( bounds );
+			minX.Append( bounds[0].x );
+			minY.Append( bounds[0].y );
+			maxX.Append( bounds[1].x );
+			maxY.Append( bounds[1].y );
+		}
+	}
+}
+
+/*
+============
+idObstacleSnapshot::GetObstacles
+============
+*/
+int idObstacleSnapshot::GetObstacles( const idPhysics *physics, const idEntity *ignore, const idBounds &clipBounds, const float stepHeight, const float headHeight,
+										const idVec2 expBounds[2], const float debugHeight, obstacle_t *obstacles, obstacleBounds_t &obstacleBounds, int maxObstacles ) {
+	int i, j, numCandidates, numObstacles, clipMask;
+	float min, max;
+	idVec2 clipBounds2D[2];
+	idVec3 start, end;
+
+	if ( frameNum != gameLocal.framenum || time != gameLocal.time || gravityNormal != physics->GetGravityNormal() ) {
+		Update( physics->GetGravityNormal() );
+	}
+
+	clipBounds2D[0] = clipBounds[0].ToVec2();
+	clipBounds2D[1] = clipBounds[1].ToVec2();
+	candidates.SetNum( snapshotObstacles.Num(), false );
+	numCandidates = CullBounds2D( minX.Ptr(), minY.Ptr(), maxX.Ptr(), maxY.Ptr(), snapshotObstacles.Num(), -1, clipBounds2D, candidates.Ptr() );
+
+	clipMask = physics->GetClipMask();
+	numObstacles = 0;
+
+	for ( i = 0; i < numCandidates && numObstacles < maxObstacles; i++ ) {
+		snapshotObstacle_t &snapshotObstacle = snapshotObstacles[candidates[i]];
+		idEntity *obEnt = snapshotObstacle.entity.GetEntity();
+
+		if ( obEnt == NULL || !( snapshotObstacle.contents & clipMask ) ) {
+			continue;
+		}
+
+		if ( snapshotObstacle.isActor ) {
+			// ignore myself and my enemy
+			if ( ( snapshotObstacle.physics == physics ) || ( obEnt == ignore ) ) {
+				continue;
+			}
+			// if the actor is moving
+			const idVec3 &v1 = snapshotObstacle.velocity;
+			if ( v1.LengthSqr() > Square( 10.0f ) ) {
+				idVec3 v2 = physics->GetLinearVelocity();
+				if ( v2.LengthSqr() > Square( 10.0f ) ) {
+					// if moving in about the same direction
+					if ( v1 * v2 > 0.0f ) {
+						continue;
+					}
+				}
+			}
+		}
+
+		// check if we can step over the object
+		snapshotObstacle.absBounds.AxisProjection( -gravityNormal, min, max );
+		if ( max < stepHeight || min > headHeight ) {
+			// can step over this one
+			continue;
+		}
+
+		// the expanded winding is shared by all AI with the same size
+		if ( snapshotObstacle.expandedWinding.GetNumPoints() == 0 || snapshotObstacle.expandedFor[0] != expBounds[0] || snapshotObstacle.expandedFor[1] != expBounds[1] ) {
+			snapshotObstacle.expandedWinding = snapshotObstacle.winding;
+			snapshotObstacle.expandedWinding.ExpandForAxialBox( expBounds );
+			snapshotObstacle.expandedWinding.GetBounds( snapshotObstacle.expandedBounds );
+			snapshotObstacle.expandedFor[0] = expBounds[0];
+			snapshotObstacle.expandedFor[1] = expBounds[1];
+		}
+
+		if ( ai_showObstacleAvoidance.GetBool() ) {
+			const idWinding2D &w = snapshotObstacle.winding;
+			start.z = end.z = debugHeight;
+			for ( j = 0; j < w.GetNumPoints(); j++ ) {
+				start.ToVec2() = w[j];
+				end.ToVec2() = w[(j+1)%w.GetNumPoints()];
+				gameRenderWorld->DebugArrow( colorWhite, start, end, 4 );
+			}
+		}
+
+		obstacle_t &obstacle = obstacles[numObstacles];
+		obstacle.winding = snapshotObstacle.expandedWinding;
+		obstacle.bounds[0] = snapshotObstacle.expandedBounds[0];
+		obstacle.bounds[1] = snapshotObstacle.expandedBounds[1];
+		obstacle.entity = obEnt;
+		obstacleBounds.Set( numObstacles, obstacle.bounds );
+		numObstacles++;
+	}
+
+	return numObstacles;
+}
+
 
 /*
 ============
@@ -271,8 +577,9 @@ void GetPointOutsideObstacles( const obstacle_t *obstacles, const int numObstacl
 GetFirstBlockingObstacle
 ============
 */
-bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, int skipObstacle, const idVec2 &startPos, const idVec2 &delta, float &blockingScale, int &blockingObstacle, int &blockingEdgeNum ) {
-	int i, edgeNums[2];
+bool GetFirstBlockingObstacle( const obstacle_t *obstacles, const obstacleBounds_t &obstacleBounds, int numObstacles, int skipObstacle, const idVec2 &startPos, const idVec2 &delta, float &blockingScale, int &blockingObstacle, int &blockingEdgeNum ) {
+	int i, j, numCandidates, edgeNums[2];
+	int candidates[MAX_OBSTACLES];
 	float dist, scale1, scale2;
 	idVec2 bounds[2];
 
@@ -285,14 +592,9 @@ bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, in
 	// test for obstacles blocking the path
 	blockingScale = idMath::INFINITY;
 	dist = delta.Length();
-	for ( i = 0; i < numObstacles; i++ ) {
-		if ( i == skipObstacle ) {
-			continue;
-		}
-		if ( bounds[0].x > obstacles[i].bounds[1].x || bounds[0].y > obstacles[i].bounds[1].y ||
-				bounds[1].x < obstacles[i].bounds[0].x || bounds[1].y < obstacles[i].bounds[0].y ) {
-			continue;
-		}
+	numCandidates = CullBounds2D( obstacleBounds.minX, obstacleBounds.minY, obstacleBounds.maxX, obstacleBounds.maxY, numObstacles, skipObstacle, bounds, candidates );
+	for ( j = 0; j < numCandidates; j++ ) {
+		i = candidates[j];
 		if ( obstacles[i].winding.RayIntersection( startPos, delta, scale1, scale2, edgeNums ) ) {
 			if ( scale1 < blockingScale && scale1 * dist > -0.01f && scale2 * dist > 0.01f ) {
 				blockingScale = scale1;
@@ -309,7 +611,7 @@ bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, in
 GetObstacles
 ============
 */
-int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum, const idVec3 &startPos, const idVec3 &seekPos, obstacle_t *obstacles, int maxObstacles, idBounds &clipBounds ) {
+int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum, const idVec3 &startPos, const idVec3 &seekPos, obstacle_t *obstacles, obstacleBounds_t &obstacleBounds, int maxObstacles, idBounds &clipBounds ) {
 	int i, j, numListedClipModels, numObstacles, numVerts, clipMask, blockingObstacle, blockingEdgeNum;
 	int wallEdges[MAX_AAS_WALL_EDGES], numWallEdges, verts[2], lastVerts[2], nextVerts[2];
 	float stepHeight, headHeight, blockingScale, min, max;
@@ -337,8 +639,14 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	clipBounds.ExpandSelf( MAX_OBSTACLE_RADIUS );
 	clipMask = physics->GetClipMask();
 
-	// find all obstacles touching the clip bounds
-	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	if ( ai_obstacleSnapshot.GetBool() ) {
+		// get the obstacles from the snapshot shared by all AI this frame
+		numObstacles = obstacleSnapshot.GetObstacles( physics, ignore, clipBounds, stepHeight, headHeight, expBounds, startPos.z, obstacles, obstacleBounds, MAX_OBSTACLES );
+		numListedClipModels = 0;
+	} else {
+		// find all obstacles touching the clip bounds
+		numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	}
 
 	for ( i = 0; i < numListedClipModels && numObstacles < MAX_OBSTACLES; i++ ) {
 		clipModel = clipModelList[i];
@@ -403,6 +711,7 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 		obstacle.winding.ExpandForAxialBox( expBounds );
 		obstacle.winding.GetBounds( obstacle.bounds );
 		obstacle.entity = obEnt;
+		obstacleBounds.Set( numObstacles - 1, obstacle.bounds );
 	}
 
 	// if there are no dynamic obstacles the path should be through valid AAS space
@@ -412,7 +721,7 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 
 	// if the current path doesn't intersect any dynamic obstacles the path should be through valid AAS space
 	if ( PointInsideObstacle( obstacles, numObstacles, startPos.ToVec2() ) == -1 ) {
-		if ( !GetFirstBlockingObstacle( obstacles, numObstacles, -1, startPos.ToVec2(), seekDelta.ToVec2(), blockingScale, blockingObstacle, blockingEdgeNum ) ) {
+		if ( !GetFirstBlockingObstacle( obstacles, obstacleBounds, numObstacles, -1, startPos.ToVec2(), seekDelta.ToVec2(), blockingScale, blockingObstacle, blockingEdgeNum ) ) {
 			return 0;
 		}
 	}
@@ -461,6 +770,7 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 			}
 			obstacle.winding.GetBounds( obstacle.bounds );
 			obstacle.entity = NULL;
+			obstacleBounds.Set( numObstacles - 1, obstacle.bounds );
 
 			memcpy( lastVerts, verts, sizeof( lastVerts ) );
 			lastEdgeNormal = edgeNormal;
@@ -592,7 +902,7 @@ bool GetPathNodeDelta( pathNode_t *node, const obstacle_t *obstacles, const idVe
 BuildPathTree
 ============
 */
-pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const idBounds &clipBounds, const idVec2 &startPos, const idVec2 &seekPos, obstaclePath_t &path ) {
+pathNode_t *BuildPathTree( const obstacle_t *obstacles, const obstacleBounds_t &obstacleBounds, int numObstacles, const idBounds &clipBounds, const idVec2 &startPos, const idVec2 &seekPos, obstaclePath_t &path ) {
 	int blockingEdgeNum, blockingObstacle, obstaclePoints, bestNumNodes = MAX_OBSTACLE_PATH;
 	float blockingScale;
 	pathNode_t *root, *node, *child;
@@ -624,7 +934,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 		}
 
 		// if an obstacle is blocking the path
-		if ( GetFirstBlockingObstacle( obstacles, numObstacles, node->obstacle, node->pos, node->delta, blockingScale, blockingObstacle, blockingEdgeNum ) ) {
+		if ( GetFirstBlockingObstacle( obstacles, obstacleBounds, numObstacles, node->obstacle, node->pos, node->delta, blockingScale, blockingObstacle, blockingEdgeNum ) ) {
 
 			if ( path.firstObstacle == NULL ) {
 				path.firstObstacle = obstacles[blockingObstacle].entity;
@@ -749,8 +1059,9 @@ void PrunePathTree( pathNode_t *root, const idVec2 &seekPos ) {
 OptimizePath
 ============
 */
-int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obstacle_t *obstacles, int numObstacles, idVec2 optimizedPath[MAX_OBSTACLE_PATH] ) {
-	int i, numPathPoints, edgeNums[2];
+int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obstacle_t *obstacles, const obstacleBounds_t &obstacleBounds, int numObstacles, idVec2 optimizedPath[MAX_OBSTACLE_PATH] ) {
+	int i, j, numPathPoints, numCandidates, edgeNums[2];
+	int candidates[MAX_OBSTACLES];
 	const pathNode_t *curNode, *nextNode;
 	idVec2 curPos, curDelta, bounds[2];
 	float scale1, scale2, curLength;
@@ -778,11 +1089,9 @@ int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obst
 			bounds[IEEE_FLT_SIGNBITNOTSET(curDelta.y)].y += curDelta.y;
 
 			// test if the shortcut intersects with any obstacles
-			for ( i = 0; i < numObstacles; i++ ) {
-				if ( bounds[0].x > obstacles[i].bounds[1].x || bounds[0].y > obstacles[i].bounds[1].y ||
-						bounds[1].x < obstacles[i].bounds[0].x || bounds[1].y < obstacles[i].bounds[0].y ) {
-					continue;
-				}
+			numCandidates = CullBounds2D( obstacleBounds.minX, obstacleBounds.minY, obstacleBounds.maxX, obstacleBounds.maxY, numObstacles, -1, bounds, candidates );
+			for ( j = 0; j < numCandidates; j++ ) {
+				i = candidates[j];
 				if ( obstacles[i].winding.RayIntersection( curPos, curDelta, scale1, scale2, edgeNums ) ) {
 					if ( scale1 >= 0.0f && scale1 <= 1.0f && ( i != nextNode->obstacle || scale1 * curLength < curLength - 0.5f ) ) {
 						break;
@@ -792,7 +1101,7 @@ int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obst
 					}
 				}
 			}
-			if ( i >= numObstacles ) {
+			if ( j >= numCandidates ) {
 				break;
 			}
 		}
@@ -833,7 +1142,7 @@ FindOptimalPath
   Returns true if there is a path all the way to the goal.
 ============
 */
-bool FindOptimalPath( const pathNode_t *root, const obstacle_t *obstacles, int numObstacles, const float height, const idVec3 &curDir, idVec3 &seekPos ) {
+bool FindOptimalPath( const pathNode_t *root, const obstacle_t *obstacles, const obstacleBounds_t &obstacleBounds, int numObstacles, const float height, const idVec3 &curDir, idVec3 &seekPos ) {
 	int i, numPathPoints, bestNumPathPoints;
 	const pathNode_t *node, *lastNode, *bestNode;
 	idVec2 optimizedPath[MAX_OBSTACLE_PATH];
@@ -860,12 +1169,12 @@ bool FindOptimalPath( const pathNode_t *root, const obstacle_t *obstacles, int n
 			if ( idMath::Fabs( node->dist - bestNode->dist ) < 0.1f ) {
 
 				if ( !optimizedPathCalculated ) {
-					bestNumPathPoints = OptimizePath( root, bestNode, obstacles, numObstacles, optimizedPath );
+					bestNumPathPoints = OptimizePath( root, bestNode, obstacles, obstacleBounds, numObstacles, optimizedPath );
 					bestPathLength = PathLength( optimizedPath, bestNumPathPoints, curDir.ToVec2() );
 					seekPos.ToVec2() = optimizedPath[1];
 				}
 
-				numPathPoints = OptimizePath( root, node, obstacles, numObstacles, optimizedPath );
+				numPathPoints = OptimizePath( root, node, obstacles, obstacleBounds, numObstacles, optimizedPath );
 				pathLength = PathLength( optimizedPath, numPathPoints, curDir.ToVec2() );
 
 				if ( pathLength < bestPathLength ) {
@@ -905,14 +1214,14 @@ bool FindOptimalPath( const pathNode_t *root, const obstacle_t *obstacles, int n
 				seekPos.ToVec2() = root->pos;
 			}
 		} else if ( !optimizedPathCalculated ) {
-			OptimizePath( root, bestNode, obstacles, numObstacles, optimizedPath );
+			OptimizePath( root, bestNode, obstacles, obstacleBounds, numObstacles, optimizedPath );
 			seekPos.ToVec2() = optimizedPath[1];
 		}
 
 		if ( ai_showObstacleAvoidance.GetBool() ) {
 			idVec3 start, end;
 			start.z = end.z = height + 4.0f;
-			numPathPoints = OptimizePath( root, bestNode, obstacles, numObstacles, optimizedPath );
+			numPathPoints = OptimizePath( root, bestNode, obstacles, obstacleBounds, numObstacles, optimizedPath );
 			for ( i = 0; i < numPathPoints-1; i++ ) {
 				start.ToVec2() = optimizedPath[i];
 				end.ToVec2() = optimizedPath[i+1];
@@ -934,6 +1243,7 @@ idAI::FindPathAroundObstacles
 bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, const idVec3 &startPos, const idVec3 &seekPos, obstaclePath_t &path ) {
 	int numObstacles, areaNum, insideObstacle;
 	obstacle_t obstacles[MAX_OBSTACLES];
+	obstacleBounds_t obstacleBounds;
 	idBounds clipBounds;
 	idBounds bounds;
 	pathNode_t *root;
@@ -959,7 +1269,7 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	aas->PushPointIntoAreaNum( areaNum, path.startPosOutsideObstacles );
 
 	// get all the nearby obstacles
-	numObstacles = GetObstacles( physics, aas, ignore, areaNum, path.startPosOutsideObstacles, path.seekPosOutsideObstacles, obstacles, MAX_OBSTACLES, clipBounds );
+	numObstacles = GetObstacles( physics, aas, ignore, areaNum, path.startPosOutsideObstacles, path.seekPosOutsideObstacles, obstacles, obstacleBounds, MAX_OBSTACLES, clipBounds );
 
 	// get a source position outside the obstacles
 	GetPointOutsideObstacles( obstacles, numObstacles, path.startPosOutsideObstacles.ToVec2(), &insideObstacle, NULL );
@@ -981,7 +1291,7 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	}
 
 	// build a path tree
-	root = BuildPathTree( obstacles, numObstacles, clipBounds, path.startPosOutsideObstacles.ToVec2(), path.seekPosOutsideObstacles.ToVec2(), path );
+	root = BuildPathTree( obstacles, obstacleBounds, numObstacles, clipBounds, path.startPosOutsideObstacles.ToVec2(), path.seekPosOutsideObstacles.ToVec2(), path );
 
 	// draw the path tree
 	if ( ai_showObstacleAvoidance.GetBool() ) {
@@ -992,7 +1302,7 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	PrunePathTree( root, path.seekPosOutsideObstacles.ToVec2() );
 
 	// find the optimal path
-	pathToGoalExists = FindOptimalPath( root, obstacles, numObstacles, physics->GetOrigin().z, physics->GetLinearVelocity(), path.seekPos );
+	pathToGoalExists = FindOptimalPath( root, obstacles, obstacleBounds, numObstacles, physics->GetOrigin().z, physics->GetLinearVelocity(), path.seekPos );
 
 	// free the tree
 	FreePathTree_r( root );
@@ -1007,6 +1317,7 @@ idAI::FreeObstacleAvoidanceNodes
 */
 void idAI::FreeObstacleAvoidanceNodes() {
 	pathNodeAllocator.Shutdown();
+	obstacleSnapshot.Clear();
 }
 
 
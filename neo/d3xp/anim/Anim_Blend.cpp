@@ -2649,6 +2649,9 @@ bool idDeclModelDef::Parse( const char *text, const int textLength, bool allowBi
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	numDefaultAnims = 0;
@@ -34,6 +34,46 @@ If you have questions concerning this license or the applicable additional terms
 
 #include <typeinfo>
 
+// delta autosaves are serialized into one memory block so object blocks can be compared
+// against the base, every other save streams straight into the pipeline file
+static const int SAVEGAME_BUFFER_SIZE			= 4 * 1024 * 1024;
+static const int SAVEGAME_BUFFER_GRANULARITY	= 1024 * 1024;
+static const int SAVEGAME_READ_CHUNK_SIZE		= 256 * 1024;
+
+static const int SAVEGAME_DELTA_ID				= ( 'D' << 24 ) | ( 'L' << 16 ) | ( 'T' << 8 ) | 2;
+
+idSaveGameDeltaBase saveGameDeltaBase;
+
+/*
+================
+idSaveGameDeltaBase::Clear
+================
+*/
+void idSaveGameDeltaBase::Clear() {
+	mapName.Clear();
+	checksum = 0;
+	written = false;
+	data.Clear();
+	blocks.Clear();
+	blockHash.Free();
+	strings.Clear();
+}
+
+/*
+================
+idSaveGameDeltaBase::FindBlock
+================
+*/
+int idSaveGameDeltaBase::FindBlock( const byte * blockData, int length, unsigned int crc ) const {
+	for ( int i = blockHash.First( crc ); i != -1; i = blockHash.Next( i ) ) {
+		const block_t & block = blocks[i];
+		if ( block.crc == crc && block.length == length && memcmp( data.Ptr() + block.offset, blockData, length ) == 0 ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 /*
 Save game related helper classes.
 
@@ -66,19 +106,42 @@ file be unloadable in some way (for example, due to script changes).
 idSaveGame::idSaveGame()
 ================
 */
-idSaveGame::idSaveGame( idFile *savefile, idFile *stringTableFile, int saveVersion ) {
-	//compressor = idCompressor::AllocLZW();
-	//compressor->Init( savefile, true, 8 );
-	//file = compressor;
-	file = savefile;
+idSaveGame::idSaveGame( idFile *savefile, idFile *stringTableFile, int saveVersion, bool delta ) {
+	saveFile = savefile;
 	stringFile = stringTableFile;
 	version = saveVersion;
+	wroteDelta = false;
+
+	// object blocks can only be compared against the base when they are serialized in memory,
+	// g_flushSave wants every write to hit the file immediately
+	deltaSave = delta && g_autoSaveDelta.GetBool() && !g_flushSave.GetBool();
+	if ( deltaSave ) {
+		buffer = new (TAG_SAVEGAMES) idFile_Memory( savefile->GetName() );
+		buffer->SetGranularity( SAVEGAME_BUFFER_GRANULARITY );
+		buffer->PreAllocate( SAVEGAME_BUFFER_SIZE );
+		file = buffer;
+	} else {
+		buffer = NULL;
+		file = savefile;
+	}
 
 	// Put NULL at the start of the list so we can skip over it.
 	objects.Clear();
 	objects.Append( NULL );
 
 	curStringTableOffset = 0;
+
+	if ( delta && !deltaSave ) {
+		// this full autosave replaces the one the base was taken from
+		saveGameDeltaBase.Clear();
+	}
+	if ( deltaSave && saveGameDeltaBase.IsValidForMap( gameLocal.GetMapName() ) ) {
+		// start with the string table of the base so unchanged blocks reference the same offsets
+		for ( int i = 0; i < saveGameDeltaBase.strings.Num(); i++ ) {
+			const char * string = saveGameDeltaBase.strings[i].c_str();
+			AddString( string, stringHash.GenerateKey( string ) );
+		}
+	}
 }
 
 /*
@@ -87,12 +150,11 @@ idSaveGame::~idSaveGame()
 ================
 */
 idSaveGame::~idSaveGame() {
-	//compressor->FinishCompress();
-	//delete compressor;
-
 	if ( objects.Num() ) {
 		Close();
 	}
+
+	delete buffer;
 }
 
 /*
@@ -106,8 +168,20 @@ void idSaveGame::Close() {
 	// read trace models
 	idClipModel::SaveTraceModels( this );
 
+	idSaveGameDeltaBase::blockList_t objectBlocks;
+	if ( deltaSave ) {
+		objectBlocks.SetNum( objects.Num() - 1 );
+	}
+
 	for( int i = 1; i < objects.Num(); i++ ) {
+		const int offset = file->Length();
 		CallSave_r( objects[ i ]->GetType(), objects[ i ] );
+		if ( deltaSave ) {
+			idSaveGameDeltaBase::block_t & block = objectBlocks[ i - 1 ];
+			block.offset = offset;
+			block.length = file->Length() - offset;
+			block.crc = MD5_BlockChecksum( buffer->GetDataPtr() + offset, block.length );
+		}
 	}
 
 	objects.Clear();
@@ -117,9 +191,26 @@ void idSaveGame::Close() {
 		stringFile->WriteString( stringTable[i].string );
 	}
 
+	if ( deltaSave ) {
+		wroteDelta = WriteDelta( objectBlocks );
+		if ( !wroteDelta ) {
+			SetDeltaBase( objectBlocks );
+		}
+	}
+
 	stringHash.Free();
 	stringTable.Clear();
 
+	// a full autosave still has to reach the pipeline file
+	if ( buffer != NULL ) {
+		if ( !wroteDelta ) {
+			saveFile->Write( buffer->GetDataPtr(), buffer->Length() );
+		}
+		delete buffer;
+		buffer = NULL;
+		file = saveFile;
+	}
+
 	if ( file->Length() > MIN_SAVEGAME_SIZE_BYTES || stringFile->Length() > MAX_SAVEGAME_STRING_TABLE_SIZE ) {
 		idLib::FatalError( "OVERFLOWED SAVE GAME FILE BUFFER" );
 	}
@@ -131,6 +222,87 @@ void idSaveGame::Close() {
 #endif
 }
 
+/*
+================
+idSaveGame::WriteDelta
+
+Writes the object blocks that aren't in the delta base, returns false when a full save should be written instead.
+================
+*/
+bool idSaveGame::WriteDelta( const idSaveGameDeltaBase::blockList_t & objectBlocks ) {
+	const idSaveGameDeltaBase & base = saveGameDeltaBase;
+	if ( !base.IsValidForMap( gameLocal.GetMapName() ) ) {
+		return false;
+	}
+
+	const byte * data = (const byte *)buffer->GetDataPtr();
+	const int prefixLength = ( objectBlocks.Num() > 0 ) ? objectBlocks[0].offset : buffer->Length();
+
+	idTempArray< int > baseBlocks( objectBlocks.Num() );
+	int deltaSize = prefixLength;
+	int numChanged = 0;
+	for ( int i = 0; i < objectBlocks.Num(); i++ ) {
+		const idSaveGameDeltaBase::block_t & block = objectBlocks[i];
+		baseBlocks[i] = base.FindBlock( data + block.offset, block.length, block.crc );
+		if ( baseBlocks[i] == -1 ) {
+			deltaSize += block.length;
+			numChanged++;
+		}
+	}
+
+	if ( deltaSize > buffer->Length() * g_autoSaveDeltaMaxRatio.GetFloat() ) {
+		return false;
+	}
+
+	// unchanged blocks are referenced by their position in the base, so restoring doesn't need the block list
+	saveFile->WriteBig( SAVEGAME_DELTA_ID );
+	saveFile->WriteBig( base.checksum );
+	saveFile->WriteBig( base.data.Num() );
+	saveFile->WriteBig( prefixLength );
+	saveFile->Write( data, prefixLength );
+	saveFile->WriteBig( objectBlocks.Num() );
+	for ( int i = 0; i < objectBlocks.Num(); i++ ) {
+		const bool changed = ( baseBlocks[i] == -1 );
+		saveFile->WriteBig( changed ? -1 : base.blocks[baseBlocks[i]].offset );
+		saveFile->WriteBig( objectBlocks[i].length );
+		if ( changed ) {
+			saveFile->Write( data + objectBlocks[i].offset, objectBlocks[i].length );
+		}
+	}
+
+	idLib::Printf( "Delta autosave: %d of %d objects changed, %d kB of %d kB\n", numChanged, objectBlocks.Num(), deltaSize >> 10, buffer->Length() >> 10 );
+	return true;
+}
+
+/*
+================
+idSaveGame::SetDeltaBase
+
+Keeps this full save as the base for the following delta autosaves,
+it is only used once the game knows the save was stored.
+================
+*/
+void idSaveGame::SetDeltaBase( const idSaveGameDeltaBase::blockList_t & objectBlocks ) {
+	idSaveGameDeltaBase & base = saveGameDeltaBase;
+	base.Clear();
+
+	base.mapName = gameLocal.GetMapName();
+	base.data.SetNum( buffer->Length() );
+	memcpy( base.data.Ptr(), buffer->GetDataPtr(), buffer->Length() );
+	base.checksum = MD5_BlockChecksum( base.data.Ptr(), base.data.Num() );
+
+	base.blocks = objectBlocks;
+	base.blockHash.Clear( 4096, Max( objectBlocks.Num(), 1 ) );
+	for ( int i = 0; i < objectBlocks.Num(); i++ ) {
+		base.blockHash.Add( objectBlocks[i].crc, i );
+	}
+
+	base.strings.SetNum( stringTable.Num() );
+	for ( int i = 0; i < stringTable.Num(); i++ ) {
+		base.strings[i] = stringTable[i].string;
+	}
+}
+
 /*
 ================
 idSaveGame::WriteDecls
@@ -293,13 +465,22 @@ void idSaveGame::WriteString( const char *string ) {
 		}
 	}
 
+	WriteInt( curStringTableOffset );
+	AddString( string, hash );
+}
+
+/*
+================
+idSaveGame::AddString
+================
+*/
+void idSaveGame::AddString( const char * string, int hash ) {
 	// Add the string to our hash, generate the index, and update our current table offset
 	stringTableIndex_s & tableIndex = stringTable.Alloc();
 	tableIndex.offset = curStringTableOffset;
 	tableIndex.string = string;
 	stringHash.Add( hash, stringTable.Num() - 1 );
 
-	WriteInt( curStringTableOffset );
 	curStringTableOffset += ( static_cast<int>(strlen( string )) + 4 );
 }
 
@@ -834,10 +1015,101 @@ void idSaveGame::WriteBuildNumber( const int value ) {
 idRestoreGame::RestoreGame
 ================
 */
-idRestoreGame::idRestoreGame( idFile * savefile, idFile * stringTableFile, int saveVersion ) {
+idRestoreGame::idRestoreGame( idFile * savefile, idFile * stringTableFile, int saveVersion, idFile * deltaFile ) {
 	file = savefile;
 	stringFile = stringTableFile;
 	version = saveVersion;
+	buffer = NULL;
+	valid = true;
+
+	// a delta autosave is consolidated with the full autosave it was made against,
+	// every other save is restored straight out of the decompressing pipeline file
+	if ( deltaFile != NULL ) {
+		valid = ConsolidateDelta( deltaFile );
+	}
+}
+
+/*
+================
+idRestoreGame::ConsolidateDelta
+
+Rebuilds the full save game stream from a delta autosave and the full save it was made against.
+================
+*/
+bool idRestoreGame::ConsolidateDelta( idFile * deltaFile ) {
+	buffer = new (TAG_SAVEGAMES) idFile_Memory( file->GetName() );
+	buffer->SetGranularity( SAVEGAME_BUFFER_GRANULARITY );
+	buffer->PreAllocate( SAVEGAME_BUFFER_SIZE );
+
+	idTempArray< byte > chunk( SAVEGAME_READ_CHUNK_SIZE );
+	while ( true ) {
+		const int numBytes = file->Read( chunk.Ptr(), SAVEGAME_READ_CHUNK_SIZE );
+		if ( numBytes > 0 ) {
+			buffer->Write( chunk.Ptr(), numBytes );
+		}
+		if ( numBytes < SAVEGAME_READ_CHUNK_SIZE ) {
+			break;
+		}
+	}
+	buffer->MakeReadOnly();
+
+	int id = 0;
+	unsigned int checksum = 0;
+	int baseLength = 0;
+	deltaFile->ReadBig( id );
+	deltaFile->ReadBig( checksum );
+	deltaFile->ReadBig( baseLength );
+	if ( id != SAVEGAME_DELTA_ID || baseLength != buffer->Length() || MD5_BlockChecksum( buffer->GetDataPtr(), buffer->Length() ) != checksum ) {
+		gameLocal.Warning( "idRestoreGame::ConsolidateDelta: %s wasn't made against %s", deltaFile->GetName(), buffer->GetName() );
+		return false;
+	}
+
+	const byte * base = (const byte *)buffer->GetDataPtr();
+	idFile_Memory * full = new (TAG_SAVEGAMES) idFile_Memory( buffer->GetName() );
+	full->SetGranularity( SAVEGAME_BUFFER_GRANULARITY );
+	full->PreAllocate( baseLength );
+
+	idList< byte, TAG_SAVEGAMES > changed;
+	int prefixLength = -1;
+	deltaFile->ReadBig( prefixLength );
+	bool ok = ( prefixLength >= 0 );
+	if ( ok ) {
+		changed.SetNum( prefixLength );
+		ok = ( deltaFile->Read( changed.Ptr(), prefixLength ) == prefixLength );
+		full->Write( changed.Ptr(), prefixLength );
+	}
+
+	int numBlocks = 0;
+	deltaFile->ReadBig( numBlocks );
+	for ( int i = 0; ok && i < numBlocks; i++ ) {
+		int baseOffset = -1;
+		int length = -1;
+		deltaFile->ReadBig( baseOffset );
+		deltaFile->ReadBig( length );
+		if ( length < 0 ) {
+			ok = false;
+		} else if ( baseOffset == -1 ) {
+			changed.SetNum( length );
+			ok = ( deltaFile->Read( changed.Ptr(), length ) == length );
+			full->Write( changed.Ptr(), length );
+		} else if ( baseOffset >= 0 && baseOffset + length <= baseLength ) {
+			full->Write( base + baseOffset, length );
+		} else {
+			ok = false;
+		}
+	}
+
+	if ( !ok ) {
+		delete full;
+		gameLocal.Warning( "idRestoreGame::ConsolidateDelta: %s is truncated or corrupt", deltaFile->GetName() );
+		return false;
+	}
+	full->MakeReadOnly();
+
+	delete buffer;
+	buffer = full;
+	file = buffer;
+	return true;
 }
 
 /*
@@ -846,6 +1118,7 @@ idRestoreGame::~idRestoreGame()
 ================
 */
 idRestoreGame::~idRestoreGame() {
+	delete buffer;
 }
 
 /*
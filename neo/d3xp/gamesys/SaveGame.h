@@ -35,9 +35,47 @@ Save game related helper classes.
 
 */
 
+/*
+Delta autosaves.
+
+The first autosave on a map with g_autoSaveDelta set is a full save that is kept in memory as the base once
+it has been written. Later autosaves only store the object blocks that differ from the base and reference
+the others by their position in it. Common writes such a delta to its own file in the autosave container
+and leaves the full autosave in place, so the base is stored and deleted with the autosave. Restoring
+consolidates the blocks back into a full stream before any object is read, so deltas always chain
+directly to a full base.
+*/
+class idSaveGameDeltaBase {
+public:
+	struct block_t {
+		int					offset;
+		int					length;
+		unsigned int		crc;
+	};
+	typedef idList< block_t, TAG_SAVEGAMES > blockList_t;
+
+							idSaveGameDeltaBase() { Clear(); }
+
+	void					Clear();
+	bool					IsValid() const { return written && data.Num() > 0; }
+	bool					IsValidForMap( const char * map ) const { return IsValid() && mapName.Icmp( map ) == 0; }
+
+	int						FindBlock( const byte * blockData, int length, unsigned int crc ) const;
+
+	idStr					mapName;
+	unsigned int			checksum;
+	bool					written;			// the full autosave the base was taken from has been stored
+	idList< byte, TAG_SAVEGAMES >		data;
+	blockList_t				blocks;
+	idHashIndex				blockHash;
+	idStrList				strings;
+};
+
+extern idSaveGameDeltaBase	saveGameDeltaBase;
+
 class idSaveGame {
 public:
-							idSaveGame( idFile *savefile, idFile *stringFile, int inVersion );
+							idSaveGame( idFile *savefile, idFile *stringFile, int inVersion, bool delta = false );
 							~idSaveGame();
 
 	void					Close();
@@ -93,16 +131,23 @@ public:
 	int						GetBuildNumber() const { return version; }
 
 	int						GetCurrentSaveSize() const { return file->Length(); }
+	bool					WroteDelta() const { return wroteDelta; }
 
 private:
 	idFile *				file;
+	idFile *				saveFile;
 	idFile *				stringFile;
-	idCompressor *			compressor;
+	idFile_Memory *			buffer;
+	bool					deltaSave;
+	bool					wroteDelta;
 
 	idList<const idClass *>	objects;
 	int						version;
 
 	void					CallSave_r( const idTypeInfo *cls, const idClass *obj );
+	void					AddString( const char * string, int hash );
+	bool					WriteDelta( const idSaveGameDeltaBase::blockList_t & objectBlocks );
+	void					SetDeltaBase( const idSaveGameDeltaBase::blockList_t & objectBlocks );
 
 	struct stringTableIndex_s {
 		idStr		string;
@@ -117,9 +162,12 @@ private:
 
 class idRestoreGame {
 public:
-							idRestoreGame( idFile * savefile, idFile * stringTableFile, int saveVersion );
+							idRestoreGame( idFile * savefile, idFile * stringTableFile, int saveVersion, idFile * deltaFile = NULL );
 							~idRestoreGame();
 
+	//						False if a delta autosave couldn't be consolidated with its base
+	bool					IsValid() const { return valid; }
+
 	void					ReadDecls();
 
 	void					CreateObjects();
@@ -174,11 +222,14 @@ public:
 private:
 	idFile *		file;
 	idFile *		stringFile;
+	idFile_Memory *	buffer;
+	bool			valid;
 	idList<idClass *, TAG_SAVEGAMES>		objects;
 	int						version;
 	int						stringTableOffset;
 
 	void					CallRestore_r( const idTypeInfo *cls, idClass *obj );
+	bool					ConsolidateDelta( idFile * deltaFile );
 };
 
 #endif /* !__SAVEGAME_H__*/
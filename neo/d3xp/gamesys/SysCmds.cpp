@@ -113,6 +113,29 @@ void Cmd_ActiveEntityList_f( const idCmdArgs &args ) {
 	gameLocal.Printf( "...%d active entities\n", count );
 }
 
+/*
+===================
+Cmd_ThinkStats_f
+===================
+*/
+void Cmd_ThinkStats_f( const idCmdArgs &args ) {
+	static const char * bucketNames[ NUM_THINK_BUCKETS ] = { "full", "half", "quarter", "eighth" };
+	const thinkBucketStats_t & stats = gameLocal.thinkBucketStats;
+	int totalActive = 0;
+	int totalRan = 0;
+
+	gameLocal.Printf( "%-8s %8s %8s\n", "bucket", "active", "ran" );
+	gameLocal.Printf( "--------------------------\n" );
+	for ( int i = 0; i < NUM_THINK_BUCKETS; i++ ) {
+		gameLocal.Printf( "%-8s %8d %8d\n", bucketNames[i], stats.active[i], stats.ran[i] );
+		totalActive += stats.active[i];
+		totalRan += stats.ran[i];
+	}
+	gameLocal.Printf( "--------------------------\n" );
+	gameLocal.Printf( "%-8s %8d %8d\n", "total", totalActive, totalRan );
+	gameLocal.Printf( "...%d entries in the active entity list%s\n", gameLocal.activeEntityList.Num(), g_thinkLod.GetBool() ? "" : ", g_thinkLod is disabled" );
+}
+
 /*
 ===================
 Cmd_ListSpawnArgs_f
@@ -1425,6 +1448,69 @@ static void Cmd_AASStats_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_AASRouteBenchmark_f
+==================
+*/
+static void Cmd_AASRouteBenchmark_f( const idCmdArgs &args ) {
+	int aasNum, goalAreaNum, numAgents;
+	idPlayer *player;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	aasNum = aas_test.GetInteger();
+	idAAS *aas = gameLocal.GetAAS( aasNum );
+	if ( !aas ) {
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+		return;
+	}
+
+	numAgents = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 64;
+	goalAreaNum = ( aas_goalArea.GetInteger() > 0 ) ? aas_goalArea.GetInteger() : aas->PointAreaNum( player->GetPhysics()->GetOrigin() );
+	aas->RouteBenchmark( goalAreaNum, numAgents );
+}
+
+/*
+==================
+Cmd_AASAreaNumBenchmark_f
+==================
+*/
+static void Cmd_AASAreaNumBenchmark_f( const idCmdArgs &args ) {
+	int aasNum, numPoints;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	aasNum = aas_test.GetInteger();
+	idAAS *aas = gameLocal.GetAAS( aasNum );
+	if ( !aas ) {
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+		return;
+	}
+
+	numPoints = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 4096;
+	aas->AreaNumBenchmark( numPoints );
+}
+
+/*
+==================
+Cmd_LagCompensationBenchmark_f
+==================
+*/
+static void Cmd_LagCompensationBenchmark_f( const idCmdArgs &args ) {
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	const int numTraces = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 4096;
+	gameLocal.clip.HistoryBenchmark( numTraces );
+}
+
 /*
 ==================
 Cmd_TestDamage_f
@@ -2298,6 +2384,7 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "listThreads",			idThread::ListThreads_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"lists script threads" );
 	cmdSystem->AddCommand( "listEntities",			Cmd_EntityList_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"lists game entities" );
 	cmdSystem->AddCommand( "listActiveEntities",	Cmd_ActiveEntityList_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"lists active game entities" );
+	cmdSystem->AddCommand( "thinkStats",			Cmd_ThinkStats_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"shows how many active entities thought in each think bucket last frame" );
 	cmdSystem->AddCommand( "listMonsters",			idAI::List_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"lists monsters" );
 	cmdSystem->AddCommand( "listSpawnArgs",			Cmd_ListSpawnArgs_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"list the spawn args of an entity", idGameLocal::ArgCompletion_EntityName );
 	cmdSystem->AddCommand( "say",					Cmd_Say_f,					CMD_FL_GAME,				"text chat" );
@@ -2350,6 +2437,9 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
+	cmdSystem->AddCommand( "aasRouteBenchmark",		Cmd_AASRouteBenchmark_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"times routing of a group of agents towards the player area with and without flow fields" );
+	cmdSystem->AddCommand( "aasAreaNumBenchmark",	Cmd_AASAreaNumBenchmark_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"times AAS area lookups with and without the area grid" );
+	cmdSystem->AddCommand( "lagCompensationBenchmark",	Cmd_LagCompensationBenchmark_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"times traces against the players now and against where they were in the lag compensation history" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
 	cmdSystem->AddCommand( "saveSelected",			Cmd_SaveSelected_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"saves the selected entity to the .map file" );
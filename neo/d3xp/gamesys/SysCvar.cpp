@@ -119,6 +119,9 @@ idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_thinkLod(					"g_thinkLod",				"1",			CVAR_GAME | CVAR_BOOL, "reduce the think rate of distant and out of pvs idle monsters in single player" );
+idCVar g_thinkLodDistance(			"g_thinkLodDistance",		"1024",			CVAR_GAME | CVAR_FLOAT, "distance from the player at which idle monsters start thinking at half rate, doubles for every further halving" );
+idCVar g_thinkLodMaxStep(			"g_thinkLodMaxStep",		"67",			CVAR_GAME | CVAR_INTEGER, "longest time in milliseconds the physics of a monster with a reduced think rate steps over at once" );
 
 idCVar g_debugShockwave(			"g_debugShockwave",			"0",			CVAR_GAME | CVAR_BOOL, "Debug the shockwave" );
 
@@ -143,6 +146,7 @@ idCVar ai_showCombatNodes(			"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL
 idCVar ai_showPaths(				"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
+idCVar ai_obstacleSnapshot(			"ai_obstacleSnapshot",		"1",			CVAR_GAME | CVAR_BOOL, "share one snapshot of the dynamic obstacles between all monsters avoiding obstacles in the same frame" );
 
 idCVar ai_showHealth(				"ai_showHealth",			"0",			CVAR_GAME | CVAR_BOOL, "Draws the AI's health above its head" );
 
@@ -296,6 +300,8 @@ idCVar g_testModelAnimate(			"g_testModelAnimate",		"0",			CVAR_GAME | CVAR_INTE
 idCVar g_testModelBlend(			"g_testModelBlend",			"0",			CVAR_GAME | CVAR_INTEGER, "number of frames to blend" );
 idCVar g_testDeath(					"g_testDeath",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_flushSave(					"g_flushSave",				"0",			CVAR_GAME | CVAR_BOOL, "1 = don't buffer file writing for save games." );
+idCVar g_autoSaveDelta(				"g_autoSaveDelta",			"0",			CVAR_GAME | CVAR_BOOL, "autosaves only store the objects that changed since the last full autosave" );
+idCVar g_autoSaveDeltaMaxRatio(		"g_autoSaveDeltaMaxRatio",	"0.5",			CVAR_GAME | CVAR_FLOAT, "write a new full autosave when a delta would be larger than this fraction of it" );
 
 idCVar aas_test(					"aas_test",					"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showAreas(				"aas_showAreas",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -307,12 +313,18 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_flowFields(				"aas_flowFields",			"1",			CVAR_GAME | CVAR_BOOL, "share per goal flow fields between AI routing towards the same goal area" );
+idCVar aas_incrementalCache(		"aas_incrementalCache",		"1",			CVAR_GAME | CVAR_BOOL, "when areas are enabled or disabled only invalidate the routing cache that routes through or next to them and repair it when it is used again" );
+idCVar aas_showCacheStats(			"aas_showCacheStats",		"0",			CVAR_GAME | CVAR_BOOL, "print routing cache invalidations and rebuild time for frames in which the routing cache changed" );
+idCVar aas_flowFieldRequests(		"aas_flowFieldRequests",	"16",			CVAR_GAME | CVAR_INTEGER, "number of routes towards the same goal within a frame before a flow field is built", 1, 1024 );
 
 idCVar g_countDown(					"g_countDown",				"15",			CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "pregame countdown in seconds", 4, 3600 );
 idCVar g_gameReviewPause(			"g_gameReviewPause",		"10",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_INTEGER | CVAR_ARCHIVE, "scores review time in seconds (at end game)", 2, 3600 );
 idCVar g_CTFArrows(					"g_CTFArrows",				"1",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_BOOL, "draw arrows over teammates in CTF" );
 
 idCVar net_clientPredictGUI(		"net_clientPredictGUI",		"1",			CVAR_GAME | CVAR_BOOL, "test guis in networking without prediction" );
+idCVar g_lagCompensation(			"g_lagCompensation",		"1",			CVAR_GAME | CVAR_BOOL, "the server traces instant hit shots from remote players against the players where the shooter saw them" );
+idCVar g_lagCompensationMaxMs(		"g_lagCompensationMaxMs",	"500",			CVAR_GAME | CVAR_INTEGER, "maximum number of milliseconds the players are rewound for lag compensation", 0, 500 );
 
 idCVar g_grabberHoldSeconds(		"g_grabberHoldSeconds",		"3",			CVAR_GAME | CVAR_FLOAT | CVAR_CHEAT, "number of seconds to hold object" );
 idCVar g_grabberEnableShake(		"g_grabberEnableShake",		"1",			CVAR_GAME | CVAR_BOOL | CVAR_CHEAT, "enable the grabber shake" );
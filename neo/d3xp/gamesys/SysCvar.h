@@ -79,6 +79,9 @@ extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
 extern idCVar	g_timeentities;
+extern idCVar	g_thinkLod;
+extern idCVar	g_thinkLodDistance;
+extern idCVar	g_thinkLodMaxStep;
 
 extern idCVar	ai_debugScript;
 extern idCVar	ai_debugMove;
@@ -88,6 +91,7 @@ extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
 extern idCVar	ai_blockedFailSafe;
+extern idCVar	ai_obstacleSnapshot;
 extern idCVar	ai_showHealth;
 
 extern idCVar	g_dvTime;
@@ -221,6 +225,8 @@ extern idCVar	g_testModelRotate;
 extern idCVar	g_testModelAnimate;
 extern idCVar	g_testModelBlend;
 extern idCVar	g_flushSave;
+extern idCVar	g_autoSaveDelta;
+extern idCVar	g_autoSaveDeltaMaxRatio;
 
 extern idCVar	g_enableSlowmo;
 extern idCVar	g_slowmoStepRate;
@@ -249,8 +255,14 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_flowFields;
+extern idCVar	aas_flowFieldRequests;
+extern idCVar	aas_incrementalCache;
+extern idCVar	aas_showCacheStats;
 
 extern idCVar	net_clientPredictGUI;
+extern idCVar	g_lagCompensation;
+extern idCVar	g_lagCompensationMaxMs;
 
 extern idCVar	si_timeLimit;
 extern idCVar	si_fragLimit;
@@ -58,6 +58,29 @@ typedef struct trmCache_s {
 	idMat3					inertiaTensor;
 } trmCache_t;
 
+const int CLIP_HISTORY_FRAMES			= 32;		// power of two, a little over 500 msec of game frames
+const int CLIP_HISTORY_ENTITY_MODELS	= 2;		// the physics clip model and the combat model
+const int CLIP_HISTORY_MODELS			= MAX_CLIENTS * CLIP_HISTORY_ENTITY_MODELS;
+const float CLIP_HISTORY_TELEPORT_DIST	= 256.0f;	// larger moves between two frames are not interpolated
+
+// the fields are kept in separate arrays indexed with frame * CLIP_HISTORY_MODELS + model
+// so that rewinding only touches the spawn ids and transforms of the two frames it needs
+typedef struct clipHistory_s {
+	int						numFrames;
+	int						newestFrame;
+	int						frameTimes[CLIP_HISTORY_FRAMES];
+	int						spawnIds[CLIP_HISTORY_FRAMES * CLIP_HISTORY_MODELS];	// -1 if the model was not linked
+	idVec3					origins[CLIP_HISTORY_FRAMES * CLIP_HISTORY_MODELS];
+	idMat3					axes[CLIP_HISTORY_FRAMES * CLIP_HISTORY_MODELS];
+	idBounds				absBounds[CLIP_HISTORY_FRAMES * CLIP_HISTORY_MODELS];
+} clipHistory_t;
+
+typedef struct rewoundClipModel_s {
+	idClipModel *			clipModel;		// clip model where it is linked now
+	idVec3					origin;			// where it was at the rewound time
+	idMat3					axis;
+} rewoundClipModel_t;
+
 idVec3 vec3_boxEpsilon( CM_BOX_EPSILON, CM_BOX_EPSILON, CM_BOX_EPSILON );
 
 idBlockAlloc<clipLink_t, 1024>	clipLinkAllocator;
@@ -707,6 +730,7 @@ idClip::idClip
 idClip::idClip() {
 	numClipSectors = 0;
 	clipSectors = NULL;
+	history = NULL;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
@@ -788,6 +812,9 @@ void idClip::Init() {
 	// initialize a default clip model
 	defaultClipModel.LoadModel( idTraceModel( idBounds( idVec3( 0, 0, 0 ) ).Expand( 8 ) ) );
 
+	history = new (TAG_PHYSICS_CLIP) clipHistory_t;
+	ClearHistory();
+
 	// set counters to zero
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
@@ -801,6 +828,9 @@ void idClip::Shutdown() {
 	delete[] clipSectors;
 	clipSectors = NULL;
 
+	delete history;
+	history = NULL;
+
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
 		idClipModel::FreeTraceModel( temporaryClipModel.traceModelIndex );
@@ -1207,6 +1237,409 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+============
+HistoryClipModel
+
+  The clip models of a player that are rewound for lag compensation.
+============
+*/
+static idClipModel *HistoryClipModel( idEntity *ent, int index ) {
+	if ( index == 0 ) {
+		return ( ent->GetPhysics()->GetNumClipModels() > 0 ) ? ent->GetPhysics()->GetClipModel() : NULL;
+	}
+	if ( ent->IsType( idActor::Type ) ) {
+		return static_cast<idActor *>( ent )->GetCombatModel();
+	}
+	return NULL;
+}
+
+/*
+============
+idClip::ClearHistory
+============
+*/
+void idClip::ClearHistory() {
+	if ( history == NULL ) {
+		return;
+	}
+	history->numFrames = 0;
+	history->newestFrame = CLIP_HISTORY_FRAMES - 1;
+}
+
+/*
+============
+idClip::SaveHistory
+
+  Copies the transforms of the player clip models at the end of a game frame.
+  Nothing is relinked, the clip models stay where they are.
+============
+*/
+void idClip::SaveHistory( int time ) {
+	int frame;
+
+	if ( history == NULL ) {
+		return;
+	}
+
+	if ( history->numFrames > 0 && time == history->frameTimes[history->newestFrame] ) {
+		frame = history->newestFrame;
+	} else {
+		if ( history->numFrames > 0 && time < history->frameTimes[history->newestFrame] ) {
+			// the game time went back, the old transforms don't belong to this timeline
+			ClearHistory();
+		}
+		frame = ( history->newestFrame + 1 ) & ( CLIP_HISTORY_FRAMES - 1 );
+		history->newestFrame = frame;
+		history->numFrames = Min( history->numFrames + 1, CLIP_HISTORY_FRAMES );
+	}
+	history->frameTimes[frame] = time;
+
+	const int base = frame * CLIP_HISTORY_MODELS;
+	for ( int i = 0; i < MAX_CLIENTS; i++ ) {
+		idEntity *ent = gameLocal.m_entities[i];
+		for ( int j = 0; j < CLIP_HISTORY_ENTITY_MODELS; j++ ) {
+			const int index = base + i * CLIP_HISTORY_ENTITY_MODELS + j;
+			const idClipModel *clipModel = ( ent != NULL ) ? HistoryClipModel( ent, j ) : NULL;
+			if ( clipModel == NULL || !clipModel->IsLinked() ) {
+				history->spawnIds[index] = -1;
+				continue;
+			}
+			history->spawnIds[index] = gameLocal.spawnIds[i];
+			history->origins[index] = clipModel->origin;
+			history->axes[index] = clipModel->axis;
+			history->absBounds[index] = clipModel->absBounds;
+		}
+	}
+}
+
+/*
+============
+idClip::GetOldestHistoryTime
+============
+*/
+int idClip::GetOldestHistoryTime() const {
+	if ( history == NULL || history->numFrames == 0 ) {
+		return 0;
+	}
+	return history->frameTimes[( history->newestFrame - history->numFrames + 1 ) & ( CLIP_HISTORY_FRAMES - 1 )];
+}
+
+/*
+============
+idClip::GetRewoundClipModels
+
+  Fills the rewound list with the player clip models that were touching the bounds
+  at the given time, interpolated between the two saved frames around the time.
+  Clip models in the current list that have a rewound transform are removed from it.
+============
+*/
+int idClip::GetRewoundClipModels( int time, const idBounds &bounds, int contentMask, const idEntity *passEntity,
+									idClipModel **clipModelList, int numClipModels, rewoundClipModel_t *rewoundList ) const {
+	int i, j, frame0, frame1, base0, base1, num;
+	float frac;
+	idEntity *passOwner;
+
+	// find the newest frame at or before the time and the frame after it
+	frame0 = frame1 = history->newestFrame;
+	for ( i = 1; i < history->numFrames && history->frameTimes[frame0] > time; i++ ) {
+		frame1 = frame0;
+		frame0 = ( frame0 - 1 ) & ( CLIP_HISTORY_FRAMES - 1 );
+	}
+	frac = 0.0f;
+	if ( frame1 != frame0 && time > history->frameTimes[frame0] ) {
+		frac = (float)( time - history->frameTimes[frame0] ) / (float)( history->frameTimes[frame1] - history->frameTimes[frame0] );
+	}
+	base0 = frame0 * CLIP_HISTORY_MODELS;
+	base1 = frame1 * CLIP_HISTORY_MODELS;
+
+	// the current transforms of the rewound clip models are not used
+	for ( i = 0; i < numClipModels; i++ ) {
+		idClipModel *cm = clipModelList[i];
+		if ( cm == NULL || cm->entity->entityNumber >= MAX_CLIENTS ) {
+			continue;
+		}
+		const int entityNum = cm->entity->entityNumber;
+		for ( j = 0; j < CLIP_HISTORY_ENTITY_MODELS; j++ ) {
+			const int index = base0 + entityNum * CLIP_HISTORY_ENTITY_MODELS + j;
+			if ( history->spawnIds[index] == gameLocal.spawnIds[entityNum] && HistoryClipModel( cm->entity, j ) == cm ) {
+				clipModelList[i] = NULL;
+				break;
+			}
+		}
+	}
+
+	if ( passEntity != NULL && passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
+		passOwner = passEntity->GetPhysics()->GetClipModel()->GetOwner();
+	} else {
+		passOwner = NULL;
+	}
+
+	num = 0;
+	for ( i = 0; i < CLIP_HISTORY_MODELS; i++ ) {
+		const int spawnId = history->spawnIds[base0 + i];
+		if ( spawnId == -1 ) {
+			continue;
+		}
+		const int entityNum = i / CLIP_HISTORY_ENTITY_MODELS;
+		idEntity *ent = gameLocal.m_entities[entityNum];
+		if ( ent == NULL || gameLocal.spawnIds[entityNum] != spawnId ) {
+			continue;
+		}
+		idClipModel *cm = HistoryClipModel( ent, i % CLIP_HISTORY_ENTITY_MODELS );
+		if ( cm == NULL || !cm->IsLinked() || !cm->enabled || !( cm->contents & contentMask ) ) {
+			continue;
+		}
+
+		// same filtering as GetTraceClipModels
+		if ( passEntity != NULL ) {
+			if ( ent == passEntity || ent == passOwner ) {
+				continue;
+			}
+			if ( cm->owner != NULL && ( cm->owner == passEntity || cm->owner == passOwner ) ) {
+				continue;
+			}
+		}
+
+		idVec3 origin = history->origins[base0 + i];
+		const idMat3 *axis = &history->axes[base0 + i];
+		if ( frac > 0.0f && history->spawnIds[base1 + i] == spawnId ) {
+			const idVec3 delta = history->origins[base1 + i] - origin;
+			if ( delta.LengthSqr() < Square( CLIP_HISTORY_TELEPORT_DIST ) ) {
+				origin += frac * delta;
+				if ( frac > 0.5f ) {
+					axis = &history->axes[base1 + i];
+				}
+			}
+		}
+
+		if ( !history->absBounds[base0 + i].Translate( origin - history->origins[base0 + i] ).IntersectsBounds( bounds ) ) {
+			continue;
+		}
+
+		rewoundList[num].clipModel = cm;
+		rewoundList[num].origin = origin;
+		rewoundList[num].axis = *axis;
+		num++;
+	}
+
+	return num;
+}
+
+/*
+============
+idClip::TranslationAtTime
+
+  Same as Translation but the players are where they were at the given game time.
+  Each rewound clip model is traced where it is linked now, with the trace moved by
+  the difference between the rewound and the current transform, and the results are
+  moved back afterwards.
+============
+*/
+bool idClip::TranslationAtTime( trace_t &results, const idVec3 &start, const idVec3 &end,
+						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity, int time ) {
+	int i, num, numRewound;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	rewoundClipModel_t rewoundList[CLIP_HISTORY_MODELS];
+	idBounds traceBounds;
+	float radius;
+	trace_t trace;
+	const idTraceModel *trm;
+
+	if ( history == NULL || history->numFrames == 0 || time >= history->frameTimes[history->newestFrame] ) {
+		return Translation( results, start, end, mdl, trmAxis, contentMask, passEntity );
+	}
+
+	if ( TestHugeTranslation( results, mdl, start, end, trmAxis ) ) {
+		return true;
+	}
+
+	trm = TraceModelForClipModel( mdl );
+
+	if ( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		idClip::numTranslations++;
+		collisionModelManager->Translation( &results, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
+		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+		if ( results.fraction == 0.0f ) {
+			return true;		// blocked immediately by the world
+		}
+	} else {
+		memset( &results, 0, sizeof( results ) );
+		results.fraction = 1.0f;
+		results.endpos = end;
+		results.endAxis = trmAxis;
+	}
+
+	if ( !trm ) {
+		traceBounds.FromPointTranslation( start, results.endpos - start );
+		radius = 0.0f;
+	} else {
+		traceBounds.FromBoundsTranslation( trm->bounds, start, trmAxis, results.endpos - start );
+		radius = trm->bounds.GetRadius();
+	}
+
+	num = GetTraceClipModels( traceBounds, contentMask, passEntity, clipModelList );
+	numRewound = GetRewoundClipModels( time, traceBounds, contentMask, passEntity, clipModelList, num, rewoundList );
+
+	for ( i = 0; i < num; i++ ) {
+		touch = clipModelList[i];
+
+		if ( !touch ) {
+			continue;
+		}
+
+		if ( touch->renderModelHandle != -1 ) {
+			idClip::numRenderModelTraces++;
+			TraceRenderModel( trace, start, end, radius, trmAxis, touch );
+		} else {
+			idClip::numTranslations++;
+			collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask,
+									touch->Handle(), touch->origin, touch->axis );
+		}
+
+		if ( trace.fraction < results.fraction ) {
+			results = trace;
+			results.c.entityNum = touch->entity->entityNumber;
+			results.c.id = touch->id;
+			if ( results.fraction == 0.0f ) {
+				return true;
+			}
+		}
+	}
+
+	for ( i = 0; i < numRewound; i++ ) {
+		const rewoundClipModel_t &rewound = rewoundList[i];
+		touch = rewound.clipModel;
+
+		// move the trace from the rewound transform to the linked transform
+		const idMat3 toLinked = rewound.axis.Transpose() * touch->axis;
+		const idVec3 linkedStart = ( start - rewound.origin ) * toLinked + touch->origin;
+		const idVec3 linkedEnd = ( end - rewound.origin ) * toLinked + touch->origin;
+		const idMat3 linkedTrmAxis = trmAxis * toLinked;
+
+		if ( touch->renderModelHandle != -1 ) {
+			idClip::numRenderModelTraces++;
+			TraceRenderModel( trace, linkedStart, linkedEnd, radius, linkedTrmAxis, touch );
+		} else {
+			idClip::numTranslations++;
+			collisionModelManager->Translation( &trace, linkedStart, linkedEnd, trm, linkedTrmAxis, contentMask,
+									touch->Handle(), touch->origin, touch->axis );
+		}
+
+		if ( trace.fraction < results.fraction ) {
+			const idMat3 fromLinked = toLinked.Transpose();
+			results = trace;
+			results.endpos = ( trace.endpos - touch->origin ) * fromLinked + rewound.origin;
+			results.endAxis = trace.endAxis * fromLinked;
+			results.c.point = ( trace.c.point - touch->origin ) * fromLinked + rewound.origin;
+			results.c.normal = trace.c.normal * fromLinked;
+			results.c.dist = results.c.normal * results.c.point;
+			results.c.entityNum = touch->entity->entityNumber;
+			results.c.id = touch->id;
+			if ( results.fraction == 0.0f ) {
+				break;
+			}
+		}
+	}
+
+	return ( results.fraction < 1.0f );
+}
+
+/*
+============
+idClip::HistoryBenchmark
+
+  Fills the history with the current transforms and times the same traces through
+  the players against the current world and against rewound times. The players don't
+  move between the saved frames, so both should hit the same things.
+============
+*/
+void idClip::HistoryBenchmark( int numTraces ) {
+	idRandom random( 0 );
+	idList<idVec3> targets;
+	idList<idVec3> starts;
+	idList<idVec3> ends;
+	idList<int> times;
+	idTimer timer;
+	trace_t tr[2];
+	int i, numHits[2], numMismatches;
+	double traceTime[2];
+
+	if ( history == NULL ) {
+		return;
+	}
+
+	const int frameMsec = FRAME_TO_MSEC( 1 );
+	const int endTime = gameLocal.time;
+	ClearHistory();
+	for ( i = CLIP_HISTORY_FRAMES - 1; i >= 0; i-- ) {
+		SaveHistory( endTime - i * frameMsec );
+	}
+
+	const int base = history->newestFrame * CLIP_HISTORY_MODELS;
+	for ( i = 0; i < CLIP_HISTORY_MODELS; i++ ) {
+		if ( history->spawnIds[base + i] != -1 ) {
+			targets.Append( history->absBounds[base + i].GetCenter() );
+		}
+	}
+	if ( targets.Num() == 0 ) {
+		gameLocal.Printf( "no players to trace against\n" );
+		ClearHistory();
+		return;
+	}
+
+	for ( i = 0; i < numTraces; i++ ) {
+		const idVec3 &target = targets[random.RandomInt( targets.Num() )];
+		idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() * 0.25f );
+		dir.Normalize();
+		starts.Append( target - dir * 512.0f );
+		ends.Append( target + dir * 512.0f + idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() ) * 16.0f );
+		times.Append( endTime - 1 - random.RandomInt( CLIP_HISTORY_FRAMES * frameMsec - frameMsec ) );
+	}
+
+	numHits[0] = numHits[1] = numMismatches = 0;
+
+	timer.Clear();
+	timer.Start();
+	for ( i = 0; i < numTraces; i++ ) {
+		Translation( tr[0], starts[i], ends[i], NULL, mat3_identity, MASK_SHOT_RENDERMODEL, NULL );
+		if ( tr[0].fraction < 1.0f && tr[0].c.entityNum < MAX_CLIENTS ) {
+			numHits[0]++;
+		}
+	}
+	timer.Stop();
+	traceTime[0] = timer.Milliseconds();
+
+	timer.Clear();
+	timer.Start();
+	for ( i = 0; i < numTraces; i++ ) {
+		TranslationAtTime( tr[1], starts[i], ends[i], NULL, mat3_identity, MASK_SHOT_RENDERMODEL, NULL, times[i] );
+		if ( tr[1].fraction < 1.0f && tr[1].c.entityNum < MAX_CLIENTS ) {
+			numHits[1]++;
+		}
+	}
+	timer.Stop();
+	traceTime[1] = timer.Milliseconds();
+
+	for ( i = 0; i < numTraces; i++ ) {
+		Translation( tr[0], starts[i], ends[i], NULL, mat3_identity, MASK_SHOT_RENDERMODEL, NULL );
+		TranslationAtTime( tr[1], starts[i], ends[i], NULL, mat3_identity, MASK_SHOT_RENDERMODEL, NULL, times[i] );
+		if ( tr[0].c.entityNum != tr[1].c.entityNum || idMath::Fabs( tr[0].fraction - tr[1].fraction ) > 1e-4f ) {
+			numMismatches++;
+		}
+	}
+
+	ClearHistory();
+
+	gameLocal.Printf( "%d traces through %d player clip models\n", numTraces, targets.Num() );
+	gameLocal.Printf( "current: %7.2f ms, %8.0f traces per second, %d player hits\n", traceTime[0], numTraces * 1000.0 / Max( traceTime[0], 0.001 ), numHits[0] );
+	gameLocal.Printf( "rewound: %7.2f ms, %8.0f traces per second, %d player hits\n", traceTime[1], numTraces * 1000.0 / Max( traceTime[1], 0.001 ), numHits[1] );
+	if ( numMismatches ) {
+		gameLocal.Warning( "HistoryBenchmark: %d rewound traces differ from the current traces", numMismatches );
+	}
+}
+
 /*
 ============
 idClip::Rotation
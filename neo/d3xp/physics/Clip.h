@@ -292,6 +292,14 @@ public:
 	void					TranslationEntities( trace_t &results, const idVec3 &start, const idVec3 &end,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
 
+	// lag compensation, keeps the transforms of the player clip models for the last few hundred milliseconds
+	void					ClearHistory();
+	void					SaveHistory( int time );
+	int						GetOldestHistoryTime() const;
+	// clip versus the rest of the world with the players moved back to where they were at the given game time
+	bool					TranslationAtTime( trace_t &results, const idVec3 &start, const idVec3 &end,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity, int time );
+
 	// get a contact feature
 	bool					GetModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, idFixedWinding &winding ) const;
 
@@ -304,12 +312,14 @@ public:
 
 							// stats and debug drawing
 	void					PrintStatistics();
+	void					HistoryBenchmark( int numTraces );
 	void					DrawClipModels( const idVec3 &eye, const float radius, const idEntity *passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 
 private:
 	int						numClipSectors;
 	struct clipSector_s *	clipSectors;
+	struct clipHistory_s *	history;
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
@@ -327,6 +337,8 @@ private:
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
+	int						GetRewoundClipModels( int time, const idBounds &bounds, int contentMask, const idEntity *passEntity,
+								idClipModel **clipModelList, int numClipModels, struct rewoundClipModel_s *rewoundList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
 };
 
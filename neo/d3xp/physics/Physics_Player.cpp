@@ -2136,22 +2136,46 @@ const int	PLAYER_VELOCITY_MANTISSA_BITS	= PLAYER_VELOCITY_TOTAL_BITS - 1 - PLAYE
 const int	PLAYER_MOVEMENT_TYPE_BITS		= 3;
 const int	PLAYER_MOVEMENT_FLAGS_BITS		= 8;
 
+// the origin stays full precision, client prediction replays from it
+static const netField_t playerSnapshotFields[] = {
+	idNetSchema::Float( "origin.x" ),
+	idNetSchema::Float( "origin.y" ),
+	idNetSchema::Float( "origin.z" ),
+	idNetSchema::FloatBits( "velocity.x", PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "velocity.y", PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "velocity.z", PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::Float( "localOrigin.x" ),		// relative to origin
+	idNetSchema::Float( "localOrigin.y" ),
+	idNetSchema::Float( "localOrigin.z" )
+};
+static idNetSchema playerSnapshotSchema( "player", playerSnapshotFields, sizeof( playerSnapshotFields ) / sizeof( playerSnapshotFields[0] ) );
+
+/*
+================
+idPhysics_Player::GetSnapshotSchema
+================
+*/
+const idNetSchema * idPhysics_Player::GetSnapshotSchema() {
+	return &playerSnapshotSchema;
+}
+
 /*
 ================
 idPhysics_Player::WriteToSnapshot
 ================
 */
 void idPhysics_Player::WriteToSnapshot( idBitMsg &msg ) const {
-	msg.WriteFloat( current.origin[0] );
-	msg.WriteFloat( current.origin[1] );
-	msg.WriteFloat( current.origin[2] );
-	msg.WriteFloat( current.velocity[0], PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
-	msg.WriteFloat( current.velocity[1], PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
-	msg.WriteFloat( current.velocity[2], PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
+	idNetFieldWriter fields( playerSnapshotSchema, msg );
+	fields.WriteFloat( current.origin[0] );
+	fields.WriteFloat( current.origin[1] );
+	fields.WriteFloat( current.origin[2] );
+	fields.WriteFloat( current.velocity[0] );
+	fields.WriteFloat( current.velocity[1] );
+	fields.WriteFloat( current.velocity[2] );
 	//idLib::Printf("Writing Velocity: x %2f, y %2f, z %2f \n", current.velocity[0], current.velocity[1], current.velocity[2] );
-	msg.WriteDeltaFloat( current.origin[0], current.localOrigin[0] );
-	msg.WriteDeltaFloat( current.origin[1], current.localOrigin[1] );
-	msg.WriteDeltaFloat( current.origin[2], current.localOrigin[2] );
+	fields.WriteDeltaFloat( current.origin[0], current.localOrigin[0] );
+	fields.WriteDeltaFloat( current.origin[1], current.localOrigin[1] );
+	fields.WriteDeltaFloat( current.origin[2], current.localOrigin[2] );
 }
 
 /*
@@ -2163,12 +2187,17 @@ void idPhysics_Player::ReadFromSnapshot( const idBitMsg &msg ) {
 
 	previous = next;
 
-	next.origin = ReadFloatArray< idVec3 >( msg );
-	next.velocity[0] = msg.ReadFloat( PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
-	next.velocity[1] = msg.ReadFloat( PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
-	next.velocity[2] = msg.ReadFloat( PLAYER_VELOCITY_EXPONENT_BITS, PLAYER_VELOCITY_MANTISSA_BITS );
+	idNetFieldReader fields( playerSnapshotSchema, msg );
+	next.origin[0] = fields.ReadFloat();
+	next.origin[1] = fields.ReadFloat();
+	next.origin[2] = fields.ReadFloat();
+	next.velocity[0] = fields.ReadFloat();
+	next.velocity[1] = fields.ReadFloat();
+	next.velocity[2] = fields.ReadFloat();
 	//idLib::Printf("Reading Velocity: x %2f, y %2f, z %2f \n", next.velocity[0], next.velocity[1], next.velocity[2] );
-	next.localOrigin = ReadDeltaFloatArray( msg, next.origin );
+	next.localOrigin[0] = fields.ReadDeltaFloat( next.origin[0] );
+	next.localOrigin[1] = fields.ReadDeltaFloat( next.origin[1] );
+	next.localOrigin[2] = fields.ReadDeltaFloat( next.origin[2] );
 
 	if ( clipModel ) {
 		clipModel->Link( gameLocal.clip, self, 0, next.origin, clipModel->GetAxis() );
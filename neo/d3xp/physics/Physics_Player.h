@@ -144,6 +144,8 @@ public:	// common physics interface
 	void					WriteToSnapshot( idBitMsg &msg ) const;
 	void					ReadFromSnapshot( const idBitMsg &msg );
 
+	static const idNetSchema *	GetSnapshotSchema();		// field block at the start of WriteToSnapshot
+
 	void					SnapToNextState() { current = next; previous = current; }
 
 private:
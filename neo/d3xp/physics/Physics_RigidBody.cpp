@@ -1484,6 +1484,30 @@ const float	RB_FORCE_MAX				= 1e20f;
 const int	RB_FORCE_TOTAL_BITS			= 16;
 const int	RB_FORCE_EXPONENT_BITS		= idMath::BitsForInteger( idMath::BitsForFloat( RB_FORCE_MAX ) ) + 1;
 const int	RB_FORCE_MANTISSA_BITS		= RB_FORCE_TOTAL_BITS - 1 - RB_FORCE_EXPONENT_BITS;
+const int	RB_POSITION_BITS			= 24;
+const int	RB_ORIENTATION_BITS			= 16;
+
+static const netField_t rigidBodySnapshotFields[] = {
+	idNetSchema::Quantized( "position.x", -MAX_WORLD_COORD, MAX_WORLD_COORD, RB_POSITION_BITS ),
+	idNetSchema::Quantized( "position.y", -MAX_WORLD_COORD, MAX_WORLD_COORD, RB_POSITION_BITS ),
+	idNetSchema::Quantized( "position.z", -MAX_WORLD_COORD, MAX_WORLD_COORD, RB_POSITION_BITS ),
+	idNetSchema::Quantized( "orientation.x", -1.0f, 1.0f, RB_ORIENTATION_BITS ),
+	idNetSchema::Quantized( "orientation.y", -1.0f, 1.0f, RB_ORIENTATION_BITS ),
+	idNetSchema::Quantized( "orientation.z", -1.0f, 1.0f, RB_ORIENTATION_BITS ),
+	idNetSchema::FloatBits( "linearMomentum.x", RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "linearMomentum.y", RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "linearMomentum.z", RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS )
+};
+static idNetSchema rigidBodySnapshotSchema( "rigidBody", rigidBodySnapshotFields, sizeof( rigidBodySnapshotFields ) / sizeof( rigidBodySnapshotFields[0] ) );
+
+/*
+================
+idPhysics_RigidBody::GetSnapshotSchema
+================
+*/
+const idNetSchema * idPhysics_RigidBody::GetSnapshotSchema() {
+	return &rigidBodySnapshotSchema;
+}
 
 /*
 ================
@@ -1495,15 +1519,16 @@ void idPhysics_RigidBody::WriteToSnapshot( idBitMsg &msg ) const {
 
 	quat = current.i.orientation.ToCQuat();
 
-	msg.WriteFloat( current.i.position[0] );
-	msg.WriteFloat( current.i.position[1] );
-	msg.WriteFloat( current.i.position[2] );
-	msg.WriteFloat( quat.x );
-	msg.WriteFloat( quat.y );
-	msg.WriteFloat( quat.z );
-	msg.WriteFloat( current.i.linearMomentum[0], RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
-	msg.WriteFloat( current.i.linearMomentum[1], RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
-	msg.WriteFloat( current.i.linearMomentum[2], RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
+	idNetFieldWriter fields( rigidBodySnapshotSchema, msg );
+	fields.WriteFloat( current.i.position[0] );
+	fields.WriteFloat( current.i.position[1] );
+	fields.WriteFloat( current.i.position[2] );
+	fields.WriteFloat( quat.x );
+	fields.WriteFloat( quat.y );
+	fields.WriteFloat( quat.z );
+	fields.WriteFloat( current.i.linearMomentum[0] );
+	fields.WriteFloat( current.i.linearMomentum[1] );
+	fields.WriteFloat( current.i.linearMomentum[2] );
 }
 
 /*
@@ -1516,15 +1541,16 @@ void idPhysics_RigidBody::ReadFromSnapshot( const idBitMsg &msg ) {
 	
 	previous = next;
 
-	next.i.position[0] = msg.ReadFloat();
-	next.i.position[1] = msg.ReadFloat();
-	next.i.position[2] = msg.ReadFloat();
-	quat.x = msg.ReadFloat();
-	quat.y = msg.ReadFloat();
-	quat.z = msg.ReadFloat();
-	next.i.linearMomentum[0] = msg.ReadFloat( RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
-	next.i.linearMomentum[1] = msg.ReadFloat( RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
-	next.i.linearMomentum[2] = msg.ReadFloat( RB_MOMENTUM_EXPONENT_BITS, RB_MOMENTUM_MANTISSA_BITS );
+	idNetFieldReader fields( rigidBodySnapshotSchema, msg );
+	next.i.position[0] = fields.ReadFloat();
+	next.i.position[1] = fields.ReadFloat();
+	next.i.position[2] = fields.ReadFloat();
+	quat.x = fields.ReadFloat();
+	quat.y = fields.ReadFloat();
+	quat.z = fields.ReadFloat();
+	next.i.linearMomentum[0] = fields.ReadFloat();
+	next.i.linearMomentum[1] = fields.ReadFloat();
+	next.i.linearMomentum[2] = fields.ReadFloat();
 
 	next.i.orientation = quat.ToMat3();
 
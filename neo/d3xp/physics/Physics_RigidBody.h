@@ -171,6 +171,8 @@ public:	// common physics interface
 	void					WriteToSnapshot( idBitMsg &msg ) const;
 	void					ReadFromSnapshot( const idBitMsg &msg );
 
+	static const idNetSchema *	GetSnapshotSchema();		// field block at the start of WriteToSnapshot
+
 private:
 	// state of the rigid body
 	rigidBodyPState_t		current;
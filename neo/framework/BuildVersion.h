@@ -29,4 +29,13 @@ If you have questions concerning this license or the applicable additional terms
 const int BUILD_NUMBER_SAVE_VERSION_CHANGE			= 1400;		// Altering saves so that the version goes in the Details file that we read in during the enumeration phase
 
 const int BUILD_NUMBER = BUILD_NUMBER_SAVE_VERSION_CHANGE;
-const int BUILD_NUMBER_MINOR = 0;
\ No newline at end of file
+const int BUILD_NUMBER_MINOR = 0;
+
+// The network protocol goes into the version checksum, so builds that can't parse each other's
+// packets refuse to connect instead of desyncing
+const int NET_PROTOCOL_VERSION_ORIGINAL				= 0;
+const int NET_PROTOCOL_VERSION_SNAPSHOT_CODEC		= 1;		// Snapshot deltas start with the id of the codec that compressed them
+const int NET_PROTOCOL_VERSION_FIELD_DELTA			= 2;		// Schema field deltas in snapshots, quantized rigid body state
+const int NET_PROTOCOL_VERSION_USERCMD_DELTA		= 3;		// Usercmds are delta coded against the previous one in the batch
+
+const int NET_PROTOCOL_VERSION = NET_PROTOCOL_VERSION_USERCMD_DELTA;
\ No newline at end of file
@@ -64,6 +64,8 @@ idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR
 idCVar com_allowConsole( "com_allowConsole", "1", CVAR_BOOL | CVAR_SYSTEM | CVAR_INIT, "allow toggling console with the tilde key" );
 #endif
 
+idCVar com_dedicated( "com_dedicated", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_INIT, "run as a headless dedicated server without renderer, sound or menus" );
+
 idCVar com_developer( "developer", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "developer mode" );
 idCVar com_speeds( "com_speeds", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "show engine timings" );
 idCVar com_showFPS( "com_showFPS", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_ARCHIVE|CVAR_NOCHEAT, "show frames rendered per second" );
@@ -79,6 +81,8 @@ idCVar preload_CommonAssets( "preload_CommonAssets", "1", CVAR_SYSTEM | CVAR_BOO
 idCVar net_inviteOnly( "net_inviteOnly", "1", CVAR_BOOL | CVAR_ARCHIVE, "whether or not the private server you create allows friends to join or invite only" );
 
 extern idCVar g_demoMode;
+extern idCVar s_noSound;
+extern idCVar net_headlessServer;
 
 idCVar com_engineHz( "com_engineHz", "60", CVAR_FLOAT | CVAR_ARCHIVE, "Frames per second the engine runs at", 10.0f, 1024.0f );
 float com_engineHz_latched = 60.0f; // Latched version of cvar, updated between map loads
@@ -157,6 +161,8 @@ idCommonLocal::idCommonLocal() :
 	insideUpdateScreen = false;
 	insideExecuteMapChange = false;
 
+	lastTickReportTime = 0;
+
 	mapSpawnData.savegameFile = NULL;
 
 	currentMapName.Clear();
@@ -926,6 +932,15 @@ bool idCommonLocal::IsInitialized() const {
 	return com_fullyInitialized;
 }
 
+/*
+=================
+idCommonLocal::IsDedicatedServer
+=================
+*/
+bool idCommonLocal::IsDedicatedServer() const {
+	return com_dedicated.GetBool();
+}
+
 
 //======================================================================================
 
@@ -1015,6 +1030,8 @@ void idCommonLocal::Init( int argc, const char * const * argv, const char *cmdli
 		stringsFile.SetNameAndType( SAVEGAME_STRINGS_FILENAME, SAVEGAMEFILE_BINARY );
 		stringsFile.PreAllocate( MAX_SAVEGAME_STRING_TABLE_SIZE );
 
+		deltaSaveFile.SetNameAndType( SAVEGAME_DELTA_FILENAME, SAVEGAMEFILE_BINARY | SAVEGAMEFILE_OPTIONAL );
+
 		fileSystem->BeginLevelLoad( "_startup", saveFile.GetDataPtr(), static_cast<int>(saveFile.GetAllocated()) );
 
 		// initialize the declaration manager
@@ -1046,9 +1063,18 @@ void idCommonLocal::Init( int argc, const char * const * argv, const char *cmdli
 
 		// if any archived cvars are modified after this, we will trigger a writing of the config file
 		cvarSystem->ClearModifiedFlags( CVAR_ARCHIVE );
-		
-		// init OpenGL, which will open a window and connect sound and input hardware
-		renderSystem->InitGL();
+
+		if ( IsDedicatedServer() ) {
+			// a dedicated server hosts the match itself and never opens a window or touches
+			// the audio hardware, the renderer comes up without a device so map loads still
+			// find their frame data and an (empty) vertex cache
+			s_noSound.SetBool( true );
+			net_headlessServer.SetBool( true );
+			renderSystem->InitHeadless();
+		} else {
+			// init OpenGL, which will open a window and connect sound and input hardware
+			renderSystem->InitGL();
+		}
 
 		// Support up to 2 digits after the decimal point
 		com_engineHz_denominator = 100LL * com_engineHz.GetFloat();
@@ -1075,7 +1101,9 @@ void idCommonLocal::Init( int argc, const char * const * argv, const char *cmdli
 
 		const int legalMinTime = 4000;
 		const bool showVideo = ( !com_skipIntroVideos.GetBool () && fileSystem->UsingResourceFiles() );
-		if ( showVideo ) {
+		if ( IsDedicatedServer() ) {
+			idLib::Printf( "Dedicated server, skipping splash screens\n" );
+		} else if ( showVideo ) {
 			RenderBink( "video\\loadvideo.bik" );
 			RenderSplash();
 			RenderSplash();
@@ -1150,7 +1178,9 @@ void idCommonLocal::Init( int argc, const char * const * argv, const char *cmdli
 			game->Leaderboards_Init();
 		}
 
-		CreateMainMenu();
+		if ( !IsDedicatedServer() ) {
+			CreateMainMenu();
+		}
 
 		commonDialog.Init();
 
@@ -1159,9 +1189,11 @@ void idCommonLocal::Init( int argc, const char * const * argv, const char *cmdli
 
 		AddStartupCommands();
 
-		StartMenu( true );
+		if ( !IsDedicatedServer() ) {
+			StartMenu( true );
+		}
 
-		while ( Sys_Milliseconds() - legalStartTime < legalMinTime ) {
+		while ( !IsDedicatedServer() && Sys_Milliseconds() - legalStartTime < legalMinTime ) {
 			RenderSplash();
 			Sys_GenerateEvents();
 			Sys_Sleep( 10 );
@@ -1276,6 +1308,10 @@ void idCommonLocal::Shutdown() {
 	printf( "session->Shutdown();\n" );
 	session->Shutdown();
 
+	// close the snapshot recording
+	printf( "idNetSimulator::Shutdown();\n" );
+	idNetSimulator::Shutdown();
+
 	// shutdown, deallocate leaderboard definitions.
 	if( game != NULL ) {
 		printf( "game->Leaderboards_Shutdown();\n" );
@@ -1317,6 +1353,8 @@ void idCommonLocal::Shutdown() {
 	saveFile.Clear( true );
 	printf( "stringsFile.Clear( true );\n" );
 	stringsFile.Clear( true );
+	printf( "deltaSaveFile.Clear( true );\n" );
+	deltaSaveFile.Clear( true );
 
 	// only shut down the log file after all output is done
 	printf( "CloseLogFile();\n" );
@@ -1709,3 +1747,30 @@ CONSOLE_COMMAND( listDictValues, "lists all values used by dictionaries", NULL )
 CONSOLE_COMMAND( testSIMD, "test SIMD code", NULL ) {
 	idSIMD::Test_f( args );
 }
+CONSOLE_COMMAND( testParser, "counts parser token allocations, usage: testParser [folder] [extension]", NULL ) {
+	idParser::Test_f( args );
+}
+CONSOLE_COMMAND( testLexer, "measures lexer throughput, usage: testLexer [folder] [extension]", NULL ) {
+	idLexer::Test_f( args );
+}
+CONSOLE_COMMAND( testBitMsg, "compares idBitMsg with the reference bit packer on random messages and times both, usage: testBitMsg [numMessages] [seed]", NULL ) {
+	idBitMsg::Test_f( args );
+}
+CONSOLE_COMMAND( testSPSCQueue, "measures single producer single consumer queue throughput between two threads, usage: testSPSCQueue [numItems] [batchSize]", NULL ) {
+	SPSCQueue_Test_f( args );
+}
+CONSOLE_COMMAND( testSnapshotPeers, "measures snapshot jobs for simulated peers, usage: testSnapshotPeers [numPeers] [numFrames] [numObjects]", NULL ) {
+	idSnapshotProcessor::Test_f( args );
+}
+
+CONSOLE_COMMAND( testSnapshotCodecs, "compares the snapshot delta codecs on captured deltas, usage: testSnapshotCodecs [captureFile] [numPasses]", NULL ) {
+	idSnapshotProcessor::TestCodecs_f( args );
+}
+
+CONSOLE_COMMAND( testSnapshotFields, "compares the snapshot bandwidth of simulated players with and without field deltas, usage: testSnapshotFields [numPlayers] [numFrames]", NULL ) {
+	idSnapshotProcessor::TestFields_f( args );
+}
+
+CONSOLE_COMMAND( netSimulate, "replays recorded snapshots to simulated clients over lossy links and reports the bandwidth and cost, usage: netSimulate [numClients] [seconds] [recordFile]", NULL ) {
+	idNetSimulator::Run_f( args );
+}
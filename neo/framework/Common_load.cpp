@@ -478,7 +478,9 @@ void idCommonLocal::ExecuteMapChange() {
 	// load / program a gui to stay up on the screen while loading
 	// set the loading gui that we will wipe to
 	bool hellMap = false;
-	LoadLoadingGui( currentMapName, hellMap );
+	if ( !IsDedicatedServer() ) {
+		LoadLoadingGui( currentMapName, hellMap );
+	}
 
 	// Stop rendering the wipe
 	ClearWipe();
@@ -526,7 +528,8 @@ void idCommonLocal::ExecuteMapChange() {
 
 	// load and spawn all other entities ( from a savegame possibly )
 	if ( mapSpawnData.savegameFile ) {
-		if ( !game->InitFromSaveGame( fullMapName, renderWorld, soundWorld, mapSpawnData.savegameFile, mapSpawnData.stringTableFile, mapSpawnData.savegameVersion ) ) {
+		idFile * deltaSaveFile = ( mapSpawnData.deltaSaveFile->Length() > 0 ) ? mapSpawnData.deltaSaveFile : NULL;
+		if ( !game->InitFromSaveGame( fullMapName, renderWorld, soundWorld, mapSpawnData.savegameFile, mapSpawnData.stringTableFile, deltaSaveFile, mapSpawnData.savegameVersion ) ) {
 			// If the loadgame failed, end the session, which will force us to go back to the main menu
 			session->QuitMatchToTitle();
 		}
@@ -838,10 +841,17 @@ bool idCommonLocal::SaveGame( const char * saveName ) {
 	game->GetServerInfo().WriteToFileHandle( &saveFile );
 
 	// let the game save its state
-	game->SaveGame( pipelineFile, &stringsFile );
+	const int startTimeMs = Sys_Milliseconds();
+
+	const int headerLength = saveFile.Length();
+	const bool autoSave = ( idStr::Icmp( saveName, "autosave" ) == 0 );
+	const bool deltaSave = game->SaveGame( pipelineFile, &stringsFile, autoSave );
 
 	pipelineFile->Finish();
 
+	Printf( "Save game '%s': %dms including compression, %d kB serialized, %d kB written, %d kB string table\n", saveName, Sys_Milliseconds() - startTimeMs,
+		(int)( pipelineFile->GetUncompressedLength() >> 10 ), saveFile.Length() >> 10, stringsFile.Length() >> 10 );
+
 	idSaveGameDetails gameDetails;
 	game->GetSaveGameDetails( gameDetails );
 
@@ -853,9 +863,26 @@ bool idCommonLocal::SaveGame( const char * saveName ) {
 
 	saveFileEntryList_t files;
 	files.Append( &stringsFile );
-	files.Append( &saveFile );
 
-	session->SaveGameSync( gameDetails.slotName, files, gameDetails );
+	deltaSaveFile.MakeWritable();
+	deltaSaveFile.Clear( false );
+	if ( deltaSave ) {
+		// the delta goes next to the full autosave it was made against, which is left as it is
+		deltaSaveFile.Write( saveFile.GetDataPtr() + headerLength, saveFile.Length() - headerLength );
+		files.Append( &deltaSaveFile );
+	} else {
+		files.Append( &saveFile );
+		if ( autoSave ) {
+			// an empty delta replaces the one made against the previous full autosave
+			files.Append( &deltaSaveFile );
+		}
+	}
+
+	saveFile.error = false;
+	stringsFile.error = false;
+	deltaSaveFile.error = false;
+	const saveGameHandle_t saveGameHandle = session->SaveGameSync( gameDetails.slotName, files, gameDetails );
+	game->SaveGameWritten( saveGameHandle != 0 && !saveFile.error && !stringsFile.error && !deltaSaveFile.error );
 
 	if ( !insideExecuteMapChange ) {
 		renderSystem->EndAutomaticBackgroundSwaps();
@@ -922,15 +949,18 @@ bool idCommonLocal::LoadGame( const char * saveName ) {
 
 	mapSpawnData.savegameFile = &saveFile;
 	mapSpawnData.stringTableFile = &stringsFile;
+	mapSpawnData.deltaSaveFile = &deltaSaveFile;
 
 	saveFileEntryList_t files;
 	files.Append( mapSpawnData.stringTableFile );
 	files.Append( mapSpawnData.savegameFile );
+	files.Append( mapSpawnData.deltaSaveFile );
 
 	idStr slotName = saveName;
 	ScrubSaveGameFileName( slotName );
 	saveFile.Clear( false );
 	stringsFile.Clear( false );
+	deltaSaveFile.Clear( false );
 
 	saveGameHandle_t loadGameHandle = session->LoadGameSync( slotName, files );
 	if ( loadGameHandle != 0 ) {
@@ -1039,6 +1069,7 @@ void idCommonLocal::OnLoadFilesCompleted( idSaveLoadParms & parms ) {
 		// just need to make the file readable
 		((idFile_Memory *)mapSpawnData.savegameFile)->MakeReadOnly();
 		((idFile_Memory *)mapSpawnData.stringTableFile)->MakeReadOnly();
+		((idFile_Memory *)mapSpawnData.deltaSaveFile)->MakeReadOnly();
 
 		idStr gamename;
 		idStr mapname;
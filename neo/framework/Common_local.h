@@ -106,12 +106,41 @@ struct frameTiming_t {
 	uint64	finishRenderTime;
 };
 
+/*
+================================================
+idTickTimes
+
+Rolling window of durations. A dedicated server reports its game tics and whole server
+frames as percentiles so the headroom left for more server instances on the same machine
+is visible.
+================================================
+*/
+class idTickTimes {
+public:
+					idTickTimes() { Clear(); }
+
+	void			Clear() { numSamples = 0; nextSample = 0; }
+	void			AddSample( int microseconds );
+	int				Num() const { return numSamples; }
+
+	// prints the median, 90th and 99th percentile and the worst sample
+	void			Print( const char * label, int budgetMicroseconds ) const;
+
+private:
+	static const int MAX_SAMPLES = 4096;
+
+	int				samples[MAX_SAMPLES];
+	int				numSamples;
+	int				nextSample;
+};
+
 #define	MAX_PRINT_MSG_SIZE	4096
 #define MAX_WARNING_LIST	256
 
 #define SAVEGAME_CHECKPOINT_FILENAME		"gamedata.save"
 #define SAVEGAME_DESCRIPTION_FILENAME		"gamedata.txt"
 #define SAVEGAME_STRINGS_FILENAME			"gamedata.strings"
+#define SAVEGAME_DELTA_FILENAME				"gamedata.delta"		// delta autosave made against gamedata.save
 
 class idCommonLocal : public idCommon {
 public:
@@ -207,6 +236,9 @@ public:
 public:
 	void	Draw();			// called by gameThread
 
+	bool	IsDedicatedServer() const;
+	void	PrintTickTimes( bool clear );
+
 	int		GetGameThreadTotalTime() const { return gameThread.GetThreadTotalTime(); }
 	int		GetGameThreadGameTime() const { return gameThread.GetThreadGameTime(); }
 	int		GetGameThreadRenderTime() const { return gameThread.GetThreadRenderTime(); }
@@ -269,6 +301,7 @@ private:
 
 	idFile_SaveGame 			saveFile;
 	idFile_SaveGame 			stringsFile;
+	idFile_SaveGame 			deltaSaveFile;
 	idFile_SaveGamePipelined 	*pipelineFile;
 
 	// The main render world and sound world
@@ -293,6 +326,7 @@ private:
 	struct mapSpawnData_t {
 		idFile_SaveGame *	savegameFile;				// Used for loading a save game
 		idFile_SaveGame *	stringTableFile;			// String table read from save game loaded
+		idFile_SaveGame *	deltaSaveFile;				// Delta autosave made against savegameFile, empty if there is none
 		idFile_SaveGamePipelined *pipelineFile;			
 		int					savegameVersion;			// Version of the save game we're loading
 		idDict				persistentPlayerInfo;		// Used for transitioning from map to map
@@ -397,6 +431,10 @@ private:
 
 	idGameThread		gameThread;				// the game and draw code can be run in parallel
 
+	idTickTimes			tickTimes;				// game tic durations on a dedicated server
+	idTickTimes			serverFrameTimes;		// whole dedicated server frames, including session pumping and snapshots
+	int					lastTickReportTime;
+
 	// com_speeds times
 	int					count_numGameFrames;	// total number of game frames that were run
 	int					time_gameFrame;			// game logic time
@@ -455,6 +493,8 @@ private:
 
 	void	ProcessGameReturn( const gameReturn_t & ret );
 
+	void	DedicatedFrame();
+
 	void	RunNetworkSnapshotFrame();
 	void	ExecuteReliableMessages();
 
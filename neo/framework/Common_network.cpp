@@ -134,6 +134,7 @@ void idCommonLocal::SendSnapshots() {
 	}
 	idSnapShot ss;
 	game->ServerWriteSnapshot( ss );
+	idNetSimulator::RecordSnapshot( ss );
 
 	session->SendSnapshot( ss );
 	nextSnapshotSendTime = MSEC_ALIGN_TO_FRAME( currentTime + net_snapRate.GetInteger() );
@@ -181,21 +182,13 @@ void idCommonLocal::SendUsercmds( int localClientNum ) {
 	}
 	// We always send the last NUM_USERCMD_SEND usercmds
 	// Which may result in duplicate usercmds being sent in the case of a low net_ucmdRate
-	// But the LZW compressor means the extra usercmds are not large and the redundancy can smooth packet loss
+	// But the bit packed deltas mean the extra usercmds are not large and the redundancy can smooth packet loss
 	byte buffer[idPacketProcessor::MAX_FINAL_PACKET_SIZE];
 	idBitMsg msg( buffer, sizeof( buffer ) );
-	idSerializer ser( msg, true );
-	usercmd_t empty;
-	usercmd_t * last = &empty;
 	
 	usercmd_t * cmdBuffer[NUM_USERCMD_SEND];
 	const int numCmds = userCmdMgr.GetPlayerCmds( localClientNum, cmdBuffer, NUM_USERCMD_SEND );
-	msg.WriteByte( numCmds );
-	for ( int i = 0; i < numCmds; i++ ) {
-		cmdBuffer[i]->Serialize( ser, *last );
-		
-		last = cmdBuffer[i];
-	}
+	WriteUsercmdBatch( msg, cmdBuffer, numCmds );
 	session->SendUsercmds( msg );
 
 	nextUsercmdSendTime = MSEC_ALIGN_TO_FRAME( currentTime + net_ucmdRate.GetInteger() );
@@ -325,42 +318,14 @@ void idCommonLocal::NetReadUsercmds( int clientNum, idBitMsg & msg ) {
 		return;
 	}
 
-	idSerializer ser( msg, false );
-	
-	usercmd_t fakeCmd;
-	usercmd_t * base = &fakeCmd;
-
-	usercmd_t lastCmd;
-
-	bool										gotNewCmd = false;
-	idStaticList< usercmd_t, NUM_USERCMD_RELAY >	newCmdBuffer;
-
+	// the redundant copies of commands we already have are dropped
 	usercmd_t baseCmd = userCmdMgr.NewestUserCmdForPlayer( clientNum );
-	int curMilliseconds = baseCmd.clientGameMilliseconds;
-
-	const int numCmds = msg.ReadByte();
-
-	for ( int i = 0; i < numCmds; i++ ) {
-		usercmd_t newCmd;
-		newCmd.Serialize( ser, *base );
-		
-		lastCmd = newCmd;
-		base = &lastCmd;
-
-		int newMilliseconds = newCmd.clientGameMilliseconds;
-
-		if ( newMilliseconds > curMilliseconds ) {
-			if ( verify( i < NUM_USERCMD_RELAY ) ) {
-				newCmdBuffer.Append( newCmd );
-				gotNewCmd = true;
-				curMilliseconds = newMilliseconds;
-			}
-		}
-	}
+	usercmd_t newCmds[NUM_USERCMD_RELAY];
+	const int numNewCmds = ReadUsercmdBatch( msg, baseCmd.clientGameMilliseconds, newCmds, NUM_USERCMD_RELAY );
 	
 	// Push the commands into the buffer.
-	for ( int i = 0; i < newCmdBuffer.Num(); ++i ) {
-		userCmdMgr.PutUserCmdForPlayer( clientNum, newCmdBuffer[i] );
+	for ( int i = 0; i < numNewCmds; ++i ) {
+		userCmdMgr.PutUserCmdForPlayer( clientNum, newCmds[i] );
 	}
 }
 
@@ -1436,6 +1436,9 @@ bool idDeclAF::Parse( const char *text, const int textLength, bool allowBinaryVe
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	while( src.ReadToken( &token ) ) {
@@ -59,6 +59,9 @@ bool idDeclEntityDef::Parse( const char *text, const int textLength, bool allowB
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	while (1) {
@@ -414,6 +414,9 @@ bool idDeclFX::Parse( const char *text, const int textLength, bool allowBinaryVe
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	// scan through, identifying each individual parameter
@@ -64,6 +64,10 @@ missing reload over a previously explicit definition
 #define USE_COMPRESSED_DECLS
 //#define GET_HUFFMAN_FREQUENCIES
 
+// binary cache of the declarations found in a decl file, see idDeclFile::ReadCache
+static const byte BDECL_VERSION = 2;
+static const unsigned int BDECL_MAGIC = ( 'B' << 24 ) | ( 'D' << 16 ) | ( 'C' << 8 ) | BDECL_VERSION;
+
 class idDeclType {
 public:
 	idStr						typeName;
@@ -101,6 +105,7 @@ public:
 	virtual size_t				Size() const;
 	virtual void				GetText( char *text ) const;
 	virtual int					GetTextLength() const;
+	virtual const idTokenStream *GetTokenStream() const;
 	virtual void				SetText( const char *text );
 	virtual bool				ReplaceSourceFileText();
 	virtual bool				SourceFileChanged() const;
@@ -128,6 +133,8 @@ protected:
 
 								// Set textSource possible with compression.
 	void						SetTextLocal( const char *text, const int length );
+								// Set textSource that was already compressed, takes ownership of the text and the tokens.
+	void						SetCompressedTextLocal( char *compressedText, const int compressedLength, const int length, const int textChecksum, idTokenStream *tokens );
 
 private:
 	idDecl *					self;
@@ -136,6 +143,7 @@ private:
 	char *						textSource;				// decl text definition
 	int							textLength;				// length of textSource
 	int							compressedLength;		// compressed length
+	idTokenStream *				tokenStream;			// tokens of textSource read ahead of time until the first parse, may be NULL
 	idDeclFile *				sourceFile;				// source file in which the decl was defined
 	int							sourceTextOffset;		// offset in source file to decl text
 	int							sourceTextLength;		// length of decl text in source file
@@ -153,6 +161,34 @@ private:
 	idDeclLocal *				nextInFile;				// next decl in the decl file
 };
 
+// a declaration found while scanning a decl file, or a warning to issue at that point
+struct declScanEntry_t {
+	declType_t					type;					// DECL_MAX_TYPES for a warning
+	idStr						name;					// decl name or warning text
+	int							offset;
+	int							size;
+	int							line;
+	char *						compressedText;			// text as it is stored by SetTextLocal
+	int							compressedLength;
+	int							checksum;
+	idTokenStream *				tokens;					// tokens of the text, NULL if there is no cache to write them to
+};
+
+// everything LoadAndParse needs from a decl file that can be done off the main thread
+struct declFileScan_t {
+	idDeclFile *				file;
+	char *						buffer;
+	int							length;
+	ID_TIME_T					timestamp;
+	bool						parsed;					// false if the lexer couldn't take the text
+	int							checksum;
+	int							numLines;
+	idList< declScanEntry_t >	entries;
+	idFile *					cacheFile;				// binary cache read by Load, may be NULL
+	bool						useCache;				// the binary cache is read and written for this file
+	bool						fromCache;				// entries came from the cache instead of the lexer
+};
+
 class idDeclFile {
 public:
 								idDeclFile();
@@ -161,6 +197,16 @@ public:
 	void						Reload( bool force );
 	int							LoadAndParse();
 
+								// LoadAndParse split into steps, only Scan can run in parallel with other files
+	bool						Load( declFileScan_t &scan );
+	static void					Scan( declFileScan_t *scan );
+	int							Register( declFileScan_t &scan );
+
+private:
+	void						GetCacheFileName( idStrStatic< MAX_OSPATH > &cacheFileName ) const;
+	static bool					ReadCache( declFileScan_t *scan );
+	void						WriteCache( const declFileScan_t &scan ) const;
+
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -175,6 +221,7 @@ public:
 
 class idDeclManagerLocal : public idDeclManager {
 	friend class idDeclLocal;
+	friend class idDeclFile;
 
 public:
 	virtual void				Init();
@@ -242,7 +289,13 @@ private:
 	int							indent;			// for MediaPrint
 	bool						insideLevelLoad;
 
+	int							numDeclsParsed;	// decl bodies parsed since the level load started
+	uint64						parseTime;		// microseconds spent parsing them
+	int							numCachedFiles;	// decl files that didn't have to be scanned
+
 	static idCVar				decl_show;
+	static idCVar				decl_parallelScan;
+	static idCVar				decl_binaryCache;
 
 private:
 	static void					ListDecls_f( const idCmdArgs &args );
@@ -251,6 +304,8 @@ private:
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar idDeclManagerLocal::decl_binaryCache( "decl_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "read/write the declarations found in decl files from/to generated/decls/" );
+idCVar idDeclManagerLocal::decl_parallelScan( "decl_parallelScan", "1", CVAR_SYSTEM | CVAR_BOOL, "scan the files of a decl folder for declarations in parallel jobs" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager *		declManager = &declManagerLocal;
@@ -472,8 +527,6 @@ int HuffmanCompressText( const char *text, int textLength, byte *compressed, int
 	int i, j;
 	idBitMsg msg;
 
-	totalUncompressedLength += textLength;
-
 	msg.InitWrite( compressed, maxCompressedSize );
 	msg.BeginWriting();
 	for ( i = 0; i < textLength; i++ ) {
@@ -486,8 +539,6 @@ int HuffmanCompressText( const char *text, int textLength, byte *compressed, int
 		}
 	}
 
-	totalCompressedLength += msg.GetSize();
-
 	return msg.GetSize();
 }
 
@@ -611,41 +662,242 @@ This is used during both the initial load, and any reloads
 int c_savedMemory = 0;
 
 int idDeclFile::LoadAndParse() {
+	declFileScan_t scan;
+
+	if ( !Load( scan ) ) {
+		return 0;
+	}
+	Scan( &scan );
+	return Register( scan );
+}
+
+/*
+================
+idDeclFile::Load
+
+Reads the file text, this has to happen on the main thread
+================
+*/
+bool idDeclFile::Load( declFileScan_t &scan ) {
+	scan.file = this;
+	scan.buffer = NULL;
+	scan.parsed = false;
+	scan.checksum = 0;
+	scan.numLines = 0;
+	scan.entries.Clear();
+	scan.cacheFile = NULL;
+	scan.useCache = false;
+	scan.fromCache = false;
+
+	// load the text
+	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
+	scan.length = fileSystem->ReadFile( fileName, (void **)&scan.buffer, &scan.timestamp );
+	if ( scan.length == -1 ) {
+		common->FatalError( "couldn't load %s", fileName.c_str() );
+		return false;
+	}
+
+	// the cache is checked against the text checksum by Scan, it is never written for resource files
+	scan.useCache = idDeclManagerLocal::decl_binaryCache.GetBool() && !fileSystem->UsingResourceFiles();
+	if ( scan.useCache ) {
+		idStrStatic< MAX_OSPATH > cacheFileName;
+		GetCacheFileName( cacheFileName );
+		scan.cacheFile = fileSystem->OpenFileReadMemory( cacheFileName );
+	}
+	return true;
+}
+
+/*
+================
+idDeclFile::GetCacheFileName
+================
+*/
+void idDeclFile::GetCacheFileName( idStrStatic< MAX_OSPATH > &cacheFileName ) const {
+	cacheFileName = "generated/decls/";
+	cacheFileName.AppendPath( fileName );
+	cacheFileName.SetFileExtension( ".bdecl" );
+}
+
+/*
+================
+idDeclFile::ReadCache
+
+Fills in the entries from the binary cache if it was written for the
+same text, so the file doesn't need to be lexed or compressed again.
+The tokens of each decl are read as well, so parsing the decl doesn't
+need to lex its text either.
+================
+*/
+bool idDeclFile::ReadCache( declFileScan_t *scan ) {
+	idFile *file = scan->cacheFile;
+
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BDECL_MAGIC ) {
+		return false;
+	}
+
+	int loadedChecksum = 0;
+	int loadedLength = 0;
+	bool compressed = false;
+	file->ReadBig( loadedChecksum );
+	file->ReadBig( loadedLength );
+	file->ReadBig( compressed );
+#ifdef USE_COMPRESSED_DECLS
+	const bool expectCompressed = true;
+#else
+	const bool expectCompressed = false;
+#endif
+	if ( loadedChecksum != scan->checksum || loadedLength != scan->length || compressed != expectCompressed ) {
+		return false;
+	}
+
+	int numEntries = 0;
+	file->ReadBig( scan->numLines );
+	file->ReadBig( numEntries );
+	if ( numEntries < 0 || numEntries > scan->length ) {
+		return false;
+	}
+
+	scan->entries.SetNum( numEntries );
+	for ( int i = 0; i < numEntries; i++ ) {
+		scan->entries[i].compressedText = NULL;
+		scan->entries[i].tokens = NULL;
+	}
+	for ( int i = 0; i < numEntries; i++ ) {
+		declScanEntry_t &entry = scan->entries[i];
+		int type = 0;
+		file->ReadBig( type );
+		entry.type = (declType_t)type;
+		file->ReadString( entry.name );
+		file->ReadBig( entry.offset );
+		file->ReadBig( entry.size );
+		file->ReadBig( entry.line );
+		file->ReadBig( entry.checksum );
+		file->ReadBig( entry.compressedLength );
+		if ( type < 0 || type > DECL_MAX_TYPES || entry.offset < 0 || entry.size < 0 || entry.offset + entry.size > scan->length || entry.compressedLength < 0 ) {
+			break;
+		}
+		if ( entry.type == DECL_MAX_TYPES ) {
+			continue;
+		}
+#ifdef USE_COMPRESSED_DECLS
+		entry.compressedText = (char *)Mem_Alloc( entry.compressedLength, TAG_DECLTEXT );
+#else
+		entry.compressedText = (char *)Mem_Alloc( entry.compressedLength + 1, TAG_DECLTEXT );
+		entry.compressedText[entry.compressedLength] = '\0';
+#endif
+		if ( file->Read( entry.compressedText, entry.compressedLength ) != entry.compressedLength ) {
+			break;
+		}
+		bool hasTokens = false;
+		file->ReadBig( hasTokens );
+		if ( hasTokens ) {
+			entry.tokens = new (TAG_DECLTEXT) idTokenStream;
+			if ( !entry.tokens->ReadFromFileHandle( file ) || entry.tokens->GetLength() != entry.size ) {
+				break;
+			}
+		}
+	}
+
+	if ( file->Tell() != file->Length() ) {
+		// truncated or corrupt, throw away what was read and lex the text
+		for ( int i = 0; i < scan->entries.Num(); i++ ) {
+			Mem_Free( scan->entries[i].compressedText );
+			delete scan->entries[i].tokens;
+		}
+		scan->entries.Clear();
+		scan->numLines = 0;
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idDeclFile::WriteCache
+================
+*/
+void idDeclFile::WriteCache( const declFileScan_t &scan ) const {
+	idStrStatic< MAX_OSPATH > cacheFileName;
+	GetCacheFileName( cacheFileName );
+
+	idFileLocal file( fileSystem->OpenFileWrite( cacheFileName, "fs_basepath" ) );
+	if ( file == NULL ) {
+		return;
+	}
+	common->DPrintf( "Writing %s\n", cacheFileName.c_str() );
+
+#ifdef USE_COMPRESSED_DECLS
+	const bool compressed = true;
+#else
+	const bool compressed = false;
+#endif
+	file->WriteBig( BDECL_MAGIC );
+	file->WriteBig( scan.checksum );
+	file->WriteBig( scan.length );
+	file->WriteBig( compressed );
+	file->WriteBig( scan.numLines );
+	file->WriteBig( scan.entries.Num() );
+	for ( int i = 0; i < scan.entries.Num(); i++ ) {
+		const declScanEntry_t &entry = scan.entries[i];
+		file->WriteBig( (int)entry.type );
+		file->WriteString( entry.name );
+		file->WriteBig( entry.offset );
+		file->WriteBig( entry.size );
+		file->WriteBig( entry.line );
+		file->WriteBig( entry.checksum );
+		file->WriteBig( entry.compressedLength );
+		if ( entry.type != DECL_MAX_TYPES ) {
+			file->Write( entry.compressedText, entry.compressedLength );
+			file->WriteBig( entry.tokens != NULL );
+			if ( entry.tokens != NULL ) {
+				entry.tokens->WriteToFileHandle( file );
+			}
+		}
+	}
+}
+
+/*
+================
+idDeclFile::Scan
+
+Identifies each individual declaration in the file text, compresses
+its text and reads its tokens for the binary cache. Doesn't touch any decls, so the files of a folder can all be
+scanned at the same time. Warnings are recorded so Register can issue
+them in file order.
+================
+*/
+void idDeclFile::Scan( declFileScan_t *scan ) {
 	int			i, numTypes;
 	idLexer		src;
 	idToken		token;
 	int			startMarker;
-	char *		buffer;
-	int			length, size;
 	int			sourceLine;
-	idStr		name;
-	idDeclLocal *newDecl;
-	bool		reparse;
 
-	// load the text
-	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
-	length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
-	if ( length == -1 ) {
-		common->FatalError( "couldn't load %s", fileName.c_str() );
-		return 0;
-	}
+	scan->checksum = MD5_BlockChecksum( scan->buffer, scan->length );
 
-	if ( !src.LoadMemory( buffer, length, fileName ) ) {
-		common->Error( "Couldn't parse %s", fileName.c_str() );
-		Mem_Free( buffer );
-		return 0;
+	if ( scan->cacheFile != NULL && ReadCache( scan ) ) {
+		scan->parsed = true;
+		scan->fromCache = true;
+		return;
 	}
 
-	// mark all the defs that were from the last reload of this file
-	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
-		decl->redefinedInReload = false;
+	if ( !src.LoadMemory( scan->buffer, scan->length, scan->file->fileName ) ) {
+		return;
 	}
+	scan->parsed = true;
 
 	src.SetFlags( DECL_LEXER_FLAGS );
 
-	checksum = MD5_BlockChecksum( buffer, length );
-
-	fileSize = length;
+	declScanEntry_t warning;
+	warning.type = DECL_MAX_TYPES;
+	warning.offset = 0;
+	warning.size = 0;
+	warning.compressedText = NULL;
+	warning.compressedLength = 0;
+	warning.checksum = 0;
+	warning.tokens = NULL;
 
 	// scan through, identifying each individual declaration
 	while( 1 ) {
@@ -675,31 +927,39 @@ int idDeclFile::LoadAndParse() {
 			if ( token.Icmp( "{" ) == 0 ) {
 
 				// if we ever see an open brace, we somehow missed the [type] <name> prefix
-				src.Warning( "Missing decl name" );
+				warning.name = "Missing decl name";
+				warning.line = src.GetLineNum();
+				scan->entries.Append( warning );
 				src.SkipBracedSection( false );
 				continue;
 
 			} else {
 
-				if ( defaultType == DECL_MAX_TYPES ) {
-					src.Warning( "No type" );
+				if ( scan->file->defaultType == DECL_MAX_TYPES ) {
+					warning.name = "No type";
+					warning.line = src.GetLineNum();
+					scan->entries.Append( warning );
 					continue;
 				}
 				src.UnreadToken( &token );
 				// use the default type
-				identifiedType = defaultType;
+				identifiedType = scan->file->defaultType;
 			}
 		}
 
 		// now parse the name
 		if ( !src.ReadToken( &token ) ) {
-			src.Warning( "Type without definition at end of file" );
+			warning.name = "Type without definition at end of file";
+			warning.line = src.GetLineNum();
+			scan->entries.Append( warning );
 			break;
 		}
 
 		if ( !token.Icmp( "{" ) ) {
 			// if we ever see an open brace, we somehow missed the [type] <name> prefix
-			src.Warning( "Missing decl name" );
+			warning.name = "Missing decl name";
+			warning.line = src.GetLineNum();
+			scan->entries.Append( warning );
 			src.SkipBracedSection( false );
 			continue;
 		}
@@ -710,31 +970,118 @@ int idDeclFile::LoadAndParse() {
 			continue;
 		}
 
-		name = token;
+		declScanEntry_t &entry = scan->entries.Alloc();
+		entry.type = identifiedType;
+		entry.name = token;
+		entry.line = sourceLine;
+		entry.compressedText = NULL;
+		entry.tokens = NULL;
 
 		// make sure there's a '{'
 		if ( !src.ReadToken( &token ) ) {
-			src.Warning( "Type without definition at end of file" );
+			entry.type = DECL_MAX_TYPES;
+			entry.name = "Type without definition at end of file";
+			entry.line = src.GetLineNum();
 			break;
 		}
 		if ( token != "{" ) {
-			src.Warning( "Expecting '{' but found '%s'", token.c_str() );
+			entry.type = DECL_MAX_TYPES;
+			entry.name.Format( "Expecting '{' but found '%s'", token.c_str() );
+			entry.line = src.GetLineNum();
 			continue;
 		}
 		src.UnreadToken( &token );
 
 		// now take everything until a matched closing brace
 		src.SkipBracedSection();
-		size = src.GetFileOffset() - startMarker;
+		entry.offset = startMarker;
+		entry.size = src.GetFileOffset() - startMarker;
+
+		// compress the text here instead of in SetTextLocal
+		const char *text = scan->buffer + entry.offset;
+		entry.checksum = MD5_BlockChecksum( text, entry.size );
+#ifdef USE_COMPRESSED_DECLS
+		int maxBytesPerCode = ( maxHuffmanBits + 7 ) >> 3;
+		byte *compressed = (byte *)Mem_Alloc( entry.size * maxBytesPerCode, TAG_TEMP );
+		entry.compressedLength = HuffmanCompressText( text, entry.size, compressed, entry.size * maxBytesPerCode );
+		entry.compressedText = (char *)Mem_Alloc( entry.compressedLength, TAG_DECLTEXT );
+		memcpy( entry.compressedText, compressed, entry.compressedLength );
+		Mem_Free( compressed );
+#else
+		entry.compressedLength = entry.size;
+		entry.compressedText = (char *) Mem_Alloc( entry.size + 1, TAG_DECLTEXT );
+		memcpy( entry.compressedText, text, entry.size );
+		entry.compressedText[entry.size] = '\0';
+#endif
+
+		// the tokens are only kept if they can be read back from the cache
+		if ( scan->useCache ) {
+			entry.tokens = new (TAG_DECLTEXT) idTokenStream;
+			if ( !entry.tokens->Tokenize( text, entry.size, scan->file->fileName, DECL_LEXER_FLAGS, NULL, entry.line ) ) {
+				delete entry.tokens;
+				entry.tokens = NULL;
+			}
+		}
+	}
+
+	scan->numLines = src.GetLineNum();
+}
+
+/*
+================
+idDeclFile::Register
+
+Creates or updates the decls found by Scan in file order, so the
+result doesn't depend on how the scans were scheduled.
+================
+*/
+int idDeclFile::Register( declFileScan_t &scan ) {
+	idDeclLocal *newDecl;
+	bool		reparse;
+
+	delete scan.cacheFile;
+	scan.cacheFile = NULL;
+
+	if ( !scan.parsed ) {
+		common->Error( "Couldn't parse %s", fileName.c_str() );
+		Mem_Free( scan.buffer );
+		scan.buffer = NULL;
+		return 0;
+	}
+
+	timestamp = scan.timestamp;
+
+	// mark all the defs that were from the last reload of this file
+	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
+		decl->redefinedInReload = false;
+	}
+
+	checksum = scan.checksum;
+
+	fileSize = scan.length;
+
+	if ( scan.fromCache ) {
+		declManagerLocal.numCachedFiles++;
+	} else if ( scan.useCache ) {
+		WriteCache( scan );
+	}
+
+	for ( int i = 0; i < scan.entries.Num(); i++ ) {
+		declScanEntry_t &entry = scan.entries[i];
+
+		if ( entry.type == DECL_MAX_TYPES ) {
+			common->Warning( "file %s, line %d: %s", fileName.c_str(), entry.line, entry.name.c_str() );
+			continue;
+		}
 
 		// look it up, possibly getting a newly created default decl
 		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
+		newDecl = declManagerLocal.FindTypeWithoutParsing( entry.type, entry.name, false );
 		if ( newDecl ) {
 			// update the existing copy
 			if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-								name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+				common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), entry.line, declManagerLocal.GetDeclNameFromType( entry.type ),
+								entry.name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
 				continue;
 			}
 			if ( newDecl->declState != DS_UNPARSED ) {
@@ -742,23 +1089,20 @@ int idDeclFile::LoadAndParse() {
 			}
 		} else {
 			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
+			newDecl = declManagerLocal.FindTypeWithoutParsing( entry.type, entry.name, true );
 			newDecl->nextInFile = this->decls;
 			this->decls = newDecl;
 		}
 
 		newDecl->redefinedInReload = true;
 
-		if ( newDecl->textSource ) {
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
-		}
-
-		newDecl->SetTextLocal( buffer + startMarker, size );
+		newDecl->SetCompressedTextLocal( entry.compressedText, entry.compressedLength, entry.size, entry.checksum, entry.tokens );
+		entry.compressedText = NULL;
+		entry.tokens = NULL;
 		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
+		newDecl->sourceTextOffset = entry.offset;
+		newDecl->sourceTextLength = entry.size;
+		newDecl->sourceLine = entry.line;
 		newDecl->declState = DS_UNPARSED;
 
 		// if it is currently in use, reparse it immedaitely
@@ -767,9 +1111,17 @@ int idDeclFile::LoadAndParse() {
 		}
 	}
 
-	numLines = src.GetLineNum();
+	numLines = scan.numLines;
 
-	Mem_Free( buffer );
+	// free the text of decls that were skipped
+	for ( int i = 0; i < scan.entries.Num(); i++ ) {
+		Mem_Free( scan.entries[i].compressedText );
+		delete scan.entries[i].tokens;
+	}
+	scan.entries.Clear();
+
+	Mem_Free( scan.buffer );
+	scan.buffer = NULL;
 
 	// any defs that weren't redefinedInReload should now be defaulted
 	for ( idDeclLocal *decl = decls ; decl ; decl = decl->nextInFile ) {
@@ -804,6 +1156,9 @@ void idDeclManagerLocal::Init() {
 	common->Printf( "----- Initializing Decls -----\n" );
 
 	checksum = 0;
+	numDeclsParsed = 0;
+	parseTime = 0;
+	numCachedFiles = 0;
 
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
@@ -900,6 +1255,8 @@ void idDeclManagerLocal::Shutdown() {
 				Mem_Free( decl->textSource );
 				decl->textSource = NULL;
 			}
+			delete decl->tokenStream;
+			decl->tokenStream = NULL;
 			delete decl;
 		}
 		linearLists[i].Clear();
@@ -936,6 +1293,8 @@ idDeclManagerLocal::BeginLevelLoad
 */
 void idDeclManagerLocal::BeginLevelLoad() {
 	insideLevelLoad = true;
+	numDeclsParsed = 0;
+	parseTime = 0;
 
 	// clear all the referencedThisLevel flags and purge all the data
 	// so the next reference will cause a reparse
@@ -956,6 +1315,8 @@ idDeclManagerLocal::EndLevelLoad
 void idDeclManagerLocal::EndLevelLoad() {
 	insideLevelLoad = false;
 
+	common->Printf( "%d decls parsed during level load in %.1f msec\n", numDeclsParsed, parseTime * 0.001f );
+
 	// we don't need to do anything here, but the image manager, model manager,
 	// and sound sample manager will need to free media that was not referenced
 }
@@ -984,6 +1345,16 @@ void idDeclManagerLocal::RegisterDeclType( const char *typeName, declType_t type
 	declTypes[type] = declType;
 }
 
+/*
+===================
+DeclScanJob
+===================
+*/
+static void DeclScanJob( declFileScan_t *scan ) {
+	idDeclFile::Scan( scan );
+}
+REGISTER_PARALLEL_JOB( DeclScanJob, "DeclScanJob" );
+
 /*
 ===================
 idDeclManagerLocal::RegisterDeclFolder
@@ -1015,7 +1386,17 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 	// scan for decl files
 	fileList = fileSystem->ListFiles( declFolder->folder, declFolder->extension, true );
 
-	// load and parse decl files
+	const uint64 startTime = Sys_Microseconds();
+	int numDecls = 0;
+	const int startCachedFiles = numCachedFiles;
+	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
+		numDecls -= linearLists[i].Num();
+	}
+
+	idList< idDeclFile * > folderFiles;
+	folderFiles.Resize( fileList->GetNumFiles() );
+
+	// find or create the decl files
 	for ( i = 0; i < fileList->GetNumFiles(); i++ ) {
 		fileName = declFolder->folder + "/" + fileList->GetFile( i );
 
@@ -1031,8 +1412,41 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 			df = new (TAG_DECL) idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		folderFiles.Append( df );
+	}
+
+	const bool parallel = decl_parallelScan.GetBool() && folderFiles.Num() > 1;
+	if ( parallel ) {
+		// read the files, scan them in parallel, then register the decls in file order
+		idList< declFileScan_t > scans;
+		scans.SetNum( folderFiles.Num() );
+		idParallelJobList *jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, folderFiles.Num(), 0, NULL );
+		for ( i = 0; i < folderFiles.Num(); i++ ) {
+			if ( folderFiles[i]->Load( scans[i] ) ) {
+				jobList->AddJob( (jobRun_t)DeclScanJob, &scans[i] );
+			}
+		}
+		jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+
+		for ( i = 0; i < folderFiles.Num(); i++ ) {
+			if ( scans[i].buffer != NULL ) {
+				folderFiles[i]->Register( scans[i] );
+			}
+		}
+	} else {
+		// load and parse decl files
+		for ( i = 0; i < folderFiles.Num(); i++ ) {
+			folderFiles[i]->LoadAndParse();
+		}
+	}
+
+	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
+		numDecls += linearLists[i].Num();
 	}
+	common->Printf( "%5d decls from %3d %s/*%s files (%d cached) in %5.1f msec (%s)\n", numDecls, folderFiles.Num(), declFolder->folder.c_str(), declFolder->extension.c_str(),
+					numCachedFiles - startCachedFiles, ( Sys_Microseconds() - startTime ) * 0.001f, parallel ? "parallel" : "serial" );
 
 	fileSystem->FreeFileList( fileList );
 }
@@ -1965,6 +2379,7 @@ idDeclLocal::idDeclLocal() {
 	textSource = NULL;
 	textLength = 0;
 	compressedLength = 0;
+	tokenStream = NULL;
 	sourceFile = NULL;
 	sourceTextOffset = 0;
 	sourceTextLength = 0;
@@ -2078,7 +2493,7 @@ idDeclLocal::Size
 =================
 */
 size_t idDeclLocal::Size() const {
-	return sizeof( idDecl ) + name.Allocated();
+	return sizeof( idDecl ) + name.Allocated() + ( ( tokenStream != NULL ) ? sizeof( idTokenStream ) + tokenStream->Allocated() : 0 );
 }
 
 /*
@@ -2103,6 +2518,15 @@ int idDeclLocal::GetTextLength() const {
 	return textLength;
 }
 
+/*
+=================
+idDeclLocal::GetTokenStream
+=================
+*/
+const idTokenStream *idDeclLocal::GetTokenStream() const {
+	return tokenStream;
+}
+
 /*
 =================
 idDeclLocal::SetText
@@ -2121,6 +2545,9 @@ void idDeclLocal::SetTextLocal( const char *text, const int length ) {
 
 	Mem_Free( textSource );
 
+	delete tokenStream;
+	tokenStream = NULL;
+
 	checksum = MD5_BlockChecksum( text, length );
 
 #ifdef GET_HUFFMAN_FREQUENCIES
@@ -2135,6 +2562,8 @@ void idDeclLocal::SetTextLocal( const char *text, const int length ) {
 	compressedLength = HuffmanCompressText( text, length, compressed, length * maxBytesPerCode );
 	textSource = (char *)Mem_Alloc( compressedLength, TAG_DECLTEXT );
 	memcpy( textSource, compressed, compressedLength );
+	totalUncompressedLength += length;
+	totalCompressedLength += compressedLength;
 #else
 	compressedLength = length;
 	textSource = (char *) Mem_Alloc( length + 1, TAG_DECLTEXT );
@@ -2144,6 +2573,29 @@ void idDeclLocal::SetTextLocal( const char *text, const int length ) {
 	textLength = length;
 }
 
+/*
+=================
+idDeclLocal::SetCompressedTextLocal
+=================
+*/
+void idDeclLocal::SetCompressedTextLocal( char *compressedText, const int compressedLength, const int length, const int textChecksum, idTokenStream *tokens ) {
+
+	Mem_Free( textSource );
+
+	delete tokenStream;
+	tokenStream = tokens;
+
+	checksum = textChecksum;
+	textSource = compressedText;
+	this->compressedLength = compressedLength;
+	textLength = length;
+
+#ifdef USE_COMPRESSED_DECLS
+	totalUncompressedLength += length;
+	totalCompressedLength += compressedLength;
+#endif
+}
+
 /*
 =================
 idDeclLocal::ReplaceSourceFileText
@@ -2306,6 +2758,9 @@ bool idDeclLocal::Parse( const char *text, const int textLength, bool allowBinar
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 	src.SkipBracedSection( false );
 	return true;
@@ -2389,10 +2844,19 @@ void idDeclLocal::ParseLocal() {
 
 	declState = DS_PARSED;
 
-	// parse
+	// parse, nested decls are counted with their parent
+	const uint64 startTime = Sys_Microseconds();
 	char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
 	GetText( declText );
 	self->Parse( declText, GetTextLength(), true );
+	if ( declManagerLocal.indent == 1 ) {
+		declManagerLocal.parseTime += Sys_Microseconds() - startTime;
+	}
+	declManagerLocal.numDeclsParsed++;
+
+	// the tokens only speed up the first parse, a reparse lexes the text again
+	delete tokenStream;
+	tokenStream = NULL;
 
 	// free generated text
 	if ( generatedDefaultText ) {
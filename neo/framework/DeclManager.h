@@ -114,6 +114,7 @@ public:
 	virtual const char *	GetFileName() const = 0;
 	virtual void			GetText( char *text ) const = 0;
 	virtual int				GetTextLength() const = 0;
+	virtual const idTokenStream *GetTokenStream() const = 0;
 	virtual void			SetText( const char *text ) = 0;
 	virtual bool			ReplaceSourceFileText() = 0;
 	virtual bool			SourceFileChanged() const = 0;
@@ -176,6 +177,10 @@ public:
 							// Returns the length of the decl text.
 	int						GetTextLength() const { return base->GetTextLength(); }
 
+							// Returns the tokens of the decl text read ahead of time, may be NULL.
+							// Pass it to idLexer::SetTokenStream after loading the text with DECL_LEXER_FLAGS.
+	const idTokenStream *	GetTokenStream() const { return base->GetTokenStream(); }
+
 							// Sets new decl text.
 	void					SetText( const char *text ) { base->SetText( text ); }
 
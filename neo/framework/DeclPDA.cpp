@@ -71,6 +71,9 @@ bool idDeclPDA::Parse( const char *text, const int textLength, bool allowBinaryV
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	// scan through, identifying each individual parameter
@@ -455,6 +455,9 @@ bool idDeclParticle::Parse( const char *text, const int textLength, bool allowBi
 	
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	depthHack = 0.0f;
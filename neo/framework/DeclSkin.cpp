@@ -59,6 +59,9 @@ bool idDeclSkin::Parse( const char *text, const int textLength, bool allowBinary
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	associatedModels.Clear();
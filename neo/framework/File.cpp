@@ -1711,6 +1711,153 @@ int idFile_InnerResource::Seek( long offset, fsOrigin_t origin ) {
 }
 #endif
 
+/*
+=================================================================================
+
+idFile_Mapped
+
+=================================================================================
+*/
+
+/*
+=================
+idFile_Mapped::idFile_Mapped
+=================
+*/
+idFile_Mapped::idFile_Mapped() {
+	memset( &mapping, 0, sizeof( mapping ) );
+	filePos = 0;
+	numRefs.SetValue( 1 );
+}
+
+/*
+=================
+idFile_Mapped::~idFile_Mapped
+=================
+*/
+idFile_Mapped::~idFile_Mapped() {
+	assert( numRefs.GetValue() == 0 );
+	Sys_UnmapFile( mapping );
+}
+
+/*
+=================
+idFile_Mapped::Release
+=================
+*/
+void idFile_Mapped::Release() {
+	if ( numRefs.Decrement() == 0 ) {
+		delete this;
+	}
+}
+
+/*
+=================
+idFile_Mapped::Open
+=================
+*/
+bool idFile_Mapped::Open( const char *_name, const char *_fullPath ) {
+	name = _name;
+	fullPath = _fullPath;
+	filePos = 0;
+
+	if ( !Sys_MapFile( fullPath, mapping ) ) {
+		return false;
+	}
+	// resource offsets are 32 bit
+	if ( mapping.length > INT_MAX ) {
+		Sys_UnmapFile( mapping );
+		return false;
+	}
+	return true;
+}
+
+/*
+=================
+idFile_Mapped::Read
+
+Properly handles partial reads
+=================
+*/
+int idFile_Mapped::Read( void *buffer, size_t len ) {
+	if ( mapping.data == NULL ) {
+		return 0;
+	}
+	if ( filePos + len > (size_t)mapping.length ) {
+		len = static_cast<size_t>( mapping.length - filePos );
+	}
+	memcpy( buffer, GetDataPtr() + filePos, len );
+	filePos += static_cast<int>( len );
+	return static_cast<int>( len );
+}
+
+/*
+=================
+idFile_Mapped::Seek
+
+  returns zero on success and -1 on failure
+=================
+*/
+int idFile_Mapped::Seek( long offset, fsOrigin_t origin ) {
+	long pos;
+
+	switch( origin ) {
+		case FS_SEEK_END: {
+			pos = static_cast<long>( mapping.length ) - offset;
+			break;
+		}
+		case FS_SEEK_SET: {
+			pos = offset;
+			break;
+		}
+		case FS_SEEK_CUR: {
+			pos = filePos + offset;
+			break;
+		}
+		default: {
+			common->FatalError( "idFile_Mapped::Seek: bad origin for %s\n", name.c_str() );
+			return -1;
+		}
+	}
+	if ( pos < 0 || pos > mapping.length ) {
+		return -1;
+	}
+	filePos = pos;
+	return 0;
+}
+
+/*
+=================
+idFile_Mapped::OpenView
+=================
+*/
+idFile *idFile_Mapped::OpenView( const char *viewName, int offset, int length ) {
+	if ( mapping.data == NULL || offset < 0 || length < 0 || (int64)offset + length > mapping.length ) {
+		return NULL;
+	}
+	return new (TAG_IDFILE) idFile_MappedView( viewName, this, offset, length );
+}
+
+/*
+=================
+idFile_MappedView::idFile_MappedView
+=================
+*/
+idFile_MappedView::idFile_MappedView( const char *name, idFile_Mapped *mappedFile, int offset, int length ) :
+	idFile_Memory( name, reinterpret_cast< const char * >( mappedFile->GetDataPtr() + offset ), length ) {
+	this->mappedFile = mappedFile;
+	mappedFile->numRefs.Increment();
+}
+
+/*
+=================
+idFile_MappedView::~idFile_MappedView
+=================
+*/
+idFile_MappedView::~idFile_MappedView() {
+	mappedFile->Release();
+}
+
 /*
 ================================================================================================
 
@@ -338,6 +338,62 @@ private:
 	byte *				resourceBuffer;		// if using the temp save memory
 };
 #endif
+
+/*
+================================================
+idFile_Mapped maps a whole file read only into memory. Reading copies
+from the mapping, while views hand out a range of the file without any
+copy. The owner and every open view hold a reference, so the mapping
+stays valid until both the owner has called Release and the last view
+is closed. It must never be deleted directly.
+================================================
+*/
+class idFile_Mapped : public idFile {
+	friend class			idFileSystemLocal;
+	friend class			idFile_MappedView;
+
+public:
+							idFile_Mapped();
+
+							// map the file at the OS path, returns false if the file can't be mapped
+	bool					Open( const char *name, const char *fullPath );
+
+	virtual const char *	GetName() const { return name.c_str(); }
+	virtual const char *	GetFullPath() const { return fullPath.c_str(); }
+	virtual int				Read( void *buffer, size_t len );
+	virtual int				Write( const void *buffer, size_t len ) { assert( false ); return 0; }
+	virtual int				Length() const { return static_cast<int>( mapping.length ); }
+	virtual ID_TIME_T		Timestamp() const { return 0; }
+	virtual int				Tell() const { return filePos; }
+	virtual int				Seek( long offset, fsOrigin_t origin );
+
+							// returns a pointer to the start of the mapped file
+	const byte *			GetDataPtr() const { return static_cast< const byte * >( mapping.data ); }
+							// returns a read only file for a range of the mapped file without copying the data
+	idFile *				OpenView( const char *name, int offset, int length );
+	int						NumOpenViews() const { return numRefs.GetValue() - 1; }
+
+							// drops a reference, the file is unmapped and deleted with the last one
+	void					Release();
+
+private:
+	virtual					~idFile_Mapped();
+
+	idStr					name;			// relative path of the file
+	idStr					fullPath;		// OS path of the file
+	sysMappedFile_t			mapping;		// platform mapping of the file
+	int						filePos;		// read offset
+	idSysInterlockedInteger	numRefs;		// the owner plus the views still open on the mapping
+};
+
+class idFile_MappedView : public idFile_Memory {
+public:
+							idFile_MappedView( const char *name, idFile_Mapped *mappedFile, int offset, int length );
+	virtual					~idFile_MappedView();
+
+private:
+	idFile_Mapped *			mappedFile;		// file the view points into
+};
 /*
 ================================================
 idFileLocal is a FileStream wrapper that automatically closes a file when the 
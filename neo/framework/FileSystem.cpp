@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "Unzip.h"
 #include "Zip.h"
+#include "File_AsyncRead.h"
 
 #ifdef WIN32
 	#include <io.h>	// for _read
@@ -181,7 +182,12 @@ public:
 	virtual void			StopPreload();
 	idFile *				GetResourceFile( const char *fileName, bool memFile );
 	bool					GetResourceCacheEntry( const char *fileName, idResourceCacheEntry &rc );
+	void					BuildResourceIndex();
 	virtual int				ReadFromBGL( idFile *_resourceFile, void * _buffer, int _offset, int _len );
+	virtual asyncReadHandle_t	QueueAsyncRead( const char *relativePath, asyncReadPriority_t priority, asyncReadCallback_t callback, void *userData );
+	virtual bool			CancelAsyncRead( asyncReadHandle_t handle ) { return asyncReads.Cancel( handle ); }
+	virtual void			DispatchAsyncReads() { asyncReads.Dispatch(); }
+	virtual void			WaitForAsyncReads() { asyncReads.WaitForAll(); }
 	virtual bool			IsBinaryModel( const idStr & resName ) const;
 	virtual bool			IsSoundSample( const idStr & resName ) const;
 	virtual void			FreeResourceBuffer() { resourceBufferAvailable = resourceBufferSize; }
@@ -215,6 +221,7 @@ public:
 	static void				ExtractResourceFile_f( const idCmdArgs &args );
 	static void				UpdateResourceFile_f( const idCmdArgs &args );
 	static void				GenerateResourceCRCs_f( const idCmdArgs &args );
+	static void				ResourceStats_f( const idCmdArgs &args );
 	static void				CreateCRCsForResourceFileList( const idFileList & list );
 
 	void					BuildOrderedStartupContainer();
@@ -243,6 +250,33 @@ private:
 	int		resourceBufferAvailable;
 	int		numFilesOpenedAsCached;
 
+	// resource reads during the current level load
+	int		levelLoadStartTime;
+	int64	levelLoadStartWorkingSet;
+	int		numResourcesMapped;		// resources handed out as views into a mapped container
+	int64	numResourceBytesMapped;
+	int		numResourcesCopied;		// resources read into a memory buffer
+	int64	numResourceBytesCopied;
+
+	// merged lookup over all the resource containers, newer containers shadow older ones
+	struct resourceIndexSlot_t {
+		uint64	hash;				// 0 for an empty slot
+		int		containerIndex;
+		int		entryIndex;			// into the container cacheTable
+	};
+	idList< resourceIndexSlot_t >	resourceIndex;	// open addressed, power of two size
+	int		resourceIndexEntries;
+	int		resourceIndexShadowed;	// entries hidden by the same file in a newer container
+	int		resourceIndexMaxProbe;	// longest probe sequence, lookups never go further
+
+	// resource lookups since the start of the current level load, can be hit from any thread
+	idSysInterlockedInteger	numResourceLookups;
+	idSysInterlockedInteger	numResourceLookupHits;
+	idSysInterlockedInteger	resourceLookupMicroseconds;
+
+	idAsyncReadQueue		asyncReads;
+	idList< asyncReadHandle_t >	preloadHandles;	// reads queued by StartPreload
+
 private:
 
 	// .resource file creation
@@ -305,12 +339,65 @@ int idFileSystemLocal::ReadFromBGL( idFile *_resourceFile, void * _buffer, int _
 	return _resourceFile->Read( _buffer, _len );
 }
 
+/*
+================
+idFileSystemLocal::QueueAsyncRead
+
+The file is looked up here, so the I/O thread only ever deals with
+an OS path and a range.
+================
+*/
+asyncReadHandle_t idFileSystemLocal::QueueAsyncRead( const char *relativePath, asyncReadPriority_t priority, asyncReadCallback_t callback, void *userData ) {
+	asyncReadRequest_t *request = new (TAG_IDFILE) asyncReadRequest_t;
+	request->priority = priority;
+	request->fileName = relativePath;
+	request->offset = 0;
+	request->length = 0;
+	request->mappedData = NULL;
+	request->callback = callback;
+	request->userData = userData;
+	request->failed = true;
+
+	idResourceCacheEntry rc;
+	if ( resourceFiles.Num() > 0 && GetResourceCacheEntry( relativePath, rc ) ) {
+		const idResourceContainer *container = resourceFiles[ rc.containerIndex ];
+		request->osPath = container->resourceFile->GetFullPath();
+		request->offset = rc.offset;
+		request->length = rc.length;
+		if ( container->mappedFile != NULL ) {
+			request->mappedData = container->mappedFile->GetDataPtr() + rc.offset;
+			request->failed = false;
+		} else {
+			// _ordered.resources is read into memory when it isn't mapped, there is no OS file to read from
+			request->failed = ( idStr::Icmp( container->fileName, "_ordered.resources" ) == 0 );
+		}
+	} else {
+		idFile *f = OpenFileRead( relativePath, false );
+		if ( f != NULL ) {
+			request->osPath = f->GetFullPath();
+			request->length = f->Length();
+			request->failed = false;
+			delete f;
+		}
+	}
+
+	return asyncReads.Queue( request );
+}
+
 /*
 ================
 idFileSystemLocal::StartPreload
+
+Reads the files ahead of the loaders on the I/O thread. OpenFileRead
+hands out the data of a finished preload instead of reading the file
+again, and waits for a preload that is still queued. Preloads in mapped
+containers only touch the pages, the open returns a view of the mapping.
 ================
 */
 void idFileSystemLocal::StartPreload( const idStrList & _preload ) {
+	for ( int i = 0; i < _preload.Num(); i++ ) {
+		preloadHandles.Append( QueueAsyncRead( _preload[ i ], ASYNC_READ_PRIORITY_LOW, NULL, NULL ) );
+	}
 }
 
 /*
@@ -319,6 +406,12 @@ idFileSystemLocal::StopPreload
 ================
 */
 void idFileSystemLocal::StopPreload() {
+	for ( int i = 0; i < preloadHandles.Num(); i++ ) {
+		asyncReads.Cancel( preloadHandles[ i ] );
+	}
+	preloadHandles.Clear();
+	asyncReads.WaitForAll();
+	asyncReads.DropPreloaded();
 }
 
 /*
@@ -333,6 +426,15 @@ idFileSystemLocal::idFileSystemLocal() {
 	resourceBufferSize = 0;
 	resourceBufferAvailable = 0;
 	numFilesOpenedAsCached = 0;
+	levelLoadStartTime = 0;
+	levelLoadStartWorkingSet = 0;
+	numResourcesMapped = 0;
+	numResourceBytesMapped = 0;
+	numResourcesCopied = 0;
+	numResourceBytesCopied = 0;
+	resourceIndexEntries = 0;
+	resourceIndexShadowed = 0;
+	resourceIndexMaxProbe = 0;
 }
 
 /*
@@ -526,6 +628,18 @@ void idFileSystemLocal::BeginLevelLoad( const char *name, char *_blockBuffer, in
 	fileManifest.Clear();
 	preloadList.Clear();
 
+	levelLoadStartTime = Sys_Milliseconds();
+	int64 peakWorkingSet = 0;
+	Sys_GetWorkingSetSize( levelLoadStartWorkingSet, peakWorkingSet );
+	numResourcesMapped = 0;
+	numResourceBytesMapped = 0;
+	numResourcesCopied = 0;
+	numResourceBytesCopied = 0;
+	numResourceLookups.SetValue( 0 );
+	numResourceLookupHits.SetValue( 0 );
+	resourceLookupMicroseconds.SetValue( 0 );
+	asyncReads.ClearStats();
+
 	EnableBackgroundCache( false );
 
 	ReOpenCacheFiles();
@@ -602,6 +716,19 @@ void idFileSystemLocal::EndLevelLoad() {
 
 	EnableBackgroundCache( true );
 
+	// anything the loaders didn't get to is no longer needed
+	StopPreload();
+
+	if ( fs_debugResources.GetBool() ) {
+		int64 workingSet = 0;
+		int64 peakWorkingSet = 0;
+		Sys_GetWorkingSetSize( workingSet, peakWorkingSet );
+		idLib::Printf( "RES: working set %d MB at the start, %d MB at the end, %d MB peak\n", (int)( levelLoadStartWorkingSet >> 20 ), (int)( workingSet >> 20 ), (int)( peakWorkingSet >> 20 ) );
+		idLib::Printf( "RES: level load took %d ms, %d resources mapped (%d KB), %d resources copied (%d KB)\n", Sys_Milliseconds() - levelLoadStartTime,
+						numResourcesMapped, (int)( numResourceBytesMapped >> 10 ), numResourcesCopied, (int)( numResourceBytesCopied >> 10 ) );
+		asyncReads.PrintStats();
+	}
+
 	resourceBufferPtr = NULL;
 	resourceBufferAvailable = 0;
 	resourceBufferSize = 0;
@@ -1606,7 +1733,7 @@ int idFileSystemLocal::ReadFile( const char *relativePath, void **buffer, ID_TIM
 	} 
 
 	if ( buffer == NULL && timestamp != NULL && resourceFiles.Num() > 0 ) {
-		static idResourceCacheEntry rc;
+		idResourceCacheEntry rc;
 		int size = 0;
 		if ( GetResourceCacheEntry( relativePath, rc ) ) {
 			*timestamp = 0;
@@ -2200,6 +2327,30 @@ void idFileSystemLocal::Path_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+============
+idFileSystemLocal::ResourceStats_f
+============
+*/
+void idFileSystemLocal::ResourceStats_f( const idCmdArgs &args ) {
+	int numEntries = 0;
+	for ( int i = 0; i < fileSystemLocal.resourceFiles.Num(); i++ ) {
+		numEntries += fileSystemLocal.resourceFiles[ i ]->cacheTable.Num();
+		common->Printf( "%5d entries in %s\n", fileSystemLocal.resourceFiles[ i ]->cacheTable.Num(), fileSystemLocal.resourceFiles[ i ]->GetFileName() );
+	}
+	const int tableSize = fileSystemLocal.resourceIndex.Num();
+	common->Printf( "%d containers, %d entries, %d unique, %d shadowed\n", fileSystemLocal.resourceFiles.Num(), numEntries, fileSystemLocal.resourceIndexEntries, fileSystemLocal.resourceIndexShadowed );
+	common->Printf( "index: %d slots (%d KB), load %.2f, max probe %d\n", tableSize, (int)( tableSize * sizeof( resourceIndexSlot_t ) ) >> 10,
+					tableSize > 0 ? (float)fileSystemLocal.resourceIndexEntries / tableSize : 0.0f, fileSystemLocal.resourceIndexMaxProbe );
+
+	const int lookups = fileSystemLocal.numResourceLookups.GetValue();
+	const int hits = fileSystemLocal.numResourceLookupHits.GetValue();
+	const int usec = fileSystemLocal.resourceLookupMicroseconds.GetValue();
+	common->Printf( "level load: %d lookups, %d hits, %d misses, %d usec total, %.3f usec per lookup\n", lookups, hits, lookups - hits, usec, lookups > 0 ? (float)usec / lookups : 0.0f );
+
+	fileSystemLocal.asyncReads.PrintStats();
+}
+
 /*
 ============
 idFileSystemLocal::TouchFile_f
@@ -2362,6 +2513,7 @@ int idFileSystemLocal::AddResourceFile( const char * resourceFileName ) {
 	idResourceContainer *rc = new idResourceContainer();
 	if ( rc->Init( resourceFile, resourceFiles.Num() ) ) {
 		resourceFiles.Append( rc );
+		BuildResourceIndex();
 		common->Printf( "Loaded resource file %s\n", resourceFile.c_str() );
 		return resourceFiles.Num() - 1;
 	} 
@@ -2389,12 +2541,15 @@ idFileSystemLocal::RemoveResourceFileByIndex
 void idFileSystemLocal::RemoveResourceFileByIndex( const int &idx ) {
 	if ( idx >= 0 && idx < resourceFiles.Num() ) {
 		if ( idx >= 0 && idx < resourceFiles.Num() ) {
+			// queued reads may point into the container
+			asyncReads.WaitForAll();
 			delete resourceFiles[ idx ];
 			resourceFiles.RemoveIndex( idx );
 			for ( int i = 0; i < resourceFiles.Num(); i++ ) {
 				// fixup any container indexes
 				resourceFiles[ i ]->SetContainerIndex( i );
 			}
+			BuildResourceIndex();
 		}
 	}
 }
@@ -2464,6 +2619,7 @@ void idFileSystemLocal::AddGameDirectory( const char *path, const char *dir ) {
 				//com_productionMode.SetInteger( 2 );
 			}
 		}
+		BuildResourceIndex();
 	}
 }
 
@@ -2575,6 +2731,9 @@ void idFileSystemLocal::Startup() {
 	cmdSystem->AddCommand( "updateResourceFile", UpdateResourceFile_f, CMD_FL_SYSTEM, "updates or appends the supplied files in the supplied resource file" );
 
 	cmdSystem->AddCommand( "generateResourceCRCs", GenerateResourceCRCs_f, CMD_FL_SYSTEM, "Generates CRC checksums for all the resource files." );
+	cmdSystem->AddCommand( "fs_resourceStats", ResourceStats_f, CMD_FL_SYSTEM, "prints the resource index, lookup and async read stats for the current level load" );
+
+	asyncReads.Init();
 
 	// print the current search paths
 	Path_f( idCmdArgs() );
@@ -2651,13 +2810,17 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 	gameFolder.Clear();
 	searchPaths.Clear();
 
-	resourceFiles.DeleteContents();
+	preloadHandles.Clear();
+	asyncReads.Shutdown();
 
+	resourceFiles.DeleteContents();
+	BuildResourceIndex();
 
 	cmdSystem->RemoveCommand( "path" );
 	cmdSystem->RemoveCommand( "dir" );
 	cmdSystem->RemoveCommand( "dirtree" );
 	cmdSystem->RemoveCommand( "touchFile" );
+	cmdSystem->RemoveCommand( "fs_resourceStats" );
 }
 
 /*
@@ -2678,6 +2841,87 @@ Opening files
 =================================================================================
 */
 
+/*
+========================
+ResourcePathHash
+
+64 bit FNV-1a of the canonical path, lower case with forward slashes,
+so the path doesn't need to be copied and converted before the lookup.
+Never returns 0, which marks an empty index slot.
+========================
+*/
+static uint64 ResourcePathHash( const char *path ) {
+	uint64 hash = 0xcbf29ce484222325ULL;
+	for ( const char *s = path; *s != '\0'; s++ ) {
+		int c = *s;
+		if ( c == '\\' ) {
+			c = '/';
+		} else if ( c >= 'A' && c <= 'Z' ) {
+			c += 'a' - 'A';
+		}
+		hash ^= (uint64)c;
+		hash *= 0x100000001b3ULL;
+	}
+	return ( hash != 0 ) ? hash : 1;
+}
+
+/*
+========================
+idFileSystemLocal::BuildResourceIndex
+
+Merges the cache tables of all the resource containers into a single
+open addressed table. Called whenever a container is added or removed.
+========================
+*/
+void idFileSystemLocal::BuildResourceIndex() {
+	int numEntries = 0;
+	for ( int i = 0; i < resourceFiles.Num(); i++ ) {
+		numEntries += resourceFiles[ i ]->cacheTable.Num();
+	}
+
+	resourceIndex.Clear();
+	resourceIndexEntries = 0;
+	resourceIndexShadowed = 0;
+	resourceIndexMaxProbe = 0;
+	if ( numEntries == 0 ) {
+		return;
+	}
+
+	// keep the load factor at or under 0.5 so probe sequences stay short
+	const int size = idMath::CeilPowerOfTwo( numEntries * 2 );
+	const int mask = size - 1;
+	resourceIndex.SetNum( size );
+	memset( resourceIndex.Ptr(), 0, size * sizeof( resourceIndexSlot_t ) );
+
+	// insert newest first so the first entry for a path is the one that is used, inside
+	// a container the last entry for a path wins, as it did with the per container hash
+	for ( int idx = resourceFiles.Num() - 1; idx >= 0; idx-- ) {
+		const idList< idResourceCacheEntry > &cacheTable = resourceFiles[ idx ]->cacheTable;
+		for ( int i = cacheTable.Num() - 1; i >= 0; i-- ) {
+			const uint64 hash = ResourcePathHash( cacheTable[ i ].filename );
+			int slot = (int)( hash & mask );
+			int probe = 0;
+			bool shadowed = false;
+			for ( ; resourceIndex[ slot ].hash != 0; slot = ( slot + 1 ) & mask, probe++ ) {
+				const resourceIndexSlot_t &other = resourceIndex[ slot ];
+				if ( other.hash == hash && idStr::Icmp( resourceFiles[ other.containerIndex ]->cacheTable[ other.entryIndex ].filename, cacheTable[ i ].filename ) == 0 ) {
+					shadowed = true;
+					break;
+				}
+			}
+			if ( shadowed ) {
+				resourceIndexShadowed++;
+				continue;
+			}
+			resourceIndex[ slot ].hash = hash;
+			resourceIndex[ slot ].containerIndex = idx;
+			resourceIndex[ slot ].entryIndex = i;
+			resourceIndexEntries++;
+			resourceIndexMaxProbe = Max( resourceIndexMaxProbe, probe );
+		}
+	}
+}
+
 /*
 ========================
 idFileSystemLocal::GetResourceCacheEntry
@@ -2686,33 +2930,43 @@ Returns false if the entry isn't found
 ========================
 */
 bool idFileSystemLocal::GetResourceCacheEntry( const char *fileName, idResourceCacheEntry &rc ) {
-	idStrStatic< MAX_OSPATH > canonical;
 	if ( strstr( fileName, ":") != NULL ) {
 		// os path, convert to relative? scripts can pass in an OS path
 		//idLib::Printf( "RESOURCE: os path passed %s\n", fileName );
-		return NULL;
-	} else {
-		canonical = fileName;
-	}
-
-	canonical.BackSlashesToSlashes();
-	canonical.ToLower();
-	int idx = resourceFiles.Num() - 1;
-	while ( idx >= 0 ) {
-		const int key = resourceFiles[ idx ]->cacheHash.GenerateKey( canonical, false );
-		for ( int index = resourceFiles[ idx ]->cacheHash.GetFirst( key ); index != idHashIndex::NULL_INDEX; index = resourceFiles[ idx ]->cacheHash.GetNext( index ) ) {
-			idResourceCacheEntry & rt = resourceFiles[ idx ]->cacheTable[ index ];
-			if ( idStr::Icmp( rt.filename, canonical ) == 0 ) {
-				rc.filename = rt.filename;
-				rc.length = rt.length;
-				rc.containerIndex = idx;
-				rc.offset = rt.offset;
-				return true;
-			}
+		return false;
+	}
+	if ( resourceIndex.Num() == 0 ) {
+		return false;
+	}
+
+	const uint64 startTime = Sys_Microseconds();
+	numResourceLookups.Increment();
+
+	const int mask = resourceIndex.Num() - 1;
+	const uint64 hash = ResourcePathHash( fileName );
+	int slot = (int)( hash & mask );
+	bool found = false;
+	for ( int probe = 0; probe <= resourceIndexMaxProbe && resourceIndex[ slot ].hash != 0; probe++, slot = ( slot + 1 ) & mask ) {
+		const resourceIndexSlot_t &entry = resourceIndex[ slot ];
+		if ( entry.hash != hash ) {
+			continue;
+		}
+		const idResourceCacheEntry &rt = resourceFiles[ entry.containerIndex ]->cacheTable[ entry.entryIndex ];
+		if ( idStr::IcmpPath( rt.filename, fileName ) == 0 ) {
+			rc.filename = rt.filename;
+			rc.length = rt.length;
+			rc.containerIndex = entry.containerIndex;
+			rc.offset = rt.offset;
+			found = true;
+			break;
 		}
-		idx--;
 	}
-	return false;
+
+	if ( found ) {
+		numResourceLookupHits.Increment();
+	}
+	resourceLookupMicroseconds.Add( (int)( Sys_Microseconds() - startTime ) );
+	return found;
 }
 
 /*
@@ -2729,11 +2983,21 @@ idFile * idFileSystemLocal::GetResourceFile( const char *fileName, bool memFile
 		return NULL;
 	}
 
-	static idResourceCacheEntry rc;
+	idResourceCacheEntry rc;
 	if ( GetResourceCacheEntry( fileName, rc ) ) {
 		if ( fs_debugResources.GetBool() ) {
 			idLib::Printf( "RES: loading file %s\n", rc.filename.c_str() );
 		}
+		// hand out a view into the mapped container without copying
+		idFile_Mapped *mappedFile = resourceFiles[ rc.containerIndex ]->mappedFile;
+		if ( mappedFile != NULL ) {
+			idFile *view = mappedFile->OpenView( rc.filename, rc.offset, rc.length );
+			if ( view != NULL ) {
+				numResourcesMapped++;
+				numResourceBytesMapped += rc.length;
+				return view;
+			}
+		}
 		idFile_InnerResource *file = new idFile_InnerResource( rc.filename, resourceFiles[ rc.containerIndex ]->resourceFile, rc.offset, rc.length );
 		if ( file != NULL && ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 ) {
 			byte *buf = NULL;
@@ -2747,6 +3011,8 @@ idFile * idFileSystemLocal::GetResourceFile( const char *fileName, bool memFile
 				buf = ( byte * )Mem_Alloc( rc.length, TAG_TEMP );
 			}
 			file->Read( (void*)buf, rc.length );
+			numResourcesCopied++;
+			numResourceBytesCopied += rc.length;
 
 			if ( buf == resourceBufferPtr ) {
 				file->SetResourceBuffer( buf );
@@ -2810,6 +3076,14 @@ idFile *idFileSystemLocal::OpenFileReadFlags( const char *relativePath, int sear
 		idLib::Printf( "FILE DEBUG: opening %s\n", relativePath );
 	}
 
+	// the I/O thread may already have read the file, preloads look in the resource files first
+	if ( resourceFiles.Num() == 0 || fs_resourceLoadPriority.GetInteger() == 1 ) {
+		idFile * pf = asyncReads.OpenPreloaded( relativePath );
+		if ( pf != NULL ) {
+			return pf;
+		}
+	}
+
 	if ( resourceFiles.Num() > 0 && fs_resourceLoadPriority.GetInteger() ==  1 ) {
 		idFile * rf = GetResourceFile( relativePath, ( searchFlags & FSFLAG_RETURN_FILE_MEM ) != 0 );
 		if ( rf != NULL ) {
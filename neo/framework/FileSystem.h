@@ -79,6 +79,26 @@ private:
 	idStrList				list;
 };
 
+// priorities for asynchronous reads, higher priorities are read first
+typedef enum {
+	ASYNC_READ_PRIORITY_LOW,		// speculative preloads
+	ASYNC_READ_PRIORITY_NORMAL,
+	ASYNC_READ_PRIORITY_HIGH,		// data the current load step is about to use
+	ASYNC_READ_NUM_PRIORITIES
+} asyncReadPriority_t;
+
+typedef int asyncReadHandle_t;		// 0 is never a valid handle
+
+struct asyncReadResult_t {
+	const char *			fileName;
+	const byte *			data;			// NULL if the read failed, only valid during the callback
+	int						length;
+	void *					userData;
+};
+
+// called from a job thread, so it must not touch anything the main thread is using
+typedef void ( *asyncReadCallback_t )( const asyncReadResult_t & result );
+
 class idFileSystem {
 public:
 	virtual					~idFileSystem() {}
@@ -188,6 +208,16 @@ public:
 	virtual void			StartPreload( const idStrList &_preload ) = 0;
 	virtual void			StopPreload() = 0;
 	virtual int				ReadFromBGL( idFile *_resourceFile, void * _buffer, int _offset, int _len ) = 0;
+	// Queues a read on the background I/O thread. Reads next to each other in a resource container are merged.
+	// The callback is run on the job system from DispatchAsyncReads or WaitForAsyncReads. With a NULL callback the
+	// data is kept until OpenFileRead opens the file, which then doesn't read it again.
+	virtual asyncReadHandle_t	QueueAsyncRead( const char *relativePath, asyncReadPriority_t priority, asyncReadCallback_t callback, void *userData ) = 0;
+	// Returns true if the callback for the read won't be called.
+	virtual bool			CancelAsyncRead( asyncReadHandle_t handle ) = 0;
+	// Runs the callbacks for the reads that have finished.
+	virtual void			DispatchAsyncReads() = 0;
+	// Waits until all the queued reads are done and their callbacks have run.
+	virtual void			WaitForAsyncReads() = 0;
 	virtual bool			IsBinaryModel( const idStr & resName ) const = 0;
 	virtual bool			IsSoundSample( const idStr & resName ) const = 0;
 	virtual bool			GetResourceCacheEntry( const char *fileName, idResourceCacheEntry &rc ) = 0;
@@ -0,0 +1,787 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "File_AsyncRead.h"
+
+idCVar fs_asyncReads( "fs_asyncReads", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "read preloads on a background thread, if 0 they are read immediately on the thread that queues them" );
+idCVar fs_asyncReadMergeGap( "fs_asyncReadMergeGap", "65536", CVAR_SYSTEM | CVAR_INTEGER, "reads in the same file closer than this many bytes are merged into a single read", 0, 1024 * 1024 );
+idCVar fs_asyncReadMaxBatch( "fs_asyncReadMaxBatch", "4194304", CVAR_SYSTEM | CVAR_INTEGER, "largest merged read in bytes", 65536, 64 * 1024 * 1024 );
+idCVar fs_asyncReadCacheSize( "fs_asyncReadCacheSize", "64", CVAR_SYSTEM | CVAR_INTEGER, "megabytes of finished preloads kept until they are opened, further preloads wait until some are opened", 1, 1024 );
+idCVar fs_debugAsyncReads( "fs_debugAsyncReads", "0", CVAR_SYSTEM | CVAR_BOOL, "print the timeline of every async read when its callback is dispatched" );
+
+static const int MAX_ASYNC_READ_JOBS	= 256;
+static const int ASYNC_READ_PAGE_SIZE	= 4096;
+
+static const char * asyncReadPriorityNames[ ASYNC_READ_NUM_PRIORITIES ] = {
+	"low",
+	"normal",
+	"high"
+};
+
+/*
+================================================
+idAsyncReadThread
+================================================
+*/
+class idAsyncReadThread : public idSysThread {
+public:
+						idAsyncReadThread( idAsyncReadQueue *queue_ ) : queue( queue_ ) {}
+	virtual int			Run() { queue->ProcessPending(); return 0; }
+
+private:
+	idAsyncReadQueue *	queue;
+};
+
+/*
+================================================
+idSort_AsyncRead
+
+Lowest priority first and descending offsets inside a file, so the
+next request to read is always at the end of the list.
+================================================
+*/
+class idSort_AsyncRead : public idSort_Quick< asyncReadRequest_t *, idSort_AsyncRead > {
+public:
+	int Compare( asyncReadRequest_t * const & a, asyncReadRequest_t * const & b ) const {
+		if ( a->priority != b->priority ) {
+			return a->priority - b->priority;
+		}
+		const int cmp = idStr::Icmp( a->osPath, b->osPath );
+		if ( cmp != 0 ) {
+			return -cmp;
+		}
+		return b->offset - a->offset;
+	}
+};
+
+/*
+========================
+ReleaseAsyncReadBlock
+========================
+*/
+static void ReleaseAsyncReadBlock( asyncReadBlock_t *block ) {
+	if ( block != NULL && block->refCount.Decrement() == 0 ) {
+		Mem_Free( block->buffer );
+		delete block;
+	}
+}
+
+/*
+================================================
+idFile_AsyncReadView is a preloaded file handed out by OpenPreloaded,
+it keeps the block it points into alive until it is closed.
+================================================
+*/
+class idFile_AsyncReadView : public idFile_Memory {
+public:
+	idFile_AsyncReadView( const char *name, asyncReadBlock_t *block_, const byte *data, int length ) :
+		idFile_Memory( name, reinterpret_cast< const char * >( data ), length ), block( block_ ) {}
+	virtual ~idFile_AsyncReadView() { ReleaseAsyncReadBlock( block ); }
+
+private:
+	asyncReadBlock_t *	block;
+};
+
+/*
+========================
+AsyncReadCallbackJob
+========================
+*/
+static void AsyncReadCallbackJob( asyncReadRequest_t *request ) {
+	asyncReadResult_t result;
+	result.fileName = request->fileName.c_str();
+	result.data = request->failed ? NULL : request->data;
+	result.length = request->length;
+	result.userData = request->userData;
+	request->callback( result );
+	request->callbackEndTime = Sys_Microseconds();
+}
+REGISTER_PARALLEL_JOB( AsyncReadCallbackJob, "AsyncReadCallbackJob" );
+
+/*
+========================
+idAsyncReadQueue::idAsyncReadQueue
+========================
+*/
+idAsyncReadQueue::idAsyncReadQueue() :
+	completedSignal( true ) {
+	thread = NULL;
+	jobList = NULL;
+	nextHandle = 0;
+	pendingSorted = true;
+	preloadedBytes = 0;
+	ignoreCacheLimit = false;
+	readFile = NULL;
+	ClearStats();
+}
+
+/*
+========================
+idAsyncReadQueue::~idAsyncReadQueue
+========================
+*/
+idAsyncReadQueue::~idAsyncReadQueue() {
+	Shutdown();
+}
+
+/*
+========================
+idAsyncReadQueue::Init
+========================
+*/
+void idAsyncReadQueue::Init() {
+	if ( fs_asyncReads.GetBool() && thread == NULL ) {
+		thread = new (TAG_IDFILE) idAsyncReadThread( this );
+		thread->StartWorkerThread( "AsyncRead", CORE_ANY, THREAD_NORMAL );
+	}
+}
+
+/*
+========================
+idAsyncReadQueue::Shutdown
+========================
+*/
+void idAsyncReadQueue::Shutdown() {
+	{
+		idScopedCriticalSection lock( mutex );
+		for ( int i = 0; i < pending.Num(); i++ ) {
+			if ( IsPreload( pending[ i ] ) ) {
+				RemovePreload( pending[ i ] );
+			}
+			delete pending[ i ];
+		}
+		pending.Clear();
+	}
+
+	if ( thread != NULL ) {
+		// finish whatever the thread is reading, then drop the callbacks
+		thread->WaitForThread();
+		thread->StopThread();
+		delete thread;
+		thread = NULL;
+	}
+	for ( int i = 0; i < completed.Num(); i++ ) {
+		completed[ i ]->cancelled = true;
+	}
+	Dispatch();
+	DropPreloaded();
+
+	if ( jobList != NULL ) {
+		parallelJobManager->FreeJobList( jobList );
+		jobList = NULL;
+	}
+	delete readFile;
+	readFile = NULL;
+}
+
+/*
+========================
+idAsyncReadQueue::Queue
+
+Takes ownership of the request. Requests that failed to resolve are
+completed right away so their callbacks still run.
+========================
+*/
+asyncReadHandle_t idAsyncReadQueue::Queue( asyncReadRequest_t *request ) {
+	request->block = NULL;
+	request->data = NULL;
+	request->cancelled = false;
+	request->ready = false;
+	request->queueTime = Sys_Microseconds();
+	request->readStartTime = request->queueTime;
+	request->readEndTime = request->queueTime;
+	request->callbackEndTime = 0;
+
+	asyncReadHandle_t handle;
+	{
+		idScopedCriticalSection lock( mutex );
+		if ( ++nextHandle <= 0 ) {
+			nextHandle = 1;
+		}
+		handle = request->handle = nextHandle;
+
+		stats.numQueued++;
+		if ( stats.startTime == 0 ) {
+			stats.startTime = request->queueTime;
+		}
+		if ( request->failed ) {
+			completed.Append( request );
+			return handle;
+		}
+		pending.Append( request );
+		pendingSorted = false;
+		if ( IsPreload( request ) ) {
+			AddPreload( request );
+		}
+	}
+
+	if ( thread != NULL ) {
+		thread->SignalWork();
+	} else {
+		ProcessPending();
+	}
+	return handle;
+}
+
+/*
+========================
+idAsyncReadQueue::Cancel
+
+Requests that haven't been read are dropped, requests being read or
+waiting for dispatch are flagged so their callbacks aren't called.
+========================
+*/
+bool idAsyncReadQueue::Cancel( asyncReadHandle_t handle ) {
+	idScopedCriticalSection lock( mutex );
+
+	for ( int i = 0; i < pending.Num(); i++ ) {
+		if ( pending[ i ]->handle == handle ) {
+			if ( IsPreload( pending[ i ] ) ) {
+				RemovePreload( pending[ i ] );
+			}
+			delete pending[ i ];
+			pending.RemoveIndex( i );
+			stats.numCancelled++;
+			return true;
+		}
+	}
+	for ( int i = 0; i < inFlight.Num(); i++ ) {
+		if ( inFlight[ i ]->handle == handle ) {
+			if ( !inFlight[ i ]->cancelled ) {
+				inFlight[ i ]->cancelled = true;
+				stats.numCancelled++;
+			}
+			return true;
+		}
+	}
+	for ( int i = 0; i < completed.Num(); i++ ) {
+		if ( completed[ i ]->handle == handle ) {
+			if ( !completed[ i ]->cancelled ) {
+				completed[ i ]->cancelled = true;
+				stats.numCancelled++;
+			}
+			return true;
+		}
+	}
+	for ( int i = 0; i < preloaded.Num(); i++ ) {
+		if ( preloaded[ i ]->handle == handle ) {
+			asyncReadRequest_t *request = preloaded[ i ];
+			preloaded.RemoveIndex( i );
+			RemovePreload( request );
+			preloadedBytes -= request->length;
+			stats.numPreloadUnused++;
+			stats.bytesPreloadUnused += request->length;
+			ReleaseBlock( request );
+			delete request;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+========================
+idAsyncReadQueue::ProcessPending
+
+Runs on the I/O thread until there is nothing left to read. Each pass
+takes the highest priority request and merges in the requests of the
+same priority that are close to it in the same file. Low priority
+preloads are held back while fs_asyncReadCacheSize worth of finished
+preloads haven't been opened yet.
+========================
+*/
+void idAsyncReadQueue::ProcessPending() {
+	idList< asyncReadRequest_t * > batch;
+
+	for ( ; ; ) {
+		batch.SetNum( 0 );
+		{
+			idScopedCriticalSection lock( mutex );
+			if ( pending.Num() == 0 ) {
+				break;
+			}
+			// only resort when new requests came in
+			if ( !pendingSorted ) {
+				pending.SortWithTemplate( idSort_AsyncRead() );
+				pendingSorted = true;
+			}
+
+			asyncReadRequest_t *first = pending[ pending.Num() - 1 ];
+			if ( first->priority == ASYNC_READ_PRIORITY_LOW && IsPreload( first ) && !ignoreCacheLimit
+					&& preloadedBytes >= (int64)fs_asyncReadCacheSize.GetInteger() << 20 ) {
+				break;
+			}
+			batch.Append( first );
+			pending.RemoveIndex( pending.Num() - 1 );
+
+			if ( first->mappedData == NULL ) {
+				const int mergeGap = fs_asyncReadMergeGap.GetInteger();
+				const int maxBatch = fs_asyncReadMaxBatch.GetInteger();
+				int spanEnd = first->offset + first->length;
+				while ( pending.Num() > 0 ) {
+					asyncReadRequest_t *next = pending[ pending.Num() - 1 ];
+					if ( next->priority != first->priority || next->mappedData != NULL || idStr::Icmp( next->osPath, first->osPath ) != 0 ) {
+						break;
+					}
+					if ( next->offset > spanEnd + mergeGap || next->offset + next->length - first->offset > maxBatch ) {
+						break;
+					}
+					batch.Append( next );
+					pending.RemoveIndex( pending.Num() - 1 );
+					spanEnd = Max( spanEnd, next->offset + next->length );
+				}
+			}
+			inFlight.Append( batch );
+		}
+
+		ReadBatch( batch );
+
+		{
+			idScopedCriticalSection lock( mutex );
+			for ( int i = 0; i < batch.Num(); i++ ) {
+				asyncReadRequest_t *request = batch[ i ];
+				inFlight.Remove( request );
+				if ( IsPreload( request ) && !request->failed && !request->cancelled ) {
+					// keep the data until the file is opened
+					stats.numCompleted++;
+					stats.numCompletedByPriority[ request->priority ]++;
+					stats.queueLatency[ request->priority ] += request->readStartTime - request->queueTime;
+					request->ready = true;
+					preloaded.Append( request );
+					preloadedBytes += request->length;
+					continue;
+				}
+				if ( IsPreload( request ) ) {
+					// failed or cancelled, there is nothing to open
+					RemovePreload( request );
+				}
+				// nobody will look at the data, so don't hold on to it until the dispatch
+				if ( request->callback == NULL ) {
+					ReleaseBlock( request );
+				}
+				completed.Append( request );
+			}
+		}
+		completedSignal.Raise();
+	}
+
+	// don't keep a container open while there is nothing to read
+	delete readFile;
+	readFile = NULL;
+}
+
+/*
+========================
+idAsyncReadQueue::ReadBatch
+========================
+*/
+void idAsyncReadQueue::ReadBatch( idList< asyncReadRequest_t * > &batch ) {
+	static volatile int touchSink;
+
+	const uint64 startTime = Sys_Microseconds();
+	asyncReadRequest_t *first = batch[ 0 ];
+	int64 bytesRead = 0;
+	int64 bytesMapped = 0;
+
+	if ( first->mappedData != NULL ) {
+		// the data is already addressable, take the page faults here instead of on the thread that uses it
+		int sum = 0;
+		for ( int i = 0; i < first->length; i += ASYNC_READ_PAGE_SIZE ) {
+			sum += first->mappedData[ i ];
+		}
+		touchSink = sum;
+		first->data = first->mappedData;
+		bytesMapped = first->length;
+	} else {
+		int spanStart = first->offset;
+		int spanEnd = first->offset + first->length;
+		for ( int i = 1; i < batch.Num(); i++ ) {
+			spanStart = Min( spanStart, batch[ i ]->offset );
+			spanEnd = Max( spanEnd, batch[ i ]->offset + batch[ i ]->length );
+		}
+
+		if ( readFile != NULL && idStr::Icmp( readFile->GetFullPath(), first->osPath ) != 0 ) {
+			delete readFile;
+			readFile = NULL;
+		}
+		if ( readFile == NULL ) {
+			readFile = fileSystem->OpenExplicitFileRead( first->osPath );
+		}
+
+		asyncReadBlock_t *block = NULL;
+		if ( readFile != NULL && spanEnd > spanStart ) {
+			block = new (TAG_IDFILE) asyncReadBlock_t;
+			block->buffer = (byte *)Mem_Alloc( spanEnd - spanStart, TAG_IDFILE );
+			block->refCount.SetValue( batch.Num() );
+			if ( readFile->Seek( spanStart, FS_SEEK_SET ) != 0 || readFile->Read( block->buffer, spanEnd - spanStart ) != spanEnd - spanStart ) {
+				Mem_Free( block->buffer );
+				delete block;
+				block = NULL;
+			} else {
+				bytesRead = spanEnd - spanStart;
+			}
+		}
+
+		for ( int i = 0; i < batch.Num(); i++ ) {
+			if ( block != NULL ) {
+				batch[ i ]->block = block;
+				batch[ i ]->data = block->buffer + ( batch[ i ]->offset - spanStart );
+			} else {
+				batch[ i ]->failed = ( batch[ i ]->length > 0 );
+			}
+		}
+	}
+
+	const uint64 endTime = Sys_Microseconds();
+	for ( int i = 0; i < batch.Num(); i++ ) {
+		batch[ i ]->readStartTime = startTime;
+		batch[ i ]->readEndTime = endTime;
+	}
+
+	idScopedCriticalSection lock( mutex );
+	stats.numBatches++;
+	stats.numMerged += batch.Num() - 1;
+	stats.bytesRead += bytesRead;
+	stats.bytesMapped += bytesMapped;
+	stats.ioTime += endTime - startTime;
+}
+
+/*
+========================
+idAsyncReadQueue::ReleaseBlock
+========================
+*/
+void idAsyncReadQueue::ReleaseBlock( asyncReadRequest_t *request ) {
+	asyncReadBlock_t *block = request->block;
+	request->block = NULL;
+	request->data = NULL;
+	ReleaseAsyncReadBlock( block );
+}
+
+/*
+========================
+PreloadHashKey
+
+IcmpPath treats both slashes as the same, so the key has to as well.
+========================
+*/
+static int PreloadHashKey( const char *fileName ) {
+	idStrStatic< MAX_OSPATH > name = fileName;
+	name.BackSlashesToSlashes();
+	return idStr::IHash( name.c_str() );
+}
+
+/*
+========================
+idAsyncReadQueue::AddPreload
+
+The mutex must be held.
+========================
+*/
+void idAsyncReadQueue::AddPreload( asyncReadRequest_t *request ) {
+	preloadHash.Add( PreloadHashKey( request->fileName ), preloads.Append( request ) );
+	numPreloads.SetValue( preloads.Num() );
+}
+
+/*
+========================
+idAsyncReadQueue::RemovePreload
+
+The mutex must be held.
+========================
+*/
+void idAsyncReadQueue::RemovePreload( asyncReadRequest_t *request ) {
+	const int key = PreloadHashKey( request->fileName );
+	for ( int i = preloadHash.First( key ); i != -1; i = preloadHash.Next( i ) ) {
+		if ( preloads[ i ] == request ) {
+			preloadHash.RemoveIndex( key, i );
+			preloads.RemoveIndex( i );
+			break;
+		}
+	}
+	numPreloads.SetValue( preloads.Num() );
+}
+
+/*
+========================
+idAsyncReadQueue::FindPreload
+
+The mutex must be held. Cancelled preloads that are still being read don't count.
+========================
+*/
+asyncReadRequest_t *idAsyncReadQueue::FindPreload( const char *fileName ) const {
+	const int key = PreloadHashKey( fileName );
+	for ( int i = preloadHash.First( key ); i != -1; i = preloadHash.Next( i ) ) {
+		if ( !preloads[ i ]->cancelled && idStr::IcmpPath( preloads[ i ]->fileName, fileName ) == 0 ) {
+			return preloads[ i ];
+		}
+	}
+	return NULL;
+}
+
+/*
+========================
+idAsyncReadQueue::Dispatch
+
+Runs the callbacks of the completed reads as jobs and frees the
+requests. The I/O thread keeps reading while the callbacks run.
+========================
+*/
+void idAsyncReadQueue::Dispatch() {
+	idList< asyncReadRequest_t * > done;
+	{
+		idScopedCriticalSection lock( mutex );
+		if ( completed.Num() == 0 ) {
+			return;
+		}
+		done = completed;
+		completed.SetNum( 0 );
+	}
+
+	const uint64 startTime = Sys_Microseconds();
+
+	for ( int i = 0; i < done.Num(); ) {
+		int numJobs = 0;
+		for ( ; i < done.Num() && numJobs < MAX_ASYNC_READ_JOBS; i++ ) {
+			asyncReadRequest_t *request = done[ i ];
+			if ( request->cancelled || request->callback == NULL ) {
+				continue;
+			}
+			if ( jobList == NULL ) {
+				jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_ASYNC_READ_JOBS, 0, NULL );
+			}
+			jobList->AddJob( (jobRun_t)AsyncReadCallbackJob, request );
+			numJobs++;
+		}
+		if ( numJobs > 0 ) {
+			jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+			jobList->Wait();
+		}
+	}
+
+	const uint64 endTime = Sys_Microseconds();
+
+	idScopedCriticalSection lock( mutex );
+	for ( int i = 0; i < done.Num(); i++ ) {
+		asyncReadRequest_t *request = done[ i ];
+		if ( request->callbackEndTime == 0 ) {
+			request->callbackEndTime = endTime;
+		}
+		if ( request->failed ) {
+			stats.numFailed++;
+		} else if ( !request->cancelled ) {
+			stats.numCompleted++;
+			stats.numCompletedByPriority[ request->priority ]++;
+			stats.queueLatency[ request->priority ] += request->readStartTime - request->queueTime;
+		}
+		if ( fs_debugAsyncReads.GetBool() ) {
+			idLib::Printf( "ASYNC: %8.2f queued %8.2f read %8.2f done %8.2f dispatched ms, %7d bytes, %-6s %s%s\n",
+				( request->queueTime - stats.startTime ) * 0.001f, ( request->readStartTime - stats.startTime ) * 0.001f,
+				( request->readEndTime - stats.startTime ) * 0.001f, ( request->callbackEndTime - stats.startTime ) * 0.001f,
+				request->length, asyncReadPriorityNames[ request->priority ], request->fileName.c_str(),
+				request->failed ? " (failed)" : ( request->cancelled ? " (cancelled)" : "" ) );
+		}
+		ReleaseBlock( request );
+		delete request;
+	}
+	stats.dispatchTime += endTime - startTime;
+	stats.endTime = endTime;
+}
+
+/*
+========================
+idAsyncReadQueue::IsIdle
+========================
+*/
+bool idAsyncReadQueue::IsIdle() {
+	idScopedCriticalSection lock( mutex );
+	return ( pending.Num() == 0 && inFlight.Num() == 0 && completed.Num() == 0 );
+}
+
+/*
+========================
+idAsyncReadQueue::WaitForAll
+========================
+*/
+void idAsyncReadQueue::WaitForAll() {
+	// the preloads held back for the cache limit count as outstanding reads too
+	{
+		idScopedCriticalSection lock( mutex );
+		ignoreCacheLimit = true;
+	}
+	if ( thread != NULL ) {
+		thread->SignalWork();
+	} else {
+		ProcessPending();
+	}
+	for ( ; ; ) {
+		Dispatch();
+		if ( IsIdle() ) {
+			break;
+		}
+		completedSignal.Wait( 10 );
+		completedSignal.Clear();
+	}
+
+	idScopedCriticalSection lock( mutex );
+	ignoreCacheLimit = false;
+}
+
+/*
+========================
+idAsyncReadQueue::OpenPreloaded
+
+If the preload hasn't been read yet it is moved to the front of the
+queue and the calling thread waits for it, while the I/O thread goes
+on with the following preloads afterwards.
+========================
+*/
+idFile *idAsyncReadQueue::OpenPreloaded( const char *fileName ) {
+	uint64 waitStartTime = 0;
+
+	// most files are opened while nothing is preloaded, don't take the mutex for them
+	if ( numPreloads.GetValue() == 0 ) {
+		return NULL;
+	}
+
+	for ( ; ; ) {
+		{
+			idScopedCriticalSection lock( mutex );
+			asyncReadRequest_t *request = FindPreload( fileName );
+			if ( request == NULL ) {
+				return NULL;
+			}
+
+			if ( request->ready ) {
+				preloaded.Remove( request );
+				RemovePreload( request );
+				preloadedBytes -= request->length;
+				stats.numPreloadHits++;
+				if ( waitStartTime != 0 ) {
+					stats.numPreloadWaits++;
+					stats.preloadWaitTime += Sys_Microseconds() - waitStartTime;
+				}
+				if ( fs_debugAsyncReads.GetBool() ) {
+					idLib::Printf( "ASYNC: %8.2f queued %8.2f read %8.2f done %8.2f opened ms, %7d bytes, %-6s %s%s\n",
+						( request->queueTime - stats.startTime ) * 0.001f, ( request->readStartTime - stats.startTime ) * 0.001f,
+						( request->readEndTime - stats.startTime ) * 0.001f, ( Sys_Microseconds() - stats.startTime ) * 0.001f,
+						request->length, asyncReadPriorityNames[ request->priority ], request->fileName.c_str(), waitStartTime != 0 ? " (waited)" : "" );
+				}
+
+				// the view takes over the reference of the request
+				idFile *file = new (TAG_IDFILE) idFile_AsyncReadView( request->fileName, request->block, request->data, request->length );
+				request->block = NULL;
+				delete request;
+
+				// there may be room for the preloads that were held back now
+				if ( thread != NULL ) {
+					thread->SignalWork();
+				}
+				return file;
+			}
+
+			// not read yet, move it to the front if the I/O thread hasn't picked it up
+			if ( request->priority != ASYNC_READ_PRIORITY_HIGH && pending.FindIndex( request ) >= 0 ) {
+				request->priority = ASYNC_READ_PRIORITY_HIGH;
+				pendingSorted = false;
+			}
+		}
+
+		if ( waitStartTime == 0 ) {
+			waitStartTime = Sys_Microseconds();
+		}
+		if ( thread != NULL ) {
+			thread->SignalWork();
+			completedSignal.Wait( 1 );
+			completedSignal.Clear();
+		} else {
+			ProcessPending();
+		}
+	}
+}
+
+/*
+========================
+idAsyncReadQueue::DropPreloaded
+
+Frees the preloads that were never opened.
+========================
+*/
+void idAsyncReadQueue::DropPreloaded() {
+	idScopedCriticalSection lock( mutex );
+	for ( int i = 0; i < preloaded.Num(); i++ ) {
+		stats.numPreloadUnused++;
+		stats.bytesPreloadUnused += preloaded[ i ]->length;
+		RemovePreload( preloaded[ i ] );
+		ReleaseBlock( preloaded[ i ] );
+		delete preloaded[ i ];
+	}
+	preloaded.Clear();
+	preloadedBytes = 0;
+}
+
+/*
+========================
+idAsyncReadQueue::ClearStats
+========================
+*/
+void idAsyncReadQueue::ClearStats() {
+	idScopedCriticalSection lock( mutex );
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+/*
+========================
+idAsyncReadQueue::PrintStats
+========================
+*/
+void idAsyncReadQueue::PrintStats() {
+	asyncReadStats_t s;
+	{
+		idScopedCriticalSection lock( mutex );
+		s = stats;
+	}
+	const float elapsed = ( s.endTime > s.startTime ) ? ( s.endTime - s.startTime ) * 0.001f : 0.0f;
+
+	idLib::Printf( "async reads: %d queued, %d completed, %d cancelled, %d failed\n", s.numQueued, s.numCompleted, s.numCancelled, s.numFailed );
+	idLib::Printf( "%d reads issued, %d requests merged, %d KB read, %d KB touched in mapped files\n", s.numBatches, s.numMerged, (int)( s.bytesRead >> 10 ), (int)( s.bytesMapped >> 10 ) );
+	idLib::Printf( "timeline: %.1f ms from first request to last dispatch, I/O thread busy %.1f ms (%.0f%%), waiting on callbacks %.1f ms\n",
+					elapsed, s.ioTime * 0.001f, elapsed > 0.0f ? s.ioTime * 0.1f / elapsed : 0.0f, s.dispatchTime * 0.001f );
+	idLib::Printf( "preloads: %d opened from memory, %d of them waited %.1f ms for their read, %d never opened (%d KB)\n", s.numPreloadHits, s.numPreloadWaits,
+					s.preloadWaitTime * 0.001f, s.numPreloadUnused, (int)( s.bytesPreloadUnused >> 10 ) );
+	for ( int i = 0; i < ASYNC_READ_NUM_PRIORITIES; i++ ) {
+		if ( s.numCompletedByPriority[ i ] > 0 ) {
+			idLib::Printf( "%-6s priority: %5d requests, %.2f ms average wait before the read started\n", asyncReadPriorityNames[ i ], s.numCompletedByPriority[ i ],
+							s.queueLatency[ i ] * 0.001f / s.numCompletedByPriority[ i ] );
+		}
+	}
+}
@@ -0,0 +1,158 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __FILE_ASYNCREAD_H__
+#define __FILE_ASYNCREAD_H__
+
+/*
+==============================================================
+
+  Asynchronous prioritized reads
+
+==============================================================
+*/
+
+class idParallelJobList;
+class idAsyncReadThread;
+
+struct asyncReadBlock_t {
+	byte *					buffer;			// NULL for mapped reads
+	idSysInterlockedInteger	refCount;		// requests still pointing into the buffer
+};
+
+struct asyncReadRequest_t {
+	asyncReadHandle_t		handle;
+	asyncReadPriority_t		priority;
+	idStrStatic< MAX_OSPATH > fileName;
+	idStrStatic< MAX_OSPATH > osPath;		// resource container or loose file the data lives in
+	int						offset;			// into osPath
+	int						length;
+	const byte *			mappedData;		// set if the data is already mapped, nothing to read
+	asyncReadCallback_t		callback;
+	void *					userData;
+
+	asyncReadBlock_t *		block;			// buffer the data was read into, shared by merged reads
+	const byte *			data;
+	bool					cancelled;
+	bool					failed;
+	bool					ready;			// preload that has been read and waits in the preloaded list
+
+	// timeline
+	uint64					queueTime;
+	uint64					readStartTime;
+	uint64					readEndTime;
+	uint64					callbackEndTime;
+};
+
+struct asyncReadStats_t {
+	int						numQueued;
+	int						numCompleted;
+	int						numCancelled;
+	int						numFailed;
+	int						numBatches;		// reads issued on the I/O thread, merged requests share one
+	int						numMerged;		// requests that were merged into another read
+	int64					bytesRead;
+	int64					bytesMapped;	// bytes touched in mapped containers instead of read
+	int						numPreloadHits;		// opens served from a finished preload
+	int						numPreloadWaits;	// opens that had to wait for their preload to be read
+	int						numPreloadUnused;	// preloads nobody opened before they were dropped
+	int64					bytesPreloadUnused;
+	uint64					preloadWaitTime;	// opening threads waiting for preloads
+	uint64					startTime;		// first request queued
+	uint64					endTime;		// last callback finished
+	uint64					ioTime;			// I/O thread busy
+	uint64					dispatchTime;	// main thread waiting on callbacks
+	uint64					queueLatency[ ASYNC_READ_NUM_PRIORITIES ];	// summed queue to read start
+	int						numCompletedByPriority[ ASYNC_READ_NUM_PRIORITIES ];
+};
+
+/*
+================================================
+idAsyncReadQueue reads files on a background thread. Requests are
+resolved to a container offset when they are queued, the I/O thread
+reads the highest priority requests first and merges requests that
+are close together in the same file into a single read. Completed
+requests have their callbacks run on the job system when the main
+thread dispatches them.
+
+Requests without a callback are preloads. Their data is kept until
+the file is opened, OpenPreloaded then hands it out without reading
+the file again, or waits for the read if it hasn't finished yet.
+================================================
+*/
+class idAsyncReadQueue {
+	friend class idAsyncReadThread;
+public:
+							idAsyncReadQueue();
+							~idAsyncReadQueue();
+
+	void					Init();
+	void					Shutdown();
+
+	asyncReadHandle_t		Queue( asyncReadRequest_t *request );
+	bool					Cancel( asyncReadHandle_t handle );
+	void					Dispatch();
+	void					WaitForAll();
+	bool					IsIdle();
+
+							// returns NULL if the file wasn't preloaded
+	idFile *				OpenPreloaded( const char *fileName );
+	void					DropPreloaded();
+
+	void					ClearStats();
+	void					PrintStats();
+
+private:
+	idSysMutex				mutex;
+	idList< asyncReadRequest_t * >	pending;
+	idList< asyncReadRequest_t * >	inFlight;
+	idList< asyncReadRequest_t * >	completed;
+	idList< asyncReadRequest_t * >	preloaded;		// finished preloads waiting to be opened
+	int64					preloadedBytes;
+	idList< asyncReadRequest_t * >	preloads;		// every preload not yet opened, dropped or cancelled, whatever its state
+	idHashIndex				preloadHash;	// preloads by file name
+	idSysInterlockedInteger	numPreloads;	// preloads.Num(), checked without the mutex
+	bool					ignoreCacheLimit;		// read the held back preloads too, set while waiting for all reads
+	idSysSignal				completedSignal;
+	idAsyncReadThread *		thread;
+	idParallelJobList *		jobList;
+	asyncReadHandle_t		nextHandle;
+	bool					pendingSorted;
+	asyncReadStats_t		stats;
+	idFile *				readFile;		// I/O thread only, last file read from
+
+	void					ProcessPending();
+	void					ReadBatch( idList< asyncReadRequest_t * > &batch );
+	void					ReleaseBlock( asyncReadRequest_t *request );
+	void					AddPreload( asyncReadRequest_t *request );
+	void					RemovePreload( asyncReadRequest_t *request );
+	asyncReadRequest_t *	FindPreload( const char *fileName ) const;
+	bool					IsPreload( const asyncReadRequest_t *request ) const { return request->callback == NULL && request->mappedData == NULL; }
+};
+
+#endif /* !__FILE_ASYNCREAD_H__ */
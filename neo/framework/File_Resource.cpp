@@ -37,12 +37,61 @@ idResourceContainer
 ================================================================================================
 */
 
+#if defined( _WIN64 )
+#define FS_MAP_RESOURCES_DEFAULT	"1"
+#else
+// mapping every container at once can exhaust a 32 bit address space
+#define FS_MAP_RESOURCES_DEFAULT	"0"
+#endif
+
+idCVar fs_mapResources( "fs_mapResources", FS_MAP_RESOURCES_DEFAULT, CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "memory map the resource files and hand out resources without copying them" );
+
+/*
+========================
+idResourceContainer::OpenResourceFile
+
+Maps the whole container into memory if possible, resources are
+then read straight from the mapping.
+========================
+*/ 
+void idResourceContainer::OpenResourceFile( const char *_fileName ) {
+	resourceFile = NULL;
+	mappedFile = NULL;
+
+	if ( fs_mapResources.GetBool() && sizeof( void * ) > 4 ) {
+		idFile *file = fileSystem->OpenFileRead( _fileName );
+		if ( file != NULL ) {
+			idFile_Mapped *mapped = new (TAG_IDFILE) idFile_Mapped();
+			if ( mapped->Open( file->GetName(), file->GetFullPath() ) ) {
+				mappedFile = mapped;
+				resourceFile = mapped;
+			} else {
+				mapped->Release();
+			}
+			delete file;
+		}
+		if ( resourceFile != NULL ) {
+			return;
+		}
+	}
+
+	if ( idStr::Icmp( _fileName, "_ordered.resources" ) == 0 ) {
+		resourceFile = fileSystem->OpenFileReadMemory( _fileName );
+	} else {
+		resourceFile = fileSystem->OpenFileRead( _fileName );
+	}
+}
+
 /*
 ========================
 idResourceContainer::ReOpen 
 ========================
 */ 
 void idResourceContainer::ReOpen() {
+	// the mapping stays valid and views into it may still be open
+	if ( mappedFile != NULL ) {
+		return;
+	}
 	delete resourceFile;
 	resourceFile = fileSystem->OpenFileRead( fileName );
 }
@@ -54,11 +103,7 @@ idResourceContainer::Init
 */ 
 bool idResourceContainer::Init( const char *_fileName, uint8 containerIndex ) {
 
-	if ( idStr::Icmp( _fileName, "_ordered.resources" ) == 0 ) {
-		resourceFile = fileSystem->OpenFileReadMemory( _fileName );
-	} else {
-		resourceFile = fileSystem->OpenFileRead( _fileName );
-	}
+	OpenResourceFile( _fileName );
 
 	if ( resourceFile == NULL ) {
 		idLib::Warning( "Unable to open resource file %s", _fileName );
@@ -74,13 +74,19 @@ class idResourceContainer {
 public:
 	idResourceContainer() {
 		resourceFile = NULL;
+		mappedFile = NULL;
 		tableOffset = 0;
 		tableLength = 0;
 		resourceMagic = 0;
 		numFileResources = 0;
 	}
 	~idResourceContainer() {
-		delete resourceFile;
+		if ( mappedFile != NULL ) {
+			// views handed out may still be open, they keep the mapping alive
+			mappedFile->Release();
+		} else {
+			delete resourceFile;
+		}
 		cacheTable.Clear();
 	}
 	bool Init( const char * fileName, uint8 containerIndex );
@@ -94,8 +100,11 @@ public:
 	void SetContainerIndex( const int & _idx );
 	void ReOpen();
 private:
+	void OpenResourceFile( const char *fileName );
+
 	idStrStatic< 256 > fileName;
 	idFile *	resourceFile;			// open file handle
+	idFile_Mapped *	mappedFile;			// resourceFile if the container is memory mapped
 	// offset should probably be a 64 bit value for development, but 4 gigs won't fit on
 	// a DVD layer, so it isn't a retail limitation.
 	int		tableOffset;			// table offset
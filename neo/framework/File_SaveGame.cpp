@@ -93,6 +93,7 @@ idFile_SaveGamePipelined::idFile_SaveGamePipelined
 idFile_SaveGamePipelined::idFile_SaveGamePipelined() :
 		mode( CLOSED ),
 		compressedLength( 0 ),
+		uncompressedLength( 0 ),
 		uncompressedProducedBytes( 0 ),
 		uncompressedConsumedBytes( 0 ),
 		compressedProducedBytes( 0 ),
@@ -656,6 +657,7 @@ int idFile_SaveGamePipelined::Write( const void * buffer, size_t length ) {
 			FlushUncompressedBlock();
 		}
 	}
+	uncompressedLength += length;
 
 	return static_cast<int>(length);
 }
@@ -1013,6 +1015,7 @@ int idFile_SaveGamePipelined::Read( void * buffer, size_t length ) {
 		while ( bytesZlib == 0 ) {
 			PumpUncompressedBlock();
 			if ( bytesZlib == 0 && zStreamEndHit ) {
+				uncompressedLength += ioCount;
 				return static_cast<int>(ioCount);
 			}
 		}
@@ -1027,6 +1030,7 @@ int idFile_SaveGamePipelined::Read( void * buffer, size_t length ) {
 		ioCount += copyFromBlock;
 		lengthRemaining -= copyFromBlock;
 	}
+	uncompressedLength += ioCount;
 	return static_cast<int>(ioCount);
 }
 
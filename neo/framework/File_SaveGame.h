@@ -122,6 +122,9 @@ public:
 	int						GetSaveFormatVersion() const { return saveFormatVersion; }
 	int						GetPointerSize() const;
 
+	// Number of uncompressed bytes written or read so far
+	size_t					GetUncompressedLength() const { return uncompressedLength; }
+
 	//------------------------
 	// idFile Interface
 	//------------------------
@@ -176,6 +179,7 @@ private:
 	idStr					osPath;		// OS path.
 	mode_t					mode;		// Open mode.
 	size_t					compressedLength;
+	size_t					uncompressedLength;
 
 	static const int COMPRESSED_BUFFER_SIZE		= COMPRESSED_BLOCK_SIZE * 2;
 	static const int UNCOMPRESSED_BUFFER_SIZE	= UNCOMPRESSED_BLOCK_SIZE * 2;
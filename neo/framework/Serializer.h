@@ -176,6 +176,10 @@ public:
 
 	void	SerializeDelta( float & value, const float & base ) { SanityCheck(); if ( writing ) { msg->WriteDeltaFloat( base, value ); } else { value = msg->ReadDeltaFloat( base ); } }
 
+	// Bit packed deltas, a value equal to base only costs a single bit
+	void	SerializeDeltaBits( int & value, int base, int smallBits, int fullBits );
+	void	SerializeChanged( float & value, const float & base );
+
 
 	// Common types, no compression
 	void	Serialize( int64 & value )		{ SanityCheck(); if ( writing ) { msg->WriteLongLong(value); }		else { value = msg->ReadLongLong(); } }
@@ -542,6 +546,75 @@ ID_INLINE void idSerializer::SerializeSPacked(int & value) {
 	}
 }
 
+/*
+========================
+idSerializer::SerializeDeltaBits
+One bit tells if value differs from base. The difference is sent as a signed number of 
+smallBits when it fits and of fullBits, the width of the type, when it does not
+
+NOTE - the difference wraps around at fullBits, the same as the full width delta functions
+========================
+*/
+ID_INLINE void idSerializer::SerializeDeltaBits( int & value, int base, int smallBits, int fullBits ) {
+	SanityCheck();
+	assert( smallBits > 0 && smallBits <= fullBits && fullBits <= 32 );
+
+	const int fullNumBits = ( fullBits == 32 ) ? 32 : -fullBits;
+
+	if ( IsWriting() ) {
+		const int shift = 32 - fullBits;
+		const int delta = (int)( ( (uint32)value - (uint32)base ) << shift ) >> shift;
+		if ( delta == 0 ) {
+			msg->WriteBits( 0, 1 );
+			return;
+		}
+		msg->WriteBits( 1, 1 );
+		if ( smallBits < fullBits ) {
+			const int smallMax = 1 << ( smallBits - 1 );
+			if ( delta >= -smallMax && delta < smallMax ) {
+				msg->WriteBits( 0, 1 );
+				msg->WriteBits( delta, -smallBits );
+				return;
+			}
+			msg->WriteBits( 1, 1 );
+		}
+		msg->WriteBits( delta, fullNumBits );
+	} else {
+		if ( msg->ReadBits( 1 ) == 0 ) {
+			value = base;
+			return;
+		}
+		int delta = 0;
+		if ( smallBits < fullBits && msg->ReadBits( 1 ) == 0 ) {
+			delta = msg->ReadBits( -smallBits );
+		} else {
+			delta = msg->ReadBits( fullNumBits );
+		}
+		value = (int)( (uint32)base + (uint32)delta );
+	}
+}
+
+/*
+========================
+idSerializer::SerializeChanged
+One bit tells if value differs from base, a changed value is sent whole so it arrives 
+bit exact instead of accumulating rounding errors like a float delta
+========================
+*/
+ID_INLINE void idSerializer::SerializeChanged( float & value, const float & base ) {
+	SanityCheck();
+
+	if ( IsWriting() ) {
+		const bool changed = ( *reinterpret_cast< const int32 * >( &value ) != *reinterpret_cast< const int32 * >( &base ) );
+		msg->WriteBool( changed );
+		if ( changed ) {
+			msg->WriteFloat( value );
+		}
+	} else {
+		value = msg->ReadBool() ? msg->ReadFloat() : base;
+	}
+}
+
 #endif
 
 
@@ -62,27 +62,97 @@ void usercmd_t::ByteSwap() {
 	angles[2] = LittleShort( angles[2] );
 }
 
+/*
+================
+SerializeUsercmdField
+================
+*/
+template< typename _type_ >
+static void SerializeUsercmdField( idSerializer & ser, _type_ & value, const _type_ & base, int smallBits ) {
+	int temp = value;
+	ser.SerializeDeltaBits( temp, base, smallBits, sizeof( _type_ ) * 8 );
+	value = (_type_)temp;
+}
+
 /*
 ================
 usercmd_t::Serialize
+
+Consecutive usercmds mostly repeat each other, so every field costs a single bit when it
+matches base. Times step by about a frame and the view angles by a few degrees, which
+fit in the short deltas.
 ================
 */
 void usercmd_t::Serialize( idSerializer & ser, const usercmd_t & base ) {
-	ser.SerializeDelta( buttons, base.buttons );
-	ser.SerializeDelta( forwardmove, base.forwardmove );
-	ser.SerializeDelta( rightmove, base.rightmove );
-	ser.SerializeDelta( angles[0], base.angles[0] );
-	ser.SerializeDelta( angles[1], base.angles[1] );
-	ser.SerializeDelta( angles[2], base.angles[2] );
-	ser.SerializeDelta( pos.x, base.pos.x );
-	ser.SerializeDelta( pos.y, base.pos.y );
-	ser.SerializeDelta( pos.z, base.pos.z );
-	ser.SerializeDelta( clientGameMilliseconds, base.clientGameMilliseconds );
-	ser.SerializeDelta( serverGameMilliseconds, base.serverGameMilliseconds );
-	ser.SerializeDelta( fireCount, base.fireCount );
-	ser.SerializeDelta( speedSquared, base.speedSquared );
-	ser.SerializeDelta( impulse, base.impulse );
-	ser.SerializeDelta( impulseSequence, base.impulseSequence );
+	SerializeUsercmdField( ser, buttons, base.buttons, 8 );
+	SerializeUsercmdField( ser, forwardmove, base.forwardmove, 8 );
+	SerializeUsercmdField( ser, rightmove, base.rightmove, 8 );
+	SerializeUsercmdField( ser, angles[0], base.angles[0], 10 );
+	SerializeUsercmdField( ser, angles[1], base.angles[1], 10 );
+	SerializeUsercmdField( ser, angles[2], base.angles[2], 10 );
+	ser.SerializeChanged( pos.x, base.pos.x );
+	ser.SerializeChanged( pos.y, base.pos.y );
+	ser.SerializeChanged( pos.z, base.pos.z );
+	SerializeUsercmdField( ser, clientGameMilliseconds, base.clientGameMilliseconds, 8 );
+	SerializeUsercmdField( ser, serverGameMilliseconds, base.serverGameMilliseconds, 8 );
+	SerializeUsercmdField( ser, fireCount, base.fireCount, 4 );
+	ser.SerializeChanged( speedSquared, base.speedSquared );
+	SerializeUsercmdField( ser, impulse, base.impulse, 8 );
+	SerializeUsercmdField( ser, impulseSequence, base.impulseSequence, 8 );
+}
+
+/*
+================
+WriteUsercmdBatch
+================
+*/
+void WriteUsercmdBatch( idBitMsg & msg, usercmd_t * const * cmds, int numCmds ) {
+	idSerializer ser( msg, true );
+	usercmd_t empty;
+	const usercmd_t * last = &empty;
+
+	msg.WriteByte( numCmds );
+	for ( int i = 0; i < numCmds; i++ ) {
+		cmds[i]->Serialize( ser, *last );
+		last = cmds[i];
+	}
+}
+
+/*
+================
+ReadUsercmdBatch
+
+Returns the commands that are newer than newestMilliseconds. The older ones are the
+redundant copies of commands that arrived in an earlier packet and are dropped.
+================
+*/
+int ReadUsercmdBatch( idBitMsg & msg, int newestMilliseconds, usercmd_t * newCmds, int maxNewCmds, int * numDuplicates ) {
+	idSerializer ser( msg, false );
+	usercmd_t lastCmd;
+
+	int numNewCmds = 0;
+	int numOldCmds = 0;
+
+	const int numCmds = msg.ReadByte();
+	for ( int i = 0; i < numCmds; i++ ) {
+		usercmd_t newCmd;
+		newCmd.Serialize( ser, lastCmd );
+		lastCmd = newCmd;
+
+		if ( newCmd.clientGameMilliseconds > newestMilliseconds ) {
+			if ( verify( numNewCmds < maxNewCmds ) ) {
+				newCmds[numNewCmds++] = newCmd;
+				newestMilliseconds = newCmd.clientGameMilliseconds;
+			}
+		} else {
+			numOldCmds++;
+		}
+	}
+
+	if ( numDuplicates != NULL ) {
+		*numDuplicates = numOldCmds;
+	}
+	return numNewCmds;
 }
 
 /*
@@ -124,6 +124,12 @@ public:
 	bool		operator==( const usercmd_t &rhs ) const;
 };
 
+// Every usercmd packet carries the last few commands, so a lost packet is covered by the next
+// one. The commands are delta packed against the one before them, and the receiver drops
+// the ones it already has.
+void	WriteUsercmdBatch( idBitMsg & msg, usercmd_t * const * cmds, int numCmds );
+int		ReadUsercmdBatch( idBitMsg & msg, int newestMilliseconds, usercmd_t * newCmds, int maxNewCmds, int * numDuplicates = NULL );
+
 typedef enum {
 	INHIBIT_SESSION = 0,
 	INHIBIT_ASYNC
@@ -68,6 +68,8 @@ idCVar com_sleepGame( "com_sleepGame", "0", CVAR_SYSTEM | CVAR_INTEGER, "intenti
 idCVar com_sleepDraw( "com_sleepDraw", "0", CVAR_SYSTEM | CVAR_INTEGER, "intentionally add a sleep in the draw time" );
 idCVar com_sleepRender( "com_sleepRender", "0", CVAR_SYSTEM | CVAR_INTEGER, "intentionally add a sleep in the render time" );
 
+idCVar com_dedicatedTickReport( "com_dedicatedTickReport", "60", CVAR_SYSTEM | CVAR_INTEGER, "seconds between game tic time reports on a dedicated server, 0 = never" );
+
 idCVar net_drawDebugHud( "net_drawDebugHud", "0", CVAR_SYSTEM | CVAR_INTEGER, "0 = None, 1 = Hud 1, 2 = Hud 2, 3 = Snapshots" );
 
 idCVar timescale( "timescale", "1", CVAR_SYSTEM | CVAR_FLOAT, "Number of game frames to run per render frame", 0.001f, 100.0f );
@@ -293,7 +295,7 @@ This is an out-of-sequence screen update, not the normal game rendering
 ===============
 */
 void idCommonLocal::UpdateScreen( bool captureToImage ) {
-	if ( insideUpdateScreen ) {
+	if ( insideUpdateScreen || IsDedicatedServer() ) {
 		return;
 	}
 	insideUpdateScreen = true;
@@ -366,6 +368,11 @@ idCommonLocal::Frame
 =================
 */
 void idCommonLocal::Frame() {
+	if ( IsDedicatedServer() ) {
+		DedicatedFrame();
+		return;
+	}
+
 	try {
 		SCOPED_PROFILE_EVENT( "Common::Frame" );
 
@@ -704,6 +711,182 @@ void idCommonLocal::Frame() {
 	}
 }
 
+/*
+=================
+idCommonLocal::DedicatedFrame
+
+A dedicated server has no renderer, sound or menus to update, so the game is stepped
+directly on the main thread at the engine tic rate and the rest of every tic is slept
+away instead of spinning.
+=================
+*/
+void idCommonLocal::DedicatedFrame() {
+	try {
+		SCOPED_PROFILE_EVENT( "Common::DedicatedFrame" );
+
+		// This is the only place this is incremented
+		idLib::frameNumber++;
+
+		// pump the console and network events
+		Sys_GenerateEvents();
+
+		// write config file if anything changed
+		WriteConfiguration();
+
+		eventLoop->RunEventLoop();
+
+		// wait for the next game tic
+		int numGameFrames = 0;
+		for ( ;; ) {
+			const int thisFrameTime = Sys_Milliseconds();
+			static int lastFrameTime = thisFrameTime;	// initialized only the first time
+			const int deltaMilliseconds = thisFrameTime - lastFrameTime;
+			lastFrameTime = thisFrameTime;
+
+			gameTimeResidual += Min( deltaMilliseconds, com_deltaTimeClamp.GetInteger() ) * timescale.GetFloat();
+
+			for ( ;; ) {
+				const int frameDelay = FRAME_TO_MSEC( gameFrame + 1 ) - FRAME_TO_MSEC( gameFrame );
+				if ( gameTimeResidual < frameDelay ) {
+					break;
+				}
+				gameTimeResidual -= frameDelay;
+				gameFrame++;
+				numGameFrames++;
+			}
+
+			if ( numGameFrames > 0 ) {
+				break;
+			}
+
+			// sleep through the rest of the tic, there is nothing else to do
+			const int frameDelay = FRAME_TO_MSEC( gameFrame + 1 ) - FRAME_TO_MSEC( gameFrame );
+			Sys_Sleep( Max( (int)( frameDelay - gameTimeResidual ), 1 ) );
+		}
+
+		// everything from here on grows with the player count, not just the game tics
+		const uint64 frameStartTime = Sys_Microseconds();
+
+		session->UpdateSignInManager();
+		session->Pump();
+		session->ProcessSnapAckQueue();
+
+		if ( session->GetState() == idSession::LOADING ) {
+			// If the session reports we should be loading a map, load it!
+			ExecuteMapChange();
+			mapSpawnData.savegameFile = NULL;
+			mapSpawnData.persistentPlayerInfo.Clear();
+			return;
+		} else if ( session->GetState() != idSession::INGAME && mapSpawned ) {
+			LeaveGame();
+			return;
+		}
+
+		ExecuteReliableMessages();
+
+		gameReturn_t ret;
+		if ( mapSpawned ) {
+			// there is nobody at the keyboard, but the game still consumes a usercmd
+			// for the local client every tic
+			const int localClientNum = Game()->GetLocalClientNum();
+			if ( localClientNum >= 0 ) {
+				usercmdGen->Clear();
+				usercmd_t newCmd = usercmdGen->GetCurrentUsercmd();
+				newCmd.serverGameMilliseconds = Game()->GetServerGameTimeMs();
+				userCmdMgr.MakeReadPtrCurrentForPlayer( localClientNum );
+				for ( int i = 0 ; i < numGameFrames ; i++ ) {
+					newCmd.clientGameMilliseconds = FRAME_TO_MSEC( gameFrame - numGameFrames + i + 1 );
+					userCmdMgr.PutUserCmdForPlayer( localClientNum, newCmd );
+				}
+			}
+
+			for ( int i = 0; i < numGameFrames; i++ ) {
+				SCOPED_PROFILE_EVENT( "GameTic" );
+				const uint64 startTime = Sys_Microseconds();
+				game->RunFrame( userCmdMgr, ret );
+				tickTimes.AddSample( (int)( Sys_Microseconds() - startTime ) );
+				if ( ret.syncNextGameFrame || ret.sessionCommand[0] != 0 ) {
+					break;
+				}
+			}
+		}
+
+		// Now that we have an updated game frame, we can send out new snapshots to our clients
+		session->Pump(); // Pump to get updated usercmds to relay
+		SendSnapshots();
+
+		// process the game return for map changes, etc
+		ProcessGameReturn( ret );
+
+		if ( mapSpawned ) {
+			serverFrameTimes.AddSample( (int)( Sys_Microseconds() - frameStartTime ) );
+		}
+
+		const int reportMilliseconds = com_dedicatedTickReport.GetInteger() * 1000;
+		if ( reportMilliseconds > 0 && tickTimes.Num() > 0 && Sys_Milliseconds() - lastTickReportTime >= reportMilliseconds ) {
+			lastTickReportTime = Sys_Milliseconds();
+			PrintTickTimes( true );
+		}
+	} catch( idException & ) {
+		return;			// an ERP_DROP was thrown
+	}
+}
+
+/*
+=================
+idCommonLocal::PrintTickTimes
+=================
+*/
+void idCommonLocal::PrintTickTimes( bool clear ) {
+	const int budgetMilliseconds = FRAME_TO_MSEC( gameFrame + 1 ) - FRAME_TO_MSEC( gameFrame );
+	tickTimes.Print( "game tics", budgetMilliseconds * 1000 );
+	serverFrameTimes.Print( "server frames", budgetMilliseconds * 1000 );
+	if ( clear ) {
+		tickTimes.Clear();
+		serverFrameTimes.Clear();
+	}
+}
+
+/*
+=================
+idTickTimes::AddSample
+=================
+*/
+void idTickTimes::AddSample( int microseconds ) {
+	samples[nextSample] = microseconds;
+	nextSample = ( nextSample + 1 ) % MAX_SAMPLES;
+	numSamples = Min( numSamples + 1, MAX_SAMPLES );
+}
+
+/*
+=================
+idTickTimes::Print
+=================
+*/
+void idTickTimes::Print( const char * label, int budgetMicroseconds ) const {
+	if ( numSamples == 0 ) {
+		idLib::Printf( "no %s recorded\n", label );
+		return;
+	}
+
+	idTempArray< int > sorted( numSamples );
+	memcpy( sorted.Ptr(), samples, numSamples * sizeof( samples[0] ) );
+	idSort_QuickDefault< int >().Sort( sorted.Ptr(), numSamples );
+
+	const int p50 = sorted[ numSamples * 50 / 100 ];
+	const int p90 = sorted[ numSamples * 90 / 100 ];
+	const int p99 = sorted[ numSamples * 99 / 100 ];
+	const int worst = sorted[ numSamples - 1 ];
+
+	idLib::Printf( "%d %s: p50 %.2f p90 %.2f p99 %.2f max %.2f msec, p99 uses %d%% of the %.2f msec tic\n",
+		numSamples, label, p50 * 0.001f, p90 * 0.001f, p99 * 0.001f, worst * 0.001f,
+		budgetMicroseconds > 0 ? p99 * 100 / budgetMicroseconds : 0, budgetMicroseconds * 0.001f );
+}
+
+CONSOLE_COMMAND( serverTickTimes, "prints game tic and whole server frame time percentiles of a dedicated server, usage: serverTickTimes [clear]", NULL ) {
+	commonLocal.PrintTickTimes( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "clear" ) == 0 );
+}
+
 /*
 =================
 idCommonLocal::RunDoomClassicFrame
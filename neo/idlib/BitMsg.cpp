@@ -108,32 +108,16 @@ void idBitMsg::WriteBits( int value, int numBits ) {
 		idLib::FatalError( "idBitMsg::WriteBits: bad numBits %i", numBits );
 	}
 
-	// check for value overflows
-	if ( numBits != 32 ) {
-		if ( numBits > 0 ) {
-			if ( value > ( 1 << numBits ) - 1 ) {
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", 
-									  value, numBits );
-
-			} else if ( value < 0 ) {
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", 
-									  value, numBits );
-			}
-		} else {
-			const unsigned shift = ( -1 - numBits );
-			int r = 1 << shift;
-			if ( value > r - 1 ) {
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", 
-									  value, numBits );
-
-			} else if ( value < -r ) {
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", 
-									  value, numBits );
-			}
+	// check for value overflows, a value fits when nothing is left after shifting out
+	// the field, signed values are biased into the unsigned range first
+	if ( numBits > 0 ) {
+		if ( numBits != 32 && ( (uint32)value >> numBits ) != 0 ) {
+			idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", value, numBits );
+		}
+	} else {
+		if ( ( ( (uint32)value + ( 1u << ( -1 - numBits ) ) ) >> -numBits ) != 0 ) {
+			idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", value, numBits );
 		}
-	}
-
-	if ( numBits < 0 ) {
 		numBits = -numBits;
 	}
 
@@ -142,22 +126,24 @@ void idBitMsg::WriteBits( int value, int numBits ) {
 		return;
 	}
 
-	// Merge value with possible previous leftover
-	tempValue |= (((int64)value) & maskForNumBits64[numBits] ) << writeBit;
-	
-	writeBit += numBits;
-	
-	// Flush 8 bits (1 byte) at a time
-	while ( writeBit >= 8 ) {
-		writeData[curSize++] = tempValue & 255;
-		tempValue >>= 8;
-		writeBit -= 8;
-	}
-	
-	// Write leftover now, in case this is the last WriteBits call
-	if ( writeBit > 0 ) {
-		writeData[curSize] = tempValue & 255;
+	// Merge value with possible previous leftover, at most 7 + 32 bits are pending
+	uint64 bits = tempValue | ( ( (uint64)(uint32)value & maskForNumBits64[numBits] ) << writeBit );
+	int totalBits = writeBit + numBits;
+
+	// Store every touched byte including the leftover, in case this is the last WriteBits call
+	byte *dst = writeData + curSize;
+	switch ( ( totalBits + 7 ) >> 3 ) {
+		case 5: dst[4] = (byte)( bits >> 32 );
+		case 4: dst[3] = (byte)( bits >> 24 );
+		case 3: dst[2] = (byte)( bits >> 16 );
+		case 2: dst[1] = (byte)( bits >> 8 );
+		case 1: dst[0] = (byte)( bits );
 	}
+
+	const int fullBytes = totalBits >> 3;
+	curSize += fullBytes;
+	tempValue = bits >> ( fullBytes << 3 );
+	writeBit = totalBits & 7;
 }
 
 /*
@@ -277,9 +263,6 @@ If the number of bits is negative a sign is included.
 */
 int idBitMsg::ReadBits( int numBits ) const {
 	int		value;
-	int		valueBits;
-	int		get;
-	int		fraction;
 	bool	sgn;
 
 	if ( !readData ) {
@@ -291,9 +274,6 @@ int idBitMsg::ReadBits( int numBits ) const {
 		idLib::FatalError( "idBitMsg::ReadBits: bad numBits %i", numBits );
 	}
 
-	value = 0;
-	valueBits = 0;
-
 	if ( numBits < 0 ) {
 		numBits = -numBits;
 		sgn = true;
@@ -306,22 +286,23 @@ int idBitMsg::ReadBits( int numBits ) const {
 		return -1;
 	}
 
-	while ( valueBits < numBits ) {
-		if ( readBit == 0 ) {
-			readCount++;
-		}
-		get = 8 - readBit;
-		if ( get > (numBits - valueBits) ) {
-			get = (numBits - valueBits);
-		}
-		fraction = readData[readCount - 1];
-		fraction >>= readBit;
-		fraction &= ( 1 << get ) - 1;
-		value |= fraction << valueBits;
-
-		valueBits += get;
-		readBit = ( readBit + get ) & 7;
+	// gather every byte the field touches into one accumulator
+	const int bitPos = GetNumBitsRead();
+	const int shift = bitPos & 7;
+	const byte *src = readData + ( bitPos >> 3 );
+	uint64 bits = 0;
+	switch ( ( shift + numBits + 7 ) >> 3 ) {
+		case 5: bits |= (uint64)src[4] << 32;
+		case 4: bits |= (uint64)src[3] << 24;
+		case 3: bits |= (uint64)src[2] << 16;
+		case 2: bits |= (uint64)src[1] << 8;
+		case 1: bits |= (uint64)src[0];
 	}
+	value = (int)( ( bits >> shift ) & maskForNumBits64[numBits] );
+
+	const int endPos = bitPos + numBits;
+	readCount = ( endPos + 7 ) >> 3;
+	readBit = endPos & 7;
 
 	if ( sgn ) {
 		if ( value & ( 1 << ( numBits - 1 ) ) ) {
@@ -509,3 +490,427 @@ idVec3 idBitMsg::BitsToDir( int bits, int numBits ) {
 	dir.NormalizeFast();
 	return dir;
 }
+
+/*
+================================================================================================
+
+	idBitMsg self test
+
+================================================================================================
+*/
+
+/*
+================================================
+idBitMsgReference
+
+The byte at a time bit packer idBitMsg used before the accumulator paths. It is only kept
+to prove that the current packer produces the exact same bits.
+================================================
+*/
+class idBitMsgReference {
+public:
+	void			BeginWriting( byte * data ) { writeData = data; curSize = 0; writeBit = 0; tempValue = 0; }
+	void			BeginReading( const byte * data, int size ) { readData = data; curSize = size; readCount = 0; readBit = 0; }
+	int				GetSize() const { return curSize; }
+	int				GetNumBitsRead() const { return ( ( readCount << 3 ) - ( ( 8 - readBit ) & 7 ) ); }
+
+	void			WriteBits( int value, int numBits );
+	void			WriteByteAlign() { curSize += writeBit != 0; writeBit = 0; tempValue = 0; }
+	void			WriteData( const byte * data, int length ) { WriteByteAlign(); memcpy( writeData + curSize, data, length ); curSize += length; }
+
+	int				ReadBits( int numBits );
+	void			ReadByteAlign() { readBit = 0; }
+	void			ReadData( byte * data, int length ) { ReadByteAlign(); memcpy( data, readData + readCount, length ); readCount += length; }
+
+private:
+	byte *			writeData;
+	const byte *	readData;
+	int				curSize;
+	int				writeBit;
+	uint64			tempValue;
+	int				readCount;
+	int				readBit;
+};
+
+/*
+========================
+idBitMsgReference::WriteBits
+========================
+*/
+void idBitMsgReference::WriteBits( int value, int numBits ) {
+	if ( numBits < 0 ) {
+		numBits = -numBits;
+	}
+	tempValue |= (((int64)value) & maskForNumBits64[numBits] ) << writeBit;
+	writeBit += numBits;
+	while ( writeBit >= 8 ) {
+		writeData[curSize++] = tempValue & 255;
+		tempValue >>= 8;
+		writeBit -= 8;
+	}
+	if ( writeBit > 0 ) {
+		writeData[curSize] = tempValue & 255;
+	}
+}
+
+/*
+========================
+idBitMsgReference::ReadBits
+========================
+*/
+int idBitMsgReference::ReadBits( int numBits ) {
+	int value = 0;
+	int valueBits = 0;
+	bool sgn = false;
+
+	if ( numBits < 0 ) {
+		numBits = -numBits;
+		sgn = true;
+	}
+	if ( numBits > ( curSize << 3 ) - GetNumBitsRead() ) {
+		return -1;
+	}
+	while ( valueBits < numBits ) {
+		if ( readBit == 0 ) {
+			readCount++;
+		}
+		int get = 8 - readBit;
+		if ( get > ( numBits - valueBits ) ) {
+			get = ( numBits - valueBits );
+		}
+		int fraction = readData[readCount - 1];
+		fraction >>= readBit;
+		fraction &= ( 1 << get ) - 1;
+		value |= fraction << valueBits;
+		valueBits += get;
+		readBit = ( readBit + get ) & 7;
+	}
+	if ( sgn ) {
+		if ( value & ( 1 << ( numBits - 1 ) ) ) {
+			value |= -1 ^ ( ( 1 << numBits ) - 1 );
+		}
+	}
+	return value;
+}
+
+enum bitMsgTestOpType_t {
+	BMT_BITS,
+	BMT_SIGNED_BITS,
+	BMT_BYTE,
+	BMT_SHORT,
+	BMT_LONG,
+	BMT_FLOAT,
+	BMT_LONGLONG,
+	BMT_DATA,
+	BMT_ALIGN,
+	BMT_NUM_TYPES
+};
+
+struct bitMsgTestOp_t {
+	bitMsgTestOpType_t	type;
+	int					numBits;		// field width, or the number of bytes for BMT_DATA
+	int64				value;			// field value, or the offset into the data pool for BMT_DATA
+};
+
+static const int BITMSG_TEST_MAX_OPS		= 128;
+static const int BITMSG_TEST_MAX_DATA		= 16;
+static const int BITMSG_TEST_POOL_SIZE		= 256;
+static const int BITMSG_TEST_MSG_SIZE		= BITMSG_TEST_MAX_OPS * ( BITMSG_TEST_MAX_DATA + 1 );
+static const int BITMSG_TEST_BENCH_MSGS		= 64;
+
+/*
+========================
+BitMsgTest_Random32
+========================
+*/
+static uint32 BitMsgTest_Random32( idRandom & random ) {
+	return ( (uint32)random.RandomInt() << 17 ) ^ ( (uint32)random.RandomInt() << 2 ) ^ (uint32)random.RandomInt();
+}
+
+/*
+========================
+BitMsgTest_Generate
+
+Builds a random sequence of fields, most of them odd widths so the byte aligned
+paths and the accumulator paths are both exercised.
+========================
+*/
+static int BitMsgTest_Generate( idRandom & random, bitMsgTestOp_t * ops ) {
+	const int numOps = 1 + random.RandomInt( BITMSG_TEST_MAX_OPS );
+	for ( int i = 0; i < numOps; i++ ) {
+		bitMsgTestOp_t & op = ops[i];
+		op.type = (bitMsgTestOpType_t)random.RandomInt( BMT_NUM_TYPES );
+		switch ( op.type ) {
+			case BMT_BITS:
+				op.numBits = 1 + random.RandomInt( 32 );
+				op.value = (uint32)( BitMsgTest_Random32( random ) & maskForNumBits64[op.numBits] );
+				break;
+			case BMT_SIGNED_BITS: {
+				op.numBits = 1 + random.RandomInt( 31 );
+				const uint32 bits = (uint32)( BitMsgTest_Random32( random ) & maskForNumBits64[op.numBits] );
+				const uint32 sign = 1u << ( op.numBits - 1 );
+				op.value = (int)( ( bits ^ sign ) - sign );
+				op.numBits = -op.numBits;
+				break;
+			}
+			case BMT_BYTE:
+				op.numBits = 8;
+				op.value = random.RandomInt( 256 );
+				break;
+			case BMT_SHORT:
+				op.numBits = -16;
+				op.value = (int16)BitMsgTest_Random32( random );
+				break;
+			case BMT_LONG:
+				op.numBits = 32;
+				op.value = (int32)BitMsgTest_Random32( random );
+				break;
+			case BMT_FLOAT: {
+				const float f = random.CRandomFloat() * 16384.0f;
+				op.numBits = 32;
+				op.value = *reinterpret_cast< const int32 * >( &f );
+				break;
+			}
+			case BMT_LONGLONG:
+				op.numBits = 64;
+				op.value = (int64)( ( (uint64)BitMsgTest_Random32( random ) << 32 ) | BitMsgTest_Random32( random ) );
+				break;
+			case BMT_DATA:
+				op.numBits = 1 + random.RandomInt( BITMSG_TEST_MAX_DATA );
+				op.value = random.RandomInt( BITMSG_TEST_POOL_SIZE - BITMSG_TEST_MAX_DATA );
+				break;
+			default:
+				op.numBits = 0;
+				op.value = 0;
+				break;
+		}
+	}
+	return numOps;
+}
+
+/*
+========================
+BitMsgTest_Write
+========================
+*/
+static void BitMsgTest_Write( idBitMsg & msg, const bitMsgTestOp_t * ops, int numOps, const byte * pool ) {
+	for ( int i = 0; i < numOps; i++ ) {
+		const bitMsgTestOp_t & op = ops[i];
+		switch ( op.type ) {
+			case BMT_BITS:
+			case BMT_SIGNED_BITS:	msg.WriteBits( (int)op.value, op.numBits ); break;
+			case BMT_BYTE:			msg.WriteByte( (uint8)op.value ); break;
+			case BMT_SHORT:			msg.WriteShort( (int16)op.value ); break;
+			case BMT_LONG:			msg.WriteLong( (int32)op.value ); break;
+			case BMT_FLOAT: {
+				const int32 bits = (int32)op.value;
+				msg.WriteFloat( *reinterpret_cast< const float * >( &bits ) );
+				break;
+			}
+			case BMT_LONGLONG:		msg.WriteLongLong( op.value ); break;
+			case BMT_DATA:			msg.WriteData( pool + op.value, op.numBits ); break;
+			case BMT_ALIGN:			msg.WriteByteAlign(); break;
+		}
+	}
+}
+
+/*
+========================
+BitMsgTest_WriteReference
+========================
+*/
+static void BitMsgTest_WriteReference( idBitMsgReference & msg, const bitMsgTestOp_t * ops, int numOps, const byte * pool ) {
+	for ( int i = 0; i < numOps; i++ ) {
+		const bitMsgTestOp_t & op = ops[i];
+		switch ( op.type ) {
+			case BMT_LONGLONG:
+				msg.WriteBits( (int)op.value, 32 );
+				msg.WriteBits( (int)( op.value >> 32 ), 32 );
+				break;
+			case BMT_DATA:
+				msg.WriteData( pool + op.value, op.numBits );
+				break;
+			case BMT_ALIGN:
+				msg.WriteByteAlign();
+				break;
+			default:
+				msg.WriteBits( (int)op.value, op.numBits );
+				break;
+		}
+	}
+}
+
+/*
+========================
+BitMsgTest_Read
+
+Returns the index of the first field that does not read back, or numOps.
+========================
+*/
+static int BitMsgTest_Read( const idBitMsg & msg, const bitMsgTestOp_t * ops, int numOps, const byte * pool ) {
+	byte data[BITMSG_TEST_MAX_DATA];
+	for ( int i = 0; i < numOps; i++ ) {
+		const bitMsgTestOp_t & op = ops[i];
+		int64 value = 0;
+		switch ( op.type ) {
+			case BMT_BITS:
+			case BMT_SIGNED_BITS:	value = msg.ReadBits( op.numBits ); break;
+			case BMT_BYTE:			value = msg.ReadByte(); break;
+			case BMT_SHORT:			value = msg.ReadShort(); break;
+			case BMT_LONG:			value = msg.ReadLong(); break;
+			case BMT_FLOAT: {
+				const float f = msg.ReadFloat();
+				value = *reinterpret_cast< const int32 * >( &f );
+				break;
+			}
+			case BMT_LONGLONG:		value = msg.ReadLongLong(); break;
+			case BMT_DATA:
+				msg.ReadData( data, op.numBits );
+				value = ( memcmp( data, pool + op.value, op.numBits ) == 0 ) ? op.value : -1;
+				break;
+			case BMT_ALIGN:			msg.ReadByteAlign(); break;
+		}
+		if ( value != op.value ) {
+			return i;
+		}
+	}
+	return numOps;
+}
+
+/*
+========================
+BitMsgTest_ReadReference
+========================
+*/
+static int BitMsgTest_ReadReference( idBitMsgReference & msg, const bitMsgTestOp_t * ops, int numOps, const byte * pool ) {
+	byte data[BITMSG_TEST_MAX_DATA];
+	for ( int i = 0; i < numOps; i++ ) {
+		const bitMsgTestOp_t & op = ops[i];
+		int64 value = 0;
+		switch ( op.type ) {
+			case BMT_LONGLONG: {
+				const int64 a = msg.ReadBits( 32 );
+				const int64 b = msg.ReadBits( 32 );
+				value = ( 0x00000000ffffffff & a ) | ( b << 32 );
+				break;
+			}
+			case BMT_DATA:
+				msg.ReadData( data, op.numBits );
+				value = ( memcmp( data, pool + op.value, op.numBits ) == 0 ) ? op.value : -1;
+				break;
+			case BMT_ALIGN:
+				msg.ReadByteAlign();
+				break;
+			case BMT_BYTE:
+				value = (unsigned char)msg.ReadBits( 8 );
+				break;
+			default:
+				value = msg.ReadBits( op.numBits );
+				break;
+		}
+		if ( value != op.value ) {
+			return i;
+		}
+	}
+	return numOps;
+}
+
+/*
+========================
+idBitMsg::Test_f
+
+testBitMsg [numMessages] [seed]
+Writes random messages with idBitMsg and with the reference packer, checks that the
+bytes are identical and that both read every field back, then times both packers.
+========================
+*/
+void idBitMsg::Test_f( const idCmdArgs & args ) {
+	const int numMessages = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 100000;
+	const int seed = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 0;
+
+	idRandom random( seed );
+
+	byte pool[BITMSG_TEST_POOL_SIZE];
+	for ( int i = 0; i < BITMSG_TEST_POOL_SIZE; i++ ) {
+		pool[i] = (byte)random.RandomInt( 256 );
+	}
+
+	idTempArray< bitMsgTestOp_t > ops( BITMSG_TEST_BENCH_MSGS * BITMSG_TEST_MAX_OPS );
+	int numOps[BITMSG_TEST_BENCH_MSGS];
+	idTempArray< byte > buffer( BITMSG_TEST_MSG_SIZE );
+	idTempArray< byte > referenceBuffer( BITMSG_TEST_MSG_SIZE );
+
+	idBitMsg msg;
+	idBitMsgReference reference;
+
+	// bit exact compatibility
+	int numFailed = 0;
+	for ( int m = 0; m < numMessages && numFailed < 10; m++ ) {
+		const int n = BitMsgTest_Generate( random, ops.Ptr() );
+
+		msg.InitWrite( buffer.Ptr(), BITMSG_TEST_MSG_SIZE );
+		BitMsgTest_Write( msg, ops.Ptr(), n, pool );
+		reference.BeginWriting( referenceBuffer.Ptr() );
+		BitMsgTest_WriteReference( reference, ops.Ptr(), n, pool );
+		msg.WriteByteAlign();
+		reference.WriteByteAlign();
+
+		if ( msg.GetSize() != reference.GetSize() || memcmp( buffer.Ptr(), referenceBuffer.Ptr(), msg.GetSize() ) != 0 ) {
+			idLib::Warning( "message %d: written bytes differ from the reference (%d vs %d bytes)", m, msg.GetSize(), reference.GetSize() );
+			numFailed++;
+			continue;
+		}
+
+		msg.InitRead( buffer.Ptr(), msg.GetSize() );
+		reference.BeginReading( referenceBuffer.Ptr(), reference.GetSize() );
+		const int failedOp = BitMsgTest_Read( msg, ops.Ptr(), n, pool );
+		const int failedReferenceOp = BitMsgTest_ReadReference( reference, ops.Ptr(), n, pool );
+		if ( failedOp != n || failedReferenceOp != n || msg.GetNumBitsRead() != reference.GetNumBitsRead() ) {
+			idLib::Warning( "message %d: read back failed at field %d (reference %d)", m, failedOp, failedReferenceOp );
+			numFailed++;
+		}
+	}
+	if ( numFailed > 0 ) {
+		idLib::Warning( "idBitMsg does not match the reference packer" );
+		return;
+	}
+	idLib::Printf( "%d random messages match the reference packer\n", numMessages );
+
+	// throughput of both packers on the same messages
+	int totalOps = 0;
+	for ( int m = 0; m < BITMSG_TEST_BENCH_MSGS; m++ ) {
+		numOps[m] = BitMsgTest_Generate( random, ops.Ptr() + m * BITMSG_TEST_MAX_OPS );
+		totalOps += numOps[m];
+	}
+	const int numPasses = Max( numMessages / BITMSG_TEST_BENCH_MSGS, 1 );
+
+	uint64 startTime = Sys_Microseconds();
+	for ( int p = 0; p < numPasses; p++ ) {
+		for ( int m = 0; m < BITMSG_TEST_BENCH_MSGS; m++ ) {
+			const bitMsgTestOp_t * msgOps = ops.Ptr() + m * BITMSG_TEST_MAX_OPS;
+			reference.BeginWriting( referenceBuffer.Ptr() );
+			BitMsgTest_WriteReference( reference, msgOps, numOps[m], pool );
+			reference.WriteByteAlign();
+			reference.BeginReading( referenceBuffer.Ptr(), reference.GetSize() );
+			BitMsgTest_ReadReference( reference, msgOps, numOps[m], pool );
+		}
+	}
+	const uint64 referenceUsec = Max( Sys_Microseconds() - startTime, (uint64)1 );
+
+	startTime = Sys_Microseconds();
+	for ( int p = 0; p < numPasses; p++ ) {
+		for ( int m = 0; m < BITMSG_TEST_BENCH_MSGS; m++ ) {
+			const bitMsgTestOp_t * msgOps = ops.Ptr() + m * BITMSG_TEST_MAX_OPS;
+			msg.InitWrite( buffer.Ptr(), BITMSG_TEST_MSG_SIZE );
+			BitMsgTest_Write( msg, msgOps, numOps[m], pool );
+			msg.WriteByteAlign();
+			msg.InitRead( buffer.Ptr(), msg.GetSize() );
+			BitMsgTest_Read( msg, msgOps, numOps[m], pool );
+		}
+	}
+	const uint64 usec = Max( Sys_Microseconds() - startTime, (uint64)1 );
+
+	const float numFields = (float)totalOps * numPasses;
+	idLib::Printf( "reference %.2f msec, %.2f million fields per second\n", referenceUsec * 0.001f, numFields / referenceUsec );
+	idLib::Printf( "idBitMsg  %.2f msec, %.2f million fields per second\n", usec * 0.001f, numFields / usec );
+}
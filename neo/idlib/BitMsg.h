@@ -246,6 +246,8 @@ public:
 	void			SetHasChanged( bool b ) { hasChanged = b; }
 	bool			HasChanged() const { return hasChanged; }
 
+	static void		Test_f( const class idCmdArgs &args );
+
 private:
 	byte *			writeData;		// pointer to data for writing
 	const byte *	readData;		// pointer to data for reading
@@ -263,6 +265,10 @@ private:
 private:
 	bool			CheckOverflow( int numBits );
 	byte *			GetByteSpace( int length );
+
+	// whole bytes at a byte boundary, return false if the general bit path has to be used
+	bool			WriteBytesAligned( uint32 value, int numBytes );
+	bool			ReadBytesAligned( uint32 &value, int numBytes ) const;
 };
 
 /*
@@ -565,6 +571,26 @@ ID_INLINE void idBitMsg::WriteByteAlign() {
 	tempValue = 0;
 }
 
+/*
+========================
+idBitMsg::WriteBytesAligned
+
+Writes the bytes directly when the message is at a byte boundary. The result is
+the same as WriteBits because the bits are stored least significant byte first.
+========================
+*/
+ID_INLINE bool idBitMsg::WriteBytesAligned( uint32 value, int numBytes ) {
+	if ( writeBit != 0 || writeData == NULL || curSize + numBytes > maxSize ) {
+		return false;
+	}
+	byte *dst = writeData + curSize;
+	for ( int i = 0; i < numBytes; i++ ) {
+		dst[i] = (byte)( value >> ( i << 3 ) );
+	}
+	curSize += numBytes;
+	return true;
+}
+
 /*
 ========================
 idBitMsg::WriteBool
@@ -580,7 +606,9 @@ idBitMsg::WriteChar
 ========================
 */
 ID_INLINE void idBitMsg::WriteChar( int8 c ) {
-	WriteBits( c, -8 );
+	if ( !WriteBytesAligned( (uint8)c, 1 ) ) {
+		WriteBits( c, -8 );
+	}
 }
 
 /*
@@ -589,7 +617,9 @@ idBitMsg::WriteByte
 ========================
 */
 ID_INLINE void idBitMsg::WriteByte( uint8 c ) {
-	WriteBits( c, 8 );
+	if ( !WriteBytesAligned( c, 1 ) ) {
+		WriteBits( c, 8 );
+	}
 }
 
 /*
@@ -598,7 +628,9 @@ idBitMsg::WriteShort
 ========================
 */
 ID_INLINE void idBitMsg::WriteShort( int16 c ) {
-	WriteBits( c, -16 );
+	if ( !WriteBytesAligned( (uint16)c, 2 ) ) {
+		WriteBits( c, -16 );
+	}
 }
 
 /*
@@ -607,7 +639,9 @@ idBitMsg::WriteUShort
 ========================
 */
 ID_INLINE void idBitMsg::WriteUShort( uint16 c ) {
-	WriteBits( c, 16 );
+	if ( !WriteBytesAligned( c, 2 ) ) {
+		WriteBits( c, 16 );
+	}
 }
 
 /*
@@ -616,7 +650,9 @@ idBitMsg::WriteLong
 ========================
 */
 ID_INLINE void idBitMsg::WriteLong( int32 c ) {
-	WriteBits( c, 32 );
+	if ( !WriteBytesAligned( (uint32)c, 4 ) ) {
+		WriteBits( c, 32 );
+	}
 }
 
 /*
@@ -627,8 +663,8 @@ idBitMsg::WriteLongLong
 ID_INLINE void idBitMsg::WriteLongLong( int64 c ) {
 	int a = c;
 	int b = c >> 32;
-	WriteBits( a, 32 );
-	WriteBits( b, 32 );
+	WriteLong( a );
+	WriteLong( b );
 }
 
 /*
@@ -637,7 +673,7 @@ idBitMsg::WriteFloat
 ========================
 */
 ID_INLINE void idBitMsg::WriteFloat( float f ) {
-	WriteBits( *reinterpret_cast<int *>(&f), 32 );
+	WriteLong( *reinterpret_cast<int *>(&f) );
 }
 
 /*
@@ -699,6 +735,24 @@ ID_INLINE void idBitMsg::ReadByteAlign() const {
 	readBit = 0;
 }
 
+/*
+========================
+idBitMsg::ReadBytesAligned
+========================
+*/
+ID_INLINE bool idBitMsg::ReadBytesAligned( uint32 &value, int numBytes ) const {
+	if ( readBit != 0 || readData == NULL || readCount + numBytes > curSize ) {
+		return false;
+	}
+	const byte *src = readData + readCount;
+	value = 0;
+	for ( int i = 0; i < numBytes; i++ ) {
+		value |= (uint32)src[i] << ( i << 3 );
+	}
+	readCount += numBytes;
+	return true;
+}
+
 /*
 ========================
 idBitMsg::ReadBool
@@ -714,6 +768,10 @@ idBitMsg::ReadChar
 ========================
 */
 ID_INLINE int idBitMsg::ReadChar() const {
+	uint32 value;
+	if ( ReadBytesAligned( value, 1 ) ) {
+		return (signed char)value;
+	}
 	return (signed char)ReadBits( -8 );
 }
 
@@ -723,6 +781,10 @@ idBitMsg::ReadByte
 ========================
 */
 ID_INLINE int idBitMsg::ReadByte() const {
+	uint32 value;
+	if ( ReadBytesAligned( value, 1 ) ) {
+		return (unsigned char)value;
+	}
 	return (unsigned char)ReadBits( 8 );
 }
 
@@ -732,6 +794,10 @@ idBitMsg::ReadShort
 ========================
 */
 ID_INLINE int idBitMsg::ReadShort() const {
+	uint32 value;
+	if ( ReadBytesAligned( value, 2 ) ) {
+		return (short)value;
+	}
 	return (short)ReadBits( -16 );
 }
 
@@ -741,6 +807,10 @@ idBitMsg::ReadUShort
 ========================
 */
 ID_INLINE int idBitMsg::ReadUShort() const {
+	uint32 value;
+	if ( ReadBytesAligned( value, 2 ) ) {
+		return (unsigned short)value;
+	}
 	return (unsigned short)ReadBits( 16 );
 }
 
@@ -750,6 +820,10 @@ idBitMsg::ReadLong
 ========================
 */
 ID_INLINE int idBitMsg::ReadLong() const {
+	uint32 value;
+	if ( ReadBytesAligned( value, 4 ) ) {
+		return (int)value;
+	}
 	return ReadBits( 32 );
 }
 
@@ -759,8 +833,8 @@ idBitMsg::ReadLongLong
 ========================
 */
 ID_INLINE int64 idBitMsg::ReadLongLong() const {
-	int64 a = ReadBits( 32 );
-	int64 b = ReadBits( 32 );
+	int64 a = ReadLong();
+	int64 b = ReadLong();
 	int64 c = ( 0x00000000ffffffff & a ) | ( b << 32 );
 	return c;
 }
@@ -772,7 +846,7 @@ idBitMsg::ReadFloat
 */
 ID_INLINE float idBitMsg::ReadFloat() const {
 	float value;
-	*reinterpret_cast<int *>(&value) = ReadBits( 32 );
+	*reinterpret_cast<int *>(&value) = ReadLong();
 	return value;
 }
 
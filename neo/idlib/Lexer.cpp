@@ -274,6 +274,176 @@ void idLexer::SetPunctuations( const punctuation_t *p ) {
 	}
 }
 
+/*
+===============================================================================
+
+	Vector scanning
+
+	The white space, comment and name loops look at 16 characters at a
+	time when SSE2 intrinsics are available, unless the lexer was given
+	LEXFL_NOVECTORSCAN. They never read at or past end_p, the last
+	characters of a script go through the scalar loops, which rely on the
+	text being zero terminated like the lexer does.
+
+===============================================================================
+*/
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+ID_INLINE static int CountBits16( unsigned int mask ) {
+	int n = 0;
+	for ( ; mask != 0; mask &= mask - 1 ) {
+		n++;
+	}
+	return n;
+}
+
+ID_INLINE static int FirstBit16( unsigned int mask ) {
+	unsigned long i;
+	_BitScanForward( &i, mask );
+	return (int)i;
+}
+
+// lanes set where lo <= c < lo + n, as an unsigned compare
+ID_INLINE static __m128i InRange16( const __m128i &v, char lo, int n ) {
+	const __m128i bias = _mm_set1_epi8( (char)0x80 );
+	const __m128i t = _mm_xor_si128( _mm_sub_epi8( v, _mm_set1_epi8( lo ) ), bias );
+	return _mm_cmplt_epi8( t, _mm_set1_epi8( (char)( n ^ 0x80 ) ) );
+}
+
+#endif
+
+/*
+================
+SkipSpaces
+
+Returns a pointer to the first character above ' ' or the terminating zero.
+Characters are signed so anything above 127 counts as white space, like
+the original loop.
+================
+*/
+ID_INLINE static const char *SkipSpaces( const char *p, const char *end, int &lines, const int flags ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	if ( !( flags & LEXFL_NOVECTORSCAN ) ) {
+		const __m128i space = _mm_set1_epi8( ' ' );
+		const __m128i newline = _mm_set1_epi8( '\n' );
+		const __m128i zero = _mm_setzero_si128();
+		while ( end - p >= 16 ) {
+			const __m128i v = _mm_loadu_si128( (const __m128i *)p );
+			const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( _mm_cmpgt_epi8( v, space ), _mm_cmpeq_epi8( v, zero ) ) );
+			const unsigned int newlines = _mm_movemask_epi8( _mm_cmpeq_epi8( v, newline ) );
+			if ( stop != 0 ) {
+				const int i = FirstBit16( stop );
+				lines += CountBits16( newlines & ( ( 1u << i ) - 1 ) );
+				return p + i;
+			}
+			lines += CountBits16( newlines );
+			p += 16;
+		}
+	}
+#endif
+	while ( *p <= ' ' && *p ) {
+		if ( *p == '\n' ) {
+			lines++;
+		}
+		p++;
+	}
+	return p;
+}
+
+/*
+================
+FindCharOrZero
+
+Returns a pointer to the first c or terminating zero, counting the new lines before it.
+================
+*/
+ID_INLINE static const char *FindCharOrZero( const char *p, const char *end, const char c, int &lines, const int flags ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	if ( !( flags & LEXFL_NOVECTORSCAN ) ) {
+		const __m128i match = _mm_set1_epi8( c );
+		const __m128i newline = _mm_set1_epi8( '\n' );
+		const __m128i zero = _mm_setzero_si128();
+		while ( end - p >= 16 ) {
+			const __m128i v = _mm_loadu_si128( (const __m128i *)p );
+			const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, match ), _mm_cmpeq_epi8( v, zero ) ) );
+			const unsigned int newlines = _mm_movemask_epi8( _mm_cmpeq_epi8( v, newline ) );
+			if ( stop != 0 ) {
+				const int i = FirstBit16( stop );
+				lines += CountBits16( newlines & ( ( 1u << i ) - 1 ) );
+				return p + i;
+			}
+			lines += CountBits16( newlines );
+			p += 16;
+		}
+	}
+#endif
+	while ( *p != c && *p ) {
+		if ( *p == '\n' ) {
+			lines++;
+		}
+		p++;
+	}
+	return p;
+}
+
+/*
+================
+IsNameChar
+================
+*/
+ID_INLINE static bool IsNameChar( const char c, const int flags ) {
+	return	(c >= 'a' && c <= 'z') ||
+			(c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9') ||
+			c == '_' ||
+			// if treating all tokens as strings, don't parse '-' as a seperate token
+			((flags & LEXFL_ONLYSTRINGS) && (c == '-')) ||
+			// if special path name characters are allowed
+			((flags & LEXFL_ALLOWPATHNAMES) && (c == '/' || c == '\\' || c == ':' || c == '.'));
+}
+
+/*
+================
+NameLength
+
+Returns the number of name characters starting at p.
+================
+*/
+ID_INLINE static int NameLength( const char *p, const char *end, const int flags ) {
+	const char *start = p;
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	if ( !( flags & LEXFL_NOVECTORSCAN ) ) {
+		const bool onlyStrings = ( flags & LEXFL_ONLYSTRINGS ) != 0;
+		const bool pathNames = ( flags & LEXFL_ALLOWPATHNAMES ) != 0;
+		while ( end - p >= 16 ) {
+			const __m128i v = _mm_loadu_si128( (const __m128i *)p );
+			__m128i name = _mm_or_si128( InRange16( v, 'a', 26 ), InRange16( v, 'A', 26 ) );
+			name = _mm_or_si128( name, InRange16( v, '0', 10 ) );
+			name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '_' ) ) );
+			if ( onlyStrings ) {
+				name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '-' ) ) );
+			}
+			if ( pathNames ) {
+				name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '/' ) ) );
+				name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '\\' ) ) );
+				name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( ':' ) ) );
+				name = _mm_or_si128( name, _mm_cmpeq_epi8( v, _mm_set1_epi8( '.' ) ) );
+			}
+			const unsigned int stop = ~_mm_movemask_epi8( name ) & 0xFFFF;
+			if ( stop != 0 ) {
+				return (int)( p - start ) + FirstBit16( stop );
+			}
+			p += 16;
+		}
+	}
+#endif
+	while ( IsNameChar( *p, flags ) ) {
+		p++;
+	}
+	return (int)( p - start );
+}
+
 /*
 ================
 idLexer::ReadWhiteSpace
@@ -285,27 +455,19 @@ When a newline character is found the scripts line counter is increased.
 int idLexer::ReadWhiteSpace() {
 	while(1) {
 		// skip white space
-		while(*idLexer::script_p <= ' ') {
-			if (!*idLexer::script_p) {
-				return 0;
-			}
-			if (*idLexer::script_p == '\n') {
-				idLexer::line++;
-			}
-			idLexer::script_p++;
+		idLexer::script_p = SkipSpaces( idLexer::script_p, idLexer::end_p, idLexer::line, idLexer::flags );
+		if (!*idLexer::script_p) {
+			return 0;
 		}
 		// skip comments
 		if (*idLexer::script_p == '/') {
 			// comments //
 			if (*(idLexer::script_p+1) == '/') {
-				idLexer::script_p++;
-				do {
-					idLexer::script_p++;
-					if ( !*idLexer::script_p ) {
-						return 0;
-					}
+				int lines = 0;
+				idLexer::script_p = FindCharOrZero( idLexer::script_p + 2, idLexer::end_p, '\n', lines, idLexer::flags );
+				if ( !*idLexer::script_p ) {
+					return 0;
 				}
-				while( *idLexer::script_p != '\n' );
 				idLexer::line++;
 				idLexer::script_p++;
 				if ( !*idLexer::script_p ) {
@@ -317,20 +479,15 @@ int idLexer::ReadWhiteSpace() {
 			else if (*(idLexer::script_p+1) == '*') {
 				idLexer::script_p++;
 				while( 1 ) {
-					idLexer::script_p++;
+					idLexer::script_p = FindCharOrZero( idLexer::script_p + 1, idLexer::end_p, '/', idLexer::line, idLexer::flags );
 					if ( !*idLexer::script_p ) {
 						return 0;
 					}
-					if ( *idLexer::script_p == '\n' ) {
-						idLexer::line++;
+					if ( *(idLexer::script_p-1) == '*' ) {
+						break;
 					}
-					else if ( *idLexer::script_p == '/' ) {
-						if ( *(idLexer::script_p-1) == '*' ) {
-							break;
-						}
-						if ( *(idLexer::script_p+1) == '*' ) {
-							idLexer::Warning( "nested comment" );
-						}
+					if ( *(idLexer::script_p+1) == '*' ) {
+						idLexer::Warning( "nested comment" );
 					}
 				}
 				idLexer::script_p++;
@@ -617,20 +774,11 @@ idLexer::ReadName
 ================
 */
 int idLexer::ReadName( idToken *token ) {
-	char c;
-
 	token->type = TT_NAME;
-	do {
-		token->AppendDirty( *idLexer::script_p++ );
-		c = *idLexer::script_p;
-	} while ((c >= 'a' && c <= 'z') ||
-				(c >= 'A' && c <= 'Z') ||
-				(c >= '0' && c <= '9') ||
-				c == '_' ||
-				// if treating all tokens as strings, don't parse '-' as a seperate token
-				((idLexer::flags & LEXFL_ONLYSTRINGS) && (c == '-')) ||
-				// if special path name characters are allowed
-				((idLexer::flags & LEXFL_ALLOWPATHNAMES) && (c == '/' || c == '\\' || c == ':' || c == '.')) );
+	// the first character is always taken, the caller decided it starts a name
+	const int l = 1 + NameLength( idLexer::script_p + 1, idLexer::end_p, idLexer::flags );
+	token->AppendDirty( idLexer::script_p, l );
+	idLexer::script_p += l;
 	token->data[token->len] = '\0';
 	//the sub type is the length of the name
 	token->subtype = token->Length();
@@ -920,6 +1068,10 @@ int idLexer::ReadToken( idToken *token ) {
 		*token = idLexer::token;
 		return 1;
 	}
+	// if the token was read ahead of time
+	if ( tokenStream != NULL && ReadStreamToken( token ) ) {
+		return 1;
+	}
 	// save script pointer
 	lastScript_p = script_p;
 	// save line counter
@@ -1000,6 +1152,65 @@ int idLexer::ReadToken( idToken *token ) {
 	return 1;
 }
 
+/*
+================
+idLexer::ReadStreamToken
+
+Replays the token read from the current position by the token stream.
+================
+*/
+int idLexer::ReadStreamToken( idToken *token ) {
+	if ( tokenStream->flags != flags || tokenStream->punctuations != punctuations ) {
+		return 0;
+	}
+
+	const int offset = script_p - buffer;
+
+	// usually the next token, back up for a read after a peek and start over when
+	// the script pointer moved back further, skip forward after SkipRestOfLine and the like
+	if ( offset < streamCursor.end ) {
+		if ( offset >= streamPrevCursor.end ) {
+			streamCursor = streamPrevCursor;
+		} else {
+			tokenStream->StartCursor( streamCursor );
+		}
+	}
+
+	idTokenStream::streamToken_t streamed;
+	idTokenStream::streamCursor_t cursor;
+	do {
+		cursor = streamCursor;
+		if ( !tokenStream->Decode( streamCursor, streamed ) ) {
+			streamCursor = cursor;
+			return 0;
+		}
+	} while ( streamed.whiteSpaceStart < offset );
+
+	if ( streamed.whiteSpaceStart != offset || streamed.lastLine != line ) {
+		streamCursor = cursor;
+		return 0;
+	}
+	streamPrevCursor = cursor;
+
+	token->Empty();
+	token->Append( ( streamed.text != NULL ) ? streamed.text : buffer + streamed.whiteSpaceEnd, streamed.textLength );
+	token->type = streamed.type;
+	token->subtype = streamed.subtype;
+	token->line = streamed.line;
+	token->linesCrossed = streamed.line - streamed.lastLine;
+	token->flags = 0;
+	token->whiteSpaceStart_p = buffer + streamed.whiteSpaceStart;
+	token->whiteSpaceEnd_p = buffer + streamed.whiteSpaceEnd;
+
+	lastScript_p = script_p;
+	lastline = line;
+	whiteSpaceStart_p = token->whiteSpaceStart_p;
+	whiteSpaceEnd_p = token->whiteSpaceEnd_p;
+	script_p = buffer + streamed.end;
+	line = streamed.endLine;
+	return 1;
+}
+
 /*
 ================
 idLexer::ExpectTokenString
@@ -1812,9 +2023,27 @@ void idLexer::FreeSource() {
 	}
 	idLexer::tokenavailable = 0;
 	idLexer::token = "";
+	idLexer::tokenStream = NULL;
 	idLexer::loaded = false;
 }
 
+/*
+================
+idLexer::SetTokenStream
+================
+*/
+void idLexer::SetTokenStream( const idTokenStream *stream ) {
+	if ( stream != NULL && stream->length != idLexer::length ) {
+		idLib::common->Warning( "idLexer::SetTokenStream: stream doesn't match '%s'", idLexer::filename.c_str() );
+		stream = NULL;
+	}
+	idLexer::tokenStream = stream;
+	if ( stream != NULL ) {
+		stream->StartCursor( idLexer::streamCursor );
+		idLexer::streamPrevCursor = idLexer::streamCursor;
+	}
+}
+
 /*
 ================
 idLexer::idLexer
@@ -1834,6 +2063,7 @@ idLexer::idLexer() {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenStream = NULL;
 }
 
 /*
@@ -1855,6 +2085,7 @@ idLexer::idLexer( int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenStream = NULL;
 }
 
 /*
@@ -1870,6 +2101,7 @@ idLexer::idLexer( const char *filename, int flags, bool OSPath ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenStream = NULL;
 	idLexer::LoadFile( filename, OSPath );
 }
 
@@ -1886,6 +2118,7 @@ idLexer::idLexer( const char *ptr, int length, const char *name, int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenStream = NULL;
 	idLexer::LoadMemory( ptr, length, name );
 }
 
@@ -1916,3 +2149,350 @@ bool idLexer::HadError() const {
 	return hadError;
 }
 
+
+/*
+================
+idTokenStream::idTokenStream
+================
+*/
+idTokenStream::idTokenStream() {
+	numTokens = 0;
+	length = 0;
+	startLine = 1;
+	flags = 0;
+	punctuations = NULL;
+}
+
+/*
+================
+idTokenStream::Clear
+================
+*/
+void idTokenStream::Clear() {
+	data.Clear();
+	numTokens = 0;
+	length = 0;
+	startLine = 1;
+	flags = 0;
+	punctuations = NULL;
+}
+
+/*
+================
+idTokenStream::StartCursor
+================
+*/
+void idTokenStream::StartCursor( streamCursor_t &cursor ) const {
+	cursor.pos = 0;
+	cursor.end = 0;
+	cursor.endLine = startLine;
+}
+
+/*
+================
+WriteStreamValue / ReadStreamValue
+
+Unsigned values in 7 bit groups, the high bit is set if more groups follow.
+================
+*/
+static void WriteStreamValue( idList< byte, TAG_IDLIB_LEXER > &data, unsigned int value ) {
+	while ( value >= 0x80 ) {
+		data.Append( (byte)( value | 0x80 ) );
+		value >>= 7;
+	}
+	data.Append( (byte)value );
+}
+
+static bool ReadStreamValue( const byte *data, int num, int &pos, int &value ) {
+	unsigned int v = 0;
+	for ( int shift = 0; shift < 32; shift += 7 ) {
+		if ( pos >= num ) {
+			return false;
+		}
+		const byte b = data[pos++];
+		v |= (unsigned int)( b & 0x7F ) << shift;
+		if ( ( b & 0x80 ) == 0 ) {
+			value = (int)v;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+================
+idTokenStream::Encode
+
+Offsets and lines are stored relative to the token before, they only increase.
+================
+*/
+void idTokenStream::Encode( const streamToken_t &token, int prevEnd, int prevEndLine ) {
+	WriteStreamValue( data, token.whiteSpaceStart - prevEnd );
+	WriteStreamValue( data, token.whiteSpaceEnd - token.whiteSpaceStart );
+	WriteStreamValue( data, token.end - token.whiteSpaceEnd );
+	WriteStreamValue( data, token.lastLine - prevEndLine );
+	WriteStreamValue( data, token.line - token.lastLine );
+	WriteStreamValue( data, token.endLine - token.line );
+	WriteStreamValue( data, ( token.type << 1 ) | ( token.text != NULL ? 1 : 0 ) );
+	WriteStreamValue( data, token.subtype );
+	if ( token.text != NULL ) {
+		WriteStreamValue( data, token.textLength );
+		for ( int i = 0; i < token.textLength; i++ ) {
+			data.Append( token.text[i] );
+		}
+	}
+}
+
+/*
+================
+idTokenStream::Decode
+
+Decodes the token at the cursor and moves the cursor past it, returns false at the end of the stream.
+================
+*/
+bool idTokenStream::Decode( streamCursor_t &cursor, streamToken_t &token ) const {
+	const byte *ptr = data.Ptr();
+	const int num = data.Num();
+	int pos = cursor.pos;
+	int v[8];
+	for ( int i = 0; i < 8; i++ ) {
+		if ( !ReadStreamValue( ptr, num, pos, v[i] ) ) {
+			return false;
+		}
+	}
+	token.whiteSpaceStart = cursor.end + v[0];
+	token.whiteSpaceEnd = token.whiteSpaceStart + v[1];
+	token.end = token.whiteSpaceEnd + v[2];
+	token.lastLine = cursor.endLine + v[3];
+	token.line = token.lastLine + v[4];
+	token.endLine = token.line + v[5];
+	token.type = v[6] >> 1;
+	token.subtype = v[7];
+	if ( v[6] & 1 ) {
+		if ( !ReadStreamValue( ptr, num, pos, token.textLength ) || token.textLength > num - pos ) {
+			return false;
+		}
+		token.text = (const char *)ptr + pos;
+		pos += token.textLength;
+	} else {
+		token.text = NULL;
+		token.textLength = token.end - token.whiteSpaceEnd;
+	}
+	cursor.pos = pos;
+	cursor.end = token.end;
+	cursor.endLine = token.endLine;
+	return true;
+}
+
+/*
+================
+idTokenStream::Tokenize
+
+Warnings are printed while tokenizing, they aren't repeated when the tokens are replayed.
+================
+*/
+bool idTokenStream::Tokenize( const char *ptr, int length, const char *name, int flags, const punctuation_t *punctuations, int startLine ) {
+	Clear();
+
+	idLexer src( flags | LEXFL_NOERRORS | LEXFL_NOFATALERRORS );
+	if ( punctuations != NULL ) {
+		src.SetPunctuations( punctuations );
+	}
+	if ( !src.LoadMemory( ptr, length, name, startLine ) ) {
+		return false;
+	}
+
+	idToken token;
+	int prevEnd = 0;
+	int prevEndLine = startLine;
+	while ( 1 ) {
+		streamToken_t streamed;
+		streamed.whiteSpaceStart = src.GetFileOffset();
+		streamed.lastLine = src.GetLineNum();
+		if ( !src.ReadToken( &token ) ) {
+			break;
+		}
+		streamed.whiteSpaceEnd = src.GetLastWhiteSpaceEnd();
+		streamed.end = src.GetFileOffset();
+		streamed.line = token.line;
+		streamed.endLine = src.GetLineNum();
+		streamed.type = token.type;
+		streamed.subtype = token.subtype & ~TT_VALUESVALID;
+		// strings and the like aren't a copy of the text, store them with the token
+		const int textLength = streamed.end - streamed.whiteSpaceEnd;
+		if ( token.Length() == textLength && idStr::Cmpn( token.c_str(), ptr + streamed.whiteSpaceEnd, textLength ) == 0 ) {
+			streamed.text = NULL;
+			streamed.textLength = textLength;
+		} else {
+			streamed.text = token.c_str();
+			streamed.textLength = token.Length();
+		}
+		Encode( streamed, prevEnd, prevEndLine );
+		prevEnd = streamed.end;
+		prevEndLine = streamed.endLine;
+		numTokens++;
+	}
+
+	if ( src.HadError() ) {
+		Clear();
+		return false;
+	}
+
+	data.Condense();
+	this->length = length;
+	this->startLine = startLine;
+	this->flags = flags;
+	this->punctuations = src.punctuations;
+	return true;
+}
+
+/*
+================
+idTokenStream::WriteToFileHandle
+================
+*/
+bool idTokenStream::WriteToFileHandle( idFile *f ) const {
+	if ( punctuations != NULL && punctuations != default_punctuations ) {
+		return false;
+	}
+	f->WriteInt( numTokens );
+	f->WriteInt( length );
+	f->WriteInt( startLine );
+	f->WriteInt( flags );
+	f->WriteInt( data.Num() );
+	return f->Write( data.Ptr(), data.Num() ) == data.Num();
+}
+
+/*
+================
+idTokenStream::ReadFromFileHandle
+================
+*/
+bool idTokenStream::ReadFromFileHandle( idFile *f ) {
+	Clear();
+	int num = 0;
+	f->ReadInt( numTokens );
+	f->ReadInt( length );
+	f->ReadInt( startLine );
+	f->ReadInt( flags );
+	f->ReadInt( num );
+	if ( num < 0 || numTokens < 0 || length < 0 ) {
+		Clear();
+		return false;
+	}
+	data.SetNum( num );
+	if ( f->Read( data.Ptr(), num ) != num ) {
+		Clear();
+		return false;
+	}
+	punctuations = default_punctuations;
+	return true;
+}
+
+/*
+================
+idLexer::Test_f
+
+testLexer [folder] [extension]
+Reads all tokens from the scripts in a folder, with and without vector
+scanning and from token streams, and prints the throughput of each.
+================
+*/
+void idLexer::Test_f( const idCmdArgs &args ) {
+	const char *folder = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "def";
+	const char *extension = ( args.Argc() > 2 ) ? args.Argv( 2 ) : ".def";
+	const int lexerFlags = LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_ALLOWBACKSLASHSTRINGCONCAT | LEXFL_NOFATALERRORS;
+	const int numPasses = 4;
+
+	struct testFile_t {
+		idStr			name;
+		char *			buffer;
+		int				length;
+		idTokenStream	stream;
+	};
+
+	idFileList *fileList = idLib::fileSystem->ListFilesTree( folder, extension, true );
+	idList< testFile_t > files;
+	files.SetNum( fileList->GetNumFiles() );
+	size_t totalBytes = 0;
+	for ( int i = 0; i < fileList->GetNumFiles(); i++ ) {
+		testFile_t &file = files[i];
+		file.name = fileList->GetFile( i );
+		file.buffer = NULL;
+		file.length = idLib::fileSystem->ReadFile( file.name, (void **)&file.buffer );
+		if ( file.length < 0 ) {
+			file.buffer = NULL;
+			file.length = 0;
+		}
+		totalBytes += file.length;
+	}
+	idLib::fileSystem->FreeFileList( fileList );
+
+	if ( totalBytes == 0 ) {
+		idLib::common->Printf( "no %s files found in %s\n", extension, folder );
+		return;
+	}
+
+	struct local {
+		// best time of all passes in microseconds
+		static uint64 LexFiles( idList< testFile_t > &files, int lexerFlags, bool useStreams, int numPasses, int &numTokens ) {
+			uint64 best = 0;
+			for ( int pass = 0; pass < numPasses; pass++ ) {
+				numTokens = 0;
+				const uint64 start = Sys_Microseconds();
+				for ( int i = 0; i < files.Num(); i++ ) {
+					if ( files[i].buffer == NULL ) {
+						continue;
+					}
+					idLexer src( lexerFlags );
+					src.LoadMemory( files[i].buffer, files[i].length, files[i].name );
+					if ( useStreams ) {
+						src.SetTokenStream( &files[i].stream );
+					}
+					idToken token;
+					while ( src.ReadToken( &token ) ) {
+						numTokens++;
+					}
+				}
+				const uint64 time = Sys_Microseconds() - start;
+				if ( pass == 0 || time < best ) {
+					best = time;
+				}
+			}
+			return Max( best, (uint64)1 );
+		}
+		static void Print( const char *label, size_t totalBytes, int numTokens, uint64 time ) {
+			idLib::common->Printf( "%-16s %8d tokens %8.2f msec %8.1f MB/s\n", label, numTokens, time * 0.001f, ( totalBytes / ( 1024.0f * 1024.0f ) ) / ( time * 0.000001f ) );
+		}
+	};
+
+	idLib::common->Printf( "lexing %d %s files from %s, %.1f MB, best of %d passes\n", files.Num(), extension, folder, totalBytes / ( 1024.0f * 1024.0f ), numPasses );
+
+	int numTokens = 0;
+	uint64 time;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	time = local::LexFiles( files, lexerFlags, false, numPasses, numTokens );
+	local::Print( "SSE2 scanning", totalBytes, numTokens, time );
+#endif
+
+	time = local::LexFiles( files, lexerFlags | LEXFL_NOVECTORSCAN, false, numPasses, numTokens );
+	local::Print( "scalar scanning", totalBytes, numTokens, time );
+
+	size_t streamBytes = 0;
+	const uint64 tokenizeStart = Sys_Microseconds();
+	for ( int i = 0; i < files.Num(); i++ ) {
+		if ( files[i].buffer != NULL ) {
+			files[i].stream.Tokenize( files[i].buffer, files[i].length, files[i].name, lexerFlags );
+			streamBytes += files[i].stream.Allocated();
+		}
+	}
+	idLib::common->Printf( "%-16s %8.2f msec %8d kB\n", "tokenizing", ( Sys_Microseconds() - tokenizeStart ) * 0.001f, (int)( streamBytes >> 10 ) );
+
+	time = local::LexFiles( files, lexerFlags, true, numPasses, numTokens );
+	local::Print( "token streams", totalBytes, numTokens, time );
+
+	for ( int i = 0; i < files.Num(); i++ ) {
+		idLib::fileSystem->FreeFile( files[i].buffer );
+	}
+}
@@ -60,7 +60,8 @@ typedef enum {
 	LEXFL_ALLOWFLOATEXCEPTIONS			= BIT(10),	// allow float exceptions like 1.#INF or 1.#IND to be parsed
 	LEXFL_ALLOWMULTICHARLITERALS		= BIT(11),	// allow multi character literals
 	LEXFL_ALLOWBACKSLASHSTRINGCONCAT	= BIT(12),	// allow multiple strings seperated by '\' to be concatenated
-	LEXFL_ONLYSTRINGS					= BIT(13)	// parse as whitespace deliminated strings (quoted strings keep quotes)
+	LEXFL_ONLYSTRINGS					= BIT(13),	// parse as whitespace deliminated strings (quoted strings keep quotes)
+	LEXFL_NOVECTORSCAN					= BIT(14)	// scan white space, comments and names one character at a time
 } lexerFlags_t;
 
 // punctuation ids
@@ -133,10 +134,83 @@ typedef struct punctuation_s
 	int n;							// punctuation id
 } punctuation_t;
 
+/*
+===============================================================================
+
+	idTokenStream
+
+	The tokens of a script read ahead of time. A lexer that is loaded with
+	the same text can replay them instead of lexing the text again, see
+	idLexer::SetTokenStream. Tokens are only replayed while the lexer is at
+	the position and line they were read from with the same flags and
+	punctuations, anything else falls back to lexing the text.
+
+	The tokens are packed as variable length deltas. A token that is a
+	verbatim copy of the text is not stored, it is copied from the text the
+	lexer is loaded with, so a stream takes about as much memory as the text.
+
+===============================================================================
+*/
+
+class idTokenStream {
+
+	friend class idLexer;
+
+public:
+					idTokenStream();
+
+					// read all tokens from the given text, returns false if the lexer had an error
+	bool			Tokenize( const char *ptr, int length, const char *name, int flags = 0, const punctuation_t *punctuations = NULL, int startLine = 1 );
+					// free the tokens
+	void			Clear();
+					// number of tokens in the stream
+	int				Num() const { return numTokens; }
+					// length of the text that was tokenized
+	int				GetLength() const { return length; }
+					// memory used by the stream
+	size_t			Allocated() const { return data.Allocated(); }
+					// only streams tokenized with the default punctuations can be written
+	bool			WriteToFileHandle( idFile *f ) const;
+	bool			ReadFromFileHandle( idFile *f );
+
+	// position in the packed tokens and the end of the token before it
+	struct streamCursor_t {
+		int			pos;
+		int			end;
+		int			endLine;
+	};
+
+private:
+	struct streamToken_t {
+		int			whiteSpaceStart;		// offset of the white space before the token
+		int			whiteSpaceEnd;			// offset of the token
+		int			end;					// offset after the token
+		int			lastLine;				// line before the token was read
+		int			line;					// line the token is on
+		int			endLine;				// line after the token was read
+		int			type;
+		int			subtype;
+		const char *text;					// NULL if the token is the text between whiteSpaceEnd and end
+		int			textLength;
+	};
+
+	idList< byte, TAG_IDLIB_LEXER >	data;	// packed tokens
+	int				numTokens;
+	int				length;					// length of the text that was tokenized
+	int				startLine;				// line the text was tokenized from
+	int				flags;					// lexer flags the text was tokenized with
+	const punctuation_t *punctuations;		// punctuations the text was tokenized with
+
+	void			StartCursor( streamCursor_t &cursor ) const;
+	bool			Decode( streamCursor_t &cursor, streamToken_t &token ) const;
+	void			Encode( const streamToken_t &token, int prevEnd, int prevEndLine );
+};
+
 
 class idLexer {
 
 	friend class idParser;
+	friend class idTokenStream;
 
 public:
 					// constructor
@@ -152,6 +226,8 @@ public:
 					// so source strings extracted from a file can still refer to proper line numbers in the file
 					// NOTE: the ptr is expected to point at a valid C string: ptr[length] == '\0'
 	int				LoadMemory( const char *ptr, size_t length, const char *name, int startLine = 1 );
+					// replay tokens from a stream that was tokenized from the loaded text, NULL to stop replaying
+	void			SetTokenStream( const idTokenStream *stream );
 					// free the script
 	void			FreeSource();
 					// returns true if a script is loaded
@@ -244,6 +320,8 @@ public:
 
 					// set the base folder to load files from
 	static void		SetBaseFolder( const char *path );
+					// measure lexing throughput on a folder of scripts
+	static void		Test_f( const class idCmdArgs &args );
 
 private:
 	int				loaded;					// set when a script file is loaded from file or memory
@@ -267,6 +345,9 @@ private:
 	idToken			token;					// available token
 	idLexer *		next;					// next script in a chain
 	bool			hadError;				// set by idLexer::Error, even if the error is supressed
+	const idTokenStream *tokenStream;		// tokens read ahead of time from the same text
+	idTokenStream::streamCursor_t streamCursor;		// next token to replay from the stream
+	idTokenStream::streamCursor_t streamPrevCursor;	// last token replayed, for a read after a peek
 
 	static char		baseFolder[ 256 ];		// base folder to load files from
 
@@ -279,6 +360,7 @@ private:
 	int				ReadNumber( idToken *token );
 	int				ReadPunctuation( idToken *token );
 	int				ReadPrimitive( idToken *token );
+	int				ReadStreamToken( idToken *token );
 	int				CheckString( const char *str ) const;
 	int				NumLinesCrossed();
 };
@@ -99,6 +99,9 @@ void idLib::ShutDown() {
 	// shut down the dictionary string pools
 	idDict::Shutdown();
 
+	// free the tokens the parsers kept for reuse
+	idParser::PurgeTokenPool();
+
 	// shut down the string memory allocator
 	idStr::ShutdownMemory();
 
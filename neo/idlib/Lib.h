@@ -294,6 +294,7 @@ public:
 #include "containers/LinkList.h"
 #include "containers/Hierarchy.h"
 #include "containers/Queue.h"
+#include "containers/SPSCQueue.h"
 #include "containers/Stack.h"
 #include "containers/StrList.h"
 #include "containers/StrPool.h"
@@ -310,6 +311,7 @@ public:
 #include "LangDict.h"
 #include "DataQueue.h"
 #include "BitMsg.h"
+#include "NetSchema.h"
 #include "MapFile.h"
 #include "Timer.h"
 #include "Thread.h"
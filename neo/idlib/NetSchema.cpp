@@ -0,0 +1,293 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+idNetSchema * idNetSchema::schemas = NULL;
+
+/*
+========================
+NetSchemaId
+
+16 bit FNV-1a hash of the schema name.
+========================
+*/
+static int NetSchemaId( const char * name ) {
+	uint32 hash = 2166136261U;
+	for ( const char * c = name; *c != '\0'; c++ ) {
+		hash = ( hash ^ (byte)*c ) * 16777619U;
+	}
+	return (int)( ( hash >> 16 ) ^ ( hash & 0xFFFF ) );
+}
+
+/*
+========================
+idNetSchema::idNetSchema
+========================
+*/
+idNetSchema::idNetSchema( const char * name_, const netField_t * fields_, int numFields_ ) {
+	assert( numFields_ > 0 && numFields_ <= MAX_FIELDS );
+
+	name		= name_;
+	id			= NetSchemaId( name_ );
+	numFields	= Min( numFields_, (int)MAX_FIELDS );
+	blockSize	= 0;
+
+	for ( int i = 0; i < numFields; i++ ) {
+		fields[i] = fields_[i];
+		assert( fields[i].bits >= 1 && fields[i].bits <= 32 );
+		fields[i].offset	= blockSize;
+		fields[i].bytes		= ( fields[i].bits + 7 ) >> 3;
+		blockSize += fields[i].bytes;
+	}
+
+	// the id goes over the wire, so two schemas can't share one
+	assert( FindById( id ) == NULL );
+
+	next = schemas;
+	schemas = this;
+}
+
+/*
+========================
+idNetSchema::~idNetSchema
+========================
+*/
+idNetSchema::~idNetSchema() {
+	for ( idNetSchema ** schema = &schemas; *schema != NULL; schema = &(*schema)->next ) {
+		if ( *schema == this ) {
+			*schema = next;
+			break;
+		}
+	}
+}
+
+/*
+========================
+idNetSchema::Int
+========================
+*/
+netField_t idNetSchema::Int( const char * name, int bits, netFieldPredict_t predict ) {
+	netField_t field;
+	memset( &field, 0, sizeof( field ) );
+	field.name		= name;
+	field.type		= NET_FIELD_INT;
+	field.predict	= predict;
+	field.bits		= bits;
+	return field;
+}
+
+/*
+========================
+idNetSchema::Float
+========================
+*/
+netField_t idNetSchema::Float( const char * name, netFieldPredict_t predict ) {
+	netField_t field;
+	memset( &field, 0, sizeof( field ) );
+	field.name		= name;
+	field.type		= NET_FIELD_FLOAT;
+	field.predict	= predict;
+	field.bits		= 32;
+	return field;
+}
+
+/*
+========================
+idNetSchema::FloatBits
+========================
+*/
+netField_t idNetSchema::FloatBits( const char * name, int exponentBits, int mantissaBits, netFieldPredict_t predict ) {
+	netField_t field;
+	memset( &field, 0, sizeof( field ) );
+	field.name			= name;
+	field.type			= NET_FIELD_FLOAT_BITS;
+	field.predict		= predict;
+	field.bits			= 1 + exponentBits + mantissaBits;
+	field.exponentBits	= exponentBits;
+	field.mantissaBits	= mantissaBits;
+	return field;
+}
+
+/*
+========================
+idNetSchema::Quantized
+========================
+*/
+netField_t idNetSchema::Quantized( const char * name, float min, float max, int bits, netFieldPredict_t predict ) {
+	assert( max > min && bits <= 31 );
+
+	netField_t field;
+	memset( &field, 0, sizeof( field ) );
+	field.name		= name;
+	field.type		= NET_FIELD_QUANTIZED;
+	field.predict	= predict;
+	field.bits		= bits;
+	field.min		= min;
+	field.max		= max;
+	return field;
+}
+
+/*
+========================
+idNetSchema::FindById
+========================
+*/
+const idNetSchema * idNetSchema::FindById( int id ) {
+	for ( const idNetSchema * schema = schemas; schema != NULL; schema = schema->next ) {
+		if ( schema->id == id ) {
+			return schema;
+		}
+	}
+	return NULL;
+}
+
+/*
+========================
+idNetSchema::EncodeInt
+========================
+*/
+uint32 idNetSchema::EncodeInt( int index, int value ) const {
+	assert( fields[index].type == NET_FIELD_INT );
+	return (uint32)value & SlotMask( index );
+}
+
+/*
+========================
+idNetSchema::DecodeInt
+========================
+*/
+int idNetSchema::DecodeInt( int index, uint32 bits ) const {
+	assert( fields[index].type == NET_FIELD_INT );
+	// sign extend from the field's width, so negative values survive narrow fields
+	const int shift = 32 - fields[index].bits;
+	return (int32)( bits << shift ) >> shift;
+}
+
+/*
+========================
+idNetSchema::EncodeFloat
+========================
+*/
+uint32 idNetSchema::EncodeFloat( int index, float value ) const {
+	const netField_t & field = fields[index];
+
+	switch ( field.type ) {
+		case NET_FIELD_FLOAT: {
+			uint32 bits;
+			memcpy( &bits, &value, sizeof( bits ) );
+			return bits;
+		}
+		case NET_FIELD_FLOAT_BITS:
+			return (uint32)idMath::FloatToBits( value, field.exponentBits, field.mantissaBits ) & SlotMask( index );
+		case NET_FIELD_QUANTIZED: {
+			// doubles, so 24 bit and wider fields still round to the nearest step
+			const double steps = (double)SlotMask( index );
+			const double fraction = ( (double)idMath::ClampFloat( field.min, field.max, value ) - field.min ) / ( (double)field.max - field.min );
+			return (uint32)( fraction * steps + 0.5 );
+		}
+		default:
+			assert( !"idNetSchema::EncodeFloat: not a float field" );
+			return 0;
+	}
+}
+
+/*
+========================
+idNetSchema::DecodeFloat
+========================
+*/
+float idNetSchema::DecodeFloat( int index, uint32 bits ) const {
+	const netField_t & field = fields[index];
+
+	switch ( field.type ) {
+		case NET_FIELD_FLOAT: {
+			float value;
+			memcpy( &value, &bits, sizeof( value ) );
+			return value;
+		}
+		case NET_FIELD_FLOAT_BITS:
+			return idMath::BitsToFloat( (int)bits, field.exponentBits, field.mantissaBits );
+		case NET_FIELD_QUANTIZED: {
+			const double steps = (double)SlotMask( index );
+			return (float)( field.min + ( (double)field.max - field.min ) * ( ( bits & SlotMask( index ) ) / steps ) );
+		}
+		default:
+			assert( !"idNetSchema::DecodeFloat: not a float field" );
+			return 0.0f;
+	}
+}
+
+/*
+========================
+idNetSchema::WriteDelta
+========================
+*/
+int idNetSchema::WriteDelta( const byte * oldBlock, const byte * newBlock, byte * dest, int maxSize ) const {
+	const int maskBytes = ( numFields + 7 ) >> 3;
+	if ( maskBytes > maxSize ) {
+		return -1;
+	}
+	memset( dest, 0, maskBytes );
+
+	int size = maskBytes;
+	for ( int i = 0; i < numFields; i++ ) {
+		const uint32 oldBits = ReadSlot( oldBlock, i );
+		const uint32 newBits = ReadSlot( newBlock, i );
+		if ( oldBits == newBits ) {
+			continue;
+		}
+
+		dest[i >> 3] |= 1 << ( i & 7 );
+
+		if ( fields[i].predict == NET_PREDICT_DELTA ) {
+			// the difference as a signed number of the field's width, zig-zag encoded so 
+			// small steps in either direction take few bytes
+			const int shift = 32 - fields[i].bits;
+			const int32 delta = (int32)( ( newBits - oldBits ) << shift ) >> shift;
+			uint32 zigzag = ( (uint32)delta << 1 ) ^ (uint32)( delta >> 31 );
+			do {
+				if ( size >= maxSize ) {
+					return -1;
+				}
+				const byte value = (byte)( zigzag & 0x7F );
+				zigzag >>= 7;
+				dest[size++] = value | ( ( zigzag != 0 ) ? 0x80 : 0 );
+			} while ( zigzag != 0 );
+		} else {
+			if ( size + fields[i].bytes > maxSize ) {
+				return -1;
+			}
+			for ( int b = 0; b < fields[i].bytes; b++ ) {
+				dest[size++] = (byte)( newBits >> ( b * 8 ) );
+			}
+		}
+	}
+	return size;
+}
@@ -0,0 +1,260 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __NETSCHEMA_H__
+#define __NETSCHEMA_H__
+
+/*
+================================================================================================
+
+	idNetSchema
+
+A typed description of a block of network state: an ordered list of fields, each with a bit
+width, a quantization, and a hint on how to send it once it changed.
+
+A field block is written to an idBitMsg byte aligned, one little endian slot per field, with
+idNetFieldWriter and read back with idNetFieldReader.  Because every field has a fixed place,
+the snapshot system can send a change mask followed by only the changed fields (WriteDelta)
+instead of diffing the object as bytes, where a moving entity touches most of them.
+
+Schemas register themselves when they are constructed, so they should be globals.  The hash
+of the name is the id sent with field deltas, both sides find the same schema as long as they
+run the same build.
+================================================================================================
+*/
+
+enum netFieldType_t {
+	NET_FIELD_INT,			// Signed integer of 1 - 32 bits, values outside the width wrap
+	NET_FIELD_FLOAT,		// Full precision float
+	NET_FIELD_FLOAT_BITS,	// Float with fewer exponent and mantissa bits, see idMath::FloatToBits
+	NET_FIELD_QUANTIZED		// Float clamped to a range, and quantized to a number of bits
+};
+
+enum netFieldPredict_t {
+	NET_PREDICT_NONE,		// A changed field sends its new value, for values that jump around (states, ids)
+	NET_PREDICT_DELTA		// A changed field sends the difference to the old value, for values that change smoothly
+};
+
+struct netField_t {
+	const char *		name;
+	netFieldType_t		type;
+	netFieldPredict_t	predict;
+	int					bits;
+	int					exponentBits;		// NET_FIELD_FLOAT_BITS
+	int					mantissaBits;
+	float				min;				// NET_FIELD_QUANTIZED
+	float				max;
+	int					offset;				// Offset of the slot in the field block, set by idNetSchema
+	int					bytes;				// Size of the slot
+};
+
+class idNetSchema {
+public:
+	static const int	MAX_FIELDS = 64;
+
+						idNetSchema( const char * name, const netField_t * fields, int numFields );
+						~idNetSchema();
+
+	// Field descriptions for the constructor
+	static netField_t	Int( const char * name, int bits, netFieldPredict_t predict = NET_PREDICT_NONE );
+	static netField_t	Float( const char * name, netFieldPredict_t predict = NET_PREDICT_DELTA );
+	static netField_t	FloatBits( const char * name, int exponentBits, int mantissaBits, netFieldPredict_t predict = NET_PREDICT_DELTA );
+	static netField_t	Quantized( const char * name, float min, float max, int bits, netFieldPredict_t predict = NET_PREDICT_DELTA );
+
+	const char *		GetName() const { return name; }
+	int					GetId() const { return id; }
+	int					NumFields() const { return numFields; }
+	const netField_t &	GetField( int index ) const { return fields[index]; }
+	int					GetBlockSize() const { return blockSize; }
+
+	// Conversion between values and the bits stored in a slot
+	uint32				EncodeInt( int index, int value ) const;
+	uint32				EncodeFloat( int index, float value ) const;
+	int					DecodeInt( int index, uint32 bits ) const;
+	float				DecodeFloat( int index, uint32 bits ) const;
+
+	// Writes a change mask for the fields that differ between the two blocks, followed by the changed fields.
+	// Returns the number of bytes written to dest, or -1 if they didn't fit in maxSize.
+	int					WriteDelta( const byte * oldBlock, const byte * newBlock, byte * dest, int maxSize ) const;
+
+	// Rebuilds newBlock from oldBlock and a delta read from src, which can be anything with
+	// an int ReadByte() that returns -1 when it runs out.  Returns false if it ran out.
+	template< class source_t >
+	bool				ReadDelta( source_t & src, const byte * oldBlock, byte * newBlock ) const;
+
+	static const idNetSchema *	FindById( int id );
+
+private:
+	uint32				ReadSlot( const byte * block, int index ) const;
+	void				WriteSlot( byte * block, int index, uint32 bits ) const;
+	uint32				SlotMask( int index ) const { return ( fields[index].bits == 32 ) ? 0xFFFFFFFF : ( ( 1u << fields[index].bits ) - 1 ); }
+
+	const char *		name;
+	int					id;
+	netField_t			fields[MAX_FIELDS];
+	int					numFields;
+	int					blockSize;
+
+	idNetSchema *		next;				// All registered schemas
+	static idNetSchema *schemas;
+};
+
+/*
+========================
+idNetSchema::ReadSlot
+========================
+*/
+ID_INLINE uint32 idNetSchema::ReadSlot( const byte * block, int index ) const {
+	const netField_t & field = fields[index];
+	uint32 bits = 0;
+	for ( int i = field.bytes - 1; i >= 0; i-- ) {
+		bits = ( bits << 8 ) | block[field.offset + i];
+	}
+	return bits;
+}
+
+/*
+========================
+idNetSchema::WriteSlot
+========================
+*/
+ID_INLINE void idNetSchema::WriteSlot( byte * block, int index, uint32 bits ) const {
+	const netField_t & field = fields[index];
+	for ( int i = 0; i < field.bytes; i++ ) {
+		block[field.offset + i] = (byte)( bits >> ( i * 8 ) );
+	}
+}
+
+/*
+========================
+idNetSchema::ReadDelta
+========================
+*/
+template< class source_t >
+ID_INLINE bool idNetSchema::ReadDelta( source_t & src, const byte * oldBlock, byte * newBlock ) const {
+	byte mask[ ( MAX_FIELDS + 7 ) / 8 ];
+	for ( int i = 0; i < ( numFields + 7 ) / 8; i++ ) {
+		const int value = src.ReadByte();
+		if ( value == -1 ) {
+			return false;
+		}
+		mask[i] = (byte)value;
+	}
+
+	for ( int i = 0; i < numFields; i++ ) {
+		const uint32 oldBits = ReadSlot( oldBlock, i );
+
+		if ( ( mask[i >> 3] & ( 1 << ( i & 7 ) ) ) == 0 ) {
+			WriteSlot( newBlock, i, oldBits );
+			continue;
+		}
+
+		uint32 bits = 0;
+		if ( fields[i].predict == NET_PREDICT_DELTA ) {
+			// zig-zag encoded difference, 7 bits per byte
+			uint32 zigzag = 0;
+			for ( int shift = 0; ; shift += 7 ) {
+				const int value = src.ReadByte();
+				if ( value == -1 || shift > 28 ) {
+					return false;
+				}
+				zigzag |= (uint32)( value & 0x7F ) << shift;
+				if ( ( value & 0x80 ) == 0 ) {
+					break;
+				}
+			}
+			const uint32 delta = ( zigzag >> 1 ) ^ ( 0 - ( zigzag & 1 ) );
+			bits = ( oldBits + delta ) & SlotMask( i );
+		} else {
+			for ( int b = 0; b < fields[i].bytes; b++ ) {
+				const int value = src.ReadByte();
+				if ( value == -1 ) {
+					return false;
+				}
+				bits |= (uint32)value << ( b * 8 );
+			}
+		}
+		WriteSlot( newBlock, i, bits );
+	}
+	return true;
+}
+
+/*
+================================================================================================
+
+	idNetFieldWriter / idNetFieldReader
+
+Write and read one field block in schema order.
+
+================================================================================================
+*/
+
+class idNetFieldWriter {
+public:
+					idNetFieldWriter( const idNetSchema & schema_, idBitMsg & msg_ ) : schema( schema_ ), msg( msg_ ), index( 0 ) { msg.WriteByteAlign(); }
+					~idNetFieldWriter() { assert( index == schema.NumFields() ); }
+
+	void			WriteInt( int value ) { WriteSlot( schema.EncodeInt( index, value ) ); }
+	void			WriteBool( bool value ) { WriteSlot( schema.EncodeInt( index, value ? 1 : 0 ) ); }
+	void			WriteFloat( float value ) { WriteSlot( schema.EncodeFloat( index, value ) ); }
+	void			WriteDeltaFloat( float oldValue, float newValue ) { WriteFloat( newValue - oldValue ); }
+
+private:
+	void			WriteSlot( uint32 bits ) {
+						assert( index < schema.NumFields() );
+						msg.WriteBits( (int)bits, schema.GetField( index ).bytes * 8 );
+						index++;
+					}
+
+	const idNetSchema &	schema;
+	idBitMsg &		msg;
+	int				index;
+};
+
+class idNetFieldReader {
+public:
+					idNetFieldReader( const idNetSchema & schema_, const idBitMsg & msg_ ) : schema( schema_ ), msg( msg_ ), index( 0 ) { msg.ReadByteAlign(); }
+					~idNetFieldReader() { assert( index == schema.NumFields() ); }
+
+	int				ReadInt() { const uint32 bits = ReadSlot(); return schema.DecodeInt( index++, bits ); }
+	bool			ReadBool() { return ReadInt() != 0; }
+	float			ReadFloat() { const uint32 bits = ReadSlot(); return schema.DecodeFloat( index++, bits ); }
+	float			ReadDeltaFloat( float oldValue ) { return oldValue + ReadFloat(); }
+
+private:
+	uint32			ReadSlot() const {
+						assert( index < schema.NumFields() );
+						return (uint32)msg.ReadBits( schema.GetField( index ).bytes * 8 );
+					}
+
+	const idNetSchema &	schema;
+	const idBitMsg &	msg;
+	int				index;
+};
+
+#endif /* !__NETSCHEMA_H__ */
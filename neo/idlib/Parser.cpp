@@ -37,6 +37,68 @@ If you have questions concerning this license or the applicable additional terms
 
 define_t * idParser::globaldefines;
 
+// the expanded macros and unread tokens of main thread parsers reuse freed tokens instead of going to the heap
+static const int MAX_FREE_TOKENS = 4096;
+
+idToken *idParser::freeTokens = NULL;
+int idParser::numFreeTokens = 0;
+
+static idSysInterlockedInteger parserTokenAllocs;	// tokens allocated from the heap
+static idSysInterlockedInteger parserTokenReuses;	// tokens taken from the free list
+static idSysInterlockedInteger parserDefineAllocs;	// defines allocated, including the copies of global and builtin defines
+
+/*
+================
+idParser::NewToken
+================
+*/
+idToken *idParser::NewToken( const idToken *token ) {
+	idToken *t;
+
+	if ( freeTokens != NULL && idLib::IsMainThread() ) {
+		t = freeTokens;
+		freeTokens = freeTokens->next;
+		numFreeTokens--;
+		// assigning reuses the string buffer of the freed token
+		*t = *token;
+		parserTokenReuses.Increment();
+		return t;
+	}
+	parserTokenAllocs.Increment();
+	return new (TAG_IDLIB_PARSER) idToken( token );
+}
+
+/*
+================
+idParser::FreeToken
+================
+*/
+void idParser::FreeToken( idToken *token ) {
+	if ( numFreeTokens < MAX_FREE_TOKENS && idLib::IsMainThread() ) {
+		token->next = freeTokens;
+		freeTokens = token;
+		numFreeTokens++;
+		return;
+	}
+	delete token;
+}
+
+/*
+================
+idParser::PurgeTokenPool
+================
+*/
+void idParser::PurgeTokenPool() {
+	idToken *t;
+
+	while ( freeTokens != NULL ) {
+		t = freeTokens;
+		freeTokens = freeTokens->next;
+		delete t;
+	}
+	numFreeTokens = 0;
+}
+
 /*
 ================
 idParser::SetBaseFolder
@@ -235,6 +297,7 @@ define_t *idParser::CopyDefine( define_t *define ) {
 	idToken *token, *newtoken, *lasttoken;
 
 	newdefine = (define_t *) Mem_Alloc(sizeof(define_t) + strlen(define->name) + 1, TAG_IDLIB_PARSER);
+	parserDefineAllocs.Increment();
 	//copy the define name
 	newdefine->name = (char *) newdefine + sizeof(define_t);
 	strcpy(newdefine->name, define->name);
@@ -247,7 +310,7 @@ define_t *idParser::CopyDefine( define_t *define ) {
 	//copy the define tokens
 	newdefine->tokens = NULL;
 	for (lasttoken = NULL, token = define->tokens; token; token = token->next) {
-		newtoken = new (TAG_IDLIB_PARSER) idToken(token);
+		newtoken = NewToken(token);
 		newtoken->next = NULL;
 		if (lasttoken) lasttoken->next = newtoken;
 		else newdefine->tokens = newtoken;
@@ -256,7 +319,7 @@ define_t *idParser::CopyDefine( define_t *define ) {
 	//copy the define parameters
 	newdefine->parms = NULL;
 	for (lasttoken = NULL, token = define->parms; token; token = token->next) {
-		newtoken = new (TAG_IDLIB_PARSER) idToken(token);
+		newtoken = NewToken(token);
 		newtoken->next = NULL;
 		if (lasttoken) lasttoken->next = newtoken;
 		else newdefine->parms = newtoken;
@@ -276,12 +339,12 @@ void idParser::FreeDefine( define_t *define ) {
 	//free the define parameters
 	for (t = define->parms; t; t = next) {
 		next = t->next;
-		delete t;
+		FreeToken( t );
 	}
 	//free the define tokens
 	for (t = define->tokens; t; t = next) {
 		next = t->next;
-		delete t;
+		FreeToken( t );
 	}
 	//free the define
 	Mem_Free( define );
@@ -457,7 +520,7 @@ int idParser::ReadSourceToken( idToken *token ) {
 	t = idParser::tokens;
 	assert( idParser::tokens != NULL );
 	idParser::tokens = idParser::tokens->next;
-	delete t;
+	FreeToken( t );
 	return true;
 }
 
@@ -469,7 +532,7 @@ idParser::UnreadSourceToken
 int idParser::UnreadSourceToken( idToken *token ) {
 	idToken *t;
 
-	t = new (TAG_IDLIB_PARSER) idToken(token);
+	t = NewToken(token);
 	t->next = idParser::tokens;
 	idParser::tokens = t;
 	return true;
@@ -559,7 +622,7 @@ int idParser::ReadDefineParms( define_t *define, idToken **parms, int maxparms )
 
 			if ( numparms < define->numparms ) {
 
-				t = new (TAG_IDLIB_PARSER) idToken( token );
+				t = NewToken( token );
 				t->next = NULL;
 				if (last) last->next = t;
 				else parms[numparms] = t;
@@ -639,6 +702,7 @@ void idParser::AddBuiltinDefines() {
 
 	for (i = 0; builtin[i].string; i++) {
 		define = (define_t *) Mem_Alloc(sizeof(define_t) + strlen(builtin[i].string) + 1, TAG_IDLIB_PARSER);
+		parserDefineAllocs.Increment();
 		define->name = (char *) define + sizeof(define_t);
 		strcpy(define->name, builtin[i].string);
 		define->flags = DEFINE_FIXED;
@@ -715,7 +779,7 @@ int idParser::ExpandBuiltinDefine( idToken *deftoken, define_t *define, idToken
 	idToken *token;
 	char buf[MAX_STRING_CHARS];
 
-	token = new (TAG_IDLIB_PARSER) idToken(deftoken);
+	token = NewToken(deftoken);
 	switch( define->builtin ) {
 		case BUILTIN_LINE: {
 			sprintf( buf, "%d", deftoken->line );
@@ -820,7 +884,7 @@ int idParser::ExpandDefine( idToken *deftoken, define_t *define, idToken **first
 		// if it is a define parameter
 		if ( parmnum >= 0 ) {
 			for ( pt = parms[parmnum]; pt; pt = pt->next ) {
-				t = new (TAG_IDLIB_PARSER) idToken(pt);
+				t = NewToken(pt);
 				//add the token to the list
 				t->next = NULL;
 				if (last) last->next = t;
@@ -847,7 +911,7 @@ int idParser::ExpandDefine( idToken *deftoken, define_t *define, idToken **first
 						idParser::Error( "can't stringize tokens" );
 						return false;
 					}
-					t = new (TAG_IDLIB_PARSER) idToken(token);
+					t = NewToken(token);
 					t->line = deftoken->line;
 				}
 				else {
@@ -856,7 +920,7 @@ int idParser::ExpandDefine( idToken *deftoken, define_t *define, idToken **first
 				}
 			}
 			else {
-				t = new (TAG_IDLIB_PARSER) idToken(dt);
+				t = NewToken(dt);
 				t->line = deftoken->line;
 			}
 			// add the token to the list
@@ -882,10 +946,10 @@ int idParser::ExpandDefine( idToken *deftoken, define_t *define, idToken **first
 						idParser::Error( "can't merge '%s' with '%s'", t1->c_str(), t2->c_str() );
 						return false;
 					}
-					delete t1->next;
+					FreeToken( t1->next );
 					t1->next = t2->next;
 					if ( t2 == last ) last = t1;
-					delete t2;
+					FreeToken( t2 );
 					continue;
 				}
 			}
@@ -899,7 +963,7 @@ int idParser::ExpandDefine( idToken *deftoken, define_t *define, idToken **first
 	for ( i = 0; i < define->numparms; i++ ) {
 		for ( pt = parms[i]; pt; pt = nextpt ) {
 			nextpt = pt->next;
-			delete pt;
+			FreeToken( pt );
 		}
 	}
 
@@ -1111,6 +1175,7 @@ int idParser::Directive_define() {
 	}
 	// allocate define
 	define = (define_t *) Mem_ClearedAlloc(sizeof(define_t) + token.Length() + 1, TAG_IDLIB_PARSER);
+	parserDefineAllocs.Increment();
 	define->name = (char *) define + sizeof(define_t);
 	strcpy(define->name, token.c_str());
 	// add the define to the source
@@ -1140,7 +1205,7 @@ int idParser::Directive_define() {
 					return false;
 				}
 				// add the define parm
-				t = new (TAG_IDLIB_PARSER) idToken(token);
+				t = NewToken(token);
 				t->ClearTokenWhiteSpace();
 				t->next = NULL;
 				if (last) last->next = t;
@@ -1171,7 +1236,7 @@ int idParser::Directive_define() {
 	last = NULL;
 	do
 	{
-		t = new (TAG_IDLIB_PARSER) idToken(token);
+		t = NewToken(token);
 		if ( t->type == TT_NAME && !strcmp( t->c_str(), define->name ) ) {
 			t->flags |= TOKEN_FL_RECURSIVE_DEFINE;
 			idParser::Warning( "recursive define (removed recursion)" );
@@ -1838,7 +1903,7 @@ int idParser::Evaluate( signed long int *intvalue, double *floatvalue, int integ
 		if (token.type == TT_NAME) {
 			if (defined) {
 				defined = false;
-				t = new (TAG_IDLIB_PARSER) idToken(token);
+				t = NewToken(token);
 				t->next = NULL;
 				if (lasttoken) lasttoken->next = t;
 				else firsttoken = t;
@@ -1846,7 +1911,7 @@ int idParser::Evaluate( signed long int *intvalue, double *floatvalue, int integ
 			}
 			else if ( token == "defined" ) {
 				defined = true;
-				t = new (TAG_IDLIB_PARSER) idToken(token);
+				t = NewToken(token);
 				t->next = NULL;
 				if (lasttoken) lasttoken->next = t;
 				else firsttoken = t;
@@ -1866,7 +1931,7 @@ int idParser::Evaluate( signed long int *intvalue, double *floatvalue, int integ
 		}
 		//if the token is a number or a punctuation
 		else if (token.type == TT_NUMBER || token.type == TT_PUNCTUATION) {
-			t = new (TAG_IDLIB_PARSER) idToken(token);
+			t = NewToken(token);
 			t->next = NULL;
 			if (lasttoken) lasttoken->next = t;
 			else firsttoken = t;
@@ -1890,7 +1955,7 @@ int idParser::Evaluate( signed long int *intvalue, double *floatvalue, int integ
 		Log_Write(" %s", t->c_str());
 #endif //DEBUG_EVAL
 		nexttoken = t->next;
-		delete t;
+		FreeToken( t );
 	} //end for
 #ifdef DEBUG_EVAL
 	if (integer) Log_Write("eval result: %d", *intvalue);
@@ -1934,7 +1999,7 @@ int idParser::DollarEvaluate( signed long int *intvalue, double *floatvalue, int
 		if (token.type == TT_NAME) {
 			if (defined) {
 				defined = false;
-				t = new (TAG_IDLIB_PARSER) idToken(token);
+				t = NewToken(token);
 				t->next = NULL;
 				if (lasttoken) lasttoken->next = t;
 				else firsttoken = t;
@@ -1942,7 +2007,7 @@ int idParser::DollarEvaluate( signed long int *intvalue, double *floatvalue, int
 			}
 			else if ( token == "defined" ) {
 				defined = true;
-				t = new (TAG_IDLIB_PARSER) idToken(token);
+				t = NewToken(token);
 				t->next = NULL;
 				if (lasttoken) lasttoken->next = t;
 				else firsttoken = t;
@@ -1967,7 +2032,7 @@ int idParser::DollarEvaluate( signed long int *intvalue, double *floatvalue, int
 			if (indent <= 0) {
 				break;
 			}
-			t = new (TAG_IDLIB_PARSER) idToken(token);
+			t = NewToken(token);
 			t->next = NULL;
 			if (lasttoken) lasttoken->next = t;
 			else firsttoken = t;
@@ -1991,7 +2056,7 @@ int idParser::DollarEvaluate( signed long int *intvalue, double *floatvalue, int
 		Log_Write(" %s", t->c_str());
 #endif //DEBUG_EVAL
 		nexttoken = t->next;
-		delete t;
+		FreeToken( t );
 	} //end for
 #ifdef DEBUG_EVAL
 	if (integer) Log_Write("$eval result: %d", *intvalue);
@@ -3100,6 +3165,24 @@ int idParser::LoadMemory(const char *ptr, int length, const char *name ) {
 	return true;
 }
 
+/*
+================
+idParser::SetTokenStream
+================
+*/
+void idParser::SetTokenStream( const idTokenStream *stream ) {
+	idLexer *script;
+
+	if ( !idParser::loaded ) {
+		idLib::common->Warning( "idParser::SetTokenStream: no source loaded" );
+		return;
+	}
+	// the loaded source is at the bottom of the include stack
+	for ( script = idParser::scriptstack; script->next; script = script->next ) {
+	}
+	script->SetTokenStream( stream );
+}
+
 /*
 ================
 idParser::FreeSource
@@ -3122,7 +3205,7 @@ void idParser::FreeSource( bool keepDefines ) {
 	while( tokens ) {
 		token = tokens;
 		tokens = tokens->next;
-		delete token;
+		FreeToken( token );
 	}
 	// free all indents
 	while( indentstack ) {
@@ -3286,3 +3369,45 @@ bool idParser::EndOfFile() {
 	return true;
 }
 
+
+/*
+================
+idParser::Test_f
+
+testParser [folder] [extension]
+Parses all sources in a folder the way GUIs are parsed and prints how many
+tokens were read, allocated from the heap and reused from the free list.
+================
+*/
+void idParser::Test_f( const idCmdArgs &args ) {
+	const char *folder = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "guis";
+	const char *extension = ( args.Argc() > 2 ) ? args.Argv( 2 ) : ".gui";
+
+	idFileList *fileList = idLib::fileSystem->ListFilesTree( folder, extension, true );
+
+	const int startAllocs = parserTokenAllocs.GetValue();
+	const int startReuses = parserTokenReuses.GetValue();
+	const int startDefines = parserDefineAllocs.GetValue();
+	const uint64 startTime = Sys_Microseconds();
+
+	int numTokens = 0;
+	int numFiles = 0;
+	for ( int i = 0; i < fileList->GetNumFiles(); i++ ) {
+		idParser src( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_ALLOWBACKSLASHSTRINGCONCAT );
+		if ( !src.LoadFile( fileList->GetFile( i ) ) ) {
+			continue;
+		}
+		numFiles++;
+		idToken token;
+		while ( src.ReadToken( &token ) ) {
+			numTokens++;
+		}
+	}
+	idLib::fileSystem->FreeFileList( fileList );
+
+	const int allocs = parserTokenAllocs.GetValue() - startAllocs;
+	const int reuses = parserTokenReuses.GetValue() - startReuses;
+	idLib::common->Printf( "%d %s files from %s parsed in %.2f msec, %d tokens read\n", numFiles, extension, folder, ( Sys_Microseconds() - startTime ) * 0.001f, numTokens );
+	idLib::common->Printf( "%d tokens allocated from the heap, %d reused (%.1f%%), %d defines allocated, %d tokens on the free list\n",
+		allocs, reuses, ( allocs + reuses > 0 ) ? reuses * 100.0f / ( allocs + reuses ) : 0.0f, parserDefineAllocs.GetValue() - startDefines, numFreeTokens );
+}
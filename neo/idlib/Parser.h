@@ -88,6 +88,9 @@ public:
 					// load a source from the given memory with the given length
 					// NOTE: the ptr is expected to point at a valid C string: ptr[length] == '\0'
 	int				LoadMemory( const char *ptr, int length, const char *name );
+					// replay tokens that were read ahead of time from the source loaded with LoadMemory,
+					// the stream has to be tokenized with the parser flags and punctuations
+	void			SetTokenStream( const idTokenStream *stream );
 					// free the current source
 	void			FreeSource( bool keepDefines = false );
 					// returns true if a source is loaded
@@ -178,6 +181,10 @@ public:
 	static void		RemoveAllGlobalDefines();
 					// set the base folder to load files from
 	static void		SetBaseFolder( const char *path );
+					// free the tokens kept for reuse
+	static void		PurgeTokenPool();
+					// count token allocations while parsing a folder of sources
+	static void		Test_f( const class idCmdArgs &args );
 
 private:
 	int				loaded;						// set when a source file is loaded from file or memory
@@ -196,7 +203,13 @@ private:
 
 	static define_t *globaldefines;				// list with global defines added to every source loaded
 
+	static idToken *freeTokens;					// tokens freed on the main thread, kept with their string buffers
+	static int		numFreeTokens;
+
 private:
+	static idToken *NewToken( const idToken *token );
+	static idToken *NewToken( const idToken &token ) { return NewToken( &token ); }
+	static void		FreeToken( idToken *token );
 	void			PushIndent( int type, int skip );
 	void			PopIndent( int *type, int *skip );
 	void			PushScript( idLexer *script );
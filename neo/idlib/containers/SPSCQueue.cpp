@@ -0,0 +1,177 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#pragma hdrstop
+#include "../precompiled.h"
+
+/*
+================================================================================================
+
+	SPSCQueue throughput test
+
+================================================================================================
+*/
+
+static const int SPSC_TEST_QUEUE_SIZE	= 1024;
+static const int SPSC_TEST_MAX_BATCH	= 256;
+
+enum spscTestMode_t {
+	SPSC_TEST_MUTEX,		// every push and pop takes a mutex, the way a shared idList would be guarded
+	SPSC_TEST_SINGLE,		// lock-free, one item per push and pop
+	SPSC_TEST_BATCH			// lock-free, PushBatch and PopBatch
+};
+
+struct spscTestItem_t {
+	int		sequence;
+	int		payload[3];
+};
+
+class idSPSCTestQueue {
+public:
+	idSPSCQueue< spscTestItem_t, SPSC_TEST_QUEUE_SIZE >	queue;
+	idSysMutex											mutex;
+	spscTestMode_t										mode;
+	int													batchSize;
+	int													numItems;
+
+	int Push( const spscTestItem_t * items, int num ) {
+		if ( mode == SPSC_TEST_MUTEX ) {
+			idScopedCriticalSection lock( mutex );
+			return queue.Push( items[0] ) ? 1 : 0;
+		} else if ( mode == SPSC_TEST_SINGLE ) {
+			return queue.Push( items[0] ) ? 1 : 0;
+		}
+		return queue.PushBatch( items, num );
+	}
+	int Pop( spscTestItem_t * items ) {
+		if ( mode == SPSC_TEST_MUTEX ) {
+			idScopedCriticalSection lock( mutex );
+			return queue.Pop( items[0] ) ? 1 : 0;
+		} else if ( mode == SPSC_TEST_SINGLE ) {
+			return queue.Pop( items[0] ) ? 1 : 0;
+		}
+		return queue.PopBatch( items, batchSize );
+	}
+};
+
+class idSPSCTestProducer : public idSysThread {
+public:
+	idSPSCTestQueue *	testQueue;
+
+	virtual int Run() {
+		spscTestItem_t batch[SPSC_TEST_MAX_BATCH];
+		int next = 0;
+		while ( next < testQueue->numItems ) {
+			const int num = Min( testQueue->batchSize, testQueue->numItems - next );
+			for ( int i = 0; i < num; i++ ) {
+				batch[i].sequence = next + i;
+				batch[i].payload[0] = batch[i].payload[1] = batch[i].payload[2] = next + i;
+			}
+			int pushed = 0;
+			while ( pushed < num ) {
+				const int n = testQueue->Push( batch + pushed, num - pushed );
+				if ( n == 0 ) {
+					Sys_Yield();
+				}
+				pushed += n;
+			}
+			next += num;
+		}
+		return 0;
+	}
+};
+
+/*
+========================
+SPSCQueue_RunTest
+
+Streams the items from a producer thread to this thread and returns the
+number of microseconds it took, or 0 if an item arrived out of order.
+========================
+*/
+static uint64 SPSCQueue_RunTest( spscTestMode_t mode, int numItems, int batchSize ) {
+	idSPSCTestQueue * testQueue = new (TAG_THREAD) idSPSCTestQueue;
+	testQueue->mode = mode;
+	testQueue->numItems = numItems;
+	testQueue->batchSize = ( mode == SPSC_TEST_BATCH ) ? batchSize : 1;
+
+	idSPSCTestProducer producer;
+	producer.testQueue = testQueue;
+
+	const uint64 startTime = Sys_Microseconds();
+	producer.StartThread( "SPSCQueueTest", CORE_ANY );
+
+	spscTestItem_t batch[SPSC_TEST_MAX_BATCH];
+	bool inOrder = true;
+	int expected = 0;
+	while ( expected < numItems ) {
+		const int num = testQueue->Pop( batch );
+		if ( num == 0 ) {
+			Sys_Yield();
+			continue;
+		}
+		for ( int i = 0; i < num; i++ ) {
+			if ( batch[i].sequence != expected || batch[i].payload[2] != expected ) {
+				inOrder = false;
+			}
+			expected++;
+		}
+	}
+	const uint64 endTime = Sys_Microseconds();
+
+	producer.StopThread();
+	delete testQueue;
+
+	return inOrder ? Max( endTime - startTime, (uint64)1 ) : 0;
+}
+
+/*
+========================
+SPSCQueue_Test_f
+
+testSPSCQueue [numItems] [batchSize]
+Streams items between two threads through a mutex guarded ring, the lock-free
+ring one item at a time and the lock-free ring in batches, and prints the
+throughput of each.
+========================
+*/
+void SPSCQueue_Test_f( const idCmdArgs & args ) {
+	const int numItems = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 4000000;
+	const int batchSize = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, SPSC_TEST_MAX_BATCH, atoi( args.Argv( 2 ) ) ) : 32;
+
+	static const char * modeNames[] = { "mutex", "lock-free", "lock-free batch" };
+	for ( int mode = SPSC_TEST_MUTEX; mode <= SPSC_TEST_BATCH; mode++ ) {
+		const uint64 usec = SPSCQueue_RunTest( (spscTestMode_t)mode, numItems, batchSize );
+		if ( usec == 0 ) {
+			idLib::Warning( "%s: items arrived out of order", modeNames[mode] );
+			continue;
+		}
+		idLib::Printf( "%-16s %d items in %.2f msec, %.2f million items per second\n", modeNames[mode], numItems, usec * 0.001f, numItems / (float)usec );
+	}
+}
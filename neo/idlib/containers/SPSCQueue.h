@@ -0,0 +1,278 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+/*
+===============================================================================
+
+	Lock-free single producer / single consumer ring buffer.
+
+	Exactly one thread may call the producer functions (Alloc, Commit, Push,
+	PushBatch) and exactly one other thread may call the consumer functions
+	(Peek, Pop, PopBatch). The read and write indices live on separate cache
+	lines so the two threads never share a line they both write, and each
+	side keeps a private copy of the other side's index so it only touches
+	the shared line when the ring looks full or empty.
+
+	The indices run freely and are masked on access, which is why the size
+	must be a power of two. The batch functions publish the whole batch with
+	a single memory barrier.
+
+===============================================================================
+*/
+
+template< class type, int size >
+class idSPSCQueue {
+public:
+							idSPSCQueue();
+
+	// only call when neither the producer nor the consumer is active
+	void					Clear();
+
+	int						Num() const { return (int)( writeIndex - readIndex ); }
+	bool					IsEmpty() const { return writeIndex == readIndex; }
+	bool					IsFull() const { return Num() >= size; }
+	int						Max() const { return size; }
+
+	// producer side
+	type *					Alloc();								// returns the next free slot, or NULL when full
+	void					Commit();								// publishes the slot returned by Alloc
+	bool					Push( const type & item );
+	int						PushBatch( const type * items, int num );	// returns the number of items pushed
+
+	// consumer side
+	type *					Peek();									// returns the oldest item, or NULL when empty
+	void					Pop();									// releases the item returned by Peek
+	bool					Pop( type & item );
+	int						PopBatch( type * items, int max );		// returns the number of items popped
+
+private:
+	static const unsigned int MASK = size - 1;
+
+	// written by the producer
+	volatile unsigned int	writeIndex;
+	unsigned int			cachedReadIndex;
+	byte					producerPad[CACHE_LINE_SIZE - 2 * sizeof( unsigned int )];
+
+	// written by the consumer
+	volatile unsigned int	readIndex;
+	unsigned int			cachedWriteIndex;
+	byte					consumerPad[CACHE_LINE_SIZE - 2 * sizeof( unsigned int )];
+
+	type					items[size];
+
+	int						FreeSlots();
+	int						UsedSlots();
+
+							idSPSCQueue( const idSPSCQueue & ) {}
+	void					operator=( const idSPSCQueue & ) {}
+};
+
+/*
+========================
+idSPSCQueue::idSPSCQueue
+========================
+*/
+template< class type, int size >
+ID_INLINE idSPSCQueue<type,size>::idSPSCQueue() {
+	compile_time_assert( size > 0 && ( size & ( size - 1 ) ) == 0 );
+	Clear();
+}
+
+/*
+========================
+idSPSCQueue::Clear
+========================
+*/
+template< class type, int size >
+ID_INLINE void idSPSCQueue<type,size>::Clear() {
+	writeIndex = 0;
+	cachedReadIndex = 0;
+	readIndex = 0;
+	cachedWriteIndex = 0;
+}
+
+/*
+========================
+idSPSCQueue::FreeSlots
+
+Only refreshes the consumer's index when the cached copy says the ring is full.
+========================
+*/
+template< class type, int size >
+ID_INLINE int idSPSCQueue<type,size>::FreeSlots() {
+	int numFree = size - (int)( writeIndex - cachedReadIndex );
+	if ( numFree == 0 ) {
+		cachedReadIndex = readIndex;
+		numFree = size - (int)( writeIndex - cachedReadIndex );
+	}
+	return numFree;
+}
+
+/*
+========================
+idSPSCQueue::UsedSlots
+
+Only refreshes the producer's index when the cached copy says the ring is empty.
+========================
+*/
+template< class type, int size >
+ID_INLINE int idSPSCQueue<type,size>::UsedSlots() {
+	int numUsed = (int)( cachedWriteIndex - readIndex );
+	if ( numUsed == 0 ) {
+		cachedWriteIndex = writeIndex;
+		// don't read the items before the index that published them
+		SYS_MEMORYBARRIER;
+		numUsed = (int)( cachedWriteIndex - readIndex );
+	}
+	return numUsed;
+}
+
+/*
+========================
+idSPSCQueue::Alloc
+========================
+*/
+template< class type, int size >
+ID_INLINE type * idSPSCQueue<type,size>::Alloc() {
+	if ( FreeSlots() == 0 ) {
+		return NULL;
+	}
+	return &items[writeIndex & MASK];
+}
+
+/*
+========================
+idSPSCQueue::Commit
+========================
+*/
+template< class type, int size >
+ID_INLINE void idSPSCQueue<type,size>::Commit() {
+	assert( Num() < size );
+	// the item has to be visible before the index that publishes it
+	SYS_MEMORYBARRIER;
+	writeIndex = writeIndex + 1;
+}
+
+/*
+========================
+idSPSCQueue::Push
+========================
+*/
+template< class type, int size >
+ID_INLINE bool idSPSCQueue<type,size>::Push( const type & item ) {
+	type * slot = Alloc();
+	if ( slot == NULL ) {
+		return false;
+	}
+	*slot = item;
+	Commit();
+	return true;
+}
+
+/*
+========================
+idSPSCQueue::PushBatch
+========================
+*/
+template< class type, int size >
+ID_INLINE int idSPSCQueue<type,size>::PushBatch( const type * items_, int num ) {
+	num = Min( num, FreeSlots() );
+	const unsigned int start = writeIndex;
+	for ( int i = 0; i < num; i++ ) {
+		items[( start + i ) & MASK] = items_[i];
+	}
+	SYS_MEMORYBARRIER;
+	writeIndex = start + num;
+	return num;
+}
+
+/*
+========================
+idSPSCQueue::Peek
+========================
+*/
+template< class type, int size >
+ID_INLINE type * idSPSCQueue<type,size>::Peek() {
+	if ( UsedSlots() == 0 ) {
+		return NULL;
+	}
+	return &items[readIndex & MASK];
+}
+
+/*
+========================
+idSPSCQueue::Pop
+========================
+*/
+template< class type, int size >
+ID_INLINE void idSPSCQueue<type,size>::Pop() {
+	assert( !IsEmpty() );
+	// finish reading the item before handing the slot back to the producer
+	SYS_MEMORYBARRIER;
+	readIndex = readIndex + 1;
+}
+
+/*
+========================
+idSPSCQueue::Pop
+========================
+*/
+template< class type, int size >
+ID_INLINE bool idSPSCQueue<type,size>::Pop( type & item ) {
+	type * slot = Peek();
+	if ( slot == NULL ) {
+		return false;
+	}
+	item = *slot;
+	Pop();
+	return true;
+}
+
+/*
+========================
+idSPSCQueue::PopBatch
+========================
+*/
+template< class type, int size >
+ID_INLINE int idSPSCQueue<type,size>::PopBatch( type * items_, int max ) {
+	max = Min( max, UsedSlots() );
+	const unsigned int start = readIndex;
+	for ( int i = 0; i < max; i++ ) {
+		items_[i] = items[( start + i ) & MASK];
+	}
+	SYS_MEMORYBARRIER;
+	readIndex = start + max;
+	return max;
+}
+
+void SPSCQueue_Test_f( const class idCmdArgs & args );
+
+#endif // !__SPSCQUEUE_H__
@@ -117,6 +117,7 @@ const int MAX_EXPRESSION_REGISTERS = 4096;
 #include "../sys/Snapshot.h"
 #include "../sys/PacketProcessor.h"
 #include "../sys/SnapshotProcessor.h"
+#include "../sys/NetSimulator.h"
 
 #include "../sys/sys_savegame.h"
 #include "../sys/sys_session_savegames.h"
@@ -752,15 +752,23 @@ void idImageManager::Preload( const idPreloadManifest &manifest, const bool & ma
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
 
-		//fileSystem->StartPreload( preloadImageFiles );
+		// the images are only registered here and loaded at the end of the level load,
+		// so start reading the generated images in the background now
+		idStrList preloadImageFiles;
+		idStr generatedName;
+		idStr binaryName;
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			if ( p.resType == PRELOAD_IMAGE && !ExcludePreloadImage( p.resourceName ) ) {
 				globalImages->ImageFromFile( p.resourceName, ( textureFilter_t )p.imgData.filter, ( textureRepeat_t )p.imgData.repeat, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
+				generatedName = p.resourceName;
+				idImage::GetGeneratedName( generatedName, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
+				idBinaryImage::GetGeneratedFileName( binaryName, generatedName );
+				preloadImageFiles.Append( binaryName );
 				numLoaded++;
 			}
 		}
-		//fileSystem->StopPreload();
+		fileSystem->StartPreload( preloadImageFiles );
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d images preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 		common->Printf( "----------------------------------------\n" );
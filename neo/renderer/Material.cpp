@@ -2200,6 +2200,9 @@ bool idMaterial::Parse( const char *text, const int textLength, bool allowBinary
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	// reset to the unparsed state
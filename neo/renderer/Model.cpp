@@ -377,13 +377,12 @@ bool idRenderModelStatic::LoadBinaryModel( idFile * file, const ID_TIME_T source
 			if ( numInFile > 0 ) {
 				R_AllocStaticTriSurfVerts( &tri, tri.numVerts );
 				assert( tri.verts != NULL );
+				// the vertices are stored field by field in the same order and size as idDrawVert,
+				// so they can be read in one go and swapped in place
+				file->Read( tri.verts, tri.numVerts * sizeof( tri.verts[0] ) );
 				for ( int j = 0; j < tri.numVerts; j++ ) {
-					file->ReadVec3( tri.verts[j].xyz );
-					file->ReadBigArray( tri.verts[j].st, 2 );
-					file->ReadBigArray( tri.verts[j].normal, 4 );
-					file->ReadBigArray( tri.verts[j].tangent, 4 );
-					file->ReadBigArray( tri.verts[j].color, sizeof( tri.verts[j].color ) / sizeof( tri.verts[j].color[0] ) );
-					file->ReadBigArray( tri.verts[j].color2, sizeof( tri.verts[j].color2 ) / sizeof( tri.verts[j].color2[0] ) );
+					LittleRevBytes( tri.verts[j].xyz.ToFloatPtr(), sizeof( float ), 3 );
+					idSwap::BigArray( tri.verts[j].st, 2 );
 				}
 			}
 
@@ -392,9 +391,8 @@ bool idRenderModelStatic::LoadBinaryModel( idFile * file, const ID_TIME_T source
 				tri.preLightShadowVertexes = NULL;
 			} else {
 				R_AllocStaticTriSurfPreLightShadowVerts( &tri, numInFile );
-				for ( int j = 0; j < numInFile; j++ ) {
-					file->ReadVec4( tri.preLightShadowVertexes[ j ].xyzw );
-				}
+				file->Read( tri.preLightShadowVertexes, numInFile * sizeof( tri.preLightShadowVertexes[0] ) );
+				LittleRevBytes( tri.preLightShadowVertexes, sizeof( float ), numInFile * 4 );
 			} 
 
 			file->ReadBig( tri.numIndexes );
@@ -550,6 +550,29 @@ void idRenderModelManagerLocal::BeginLevelLoad() {
 	vertexCache.FreeStaticData();
 }
 
+/*
+=================
+GetPreloadFileName
+
+Returns the generated file a model or particle preload is read from
+=================
+*/
+static void GetPreloadFileName( const preloadEntry_s & p, idStr & filename ) {
+	filename.Empty();
+	if ( p.resType == PRELOAD_MODEL ) {
+		filename = "generated/rendermodels/";
+		filename += p.resourceName;
+		idStrStatic< 16 > ext;
+		filename.ExtractFileExtension( ext );
+		filename.SetFileExtension( va( "b%s", ext.c_str() ) );
+	}
+	if ( p.resType == PRELOAD_PARTICLE ) {
+		filename = "generated/particles/";
+		filename += p.resourceName;
+		filename += ".bprt";
+	}
+}
+
 /*
 =================
 idRenderModelManagerLocal::Preload
@@ -562,22 +585,11 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 		int numLoaded = 0;
 		idList< preloadSort_t > preloadSort;
 		preloadSort.Resize( manifest.NumResources() );
+		idStr filename;
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			idResourceCacheEntry rc;
-			idStrStatic< MAX_OSPATH > filename;
-			if ( p.resType == PRELOAD_MODEL ) {
-				filename = "generated/rendermodels/";
-				filename += p.resourceName;
-				idStrStatic< 16 > ext;
-				filename.ExtractFileExtension( ext );
-				filename.SetFileExtension( va( "b%s", ext.c_str() ) );
-			}
-			if ( p.resType == PRELOAD_PARTICLE ) {
-				filename = "generated/particles/";
-				filename += p.resourceName;
-				filename += ".bprt";
-			}
+			GetPreloadFileName( p, filename );
 			if ( !filename.IsEmpty() ) {
 				if ( fileSystem->GetResourceCacheEntry( filename, rc ) ) {
 					preloadSort_t ps = {};
@@ -590,6 +602,14 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 		
 		preloadSort.SortWithTemplate( idSort_Preload() );
 
+		// the models are loaded at the end of the level load, read them in the background until then
+		idStrList preloadFiles;
+		preloadFiles.SetNum( preloadSort.Num() );
+		for ( int i = 0; i < preloadSort.Num(); i++ ) {
+			GetPreloadFileName( manifest.GetPreloadByIndex( preloadSort[ i ].idx ), preloadFiles[ i ] );
+		}
+		fileSystem->StartPreload( preloadFiles );
+
 		for ( int i = 0; i < preloadSort.Num(); i++ ) {
 			const preloadSort_t & ps = preloadSort[ i ];
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( ps.idx );
@@ -188,6 +188,10 @@ public:
 
 	virtual void			InitGL() = 0;
 
+	// sets up what map loads and the game need from the renderer without
+	// opening a window or creating a device, for dedicated servers
+	virtual void			InitHeadless() = 0;
+
 	virtual void			ShutdownGL() = 0;
 
 	virtual bool			IsGLRunning() const = 0;
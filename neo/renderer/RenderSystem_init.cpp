@@ -1898,6 +1898,29 @@ void idRenderSystemLocal::InitGL() {
 	}
 }
 
+/*
+========================
+idRenderSystemLocal::InitHeadless
+
+r_initialized stays false, so images are never uploaded and the back end never runs.
+========================
+*/
+void idRenderSystemLocal::InitHeadless() {
+	if ( R_IsInitialized() ) {
+		return;
+	}
+
+	common->Printf( "----- R_InitHeadless -----\n" );
+
+	renderProgManager.Init();
+
+	// map loads still create static geometry, but there are no buffers behind it
+	vertexCache.InitHeadless();
+
+	// allocate the frame data, which may be more if smp is enabled
+	R_InitFrameData();
+}
+
 /*
 ========================
 idRenderSystemLocal::ShutdownDX12
@@ -118,6 +118,7 @@ idRenderModel *idRenderWorldLocal::ReadBinaryModel( idFile *fileIn ) {
 	if ( model->LoadBinaryModel( fileIn, mapTimeStamp ) ) {
 		return model;
 	}
+	delete model;
 	return NULL;
 }
 
@@ -395,12 +396,6 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src, idFile *fileOut )
 		return;
 	}
 
-	if ( fileOut != NULL ) {
-		// write out the type so the binary reader knows what to instantiate
-		fileOut->WriteString( "interAreaPortals" );
-	}
-
-
 	portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
 	areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
 
@@ -413,70 +408,102 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src, idFile *fileOut )
 		return;
 	}
 
-	if ( fileOut != NULL ) {
-		fileOut->WriteBig( numPortalAreas );
-		fileOut->WriteBig( numInterAreaPortals );
-	}
-
 	doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals * 
 		sizeof( doublePortals [0] ) );
 
 	for ( int i = 0; i < numInterAreaPortals; i++ ) {
 		int		numPoints, a1, a2;
 		idWinding	*w;
-		portal_t	*p;
 
 		numPoints = src->ParseInt();
 		a1 = src->ParseInt();
 		a2 = src->ParseInt();
 
-		if ( fileOut != NULL ) {
-			fileOut->WriteBig( numPoints );
-			fileOut->WriteBig( a1 );
-			fileOut->WriteBig( a2 );
-		}
-
 		w = new (TAG_RENDER_WINDING) idWinding( numPoints );
 		w->SetNumPoints( numPoints );
 		for ( int j = 0; j < numPoints; j++ ) {
 			src->Parse1DMatrix( 3, (*w)[j].ToFloatPtr() );
-
-			if ( fileOut != NULL ) {
-				fileOut->WriteBig( (*w)[j].x );
-				fileOut->WriteBig( (*w)[j].y );
-				fileOut->WriteBig( (*w)[j].z );
-			}
 			// no texture coordinates
 			(*w)[j][3] = 0;
 			(*w)[j][4] = 0;
 		}
 
-		// add the portal to a1
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w = w;
-		p->w->GetPlane( p->plane );
+		AddInterAreaPortal( i, w, a1, a2 );
+	}
+
+	src->ExpectTokenString( "}" );
+
+	if ( fileOut != NULL ) {
+		WriteBinaryAreaPortals( fileOut );
+	}
+}
+
+/*
+================
+idRenderWorldLocal::AddInterAreaPortal
+
+Links the portal into a1 and its reverse into a2, takes ownership of the winding
+================
+*/
+void idRenderWorldLocal::AddInterAreaPortal( int portalNum, idWinding *w, int a1, int a2 ) {
+	portal_t	*p;
+
+	// add the portal to a1
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a2;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w;
+	p->w->GetPlane( p->plane );
+
+	p->next = portalAreas[a1].portals;
+	portalAreas[a1].portals = p;
+
+	doublePortals[portalNum].portals[0] = p;
+
+	// reverse it for a2
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a1;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w->Reverse();
+	p->w->GetPlane( p->plane );
+
+	p->next = portalAreas[a2].portals;
+	portalAreas[a2].portals = p;
 
-		p->next = portalAreas[a1].portals;
-		portalAreas[a1].portals = p;
+	doublePortals[portalNum].portals[1] = p;
+}
 
-		doublePortals[i].portals[0] = p;
+/*
+================
+idRenderWorldLocal::WriteBinaryAreaPortals
 
-		// reverse it for a2
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = w->Reverse();
-		p->w->GetPlane( p->plane );
+The portals are written as flat arrays, the point counts and areas of all
+portals followed by all portal points, so they can be read in two reads.
+================
+*/
+void idRenderWorldLocal::WriteBinaryAreaPortals( idFile *file ) const {
+	// write out the type so the binary reader knows what to instantiate
+	file->WriteString( "interAreaPortals" );
 
-		p->next = portalAreas[a2].portals;
-		portalAreas[a2].portals = p;
+	file->WriteBig( numPortalAreas );
+	file->WriteBig( numInterAreaPortals );
 
-		doublePortals[i].portals[1] = p;
+	idList< int > portalInfo;
+	idList< idVec3 > points;
+	portalInfo.SetNum( numInterAreaPortals * 3 );
+	for ( int i = 0; i < numInterAreaPortals; i++ ) {
+		const idWinding *w = doublePortals[i].portals[0]->w;
+		portalInfo[i * 3 + 0] = w->GetNumPoints();
+		portalInfo[i * 3 + 1] = doublePortals[i].portals[1]->intoArea;
+		portalInfo[i * 3 + 2] = doublePortals[i].portals[0]->intoArea;
+		for ( int j = 0; j < w->GetNumPoints(); j++ ) {
+			points.Append( (*w)[j].ToVec3() );
+		}
 	}
 
-	src->ExpectTokenString( "}" );
+	file->WriteBigArray( portalInfo.Ptr(), portalInfo.Num() );
+	file->WriteBig( points.Num() );
+	file->WriteBigArray( points.Ptr(), points.Num() );
 }
 
 /*
@@ -484,10 +511,47 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src, idFile *fileOut )
 idRenderWorldLocal::ParseInterAreaPortals
 ================
 */
-void idRenderWorldLocal::ReadBinaryAreaPortals( idFile *file ) {
+bool idRenderWorldLocal::ReadBinaryAreaPortals( idFile *file ) {
+	int numAreas = 0;
+	int numPortals = 0;
+	file->ReadBig( numAreas );
+	file->ReadBig( numPortals );
+	if ( numAreas < 0 || numPortals < 0 ) {
+		return false;
+	}
+
+	idList< int > portalInfo;
+	portalInfo.SetNum( numPortals * 3 );
+	file->ReadBigArray( portalInfo.Ptr(), portalInfo.Num() );
+
+	int numPoints = 0;
+	file->ReadBig( numPoints );
+	if ( numPoints < 0 ) {
+		return false;
+	}
+	idList< idVec3 > points;
+	points.SetNum( numPoints );
+	if ( file->ReadBigArray( points.Ptr(), points.Num() ) != points.Num() * sizeof( idVec3 ) ) {
+		return false;
+	}
+
+	// make sure the arrays are consistent before anything is allocated
+	int pointCount = 0;
+	for ( int i = 0; i < numPortals; i++ ) {
+		const int n = portalInfo[i * 3 + 0];
+		const int a1 = portalInfo[i * 3 + 1];
+		const int a2 = portalInfo[i * 3 + 2];
+		if ( n < 3 || a1 < 0 || a1 >= numAreas || a2 < 0 || a2 >= numAreas ) {
+			return false;
+		}
+		pointCount += n;
+	}
+	if ( pointCount != numPoints ) {
+		return false;
+	}
 
-	file->ReadBig( numPortalAreas );
-	file->ReadBig( numInterAreaPortals );
+	numPortalAreas = numAreas;
+	numInterAreaPortals = numPortals;
 
 	portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
 	areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
@@ -497,49 +561,22 @@ void idRenderWorldLocal::ReadBinaryAreaPortals( idFile *file ) {
 
 	doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals * sizeof( doublePortals [0] ) );
 
+	const idVec3 *point = points.Ptr();
 	for ( int i = 0; i < numInterAreaPortals; i++ ) {
-		int		numPoints, a1, a2;
-		idWinding	*w;
-		portal_t	*p;
-
-		file->ReadBig( numPoints );
-		file->ReadBig( a1 );
-		file->ReadBig( a2 );
-		w = new (TAG_RENDER_WINDING) idWinding( numPoints );
-		w->SetNumPoints( numPoints );
-		for ( int j = 0; j < numPoints; j++ ) {
-			file->ReadBig( (*w)[ j ][ 0 ] );
-			file->ReadBig( (*w)[ j ][ 1 ] );
-			file->ReadBig( (*w)[ j ][ 2 ] );
+		const int n = portalInfo[i * 3 + 0];
+		idWinding *w = new (TAG_RENDER_WINDING) idWinding( n );
+		w->SetNumPoints( n );
+		for ( int j = 0; j < n; j++, point++ ) {
+			(*w)[ j ][ 0 ] = point->x;
+			(*w)[ j ][ 1 ] = point->y;
+			(*w)[ j ][ 2 ] = point->z;
 			// no texture coordinates
 			(*w)[ j ][ 3 ] = 0;
 			(*w)[ j ][ 4 ] = 0;
 		}
-
-		// add the portal to a1
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w = w;
-		p->w->GetPlane( p->plane );
-
-		p->next = portalAreas[a1].portals;
-		portalAreas[a1].portals = p;
-
-		doublePortals[i].portals[0] = p;
-
-		// reverse it for a2
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = w->Reverse();
-		p->w->GetPlane( p->plane );
-
-		p->next = portalAreas[a2].portals;
-		portalAreas[a2].portals = p;
-
-		doublePortals[i].portals[1] = p;
+		AddInterAreaPortal( i, w, portalInfo[i * 3 + 1], portalInfo[i * 3 + 2] );
 	}
+	return true;
 }
 
 
@@ -557,15 +594,6 @@ void idRenderWorldLocal::ParseNodes( idLexer *src, idFile *fileOut ) {
 	}
 	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
 
-	if ( fileOut != NULL ) {
-		// write out the type so the binary reader knows what to instantiate
-		fileOut->WriteString( "nodes" );
-	}
-
-	if ( fileOut != NULL ) {
-		fileOut->WriteBig( numAreaNodes );
-	}
-
 	for ( int i = 0; i < numAreaNodes; i++ ) {
 		areaNode_t	*node;
 
@@ -575,19 +603,39 @@ void idRenderWorldLocal::ParseNodes( idLexer *src, idFile *fileOut ) {
 
 		node->children[0] = src->ParseInt();
 		node->children[1] = src->ParseInt();
+	}
 
-		if ( fileOut != NULL ) {
-			fileOut->WriteBig( node->plane[ 0 ] );
-			fileOut->WriteBig( node->plane[ 1 ] );
-			fileOut->WriteBig( node->plane[ 2 ] );
-			fileOut->WriteBig( node->plane[ 3 ] );
-			fileOut->WriteBig( node->children[ 0 ] );
-			fileOut->WriteBig( node->children[ 1 ] );
-		}
+	src->ExpectTokenString( "}" );
+
+	if ( fileOut != NULL ) {
+		WriteBinaryNodes( fileOut );
+	}
+}
+
+/*
+================
+idRenderWorldLocal::WriteBinaryNodes
 
+The node planes and children are written as two flat arrays.
+================
+*/
+void idRenderWorldLocal::WriteBinaryNodes( idFile *file ) const {
+	// write out the type so the binary reader knows what to instantiate
+	file->WriteString( "nodes" );
+
+	idList< idPlane > planes;
+	idList< int > children;
+	planes.SetNum( numAreaNodes );
+	children.SetNum( numAreaNodes * 2 );
+	for ( int i = 0; i < numAreaNodes; i++ ) {
+		planes[i] = areaNodes[i].plane;
+		children[i * 2 + 0] = areaNodes[i].children[0];
+		children[i * 2 + 1] = areaNodes[i].children[1];
 	}
 
-	src->ExpectTokenString( "}" );
+	file->WriteBig( numAreaNodes );
+	file->WriteBigArray( planes.Ptr(), planes.Num() );
+	file->WriteBigArray( children.Ptr(), children.Num() );
 }
 
 /*
@@ -595,18 +643,31 @@ void idRenderWorldLocal::ParseNodes( idLexer *src, idFile *fileOut ) {
 idRenderWorldLocal::ReadBinaryNodes
 ================
 */
-void idRenderWorldLocal::ReadBinaryNodes( idFile * file ) {
-	file->ReadBig( numAreaNodes );
+bool idRenderWorldLocal::ReadBinaryNodes( idFile * file ) {
+	int numNodes = 0;
+	file->ReadBig( numNodes );
+	if ( numNodes < 0 ) {
+		return false;
+	}
+
+	idList< idPlane > planes;
+	idList< int > children;
+	planes.SetNum( numNodes );
+	children.SetNum( numNodes * 2 );
+	file->ReadBigArray( planes.Ptr(), planes.Num() );
+	if ( file->ReadBigArray( children.Ptr(), children.Num() ) != children.Num() * sizeof( int ) ) {
+		return false;
+	}
+
+	numAreaNodes = numNodes;
 	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
 	for ( int i = 0; i < numAreaNodes; i++ ) {
 		areaNode_t * node = &areaNodes[ i ];
-		file->ReadBig( node->plane[ 0 ] );
-		file->ReadBig( node->plane[ 1 ] );
-		file->ReadBig( node->plane[ 2 ] );
-		file->ReadBig( node->plane[ 3 ] );
-		file->ReadBig( node->children[ 0 ] );
-		file->ReadBig( node->children[ 1 ] );
+		node->plane = planes[i];
+		node->children[ 0 ] = children[i * 2 + 0];
+		node->children[ 1 ] = children[i * 2 + 1];
 	}
+	return true;
 }
 
 /*
@@ -760,33 +821,30 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	FreeWorld();
 
+	const uint64 loadStart = Sys_Microseconds();
+
 	// see if we have a generated version of this 
-	static const byte BPROC_VERSION = 1;
+	static const byte BPROC_VERSION = 2;
 	static const unsigned int BPROC_MAGIC = ( 'P' << 24 ) | ( 'R' << 16 ) | ( 'O' << 8 ) | BPROC_VERSION;
 	bool loaded = false;
-	idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
+	idFileLocal file( r_binaryLoadRenderModels.GetBool() ? fileSystem->OpenFileReadMemory( generatedFileName ) : NULL );
 	if ( file != NULL ) {
 		int numEntries = 0;
 		int magic = 0;
+		ID_TIME_T sourceTimeStamp = FILE_NOT_FOUND_TIMESTAMP;
 		file->ReadBig( magic );
-		if ( magic == BPROC_MAGIC ) {
-			file->ReadBig( numEntries );
-			file->ReadString( mapName );
-			file->ReadBig( mapTimeStamp );
+		file->ReadBig( numEntries );
+		file->ReadString( mapName );
+		file->ReadBig( sourceTimeStamp );
+		// the generated file is only used if it was written for the current proc file
+		if ( magic == BPROC_MAGIC && ( fileSystem->InProductionMode() || currentTimeStamp == FILE_NOT_FOUND_TIMESTAMP || sourceTimeStamp == currentTimeStamp ) ) {
+			mapTimeStamp = sourceTimeStamp;
 			loaded = true;
-			for ( int i = 0; i < numEntries; i++ ) {
+			for ( int i = 0; i < numEntries && loaded; i++ ) {
 				idStrStatic< MAX_OSPATH > type;
 				file->ReadString( type );
 				type.ToLower();
-				if ( type == "model" ) {
-					idRenderModel * lastModel = ReadBinaryModel( file );
-					if ( lastModel == NULL ) {
-						loaded = false;
-						break;
-					}
-					renderModelManager->AddModel( lastModel );
-					localModels.Append( lastModel );
-				} else if ( type == "shadowmodel" ) {
+				if ( type == "model" || type == "shadowmodel" ) {
 					idRenderModel * lastModel = ReadBinaryModel( file );
 					if ( lastModel == NULL ) {
 						loaded = false;
@@ -795,13 +853,18 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 					renderModelManager->AddModel( lastModel );
 					localModels.Append( lastModel );
 				} else if ( type == "interareaportals" ) {
-					ReadBinaryAreaPortals( file );
+					loaded = ReadBinaryAreaPortals( file );
 				} else if ( type == "nodes" ) {
-					ReadBinaryNodes( file );
+					loaded = ReadBinaryNodes( file );
 				} else {
-					idLib::Error( "Binary proc file failed, unexpected type %s\n", type.c_str() );
+					loaded = false;
 				}
 			}
+			if ( !loaded ) {
+				// throw away whatever was read and parse the text
+				common->Warning( "idRenderWorldLocal::InitFromMap: %s is damaged, reparsing %s", generatedFileName.c_str(), filename.c_str() );
+				FreeWorld();
+			}
 		}
 	}
 
@@ -830,7 +893,7 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		}
 			
 		int numEntries = 0;
-		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
+		idFileLocal outputFile( r_binaryLoadRenderModels.GetBool() ? fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) : NULL );
 		if ( outputFile != NULL ) {
 			int magic = BPROC_MAGIC;
 			outputFile->WriteBig( magic );
@@ -903,6 +966,8 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	}
 
+	common->Printf( "idRenderWorldLocal::InitFromMap: %d models, %d areas, %d portals, %d nodes from %s in %.1f msec\n", localModels.Num(), numPortalAreas, numInterAreaPortals, numAreaNodes,
+					loaded ? generatedFileName.c_str() : filename.c_str(), ( Sys_Microseconds() - loadStart ) * 0.001f );
 
 
 	// if it was a trivial map without any areas, create a single area
@@ -210,8 +210,11 @@ public:
 	void					TouchWorldModels();
 	void					AddWorldModelEntities();
 	void					ClearPortalStates();
-	void					ReadBinaryAreaPortals( idFile *file );
-	void					ReadBinaryNodes( idFile *file );
+	bool					ReadBinaryAreaPortals( idFile *file );
+	bool					ReadBinaryNodes( idFile *file );
+	void					WriteBinaryAreaPortals( idFile *file ) const;
+	void					WriteBinaryNodes( idFile *file ) const;
+	void					AddInterAreaPortal( int portalNum, idWinding *w, int a1, int a2 );
 	idRenderModel *			ReadBinaryModel( idFile *file );
 	idRenderModel *			ReadBinaryShadowModel( idFile *file );
 
@@ -106,6 +106,7 @@ idVertexCache::Init
 ==============
 */
 void idVertexCache::Init( bool restart ) {
+	headless = false;
 	currentFrame = 0;
 	listNum = 0;
 
@@ -121,6 +122,29 @@ void idVertexCache::Init( bool restart ) {
 	MapGeoBufferSet( frameData[listNum] );
 }
 
+/*
+==============
+idVertexCache::InitHeadless
+
+A dedicated server has no device and never draws, so no buffers are created
+and every allocation hands back an empty handle.
+==============
+*/
+void idVertexCache::InitHeadless() {
+	headless = true;
+	currentFrame = 0;
+	listNum = 0;
+
+	mostUsedVertex = 0;
+	mostUsedIndex = 0;
+	mostUsedJoint = 0;
+
+	for ( int i = 0; i < VERTCACHE_NUM_FRAMES; i++ ) {
+		ClearGeoBufferSet( frameData[i] );
+	}
+	ClearGeoBufferSet( staticData );
+}
+
 /*
 ==============
 idVertexCache::Shutdown
@@ -141,7 +165,11 @@ idVertexCache::PurgeAll
 */
 void idVertexCache::PurgeAll() {
 	Shutdown();
-	Init( true );
+	if ( headless ) {
+		InitHeadless();
+	} else {
+		Init( true );
+	}
 }
 
 /*
@@ -164,7 +192,7 @@ idVertexCache::ActuallyAlloc
 ==============
 */
 vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t & vcs, const void * data, int bytes, cacheType_t type ) {
-	if ( bytes == 0 ) {
+	if ( bytes == 0 || headless ) {
 		return (vertCacheHandle_t)0;
 	}
 
@@ -75,6 +75,7 @@ struct geoBufferSet_t {
 class idVertexCache {
 public:
 	void			Init( bool restart = false );
+	void			InitHeadless();
 	void			Shutdown();
 	void			PurgeAll();
 
@@ -148,6 +149,9 @@ public:
 
 	void			BeginBackEnd();
 
+	// true when there is no device behind the cache, every allocation returns an empty handle
+	bool			IsHeadless() const { return headless; }
+
 public:
 	int				currentFrame;	// for determining the active buffers
 	int				listNum;		// currentFrame % VERTCACHE_NUM_FRAMES
@@ -161,6 +165,8 @@ public:
 	int				mostUsedIndex;
 	int				mostUsedJoint;
 
+	bool			headless;
+
 	// Try to make room for <bytes> bytes
 	vertCacheHandle_t	ActuallyAlloc( geoBufferSet_t & vcs, const void * data, int bytes, cacheType_t type );
 };
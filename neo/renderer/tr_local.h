@@ -702,6 +702,7 @@ public:
 	virtual void			Shutdown();
 	virtual void			ResetGuiModels();
 	virtual void			InitGL();
+	virtual void			InitHeadless();
 	virtual void			ShutdownGL();
 	virtual bool			IsGLRunning() const;
 	virtual bool			IsFullScreen() const;
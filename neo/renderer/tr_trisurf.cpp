@@ -1942,6 +1942,11 @@ void R_CreateStaticBuffersForTri( srfTriangles_t & tri ) {
 	tri.ambientCache = 0;
 	tri.shadowCache = 0;
 
+	// nothing is ever drawn without a device, so don't build the shadow verts either
+	if ( vertexCache.IsHeadless() ) {
+		return;
+	}
+
 	// index cache
 	if ( tri.indexes != NULL ) {
 		tri.indexCache = vertexCache.AllocStaticIndex( tri.indexes, ALIGN( tri.numIndexes * sizeof( tri.indexes[0] ), INDEX_CACHE_ALIGN ) );
@@ -137,6 +137,9 @@ bool idSoundShader::Parse( const char *text, const int textLength, bool allowBin
 
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( allowBinaryVersion ) {
+		src.SetTokenStream( GetTokenStream() );
+	}
 	src.SkipUntilString( "{" );
 
 	if ( !ParseShader( src ) ) {
@@ -510,6 +510,16 @@ void idSoundSystemLocal::Preload( idPreloadManifest & manifest ) {
 
 	preloadSort.SortWithTemplate( idSort_Preload() );
 
+	// read the samples on the I/O thread just ahead of loading them here
+	idStrList preloadFiles;
+	preloadFiles.SetNum( preloadSort.Num() );
+	for ( int i = 0; i < preloadSort.Num(); i++ ) {
+		preloadFiles[ i ] = "generated/";
+		preloadFiles[ i ] += manifest.GetPreloadByIndex( preloadSort[ i ].idx ).resourceName;
+		preloadFiles[ i ].SetFileExtension( "idwav" );
+	}
+	fileSystem->StartPreload( preloadFiles );
+
 	for ( int i = 0; i < preloadSort.Num(); i++ ) {
 		const preloadSort_t & ps = preloadSort[ i ];
 		const preloadEntry_s & p = manifest.GetPreloadByIndex( ps.idx );
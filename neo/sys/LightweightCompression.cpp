@@ -378,6 +378,389 @@ void idLZWCompressor::ClearHash() {
 	memset( hash, 0xFF, sizeof( hash ) ); 
 }
 
+/*
+========================
+LZHash
+========================
+*/
+static ID_INLINE int LZHash( const uint8 * p ) {
+	const uint32 v = p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( p[3] << 24 );
+	return (int)( ( v * 2654435761U ) >> ( 32 - lzCompressionData_t::LZ_HASH_BITS ) );
+}
+
+/*
+========================
+LZLengthBytes
+
+Number of bytes following the token needed to store a literal or match length.
+========================
+*/
+static ID_INLINE int LZLengthBytes( int length ) {
+	return ( length >= idLZCompressor::LZ_RUN_MASK ) ? ( length - idLZCompressor::LZ_RUN_MASK ) / 255 + 1 : 0;
+}
+
+/*
+========================
+idLZCompressor::Start
+========================
+*/
+void idLZCompressor::Start( uint8 * data_, int maxSize_, bool append ) {
+	if ( append ) {
+		// The window, hash and pending sequence carry over from the last job, 
+		// and the output continues at the same place with the same bytesWritten.
+		assert( lzData->windowSize > 0 );
+	} else {
+		memset( lzData->hash, 0xFF, sizeof( lzData->hash ) );
+
+		lzData->windowSize		= 0;
+		lzData->nextHash		= 0;
+		lzData->literalStart	= 0;
+		lzData->matchStart		= 0;
+		lzData->matchSource		= 0;
+		lzData->matchLength		= 0;
+		lzData->bytesWritten	= 0;
+	}
+
+	data		= data_;
+	maxSize		= maxSize_;
+	overflowed	= false;
+	ended		= false;
+
+	bytesRead	= 0;
+	readIndex	= 0;
+
+	Save();
+}
+
+/*
+========================
+idLZCompressor::EmitByte
+========================
+*/
+void idLZCompressor::EmitByte( uint8 value ) {
+	if ( lzData->bytesWritten >= maxSize ) {
+		overflowed = true;
+		return;
+	}
+	data[lzData->bytesWritten++] = value;
+}
+
+/*
+========================
+idLZCompressor::EmitLength
+
+Lengths that don't fit in the token nibble continue in bytes of 255 until a smaller byte.
+========================
+*/
+void idLZCompressor::EmitLength( int length ) {
+	for ( length -= LZ_RUN_MASK; length >= 255; length -= 255 ) {
+		EmitByte( 255 );
+	}
+	EmitByte( (uint8)length );
+}
+
+/*
+========================
+idLZCompressor::EmitSequence
+
+Writes the literals from literalStart up to literalEnd, followed by the match.
+A matchLength of 0 ends the stream: the decoder stops once the literals run into the end of the data.
+========================
+*/
+void idLZCompressor::EmitSequence( int literalEnd, int offset, int matchLength ) {
+	const int numLiterals	= literalEnd - lzData->literalStart;
+	const int matchNibble	= ( matchLength > 0 ) ? Min( matchLength - LZ_MIN_MATCH, LZ_RUN_MASK ) : 0;
+
+	assert( numLiterals >= 0 );
+	assert( matchLength == 0 || ( matchLength >= LZ_MIN_MATCH && offset > 0 && offset <= LZ_MAX_OFFSET ) );
+
+	EmitByte( (uint8)( ( Min( numLiterals, LZ_RUN_MASK ) << 4 ) | matchNibble ) );
+	if ( numLiterals >= LZ_RUN_MASK ) {
+		EmitLength( numLiterals );
+	}
+
+	if ( lzData->bytesWritten + numLiterals > maxSize ) {
+		overflowed = true;
+		return;
+	}
+	memcpy( &data[lzData->bytesWritten], &lzData->window[lzData->literalStart], numLiterals );
+	lzData->bytesWritten += numLiterals;
+
+	if ( matchLength == 0 ) {
+		return;
+	}
+
+	EmitByte( (uint8)( offset & 255 ) );
+	EmitByte( (uint8)( offset >> 8 ) );
+	if ( matchLength - LZ_MIN_MATCH >= LZ_RUN_MASK ) {
+		EmitLength( matchLength - LZ_MIN_MATCH );
+	}
+}
+
+/*
+========================
+idLZCompressor::FindMatches
+
+Hashes every window position that has LZ_MIN_MATCH bytes after it, until one of them starts a match.
+A match that reaches the end of the window stays pending, so the following writes can extend it.
+========================
+*/
+void idLZCompressor::FindMatches() {
+	lzCompressionData_t & lz = *lzData;
+
+	while ( lz.matchLength == 0 && lz.nextHash + LZ_MIN_MATCH <= lz.windowSize ) {
+		const int pos = lz.nextHash++;
+		const int h = LZHash( &lz.window[pos] );
+		const int candidate = lz.hash[h];
+		lz.hash[h] = (int16)pos;
+
+		// Restore leaves the hash pointing into the rolled back part of the window, only earlier positions are real data
+		if ( candidate < 0 || candidate >= pos || pos - candidate > LZ_MAX_OFFSET || memcmp( &lz.window[candidate], &lz.window[pos], LZ_MIN_MATCH ) != 0 ) {
+			continue;
+		}
+
+		int length = LZ_MIN_MATCH;
+		while ( pos + length < lz.windowSize && lz.window[candidate + length] == lz.window[pos + length] ) {
+			length++;
+		}
+
+		if ( pos + length < lz.windowSize ) {
+			// Already ended, so emit it and keep looking behind it
+			EmitSequence( pos, pos - candidate, length );
+			lz.literalStart	= pos + length;
+			lz.nextHash		= lz.literalStart;
+		} else {
+			lz.matchStart	= pos;
+			lz.matchSource	= candidate;
+			lz.matchLength	= length;
+		}
+	}
+}
+
+/*
+========================
+idLZCompressor::WriteByte
+========================
+*/
+void idLZCompressor::WriteByte( uint8 value ) {
+	lzCompressionData_t & lz = *lzData;
+
+	if ( overflowed ) {
+		return;
+	}
+
+	if ( lz.windowSize >= lzCompressionData_t::LZ_WINDOW_SIZE ) {
+		overflowed = true;
+		return;
+	}
+
+	lz.window[lz.windowSize++] = value;
+
+	if ( lz.matchLength > 0 ) {
+		if ( lz.window[lz.matchSource + lz.matchLength] == value ) {
+			lz.matchLength++;
+		} else {
+			EmitSequence( lz.matchStart, lz.matchStart - lz.matchSource, lz.matchLength );
+			lz.literalStart	= lz.matchStart + lz.matchLength;
+			lz.nextHash		= lz.literalStart;
+			lz.matchLength	= 0;
+		}
+	}
+
+	FindMatches();
+
+	if ( Length() > maxSize ) {
+		overflowed = true;	// At any point, if we can't perform an End call, then trigger an overflow
+	}
+}
+
+/*
+========================
+idLZCompressor::Length
+
+The size the stream would have if End was called now.
+========================
+*/
+int idLZCompressor::Length() const {
+	const lzCompressionData_t & lz = *lzData;
+
+	if ( ended ) {
+		return lz.bytesWritten;
+	}
+
+	int length = lz.bytesWritten;
+	int literalStart = lz.literalStart;
+
+	if ( lz.matchLength > 0 ) {
+		const int numLiterals = lz.matchStart - literalStart;
+		length += 1 + LZLengthBytes( numLiterals ) + numLiterals + 2 + LZLengthBytes( lz.matchLength - LZ_MIN_MATCH );
+		literalStart = lz.matchStart + lz.matchLength;
+	}
+
+	// Final literals only sequence
+	const int numLiterals = lz.windowSize - literalStart;
+	length += 1 + LZLengthBytes( numLiterals ) + numLiterals;
+
+	return length;
+}
+
+/*
+========================
+idLZCompressor::End
+========================
+*/
+int idLZCompressor::End() {
+	lzCompressionData_t & lz = *lzData;
+
+	assert( !ended );
+
+	if ( lz.matchLength > 0 ) {
+		EmitSequence( lz.matchStart, lz.matchStart - lz.matchSource, lz.matchLength );
+		lz.literalStart	= lz.matchStart + lz.matchLength;
+		lz.matchLength	= 0;
+	}
+
+	EmitSequence( lz.windowSize, 0, 0 );
+	lz.literalStart	= lz.windowSize;
+	lz.nextHash		= lz.windowSize;
+
+	ended = true;
+
+	if ( overflowed || lz.windowSize == 0 ) {
+		return -1;
+	}
+
+	return lz.bytesWritten;		// Total bytes written
+}
+
+/*
+========================
+idLZCompressor::Save
+========================
+*/
+void idLZCompressor::Save() {
+	assert( !overflowed );
+
+	savedWindowSize		= lzData->windowSize;
+	savedNextHash		= lzData->nextHash;
+	savedLiteralStart	= lzData->literalStart;
+	savedMatchStart		= lzData->matchStart;
+	savedMatchSource	= lzData->matchSource;
+	savedMatchLength	= lzData->matchLength;
+	savedBytesWritten	= lzData->bytesWritten;
+}
+
+/*
+========================
+idLZCompressor::Restore
+========================
+*/
+void idLZCompressor::Restore() {
+	lzData->windowSize		= savedWindowSize;
+	lzData->nextHash		= savedNextHash;
+	lzData->literalStart	= savedLiteralStart;
+	lzData->matchStart		= savedMatchStart;
+	lzData->matchSource		= savedMatchSource;
+	lzData->matchLength		= savedMatchLength;
+	lzData->bytesWritten	= savedBytesWritten;
+
+	overflowed	= false;
+	ended		= false;
+}
+
+/*
+========================
+idLZCompressor::DecodeLength
+========================
+*/
+int idLZCompressor::DecodeLength( int length ) {
+	if ( length < LZ_RUN_MASK ) {
+		return length;
+	}
+	while ( bytesRead < maxSize ) {
+		const int value = data[bytesRead++];
+		length += value;
+		if ( value != 255 ) {
+			return length;
+		}
+	}
+	return -1;
+}
+
+/*
+========================
+idLZCompressor::DecodeSequence
+
+Decodes the next literals + match into the window.  Returns false at the end of the data, 
+or if the data is corrupt.
+========================
+*/
+bool idLZCompressor::DecodeSequence() {
+	lzCompressionData_t & lz = *lzData;
+
+	if ( bytesRead >= maxSize ) {
+		return false;
+	}
+
+	const int token = data[bytesRead++];
+
+	const int numLiterals = DecodeLength( token >> 4 );
+	if ( numLiterals < 0 || bytesRead + numLiterals > maxSize || lz.windowSize + numLiterals > lzCompressionData_t::LZ_WINDOW_SIZE ) {
+		bytesRead = maxSize;
+		return false;
+	}
+	memcpy( &lz.window[lz.windowSize], &data[bytesRead], numLiterals );
+	lz.windowSize += numLiterals;
+	bytesRead += numLiterals;
+
+	if ( bytesRead == maxSize ) {
+		return true;		// The last sequence has no match
+	}
+
+	if ( bytesRead + 2 > maxSize ) {
+		bytesRead = maxSize;
+		return false;
+	}
+	const int offset = data[bytesRead] | ( data[bytesRead + 1] << 8 );
+	bytesRead += 2;
+
+	int matchLength = DecodeLength( token & LZ_RUN_MASK );
+	if ( matchLength < 0 || offset == 0 || offset > lz.windowSize || lz.windowSize + matchLength + LZ_MIN_MATCH > lzCompressionData_t::LZ_WINDOW_SIZE ) {
+		bytesRead = maxSize;
+		return false;
+	}
+	matchLength += LZ_MIN_MATCH;
+
+	// The source can overlap the bytes being produced, so copy forwards a byte at a time
+	const uint8 * src = &lz.window[lz.windowSize - offset];
+	uint8 * dest = &lz.window[lz.windowSize];
+	for ( int i = 0; i < matchLength; i++ ) {
+		dest[i] = src[i];
+	}
+	lz.windowSize += matchLength;
+
+	return true;
+}
+
+/*
+========================
+idLZCompressor::ReadByte
+========================
+*/
+int idLZCompressor::ReadByte( bool ignoreOverflow ) {
+	while ( readIndex == lzData->windowSize ) {
+		if ( !DecodeSequence() ) {
+			if ( !ignoreOverflow ) {
+				overflowed = true;
+				assert( !"idLZCompressor::ReadByte overflowed!" );
+			}
+			return -1;
+		}
+	}
+
+	return lzData->window[readIndex++];
+}
+
 /*
 ========================
 idZeroRunLengthCompressor
@@ -385,7 +768,7 @@ Simple zero based run length encoder/decoder
 ========================
 */
 
-void idZeroRunLengthCompressor::Start( uint8 * dest_, idLZWCompressor * comp_, int maxSize_ ) {
+void idZeroRunLengthCompressor::Start( uint8 * dest_, idLightweightCompressor * comp_, int maxSize_ ) {
 	zeroCount	= 0;
 	dest		= dest_;
 	comp		= comp_;
@@ -28,58 +28,37 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __LIGHTWEIGHT_COMPRESSION_H__
 #define __LIGHTWEIGHT_COMPRESSION_H__
 
-		
-struct lzwCompressionData_t {
-	static const int	LZW_DICT_BITS	= 12;
-	static const int	LZW_DICT_SIZE	= 1 << LZW_DICT_BITS;
-	
-	uint8					dictionaryK[LZW_DICT_SIZE];
-	uint16					dictionaryW[LZW_DICT_SIZE];
-
-	int						nextCode;
-	int						codeBits;
-
-	int						codeWord;
-	
-	uint64					tempValue;
-	int						tempBits;
-	int						bytesWritten;
+// Codecs that can compress a snapshot delta stream.  The codec is written as the first byte of
+// every delta, so the reader never has to be told which one the writer picked.
+enum snapCodec_t {
+	SNAP_CODEC_LZW,			// idLZWCompressor
+	SNAP_CODEC_LZ,			// idLZCompressor
+	SNAP_CODEC_MAX
 };
 
 /*
 ========================
-idLZWCompressor
-Simple lzw based encoder/decoder
+idLightweightCompressor
+Byte stream interface shared by the snapshot delta compressors
 ========================
 */
-class idLZWCompressor {
+class idLightweightCompressor {
 public:
-	idLZWCompressor( lzwCompressionData_t * lzwData_ ) : lzwData( lzwData_ ) {}
+	virtual			~idLightweightCompressor() {}
 
-	static const int	LZW_BLOCK_SIZE	= ( 1 << 15 );
-	static const int	LZW_START_BITS	= 9;
-	static const int	LZW_FIRST_CODE	= ( 1 << ( LZW_START_BITS - 1 ) );
+	virtual void	Start( uint8 * data_, int maxSize, bool append = false ) = 0;
+	virtual int		ReadByte( bool ignoreOverflow = false ) = 0;
+	virtual void	WriteByte( uint8 value ) = 0;
+	virtual int		End() = 0;
 
-	void	Start( uint8 * data_, int maxSize, bool append = false );
-	int		ReadBits( int bits );
-	int		WriteChain( int code );
-	void	DecompressBlock();
-	void	WriteBits( uint32 value, int bits );
-	int		ReadByte( bool ignoreOverflow = false );
-	void	WriteByte( uint8 value );
-	int		Lookup( int w, int k );
-	int		AddToDict( int w, int k );
-	bool	BumpBits();
-	int		End();
-	
-	int		Length() const { return lzwData->bytesWritten; }
-	int		GetReadCount() const { return bytesRead; }
+	virtual int		Length() const = 0;
+	virtual int		GetReadCount() const = 0;
 
-	void	Save();
-	void	Restore();
+	virtual void	Save() = 0;
+	virtual void	Restore() = 0;
+
+	virtual bool	IsOverflowed() = 0;
 
-	bool	IsOverflowed() { return overflowed; }
-	
 	int		Write( const void * data, int length ) {
 		uint8 * src = (uint8*)data;
 		
@@ -140,6 +119,58 @@ public:
 		size_t r = Read( &c, sizeof( c ), ignoreOverflow );
 		return r;
 	}
+};
+		
+struct lzwCompressionData_t {
+	static const int	LZW_DICT_BITS	= 12;
+	static const int	LZW_DICT_SIZE	= 1 << LZW_DICT_BITS;
+	
+	uint8					dictionaryK[LZW_DICT_SIZE];
+	uint16					dictionaryW[LZW_DICT_SIZE];
+
+	int						nextCode;
+	int						codeBits;
+
+	int						codeWord;
+	
+	uint64					tempValue;
+	int						tempBits;
+	int						bytesWritten;
+};
+
+/*
+========================
+idLZWCompressor
+Simple lzw based encoder/decoder
+========================
+*/
+class idLZWCompressor : public idLightweightCompressor {
+public:
+	idLZWCompressor( lzwCompressionData_t * lzwData_ ) : lzwData( lzwData_ ) {}
+
+	static const int	LZW_BLOCK_SIZE	= ( 1 << 15 );
+	static const int	LZW_START_BITS	= 9;
+	static const int	LZW_FIRST_CODE	= ( 1 << ( LZW_START_BITS - 1 ) );
+
+	virtual void	Start( uint8 * data_, int maxSize, bool append = false );
+	int		ReadBits( int bits );
+	int		WriteChain( int code );
+	void	DecompressBlock();
+	void	WriteBits( uint32 value, int bits );
+	virtual int		ReadByte( bool ignoreOverflow = false );
+	virtual void	WriteByte( uint8 value );
+	int		Lookup( int w, int k );
+	int		AddToDict( int w, int k );
+	bool	BumpBits();
+	virtual int		End();
+	
+	virtual int		Length() const { return lzwData->bytesWritten; }
+	virtual int		GetReadCount() const { return bytesRead; }
+
+	virtual void	Save();
+	virtual void	Restore();
+
+	virtual bool	IsOverflowed() { return overflowed; }
 
 	static const int DICTIONARY_HASH_BITS	= 10;
 	static const int MAX_DICTIONARY_HASH	= 1 << DICTIONARY_HASH_BITS;
@@ -174,6 +205,83 @@ private:
 	int					savedTempBits;
 };
 
+struct lzCompressionData_t {
+	static const int	LZ_WINDOW_SIZE	= idLZWCompressor::LZW_BLOCK_SIZE;
+	static const int	LZ_HASH_BITS	= 12;
+	static const int	LZ_HASH_SIZE	= 1 << LZ_HASH_BITS;
+
+	uint8					window[LZ_WINDOW_SIZE];		// Every raw byte written to the stream so far
+	int16					hash[LZ_HASH_SIZE];			// Last window position seen for each hashed LZ_MIN_MATCH bytes
+
+	int						windowSize;
+	int						nextHash;					// Next window position to look up/insert in the hash
+	int						literalStart;				// First window position not yet covered by an emitted sequence
+	int						matchStart;					// Pending match, matchLength == 0 if there is none
+	int						matchSource;
+	int						matchLength;
+	int						bytesWritten;
+};
+
+/*
+========================
+idLZCompressor
+LZ4 style encoder/decoder: runs of literals, each followed by a copy from earlier in the stream.
+Matches are searched for as bytes are written, so Length() tracks the compressed size closely enough
+to cut deltas at net_optimalSnapDeltaSize, and Save/Restore work the same way as idLZWCompressor.
+Decoding is a plain copy loop, which makes it considerably cheaper than walking LZW chains.
+========================
+*/
+class idLZCompressor : public idLightweightCompressor {
+public:
+	idLZCompressor( lzCompressionData_t * lzData_ ) : lzData( lzData_ ) {}
+
+	static const int	LZ_MIN_MATCH	= 4;
+	static const int	LZ_MAX_OFFSET	= 0xFFFF;
+	static const int	LZ_RUN_MASK		= 15;		// Nibble value that means more length bytes follow
+
+	virtual void	Start( uint8 * data_, int maxSize, bool append = false );
+	virtual int		ReadByte( bool ignoreOverflow = false );
+	virtual void	WriteByte( uint8 value );
+	virtual int		End();
+
+	virtual int		Length() const;
+	virtual int		GetReadCount() const { return bytesRead; }
+
+	virtual void	Save();
+	virtual void	Restore();
+
+	virtual bool	IsOverflowed() { return overflowed; }
+
+private:
+	void	FindMatches();
+	void	EmitSequence( int literalEnd, int offset, int matchLength );
+	void	EmitLength( int length );
+	void	EmitByte( uint8 value );
+	bool	DecodeSequence();
+	int		DecodeLength( int length );
+
+	lzCompressionData_t *	lzData;
+
+	uint8 *				data;		// Read/write
+	int					maxSize;
+	bool				overflowed;
+	bool				ended;
+
+	// For reading, decoded bytes go to lzData->window
+	int					bytesRead;
+	int					readIndex;
+
+	// saving/restoring when overflow (when writing). 
+	// Must call End directly after restoring (the hash may point past the restored window)
+	int					savedWindowSize;
+	int					savedNextHash;
+	int					savedLiteralStart;
+	int					savedMatchStart;
+	int					savedMatchSource;
+	int					savedMatchLength;
+	int					savedBytesWritten;
+};
+
 /*
 ========================
 idZeroRunLengthCompressor
@@ -185,7 +293,7 @@ public:
 	idZeroRunLengthCompressor() : zeroCount( 0 ), destStart( NULL ) {
 	}
 	
-	void Start( uint8 * dest_, idLZWCompressor * comp_, int maxSize_ );
+	void Start( uint8 * dest_, idLightweightCompressor * comp_, int maxSize_ );
 	bool WriteRun();
 	bool WriteByte( uint8 value );
 	byte ReadByte();
@@ -199,7 +307,7 @@ private:
 	int ReadInternal();
 
 	int					zeroCount;		// Number of pending zeroes
-	idLZWCompressor *	comp;
+	idLightweightCompressor *	comp;
 	uint8 *				destStart;
 	uint8 *				dest;
 	int					compressed;		// Compressed size
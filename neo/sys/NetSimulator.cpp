@@ -0,0 +1,746 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+#include "../framework/Common_local.h"
+
+#define SNAP_RECORD_FILE	"snaprecord.bin"
+
+idCVar net_snapRecord( "net_snapRecord", "0", CVAR_BOOL, "Append the snapshots the server sends to " SNAP_RECORD_FILE " for netSimulate" );
+idCVar net_simLatency( "net_simLatency", "50", CVAR_INTEGER, "netSimulate: one way latency in milliseconds", 0, 2000 );
+idCVar net_simJitter( "net_simJitter", "10", CVAR_INTEGER, "netSimulate: random extra latency in milliseconds", 0, 1000 );
+idCVar net_simLoss( "net_simLoss", "0.02", CVAR_FLOAT, "netSimulate: fraction of the packets that are lost", 0.0f, 1.0f );
+idCVar net_simReorder( "net_simReorder", "0.01", CVAR_FLOAT, "netSimulate: fraction of the packets that arrive after the packets sent after them", 0.0f, 1.0f );
+idCVar net_simRate( "net_simRate", "0", CVAR_INTEGER, "netSimulate: down link rate of every client in kilobytes per second, 0 = unlimited" );
+
+extern idCVar net_snapRate;
+extern idCVar net_ucmdRate;
+extern idCVar net_maxRate;
+extern idCVar net_snapObjDeltaCache;
+extern idCVar net_snap_redundant_resend_in_ms;
+extern idCVar net_peer_throttle_mode;
+extern idCVar net_min_ping_in_ms;
+extern idCVar net_pingIncPercentBeforeRecover;
+extern idCVar net_maxFailedPingRecoveries;
+extern idCVar net_pingRecoveryThrottleTimeInSeconds;
+
+static idFile * snapRecordFile = NULL;
+
+/*
+========================
+idNetSimLink::idNetSimLink
+========================
+*/
+idNetSimLink::idNetSimLink() {
+	netSimLinkParms_t defaultParms;
+	memset( &defaultParms, 0, sizeof( defaultParms ) );
+	Init( defaultParms, 0 );
+}
+
+/*
+========================
+idNetSimLink::Init
+========================
+*/
+void idNetSimLink::Init( const netSimLinkParms_t & parms_, int seed ) {
+	parms			= parms_;
+	random.SetSeed( seed );
+	packets.Clear();
+	linkFreeTime	= 0;
+	lastArriveTime	= 0;
+	numSent			= 0;
+	numDropped		= 0;
+	bytesSent		= 0;
+}
+
+/*
+========================
+idNetSimLink::Send
+========================
+*/
+void idNetSimLink::Send( int time, const byte * data, int size ) {
+	assert( size > 0 && size <= idPacketProcessor::MAX_FINAL_PACKET_SIZE );
+
+	numSent++;
+	bytesSent += size;
+
+	// wait for the packets ahead of this one to get on the wire
+	int sendTime = time;
+	if ( parms.rate > 0 ) {
+		sendTime = Max( time, linkFreeTime );
+		if ( sendTime - time > parms.maxQueue ) {
+			numDropped++;
+			return;
+		}
+		linkFreeTime = sendTime + size * 1000 / parms.rate;
+		sendTime = linkFreeTime;
+	}
+
+	if ( random.RandomFloat() < parms.loss ) {
+		numDropped++;
+		return;
+	}
+
+	int arriveTime = sendTime + parms.latency + ( parms.jitter > 0 ? random.RandomInt( parms.jitter + 1 ) : 0 );
+	if ( random.RandomFloat() < parms.reorder ) {
+		// held back long enough for the following packets to overtake it
+		arriveTime += parms.latency + parms.jitter + 1;
+	} else {
+		// jitter alone doesn't reorder packets, they queue behind each other on the way
+		arriveTime = Max( arriveTime, lastArriveTime );
+		lastArriveTime = arriveTime;
+	}
+
+	packet_t & packet = packets.Alloc();
+	packet.arriveTime = arriveTime;
+	packet.size = size;
+	memcpy( packet.data, data, size );
+}
+
+/*
+========================
+idNetSimLink::Receive
+========================
+*/
+int idNetSimLink::Receive( int time, byte * data, int maxSize ) {
+	int best = -1;
+	for ( int i = 0; i < packets.Num(); i++ ) {
+		if ( packets[i].arriveTime <= time && ( best == -1 || packets[i].arriveTime < packets[best].arriveTime ) ) {
+			best = i;
+		}
+	}
+	if ( best == -1 ) {
+		return 0;
+	}
+
+	const int size = packets[best].size;
+	if ( !verify( size <= maxSize ) ) {
+		packets.RemoveIndex( best );
+		return 0;
+	}
+	memcpy( data, packets[best].data, size );
+	packets.RemoveIndex( best );		// keep the send order of packets that arrive at the same time
+
+	return size;
+}
+
+/*
+========================
+idNetSimulator::RecordSnapshot
+
+A recorded snapshot is its time and object count, followed by the number, visibility mask, 
+size, schema id (-1 for none), schema offset and state of every object.
+========================
+*/
+void idNetSimulator::RecordSnapshot( const idSnapShot & ss ) {
+	if ( !net_snapRecord.GetBool() ) {
+		Shutdown();
+		return;
+	}
+
+	if ( snapRecordFile == NULL ) {
+		snapRecordFile = fileSystem->OpenFileWrite( SNAP_RECORD_FILE, "fs_savepath" );
+		if ( snapRecordFile == NULL ) {
+			idLib::Warning( "Couldn't open %s, stopped recording snapshots", SNAP_RECORD_FILE );
+			net_snapRecord.SetBool( false );
+			return;
+		}
+	}
+
+	snapRecordFile->WriteBig( ss.GetTime() );
+	snapRecordFile->WriteBig( ss.NumObjects() );
+	for ( int i = 0; i < ss.NumObjects(); i++ ) {
+		idBitMsg msg;
+		const int objectNum = ss.GetObjectMsgByIndex( i, msg );
+		const idSnapShot::objectState_t * state = ss.FindObjectByID( objectNum );
+		snapRecordFile->WriteBig( objectNum );
+		snapRecordFile->WriteBig( state->visMask );
+		snapRecordFile->WriteBig( msg.GetSize() );
+		snapRecordFile->WriteBig( state->schema != NULL ? state->schema->GetId() : -1 );
+		snapRecordFile->WriteBig( (int)state->schemaOffset );
+		snapRecordFile->Write( msg.GetReadData(), msg.GetSize() );
+	}
+}
+
+/*
+========================
+idNetSimulator::Shutdown
+========================
+*/
+void idNetSimulator::Shutdown() {
+	if ( snapRecordFile != NULL ) {
+		fileSystem->CloseFile( snapRecordFile );
+		snapRecordFile = NULL;
+	}
+}
+
+/*
+========================
+LoadRecordedSnapshots
+========================
+*/
+static bool LoadRecordedSnapshots( const char * fileName, idList< idSnapShot > & snapshots ) {
+	idFile * file = fileSystem->OpenFileRead( fileName );
+	if ( file == NULL ) {
+		return false;
+	}
+
+	static byte objectData[ idPacketProcessor::MAX_MSG_SIZE ];
+
+	while ( file->Tell() < file->Length() ) {
+		int time = 0;
+		int numObjects = 0;
+		file->ReadBig( time );
+		file->ReadBig( numObjects );
+
+		idSnapShot & ss = snapshots.Alloc();
+		ss.SetTime( time );
+		for ( int i = 0; i < numObjects; i++ ) {
+			int objectNum = 0;
+			uint32 visMask = 0;
+			int size = 0;
+			int schemaId = 0;
+			int schemaOffset = 0;
+			file->ReadBig( objectNum );
+			file->ReadBig( visMask );
+			file->ReadBig( size );
+			file->ReadBig( schemaId );
+			file->ReadBig( schemaOffset );
+			if ( size < 0 || size > (int)sizeof( objectData ) || file->Read( objectData, size ) != size ) {
+				idLib::Warning( "%s is truncated or invalid, replaying the first %d snapshots", fileName, snapshots.Num() - 1 );
+				snapshots.RemoveIndex( snapshots.Num() - 1 );
+				fileSystem->CloseFile( file );
+				return true;
+			}
+			idSnapShot::objectState_t * state = ss.S_AddObject( objectNum, visMask, objectData, size );
+			if ( schemaId != -1 ) {
+				state->schema = idNetSchema::FindById( schemaId );
+				state->schemaOffset = schemaOffset;
+			}
+		}
+	}
+
+	fileSystem->CloseFile( file );
+	return true;
+}
+
+/*
+================================================
+simPeer_t
+
+Both ends of the connection to one client.
+================================================
+*/
+struct simPeer_t {
+	idPacketProcessor *		serverPackets;
+	idSnapshotProcessor *	serverSnaps;
+	idPacketProcessor *		clientPackets;
+	idSnapshotProcessor *	clientSnaps;
+
+	idNetSimLink			down;				// server to client
+	idNetSimLink			up;					// client to server
+
+	bool					needToSubmitPendingSnap;
+	int						lastSnapJobTime;
+	int						lastFragmentSendTime;
+	int						lastClientFragmentSendTime;
+
+	int						sentSequence[ idSnapshotProcessor::MAX_SNAPSHOT_QUEUE ];	// to measure the ping with the acks
+	int						sentTime[ idSnapshotProcessor::MAX_SNAPSHOT_QUEUE ];
+	int						lastPingRtt;
+	int						rightBeforeSnapsPing;
+	int						throttleSnapsUntil;
+	int						failedPingRecoveries;
+
+	int						lastBaseSequence;
+	int						numDeltas;
+	int64					deltaBytes;
+	int						maxDeltaSize;
+	int						numBaseResends;		// deltas against a base the previous delta was already against
+	int						numOverflows;		// deltas that filled up the client delta queue
+	int						numSaturations;
+	int						numFullSnaps;		// complete snapshots the client received
+
+	usercmd_t				cmds[ NUM_USERCMD_SEND ];	// client side, the newest usercmds, oldest first
+	int						numCmds;
+	int						lastUsercmdSendTime;
+	int						newestCmdMilliseconds;		// server side, the newest usercmd received
+	int						numCmdPackets;
+	int64					cmdPacketBytes;				// after compression, without the packet headers
+	int						numCmdsReceived;
+	int						numCmdDuplicates;			// redundant copies of usercmds that already arrived
+	int						numCmdsLost;				// usercmds that never arrived in any packet
+};
+
+static const int SIM_FRAME_MSEC			= 16;
+static const int SIM_MAX_QUEUE_MSEC		= 500;
+static const int SIM_SESSION_ID			= 16;
+static const int SIM_OBJ_JOB_MEMORY		= 1024 * 128;
+
+/*
+========================
+SimSendFragment
+
+Sends the next fragment of the last ProcessOutgoing, no sooner than 2 ms after the previous one.
+========================
+*/
+static void SimSendFragment( int time, idPacketProcessor * packets, int sessionId, int & lastFragmentSendTime, idNetSimLink & link ) {
+	if ( !packets->HasMoreFragments() || time - lastFragmentSendTime < 2 ) {
+		return;
+	}
+	packets->RefreshRates( time );
+	if ( !packets->CanSendMoreData() ) {
+		return;
+	}
+	lastFragmentSendTime = time;
+
+	byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	idBitMsg msg;
+	msg.InitWrite( buffer, sizeof( buffer ) );
+	if ( packets->GetSendFragment( time, sessionId, msg ) ) {
+		link.Send( time, msg.GetReadData(), msg.GetSize() );
+	}
+}
+
+/*
+========================
+SimReceive
+
+Returns the next in-band msg that arrived on link, reassembled from its fragments.
+========================
+*/
+static bool SimReceive( int time, idPacketProcessor * packets, int sessionId, int peerNum, idNetSimLink & link, idBitMsg & msg ) {
+	byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	int size = 0;
+	while ( ( size = link.Receive( time, buffer, sizeof( buffer ) ) ) > 0 ) {
+		idBitMsg fragMsg;
+		fragMsg.InitRead( buffer, size );
+		msg.BeginWriting();
+		int userData = 0;
+		if ( packets->ProcessIncoming( time, sessionId, fragMsg, msg, userData, peerNum ) == idPacketProcessor::RETURN_TYPE_INBAND && msg.GetRemainingData() > 0 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+========================
+SimAdvanceUsercmd
+
+Builds the next usercmd of a simulated player, who mostly runs in one direction while 
+turning a little every frame, and now and then changes direction, shoots, jumps or 
+switches weapons.
+========================
+*/
+static void SimAdvanceUsercmd( idRandom & random, int time, usercmd_t & cmd ) {
+	cmd.clientGameMilliseconds = time + SIM_FRAME_MSEC;
+	cmd.serverGameMilliseconds = time;
+	cmd.angles[YAW] += random.RandomInt( 601 ) - 300;
+	cmd.angles[PITCH] = idMath::ClampInt( -8192, 8192, cmd.angles[PITCH] + random.RandomInt( 101 ) - 50 );
+	if ( random.RandomInt( 30 ) == 0 ) {
+		cmd.forwardmove = ( random.RandomInt( 3 ) - 1 ) * 127;
+		cmd.rightmove = ( random.RandomInt( 3 ) - 1 ) * 127;
+	}
+	cmd.buttons = BUTTON_RUN;
+	if ( random.RandomInt( 8 ) == 0 ) {
+		cmd.buttons |= BUTTON_ATTACK;
+		cmd.fireCount++;
+	}
+	if ( random.RandomInt( 60 ) == 0 ) {
+		cmd.buttons |= BUTTON_JUMP;
+	}
+	cmd.impulse = 0;
+	if ( random.RandomInt( 300 ) == 0 ) {
+		cmd.impulse = IMPULSE_14;
+		cmd.impulseSequence++;
+	}
+	const float speed = ( cmd.forwardmove != 0 || cmd.rightmove != 0 ) ? 320.0f : 0.0f;
+	const float yaw = DEG2RAD( SHORT2ANGLE( cmd.angles[YAW] ) );
+	cmd.pos.x += idMath::Cos( yaw ) * speed * SIM_FRAME_MSEC * 0.001f;
+	cmd.pos.y += idMath::Sin( yaw ) * speed * SIM_FRAME_MSEC * 0.001f;
+	cmd.speedSquared = speed * speed;
+}
+
+/*
+========================
+SimSendUsercmds
+
+Sends the newest usercmds of a client together with its snapshot ack, compressed the 
+same way as idSessionLocal::SendUsercmds.
+========================
+*/
+static void SimSendUsercmds( int time, simPeer_t & peer ) {
+	usercmd_t * cmdPtrs[ NUM_USERCMD_SEND ];
+	for ( int i = 0; i < peer.numCmds; i++ ) {
+		cmdPtrs[i] = &peer.cmds[i];
+	}
+	byte cmdBuffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	idBitMsg cmdMsg( cmdBuffer, sizeof( cmdBuffer ) );
+	WriteUsercmdBatch( cmdMsg, cmdPtrs, peer.numCmds );
+
+	byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	lzwCompressionData_t lzwData;
+	idLZWCompressor lzwCompressor( &lzwData );
+	lzwCompressor.Start( buffer, sizeof( buffer ) );
+	lzwCompressor.WriteAgnostic( peer.clientSnaps->GetLastAppendedSequence() );
+	lzwCompressor.WriteAgnostic( (uint16)0 );
+	lzwCompressor.Write( cmdMsg.GetReadData(), cmdMsg.GetSize() );
+	lzwCompressor.End();
+
+	peer.numCmdPackets++;
+	peer.cmdPacketBytes += lzwCompressor.Length();
+
+	idBitMsg msg;
+	msg.InitRead( buffer, lzwCompressor.Length() );
+	peer.clientPackets->ProcessOutgoing( time, msg, false, 0 );
+}
+
+/*
+========================
+SimReceiveUsercmds
+
+Reads a usercmd packet on the server like idLobby does, returns the acked snapshot.
+========================
+*/
+static int SimReceiveUsercmds( idBitMsg & msg, simPeer_t & peer ) {
+	int snapNum = 0;
+	uint16 receivedBps = 0;
+	byte cmdBuffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+
+	lzwCompressionData_t lzwData;
+	idLZWCompressor lzwCompressor( &lzwData );
+	lzwCompressor.Start( const_cast< byte * >( msg.GetReadData() ) + msg.GetReadCount(), msg.GetRemainingData() );
+	lzwCompressor.ReadAgnostic( snapNum );
+	lzwCompressor.ReadAgnostic( receivedBps );
+	const int cmdSize = lzwCompressor.Read( cmdBuffer, sizeof( cmdBuffer ), true );
+	lzwCompressor.End();
+
+	idBitMsg cmdMsg( (const byte *)cmdBuffer, cmdSize );
+	usercmd_t newCmds[ NUM_USERCMD_RELAY ];
+	int numDuplicates = 0;
+	const int numNewCmds = ReadUsercmdBatch( cmdMsg, peer.newestCmdMilliseconds, newCmds, NUM_USERCMD_RELAY, &numDuplicates );
+	for ( int i = 0; i < numNewCmds; i++ ) {
+		// a gap means the packets carrying the commands in between were all lost
+		peer.numCmdsLost += Max( ( newCmds[i].clientGameMilliseconds - peer.newestCmdMilliseconds ) / SIM_FRAME_MSEC - 1, 0 );
+		peer.newestCmdMilliseconds = newCmds[i].clientGameMilliseconds;
+	}
+	peer.numCmdsReceived += numNewCmds;
+	peer.numCmdDuplicates += numDuplicates;
+
+	return snapNum;
+}
+
+/*
+========================
+idNetSimulator::Run_f
+========================
+*/
+void idNetSimulator::Run_f( const idCmdArgs & args ) {
+	const int numClients	= idMath::ClampInt( 1, 31, ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 8 );
+	const int seconds		= idMath::ClampInt( 1, 3600, ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 30 );
+	const char * fileName	= ( args.Argc() > 3 ) ? args.Argv( 3 ) : SNAP_RECORD_FILE;
+	const int endTime		= seconds * 1000;
+	const int snapRate		= Max( net_snapRate.GetInteger(), 1 );
+	const int budgetBytes	= net_maxRate.GetInteger() * 1024 * snapRate / 1000;
+
+	idList< idSnapShot > recorded;
+	if ( LoadRecordedSnapshots( fileName, recorded ) && recorded.Num() > 0 ) {
+		idLib::Printf( "Replaying %d snapshots from %s to %d clients\n", recorded.Num(), fileName, numClients );
+	} else {
+		idLib::Printf( "No snapshots in %s, simulating a deathmatch for %d clients\n", fileName, numClients );
+	}
+
+	netSimLinkParms_t linkParms;
+	linkParms.latency	= net_simLatency.GetInteger();
+	linkParms.jitter	= net_simJitter.GetInteger();
+	linkParms.loss		= net_simLoss.GetFloat();
+	linkParms.reorder	= net_simReorder.GetFloat();
+	linkParms.rate		= net_simRate.GetInteger() * 1024;
+	linkParms.maxQueue	= SIM_MAX_QUEUE_MSEC;
+
+	netSimLinkParms_t upParms = linkParms;
+	upParms.rate		= 0;
+
+	uint8 * objMemory = (uint8 *)Mem_Alloc( SIM_OBJ_JOB_MEMORY, TAG_NETWORKING );
+	lzwCompressionData_t * lzwData = (lzwCompressionData_t *)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+	lzCompressionData_t * lzData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	idSnapObjDeltaCache * objDeltaCache = new (TAG_NETWORKING) idSnapObjDeltaCache();
+
+	idList< simPeer_t > peers;
+	peers.SetNum( numClients );
+	for ( int p = 0; p < numClients; p++ ) {
+		simPeer_t & peer = peers[p];
+		memset( peer.sentSequence, -1, sizeof( peer.sentSequence ) );
+		memset( peer.sentTime, 0, sizeof( peer.sentTime ) );
+		peer.serverPackets				= new (TAG_NETWORKING) idPacketProcessor();
+		peer.serverSnaps				= new (TAG_NETWORKING) idSnapshotProcessor();
+		peer.clientPackets				= new (TAG_NETWORKING) idPacketProcessor();
+		peer.clientSnaps				= new (TAG_NETWORKING) idSnapshotProcessor();
+		peer.down.Init( linkParms, p * 2 + 1 );
+		peer.up.Init( upParms, p * 2 + 2 );
+		peer.needToSubmitPendingSnap	= false;
+		peer.lastSnapJobTime			= 0;
+		peer.lastFragmentSendTime		= -2;
+		peer.lastClientFragmentSendTime	= -2;
+		peer.rightBeforeSnapsPing		= linkParms.latency * 2 + linkParms.jitter;
+		peer.lastPingRtt				= peer.rightBeforeSnapsPing;
+		peer.throttleSnapsUntil			= 0;
+		peer.failedPingRecoveries		= 0;
+		peer.lastBaseSequence			= -2;
+		peer.numDeltas					= 0;
+		peer.deltaBytes					= 0;
+		peer.maxDeltaSize				= 0;
+		peer.numBaseResends				= 0;
+		peer.numOverflows				= 0;
+		peer.numSaturations				= 0;
+		peer.numFullSnaps				= 0;
+		peer.numCmds					= 0;
+		peer.lastUsercmdSendTime		= -net_ucmdRate.GetInteger();
+		peer.newestCmdMilliseconds		= 0;
+		peer.numCmdPackets				= 0;
+		peer.cmdPacketBytes				= 0;
+		peer.numCmdsReceived			= 0;
+		peer.numCmdDuplicates			= 0;
+		peer.numCmdsLost				= 0;
+	}
+
+	byte buffer[ idPacketProcessor::MAX_MSG_SIZE ];
+	byte msgBuffer[ idPacketProcessor::MAX_MSG_SIZE ];
+	idRandom random( 0x51a );
+	idSnapShot ss;
+	int nextSnapTime = 0;
+	int numSnaps = 0;
+	int numSubmits = 0;
+	uint64 snapMicroseconds = 0;
+
+	for ( int time = 0; time < endTime; time++ ) {
+		// deliver the packets that arrived
+		for ( int p = 0; p < numClients; p++ ) {
+			simPeer_t & peer = peers[p];
+			const int sessionId = SIM_SESSION_ID + p;
+			idBitMsg msg;
+			msg.InitWrite( msgBuffer, sizeof( msgBuffer ) );
+
+			while ( SimReceive( time, peer.clientPackets, sessionId, p, peer.down, msg ) ) {
+				idSnapShot localSnap;
+				int sequence = -1;
+				int baseSequence = -1;
+				bool fullSnap = false;
+				if ( peer.clientSnaps->ReceiveSnapshotDelta( msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData(), 0, sequence, baseSequence, localSnap, fullSnap ) && fullSnap ) {
+					peer.numFullSnaps++;
+				}
+			}
+
+			while ( SimReceive( time, peer.serverPackets, sessionId, p, peer.up, msg ) ) {
+				const int snapNum = SimReceiveUsercmds( msg, peer );
+				const int slot = snapNum & ( idSnapshotProcessor::MAX_SNAPSHOT_QUEUE - 1 );
+				if ( snapNum >= 0 && peer.sentSequence[slot] == snapNum ) {
+					peer.lastPingRtt = time - peer.sentTime[slot];
+					peer.sentSequence[slot] = -1;
+				}
+				if ( peer.serverSnaps->ApplySnapshotDelta( idSnapShot::VisIndexForPeer( p ), snapNum ) && peer.serverSnaps->HasPendingSnap() ) {
+					peer.needToSubmitPendingSnap = true;
+				}
+			}
+		}
+
+		if ( time % SIM_FRAME_MSEC == 0 ) {
+			// clients build a usercmd every frame and send the newest ones at net_ucmdRate, acking the latest snapshot
+			for ( int p = 0; p < numClients; p++ ) {
+				simPeer_t & peer = peers[p];
+				usercmd_t cmd = ( peer.numCmds > 0 ) ? peer.cmds[ peer.numCmds - 1 ] : usercmd_t();
+				SimAdvanceUsercmd( random, time, cmd );
+				if ( peer.numCmds == NUM_USERCMD_SEND ) {
+					for ( int i = 1; i < NUM_USERCMD_SEND; i++ ) {
+						peer.cmds[i - 1] = peer.cmds[i];
+					}
+					peer.numCmds--;
+				}
+				peer.cmds[ peer.numCmds++ ] = cmd;
+
+				if ( peer.clientPackets->HasMoreFragments() || time - peer.lastUsercmdSendTime < net_ucmdRate.GetInteger() ) {
+					continue;
+				}
+				peer.lastUsercmdSendTime = time;
+				SimSendUsercmds( time, peer );
+			}
+
+			// new snapshots are handed to the peers at the snapshot rate
+			if ( time >= nextSnapTime ) {
+				nextSnapTime = time + snapRate;
+				if ( recorded.Num() > 0 ) {
+					ss = recorded[ numSnaps % recorded.Num() ];
+					ss.SetTime( time );
+				} else {
+					ss.Clear();
+					idSnapshotProcessor::WriteTestPlayers( ss, numClients, time );
+				}
+				numSnaps++;
+
+				for ( int p = 0; p < numClients; p++ ) {
+					simPeer_t & peer = peers[p];
+
+					// see if the ping shot up, which indicates a saturated connection
+					if ( peer.lastPingRtt > peer.rightBeforeSnapsPing * net_pingIncPercentBeforeRecover.GetFloat() && peer.lastPingRtt > net_min_ping_in_ms.GetInteger() && time >= peer.throttleSnapsUntil ) {
+						peer.numSaturations++;
+						if ( net_peer_throttle_mode.GetInteger() != 0 && peer.failedPingRecoveries < net_maxFailedPingRecoveries.GetInteger() ) {
+							peer.throttleSnapsUntil = time + net_pingRecoveryThrottleTimeInSeconds.GetInteger() * 1000;
+							peer.failedPingRecoveries++;
+						}
+					}
+
+					if ( peer.serverSnaps->TrySetPendingSnapshot( ss, idSnapShot::VisIndexForPeer( p ), budgetBytes ) ) {
+						peer.serverSnaps->GetBaseState()->UpdateExpectedSeq( peer.serverSnaps->GetSnapSequence() );
+					}
+					peer.needToSubmitPendingSnap = true;
+				}
+			}
+
+			// send the snapshot deltas of the last frame, then submit the next ones like idLobby::UpdateSnaps
+			bool sentAllSubmitted = true;
+			for ( int p = 0; p < numClients; p++ ) {
+				simPeer_t & peer = peers[p];
+				if ( !peer.serverSnaps->PendingSnapReadyToSend() ) {
+					continue;
+				}
+
+				const uint64 startMicroseconds = Sys_Microseconds();
+				int size = peer.serverSnaps->GetPendingSnapDelta( buffer, sizeof( buffer ) - 128 );
+				snapMicroseconds += Sys_Microseconds() - startMicroseconds;
+
+				peer.serverPackets->RefreshRates( time );
+				if ( !peer.serverPackets->CanSendMoreData() || peer.serverPackets->HasMoreFragments() || time < peer.throttleSnapsUntil || size == 0 ) {
+					continue;
+				}
+
+				if ( size < 0 ) {
+					peer.numOverflows++;
+					size = -size;
+				}
+
+				int sequence = 0;
+				int baseSequence = 0;
+				peer.serverSnaps->PeekDeltaSequence( (const char *)buffer, size, sequence, baseSequence );
+				if ( baseSequence == peer.lastBaseSequence ) {
+					peer.numBaseResends++;
+				}
+				peer.lastBaseSequence = baseSequence;
+
+				const int slot = sequence & ( idSnapshotProcessor::MAX_SNAPSHOT_QUEUE - 1 );
+				peer.sentSequence[slot] = sequence;
+				peer.sentTime[slot] = time;
+				peer.numDeltas++;
+				peer.deltaBytes += size;
+				peer.maxDeltaSize = Max( peer.maxDeltaSize, size );
+
+				idBitMsg msg;
+				msg.InitRead( buffer, size );
+				peer.serverPackets->ProcessOutgoing( time, msg, false, 0 );
+			}
+			for ( int p = 0; p < numClients; p++ ) {
+				if ( peers[p].serverSnaps->PendingSnapReadyToSend() ) {
+					sentAllSubmitted = false;
+				}
+			}
+
+			if ( sentAllSubmitted ) {
+				objDeltaCache->Reset();
+				for ( int p = 0; p < numClients; p++ ) {
+					simPeer_t & peer = peers[p];
+					if ( !peer.needToSubmitPendingSnap || !peer.serverSnaps->HasPendingSnap() ) {
+						continue;
+					}
+					if ( time - peer.lastSnapJobTime < net_snap_redundant_resend_in_ms.GetInteger() && peer.serverSnaps->IsBusyConfirmingPartialSnap() ) {
+						continue;
+					}
+					peer.lastSnapJobTime = time;
+					peer.needToSubmitPendingSnap = false;
+
+					const uint64 startMicroseconds = Sys_Microseconds();
+					peer.serverSnaps->SubmitPendingSnap( idSnapShot::VisIndexForPeer( p ), objMemory, SIM_OBJ_JOB_MEMORY, lzwData, lzData, net_snapObjDeltaCache.GetBool() ? objDeltaCache : NULL );
+					snapMicroseconds += Sys_Microseconds() - startMicroseconds;
+					numSubmits++;
+				}
+			}
+		}
+
+		for ( int p = 0; p < numClients; p++ ) {
+			simPeer_t & peer = peers[p];
+			const int sessionId = SIM_SESSION_ID + p;
+			SimSendFragment( time, peer.serverPackets, sessionId, peer.lastFragmentSendTime, peer.down );
+			SimSendFragment( time, peer.clientPackets, sessionId, peer.lastClientFragmentSendTime, peer.up );
+		}
+	}
+
+	idLib::Printf( "%d clients, %d sec, latency %d +%d ms, loss %.1f%%, reorder %.1f%%, rate %s\n", numClients, seconds, linkParms.latency, linkParms.jitter,
+		linkParms.loss * 100.0f, linkParms.reorder * 100.0f, linkParms.rate > 0 ? va( "%d kB/s", net_simRate.GetInteger() ) : "unlimited" );
+	idLib::Printf( "peer  down kB/s  up kB/s  deltas  avg size  max size  base resends  overflows  saturations  held changes  full snaps  ping  cmds lost  cmd dups  dropped\n" );
+
+	int64 totalBytes = 0;
+	int totalDeltas = 0;
+	int totalSaturations = 0;
+	int64 totalCmdBytes = 0;
+	int totalCmdPackets = 0;
+	int totalCmdsReceived = 0;
+	int totalCmdDuplicates = 0;
+	for ( int p = 0; p < numClients; p++ ) {
+		const simPeer_t & peer = peers[p];
+		idLib::Printf( "%4d  %10.1f  %7.1f  %6d  %8d  %8d  %12d  %9d  %11d  %12d  %10d  %4d  %9d  %8d  %3d/%d\n", p,
+			peer.down.GetBytesSent() / 1024.0f / seconds, peer.up.GetBytesSent() / 1024.0f / seconds,
+			peer.numDeltas, peer.numDeltas > 0 ? (int)( peer.deltaBytes / peer.numDeltas ) : 0, peer.maxDeltaSize,
+			peer.numBaseResends, peer.numOverflows, peer.numSaturations, peer.serverSnaps->GetNumHeldChanges(), peer.numFullSnaps, peer.lastPingRtt,
+			peer.numCmdsLost, peer.numCmdDuplicates,
+			peer.down.GetNumDropped() + peer.up.GetNumDropped(), peer.down.GetNumSent() + peer.up.GetNumSent() );
+		totalBytes += peer.down.GetBytesSent();
+		totalDeltas += peer.numDeltas;
+		totalSaturations += peer.numSaturations;
+		totalCmdBytes += peer.cmdPacketBytes;
+		totalCmdPackets += peer.numCmdPackets;
+		totalCmdsReceived += peer.numCmdsReceived;
+		totalCmdDuplicates += peer.numCmdDuplicates;
+	}
+	idLib::Printf( "server sent %.1f kB/s, %d snapshots, %d deltas, %d saturations, %d usec of snapshot cpu per snapshot, %d per delta\n",
+		totalBytes / 1024.0f / seconds, numSnaps, totalDeltas, totalSaturations,
+		numSnaps > 0 ? (int)( snapMicroseconds / numSnaps ) : 0, numSubmits > 0 ? (int)( snapMicroseconds / numSubmits ) : 0 );
+	idLib::Printf( "clients sent %.2f kB/s of usercmds each, %d packets of %.1f bytes avg, %d usercmds received, %d redundant copies dropped\n",
+		numClients > 0 ? totalCmdBytes / 1024.0f / seconds / numClients : 0.0f, totalCmdPackets,
+		totalCmdPackets > 0 ? (float)totalCmdBytes / totalCmdPackets : 0.0f, totalCmdsReceived, totalCmdDuplicates );
+
+	for ( int p = 0; p < numClients; p++ ) {
+		delete peers[p].serverPackets;
+		delete peers[p].serverSnaps;
+		delete peers[p].clientPackets;
+		delete peers[p].clientSnaps;
+	}
+	delete objDeltaCache;
+	Mem_Free( lzData );
+	Mem_Free( lzwData );
+	Mem_Free( objMemory );
+}
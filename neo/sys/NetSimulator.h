@@ -0,0 +1,103 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __NET_SIMULATOR_H__
+#define __NET_SIMULATOR_H__
+
+/*
+================================================
+idNetSimLink
+
+One direction of a simulated connection. Packets queue behind each other at the link rate, 
+arrive after the latency plus a random jitter, and are randomly lost or held back so later 
+packets overtake them.
+================================================
+*/
+struct netSimLinkParms_t {
+	int		latency;		// One way, in milliseconds
+	int		jitter;			// Random extra delay, in milliseconds
+	float	loss;			// Fraction of the packets that are dropped
+	float	reorder;		// Fraction of the packets that are held back by another latency
+	int		rate;			// Bytes per second, 0 for unlimited
+	int		maxQueue;		// Packets that would wait longer than this many milliseconds for the link are dropped
+};
+
+class idNetSimLink {
+public:
+					idNetSimLink();
+
+	void			Init( const netSimLinkParms_t & parms, int seed );
+
+	void			Send( int time, const byte * data, int size );
+	// Returns the size of the next packet that arrived by time, or 0 if there is none
+	int				Receive( int time, byte * data, int maxSize );
+
+	int				GetNumSent() const { return numSent; }
+	int				GetNumDropped() const { return numDropped; }
+	int64			GetBytesSent() const { return bytesSent; }
+
+private:
+	struct packet_t {
+		int			arriveTime;
+		int			size;
+		byte		data[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	};
+
+	netSimLinkParms_t			parms;
+	idRandom					random;
+	idList< packet_t, TAG_NETWORKING >	packets;		// In flight
+	int							linkFreeTime;			// Time the link is done sending the packets queued so far
+	int							lastArriveTime;			// Arrival of the last packet that wasn't reordered
+	int							numSent;
+	int							numDropped;
+	int64						bytesSent;
+};
+
+/*
+================================================
+idNetSimulator
+
+Runs a server and a number of clients in one process, without networking. The server replays 
+snapshots recorded with net_snapRecord (or a simulated deathmatch) to every client through the 
+real idSnapshotProcessor and idPacketProcessor code and simulated links, and the clients ack 
+them with batches of simulated usercmds encoded like in a game. Reports the bandwidth, delta 
+sizes, resends, snapshot CPU time and saturation events of every peer, and the usercmds the 
+server lost or dropped as redundant.
+================================================
+*/
+class idNetSimulator {
+public:
+	// Appends ss to the net_snapRecord file, called for every snapshot the server sends
+	static void		RecordSnapshot( const idSnapShot & ss );
+	// Closes the net_snapRecord file, if one is open
+	static void		Shutdown();
+
+	static void		Run_f( const class idCmdArgs & args );
+};
+
+#endif // __NET_SIMULATOR_H__
@@ -144,6 +144,7 @@ idSnapShot::idSnapShot() :
 	time( 0 ),
 	recvTime( 0 )
 {
+	memset( viewOrigins, 0, sizeof( viewOrigins ) );
 }
 
 /*
@@ -152,6 +153,7 @@ idSnapShot::idSnapShot
 ========================
 */
 idSnapShot::idSnapShot( const idSnapShot & other ) : time( 0 ), recvTime(0) {
+	memset( viewOrigins, 0, sizeof( viewOrigins ) );
 	*this = other;
 }
 
@@ -172,6 +174,7 @@ idSnapShot::Clear
 void idSnapShot::Clear() {
 	time = 0;
 	recvTime = 0;
+	memset( viewOrigins, 0, sizeof( viewOrigins ) );
 	for ( int i = 0; i < objectStates.Num(); i++ ) {
 		FreeObjectState( i );
 	}
@@ -206,24 +209,83 @@ void idSnapShot::operator=( const idSnapShot & other ) {
 			state.changedCount	= otherState.changedCount;
 			state.expectedSequence = otherState.expectedSequence;
 			state.createdFromTemplate = otherState.createdFromTemplate;
+			state.schema		= otherState.schema;
+			state.schemaOffset	= otherState.schemaOffset;
+			state.importance	= otherState.importance;
+			state.origin		= otherState.origin;
+			state.pvsMask		= otherState.pvsMask;
 		}
 		time = other.time;
 		recvTime = other.recvTime;
+		memcpy( viewOrigins, other.viewOrigins, sizeof( viewOrigins ) );
 	}
 }
 
+/*
+========================
+StartDeltaDecompression
+
+Reads the codec in front of a delta stream, and starts the matching decompressor on the rest of it.
+Returns NULL if the delta can't be decompressed.
+========================
+*/
+static idLightweightCompressor * StartDeltaDecompression( const char * deltaMem, int deltaSize, idLZWCompressor & lzwCompressor, idLZCompressor & lzCompressor, lzCompressionData_t * lzData ) {
+	if ( deltaSize <= SNAP_CODEC_BYTES ) {
+		return NULL;
+	}
+
+	idLightweightCompressor * compressor = NULL;
+	switch ( (uint8)deltaMem[0] ) {
+		case SNAP_CODEC_LZW:
+			compressor = &lzwCompressor;
+			break;
+		case SNAP_CODEC_LZ:
+			if ( !verify( lzData != NULL ) ) {
+				return NULL;
+			}
+			compressor = &lzCompressor;
+			break;
+		default:
+			return NULL;
+	}
+	compressor->Start( (uint8*)deltaMem + SNAP_CODEC_BYTES, deltaSize - SNAP_CODEC_BYTES );
+	return compressor;
+}
+
 /*
 ========================
 idSnapShot::PeekDeltaSequence
 ========================
 */
-void idSnapShot::PeekDeltaSequence( const char * deltaMem, int deltaSize, int & sequence, int & baseSequence ) {
+bool idSnapShot::PeekDeltaSequence( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, int & sequence, int & baseSequence ) {
 	lzwCompressionData_t	lzwData;
 	idLZWCompressor			lzwCompressor( &lzwData );
+	idLZCompressor			lzCompressor( lzData );
 	
-	lzwCompressor.Start( (uint8*)deltaMem, deltaSize );	
-	lzwCompressor.ReadAgnostic( sequence );
-	lzwCompressor.ReadAgnostic( baseSequence );
+	idLightweightCompressor * compressor = StartDeltaDecompression( deltaMem, deltaSize, lzwCompressor, lzCompressor, lzData );
+	if ( compressor == NULL ) {
+		return false;
+	}
+	compressor->ReadAgnostic( sequence );
+	compressor->ReadAgnostic( baseSequence );
+	return true;
+}
+
+/*
+========================
+idSnapShot::DecompressDelta
+========================
+*/
+int idSnapShot::DecompressDelta( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, uint8 * dest, int maxDestSize ) {
+	lzwCompressionData_t	lzwData;
+	idLZWCompressor			lzwCompressor( &lzwData );
+	idLZCompressor			lzCompressor( lzData );
+
+	idLightweightCompressor * compressor = StartDeltaDecompression( deltaMem, deltaSize, lzwCompressor, lzCompressor, lzData );
+	if ( compressor == NULL ) {
+		return 0;
+	}
+	return compressor->Read( dest, maxDestSize, true );
 }
 
 /*
@@ -231,7 +293,7 @@ void idSnapShot::PeekDeltaSequence( const char * deltaMem, int deltaSize, int &
 idSnapShot::ReadDeltaForJob
 ========================
 */
-bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visIndex, idSnapShot * templateStates ) {
+bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, int visIndex, idSnapShot * templateStates ) {
 
 	bool report = net_verboseSnapshotReport.GetBool();
 	net_verboseSnapshotReport.SetBool( false );
@@ -239,24 +301,30 @@ bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visI
 	lzwCompressionData_t		lzwData;
 	idZeroRunLengthCompressor	rleCompressor;
 	idLZWCompressor				lzwCompressor( &lzwData );
+	idLZCompressor				lzCompressor( lzData );
 	int bytesRead = 0; // how many uncompressed bytes we read in. Used to figure out compression ratio
 
-	lzwCompressor.Start( (uint8*)deltaMem, deltaSize );
+	idLightweightCompressor * compressor = StartDeltaDecompression( deltaMem, deltaSize, lzwCompressor, lzCompressor, lzData );
+	if ( compressor == NULL ) {
+		// the snapshot processor rejects these before they are queued
+		idLib::Warning( "Snapshot delta can't be decompressed, skipping it" );
+		return false;
+	}
 
 	// Skip past sequence and baseSequence
 	int sequence		= 0;
 	int baseSequence	= 0;
 
-	lzwCompressor.ReadAgnostic( sequence );
-	lzwCompressor.ReadAgnostic( baseSequence );
-	lzwCompressor.ReadAgnostic( time );
+	compressor->ReadAgnostic( sequence );
+	compressor->ReadAgnostic( baseSequence );
+	compressor->ReadAgnostic( time );
 	bytesRead += sizeof( int ) * 3;
 
 	int objectNum = 0;
 	uint16 delta = 0;
 	
 
-	while ( lzwCompressor.ReadAgnostic( delta, true ) == sizeof( delta ) ) {
+	while ( compressor->ReadAgnostic( delta, true ) == sizeof( delta ) ) {
 		bytesRead += sizeof( delta );
 
 		objectNum += delta;
@@ -272,7 +340,7 @@ bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visI
 		objectState_t & state = FindOrCreateObjectByID( objectNum );
 		
 		objectSize_t newsize = 0;
-		lzwCompressor.ReadAgnostic( newsize );
+		compressor->ReadAgnostic( newsize );
 		bytesRead += sizeof( newsize );
 
 		if ( newsize == SIZE_STALE ) {
@@ -298,10 +366,28 @@ bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visI
 			state.visMask |= ( 1 << visIndex );
 			state.stale = false;
 			// the latest state is packed in, get the new size and continue reading the new state
-			lzwCompressor.ReadAgnostic( newsize );
+			compressor->ReadAgnostic( newsize );
 			bytesRead += sizeof( newsize );
 		}
 
+		const idNetSchema * fieldSchema = NULL;
+		int fieldStart = 0;
+		if ( newsize == SIZE_FIELD_DELTA ) {
+			uint16 schemaId = 0;
+			uint16 schemaOffset = 0;
+			compressor->ReadAgnostic( schemaId );
+			compressor->ReadAgnostic( schemaOffset );
+			compressor->ReadAgnostic( newsize );
+			bytesRead += sizeof( schemaId ) + sizeof( schemaOffset ) + sizeof( newsize );
+
+			fieldSchema = idNetSchema::FindById( schemaId );
+			fieldStart = schemaOffset;
+			// field deltas are only sent for objects that didn't change size
+			if ( fieldSchema == NULL || state.buffer.Size() != newsize || fieldStart + fieldSchema->GetBlockSize() > newsize ) {
+				idLib::Error( "Invalid field delta for snapshot object %d (schema %d)", objectNum, schemaId );
+			}
+		}
+
 		objectState_t *	objTemplateState = templateStates->FindObjectByID( objectNum );
 
 		if ( newsize == 0 ) {
@@ -347,30 +433,46 @@ bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visI
 				state.createdFromTemplate = false;
 			}
 
-			// the buffer shrank or stayed the same
 			objectBuffer_t newbuffer( newsize );
-			rleCompressor.Start( NULL, &lzwCompressor, newsize );
-			objectSize_t compareSize = Min( state.buffer.Size(), newsize );
-			for ( objectSize_t i = 0; i < compareSize; i++ ) {
-				byte b = rleCompressor.ReadByte();
-				newbuffer[i] = state.buffer[i] + b;
-
-				if ( debug && InDebugRange( i ) ) {
-					idLib::Printf( "%02X", b );
+			if ( fieldSchema != NULL ) {
+				// byte delta up to the field block, the changed fields, and a byte delta of the rest
+				const int fieldEnd = fieldStart + fieldSchema->GetBlockSize();
+				rleCompressor.Start( NULL, compressor, newsize );
+				for ( int i = 0; i < fieldStart; i++ ) {
+					newbuffer[i] = state.buffer[i] + rleCompressor.ReadByte();
 				}
-			}
-			// Catch leftover
-			if ( newsize > compareSize ) {
-				rleCompressor.ReadBytes( newbuffer.Ptr() + compareSize, newsize - compareSize );
-
-				if ( debug ) {
-					for ( objectSize_t i = compareSize; i < newsize; i++ ) {
-						if ( InDebugRange( i ) ) {
-							idLib::Printf( "%02X", newbuffer[i] );
-						}
+				if ( !fieldSchema->ReadDelta( *compressor, state.buffer.Ptr() + fieldStart, newbuffer.Ptr() + fieldStart ) ) {
+					idLib::Error( "Truncated field delta for snapshot object %d", objectNum );
+				}
+				rleCompressor.Start( NULL, compressor, newsize );
+				for ( int i = fieldEnd; i < newsize; i++ ) {
+					newbuffer[i] = state.buffer[i] + rleCompressor.ReadByte();
+				}
+			} else {
+				// the buffer shrank or stayed the same
+				rleCompressor.Start( NULL, compressor, newsize );
+				objectSize_t compareSize = Min( state.buffer.Size(), newsize );
+				for ( objectSize_t i = 0; i < compareSize; i++ ) {
+					byte b = rleCompressor.ReadByte();
+					newbuffer[i] = state.buffer[i] + b;
+
+					if ( debug && InDebugRange( i ) ) {
+						idLib::Printf( "%02X", b );
 					}
 				}
+				// Catch leftover
+				if ( newsize > compareSize ) {
+					rleCompressor.ReadBytes( newbuffer.Ptr() + compareSize, newsize - compareSize );
+
+					if ( debug ) {
+						for ( objectSize_t i = compareSize; i < newsize; i++ ) {
+							if ( InDebugRange( i ) ) {
+								idLib::Printf( "%02X", newbuffer[i] );
+							}
+						}
+					}
 
+				}
 			}
 			state.buffer = newbuffer;
 			state.changedCount = sequence;
@@ -388,7 +490,7 @@ bool idSnapShot::ReadDeltaForJob( const char * deltaMem, int deltaSize, int visI
 		extern uint32 SnapObjChecksum( const uint8 * data, int length );
 		if ( state.buffer.Size() > 0 ) {
 			uint32 checksum = 0;
-			lzwCompressor.ReadAgnostic( checksum );
+			compressor->ReadAgnostic( checksum );
 			bytesRead += sizeof( checksum );
 			if ( !verify( checksum == SnapObjChecksum( state.buffer.Ptr(), state.buffer.Size() ) ) ) {
 				idLib::Error(" Invalid snapshot checksum" );
@@ -440,6 +542,8 @@ void idSnapShot::SubmitObjectJob(	const submitDeltaJobsInfo_t &	submitDeltaJobsI
 	// Setup obj parms
 	assert( submitDeltaJobsInfo.visIndex < 256 );
 	curObjParm->visIndex	= submitDeltaJobsInfo.visIndex;
+	curObjParm->deltaCache	= submitDeltaJobsInfo.deltaCache;
+	curObjParm->fieldDeltas	= submitDeltaJobsInfo.fieldDeltas;
 	curObjParm->destHeader	= curHeader;
 	curObjParm->dest		= curObjDest;
 
@@ -454,6 +558,8 @@ void idSnapShot::SubmitObjectJob(	const submitDeltaJobsInfo_t &	submitDeltaJobsI
 		curObjParm->newState.size		= newState->buffer.Size();
 		curObjParm->newState.objectNum	= newState->objectNum;
 		curObjParm->newState.visMask	= newState->visMask;
+		curObjParm->newState.schema		= newState->schema;
+		curObjParm->newState.schemaOffset	= newState->schemaOffset;
 	}
 	
 	if ( oldState != NULL ) {
@@ -939,6 +1045,11 @@ idSnapShot::objectState_t * idSnapShot::S_AddObject( int objectNum, uint32 visMa
 	objectSize_t size = _size;
 	objectState_t & state = FindOrCreateObjectByID( objectNum );
 	state.visMask = visMask;
+	state.schema = NULL;
+	state.schemaOffset = 0;
+	state.importance = 0.0f;
+	state.origin = vec3_origin;
+	state.pvsMask = MAX_UNSIGNED_TYPE( uint32 );
 	if ( state.buffer.Size() == size && state.buffer.NumRefs() == 1 ) {
 		// re-use the same buffer
 		memcpy( state.buffer.Ptr(), data, size );
@@ -973,6 +1084,11 @@ bool idSnapShot::CopyObject( const idSnapShot & oldss, int objectNum, bool force
 	newState.changedCount	= oldState.changedCount;
 	newState.expectedSequence = oldState.expectedSequence;
 	newState.createdFromTemplate = oldState.createdFromTemplate;
+	newState.schema			= oldState.schema;
+	newState.schemaOffset	= oldState.schemaOffset;
+	newState.importance		= oldState.importance;
+	newState.origin			= oldState.origin;
+	newState.pvsMask		= oldState.pvsMask;
 
 	if ( forceStale ) {
 		newState.visMask = 0;
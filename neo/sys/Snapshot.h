@@ -54,11 +54,20 @@ public:
 	int  GetRecvTime() const { return recvTime; }
 	void SetRecvTime( int t ) { recvTime = t; }
 
-	// Loads only sequence and baseSequence values from the compressed stream
-	static void PeekDeltaSequence( const char * deltaMem, int deltaSize, int & sequence, int & baseSequence );
+	// Server only: where the viewer with visIndex is, for the interest priority of the objects
+	const idVec3 & GetViewOrigin( int visIndex ) const { return viewOrigins[ visIndex ]; }
+	void SetViewOrigin( int visIndex, const idVec3 & origin ) { viewOrigins[ visIndex ] = origin; }
+
+	// lzData is the window to decode SNAP_CODEC_LZ deltas with, it can be NULL for any other codec.
+	// Deltas with an unknown codec, or LZ deltas without lzData, are rejected.
+
+	// Loads only sequence and baseSequence values from the compressed stream, false if the delta is rejected
+	static bool PeekDeltaSequence( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, int & sequence, int & baseSequence );
+	// Decompresses a delta back to the stream the snapshot jobs wrote, returns the number of bytes
+	static int DecompressDelta( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, uint8 * dest, int maxDestSize );
 
 	// Reads a new object state packet, which is assumed to be delta compressed against this snapshot
-	bool ReadDeltaForJob( const char * deltaMem, int deltaSize, int visIndex, idSnapShot * templateStates );
+	bool ReadDeltaForJob( const char * deltaMem, int deltaSize, lzCompressionData_t * lzData, int visIndex, idSnapShot * templateStates );
 	bool ReadDelta( idFile * file, int visIndex );
 
 	// Writes an object state packet which is delta compressed against the old snapshot
@@ -91,7 +100,12 @@ public:
 			changedCount( 0 ),
 			createdFromTemplate( false ),
 			
-			expectedSequence( 0 )
+			expectedSequence( 0 ),
+			schema( NULL ),
+			schemaOffset( 0 ),
+			importance( 0.0f ),
+			origin( vec3_origin ),
+			pvsMask( MAX_UNSIGNED_TYPE( uint32 ) )
 			{ }
 		void Print( const char * name );
 
@@ -103,8 +117,19 @@ public:
 		int				changedCount;	// Incremented each time the state changed
 		int				expectedSequence;
 		bool			createdFromTemplate;
+		const idNetSchema *	schema;		// Field block the server can send as a field delta (set after S_AddObject)
+		uint16			schemaOffset;
+		float			importance;		// Interest priority, 0 to always send changes right away (set after S_AddObject)
+		idVec3			origin;			// Position the interest distance is measured from
+		uint32			pvsMask;		// Viewers (by visIndex) whose PVS the object is in
 	};
 
+	static const int MAX_VIEWERS = 32;	// One per visMask bit
+
+	// The server sends to peer p as viewer p + 1, viewer 0 is the server itself.  View origins and pvsMask
+	// bits the game writes must be keyed the same way, since the snapshot processors only know the visIndex.
+	static int VisIndexForPeer( int peer ) { return peer + 1; }
+
 	struct submitDeltaJobsInfo_t {
 		objParms_t *		objParms;				// Start of object parms
 		int					maxObjParms;			// Max parms (which will dictate how many objects can be processed)
@@ -122,6 +147,8 @@ public:
 		idSnapShot *		templateStates;			// states for new snapObj that arent in old states
 		
 		lzwInOutData_t *	lzwInOutData;
+		idSnapObjDeltaCache * deltaCache;			// compressed object deltas shared across peers (optional)
+		bool				fieldDeltas;			// send field deltas for objects with a schema
 	};
 
 	void SubmitWriteDeltaToJobs( const submitDeltaJobsInfo_t & submitDeltaJobInfo );
@@ -149,6 +176,7 @@ public:
 	
 	// returns the object by id, or NULL if not found
 	objectState_t *	FindObjectByID( int objectNum ) const;
+	objectState_t *	GetObjectStateByIndex( int i ) const { return objectStates[i]; }
 
 	// Returns whether or not an object is stale
 	bool ObjectIsStaleByIndex( int i ) const;
@@ -174,6 +202,7 @@ private:
 
 	int													time;
 	int													recvTime;
+	idVec3												viewOrigins[ MAX_VIEWERS ];
 
 	int				BinarySearch( int objectNum ) const;
 	objectState_t &	FindOrCreateObjectByID( int objectNum );					// objIndex is optional parm for returning the index of the obj
@@ -28,9 +28,21 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 #include "../idlib/precompiled.h"
 
+#define SNAP_CAPTURE_FILE	"snapdeltas.bin"
+
 idCVar net_optimalSnapDeltaSize( "net_optimalSnapDeltaSize", "1000", CVAR_INTEGER, "Optimal size of snapshot delta msgs." );
 idCVar net_debugBaseStates( "net_debugBaseStates", "0", CVAR_BOOL, "Log out base state information" );
 idCVar net_skipClientDeltaAppend( "net_skipClientDeltaAppend", "0", CVAR_BOOL, "Simulate delta receive buffer overflowing" );
+idCVar net_snapCodec( "net_snapCodec", "0", CVAR_INTEGER, "Compression of the snapshot deltas we send: 0 = lzw, 1 = lz. Clients read either.", 0, SNAP_CODEC_MAX - 1 );
+idCVar net_snapFieldDeltas( "net_snapFieldDeltas", "1", CVAR_BOOL, "Send only the changed fields of objects that describe their state with an idNetSchema. Clients read either." );
+idCVar net_snapInterest( "net_snapInterest", "1", CVAR_BOOL, "When the changes of a snapshot don't fit in a peer's net_maxRate budget, hold back the changes of the objects with the lowest accumulated priority for the peer" );
+idCVar net_snapInterestFalloff( "net_snapInterestFalloff", "1024", CVAR_FLOAT, "Distance from a peer's view at which the interest priority of an object halves" );
+idCVar net_snapInterestOutsidePVS( "net_snapInterestOutsidePVS", "0.25", CVAR_FLOAT, "Interest priority scale of objects outside the PVS of a peer" );
+idCVar net_snapCapture( "net_snapCapture", "0", CVAR_BOOL, "Write the uncompressed snapshot delta streams we send to " SNAP_CAPTURE_FILE " for testSnapshotCodecs" );
+
+static const char * snapCodecNames[SNAP_CODEC_MAX] = { "lzw", "lz" };
+
+static idFile * snapCaptureFile = NULL;
 
 /*
 ========================
@@ -42,6 +54,7 @@ idSnapshotProcessor::idSnapshotProcessor() {
 	//assert( mem.IsGlobalHeap() );
 
 	jobMemory = (jobMemory_t*)Mem_Alloc( sizeof( jobMemory_t) , TAG_NETWORKING );
+	lzReadData = NULL;
 
 	assert_16_byte_aligned( jobMemory );
 	assert_16_byte_aligned( jobMemory->objParms.Ptr() );
@@ -59,6 +72,7 @@ idSnapshotProcessor::idSnapshotProcessor
 idSnapshotProcessor::~idSnapshotProcessor() {
 	//mem.PushHeap();
 	Mem_Free( jobMemory );
+	Mem_Free( lzReadData );
 	//mem.PopHeap();
 }
 
@@ -80,8 +94,12 @@ void idSnapshotProcessor::Reset( bool cstor ) {
 	baseState.Clear();
 	submittedState.Clear();
 	pendingSnap.Clear();
+	heldSnap.Clear();
 	deltas.Clear();
 
+	priorityAccumulators.Clear();
+	numHeldChanges = 0;
+
 	partialBaseSequence = -1;
 
 	memset( &jobMemory->lzwInOutData, 0, sizeof( jobMemory->lzwInOutData ) );
@@ -92,23 +110,135 @@ void idSnapshotProcessor::Reset( bool cstor ) {
 idSnapshotProcessor::TrySetPendingSnapshot
 ========================
 */
-bool idSnapshotProcessor::TrySetPendingSnapshot( idSnapShot & ss ) {
+bool idSnapshotProcessor::TrySetPendingSnapshot( idSnapShot & ss, int visIndex, int budgetBytes ) {
 	// Don't advance to the next snap until the last one was fully sent
 	if ( hasPendingSnap ) {
 		return false;
 	}
-	pendingSnap = ss;
+	if ( visIndex >= 0 && visIndex < idSnapShot::MAX_VIEWERS && budgetBytes > 0 && net_snapInterest.GetBool() ) {
+		heldSnap = pendingSnap;
+		pendingSnap = ss;
+		ApplyInterest( visIndex, budgetBytes );
+	} else {
+		pendingSnap = ss;
+	}
 	hasPendingSnap = true;
 	return true;
 }
 
+/*
+================================================
+interestObject_t
+================================================
+*/
+struct interestObject_t {
+	int		objectNum;
+	int		bytes;
+	float	priority;
+};
+
+class idSort_InterestObjects : public idSort_Quick< interestObject_t, idSort_InterestObjects > {
+public:
+	int Compare( const interestObject_t & a, const interestObject_t & b ) const { return ( a.priority < b.priority ) ? 1 : ( ( a.priority > b.priority ) ? -1 : 0 ); }
+};
+
+static const int INTEREST_OBJECT_OVERHEAD	= 4;	// object number and size in the delta stream
+static const int INTEREST_CHANGE_BYTES		= 16;	// changed bytes that double the priority of an object
+
+/*
+========================
+idSnapshotProcessor::PriorityAccumulator
+========================
+*/
+float & idSnapshotProcessor::PriorityAccumulator( int objectNum ) {
+	if ( objectNum >= priorityAccumulators.Num() ) {
+		const int oldNum = priorityAccumulators.Num();
+		priorityAccumulators.SetNum( objectNum + 1 );
+		for ( int i = oldNum; i < priorityAccumulators.Num(); i++ ) {
+			priorityAccumulators[i] = 0.0f;
+		}
+	}
+	return priorityAccumulators[ objectNum ];
+}
+
+/*
+========================
+idSnapshotProcessor::ApplyInterest
+
+Every changed object with an importance accumulates priority for this peer, more when it is 
+close to the peer's view, in the peer's PVS, and changed a lot. When the changes since the 
+last pending snap don't fit in budgetBytes, the objects with the lowest accumulated priority 
+keep their state from the last pending snap, so they are sent at a reduced rate. Sending an 
+object resets its priority.
+========================
+*/
+void idSnapshotProcessor::ApplyInterest( int visIndex, int budgetBytes ) {
+	const uint32 visBit = (uint32)BIT( visIndex );
+	const idVec3 & viewOrigin = pendingSnap.GetViewOrigin( visIndex );
+	const float falloff = Max( net_snapInterestFalloff.GetFloat(), 1.0f );
+	const float outsidePVS = net_snapInterestOutsidePVS.GetFloat();
+
+	idList< interestObject_t, TAG_NETWORKING > candidates;
+	int forcedBytes = 0;
+
+	for ( int i = 0; i < pendingSnap.NumObjects(); i++ ) {
+		const idSnapShot::objectState_t & state = *pendingSnap.GetObjectStateByIndex( i );
+		if ( ( state.visMask & visBit ) == 0 ) {
+			continue;		// stale for this peer, nothing is sent
+		}
+
+		const int bytes = pendingSnap.CompareObject( &heldSnap, state.objectNum );
+		if ( bytes == 0 ) {
+			PriorityAccumulator( state.objectNum ) = 0.0f;
+			continue;
+		}
+
+		// new objects and objects that come back into view can't keep an old state
+		const idSnapShot::objectState_t * heldState = heldSnap.FindObjectByID( state.objectNum );
+		if ( state.importance <= 0.0f || heldState == NULL || ( heldState->visMask & visBit ) == 0 ) {
+			PriorityAccumulator( state.objectNum ) = 0.0f;
+			forcedBytes += bytes + INTEREST_OBJECT_OVERHEAD;
+			continue;
+		}
+
+		float priority = state.importance * falloff / ( falloff + ( state.origin - viewOrigin ).Length() );
+		if ( ( state.pvsMask & visBit ) == 0 ) {
+			priority *= outsidePVS;
+		}
+		priority *= 1.0f + (float)bytes / INTEREST_CHANGE_BYTES;
+
+		float & accumulator = PriorityAccumulator( state.objectNum );
+		accumulator += priority;
+
+		interestObject_t & candidate = candidates.Alloc();
+		candidate.objectNum	= state.objectNum;
+		candidate.bytes		= bytes;
+		candidate.priority	= accumulator;
+	}
+
+	candidates.SortWithTemplate( idSort_InterestObjects() );
+
+	// the top object always goes out, so everything is sent eventually even when the forced changes fill the budget
+	int budgetLeft = budgetBytes - forcedBytes;
+	for ( int i = 0; i < candidates.Num(); i++ ) {
+		const int cost = candidates[i].bytes + INTEREST_OBJECT_OVERHEAD;
+		if ( cost <= budgetLeft || i == 0 ) {
+			budgetLeft -= cost;
+			PriorityAccumulator( candidates[i].objectNum ) = 0.0f;
+		} else {
+			pendingSnap.CopyObject( heldSnap, candidates[i].objectNum );
+			numHeldChanges++;
+		}
+	}
+}
+
 /*
 ========================
 idSnapshotProcessor::PeekDeltaSequence
 ========================
 */
-void idSnapshotProcessor::PeekDeltaSequence( const char * deltaMem, int deltaSize, int & deltaSequence, int & deltaBaseSequence ) {
-	idSnapShot::PeekDeltaSequence( deltaMem, deltaSize, deltaSequence, deltaBaseSequence );
+bool idSnapshotProcessor::PeekDeltaSequence( const char * deltaMem, int deltaSize, int & deltaSequence, int & deltaBaseSequence ) {
+	return idSnapShot::PeekDeltaSequence( deltaMem, deltaSize, GetLZReadData( deltaMem ), deltaSequence, deltaBaseSequence );
 }
 
 /*
@@ -117,7 +247,21 @@ idSnapshotProcessor::ApplyDeltaToSnapshot
 ========================
 */
 bool idSnapshotProcessor::ApplyDeltaToSnapshot( idSnapShot & snap, const char * deltaMem, int deltaSize, int visIndex ) {
-	return snap.ReadDeltaForJob( deltaMem, deltaSize, visIndex, &templateStates );
+	return snap.ReadDeltaForJob( deltaMem, deltaSize, GetLZReadData( deltaMem ), visIndex, &templateStates );
+}
+
+/*
+========================
+idSnapshotProcessor::GetLZReadData
+
+Most peers only ever see LZW deltas, so the LZ window isn't allocated until an LZ delta has to be read.
+========================
+*/
+lzCompressionData_t * idSnapshotProcessor::GetLZReadData( const char * deltaMem ) {
+	if ( lzReadData == NULL && (uint8)deltaMem[0] == SNAP_CODEC_LZ ) {
+		lzReadData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	}
+	return lzReadData;
 }
 
 #ifdef STRESS_LZW_MEM
@@ -131,10 +275,11 @@ static int g_maxlwMem = 100;
 idSnapshotProcessor::SubmitPendingSnap
 ========================
 */
-void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8 * objMemory, int objMemorySize, lzwCompressionData_t * lzwData ) {
+void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8 * objMemory, int objMemorySize, lzwCompressionData_t * lzwData, lzCompressionData_t * lzData, idSnapObjDeltaCache * deltaCache ) {
 
 	assert_16_byte_aligned( objMemory );
 	assert_16_byte_aligned( lzwData );
+	assert_16_byte_aligned( lzData );
 
 	assert( hasPendingSnap );
 	assert( jobMemory->lzwInOutData.numlzwDeltas == 0 );
@@ -157,7 +302,9 @@ void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8 * objMemory, in
 	jobMemory->lzwInOutData.optimalLength	= net_optimalSnapDeltaSize.GetInteger();
 	jobMemory->lzwInOutData.snapSequence	= snapSequence;
 	jobMemory->lzwInOutData.lastObjId		= 0;
+	jobMemory->lzwInOutData.codec			= ( lzData != NULL ) ? idMath::ClampInt( 0, SNAP_CODEC_MAX - 1, net_snapCodec.GetInteger() ) : SNAP_CODEC_LZW;
 	jobMemory->lzwInOutData.lzwData			= lzwData;
+	jobMemory->lzwInOutData.lzData			= lzData;
 
 	idSnapShot::submitDeltaJobsInfo_t submitInfo;
 
@@ -183,10 +330,46 @@ void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8 * objMemory, in
 	submitInfo.baseSequence		= baseSequence;
 		
 	submitInfo.lzwInOutData		= &jobMemory->lzwInOutData;
+	submitInfo.deltaCache		= deltaCache;
+	submitInfo.fieldDeltas		= net_snapFieldDeltas.GetBool();
 
 	pendingSnap.SubmitWriteDeltaToJobs( submitInfo );
 }
 
+/*
+========================
+WriteCapturedDelta
+
+A captured delta is its uncompressed length followed by the uncompressed stream.
+========================
+*/
+static void WriteCapturedDelta( idFile * file, const uint8 * deltaData, int size, lzCompressionData_t * lzData ) {
+	static uint8 stream[ idLZWCompressor::LZW_BLOCK_SIZE ];
+
+	const int streamSize = idSnapShot::DecompressDelta( (const char *)deltaData, size, lzData, stream, sizeof( stream ) );
+	if ( streamSize > 0 ) {
+		file->WriteBig( streamSize );
+		file->Write( stream, streamSize );
+	}
+}
+
+/*
+========================
+CaptureSnapshotDelta
+========================
+*/
+static void CaptureSnapshotDelta( const uint8 * deltaData, int size, lzCompressionData_t * lzData ) {
+	if ( snapCaptureFile == NULL ) {
+		snapCaptureFile = fileSystem->OpenFileWrite( SNAP_CAPTURE_FILE, "fs_savepath" );
+		if ( snapCaptureFile == NULL ) {
+			idLib::Warning( "Couldn't open %s, stopped capturing snapshots", SNAP_CAPTURE_FILE );
+			net_snapCapture.SetBool( false );
+			return;
+		}
+	}
+	WriteCapturedDelta( snapCaptureFile, deltaData, size, lzData );
+}
+
 /*
 ========================
 idSnapshotProcessor::GetPendingSnapDelta
@@ -232,6 +415,13 @@ int idSnapshotProcessor::GetPendingSnapDelta( byte * outBuffer, int maxLength )
 		idLib::Error( "GetPendingSnapDelta: Size overflow." );
 	}
 
+	if ( net_snapCapture.GetBool() ) {
+		CaptureSnapshotDelta( deltaData, size, GetLZReadData( (const char *)deltaData ) );
+	} else if ( snapCaptureFile != NULL ) {
+		fileSystem->CloseFile( snapCaptureFile );
+		snapCaptureFile = NULL;
+	}
+
 	// Copy to out buffer
 	memcpy( outBuffer, deltaData, size );
 	
@@ -303,7 +493,10 @@ bool idSnapshotProcessor::ReceiveSnapshotDelta( const byte * deltaData, int delt
 	int deltaBaseSequence	= 0;
 
 	// Get the sequence of this delta, and the base sequence it is delta'd from
-	PeekDeltaSequence( (const char *)deltaData, deltaLength, deltaSequence, deltaBaseSequence );
+	if ( !PeekDeltaSequence( (const char *)deltaData, deltaLength, deltaSequence, deltaBaseSequence ) ) {
+		idLib::Printf( "NET: ReceiveSnapshotDelta: Rejecting delta with unknown codec %d\n", deltaLength > 0 ? deltaData[0] : -1 );
+		return false;		// Never queue a delta we can't apply
+	}
 
 	//idLib::Printf("Incoming snapshot: %i, %i\n", deltaSequence, deltaBaseSequence );
 	
@@ -473,7 +666,7 @@ void idSnapshotProcessor::RemoveDeltasForOldBaseSequence() {
 	for ( int i = deltas.Num() - 1; i >= 0; i-- ) {
 		int deltaSequence		= 0;
 		int deltaBaseSequence	= 0;
-		baseState.PeekDeltaSequence( (const char *)deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
+		PeekDeltaSequence( (const char *)deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
 		if ( deltaBaseSequence < baseSequence ) {
 			// Remove this delta, and all deltas before this one 
 			deltas.RemoveOlderThan( deltas.ItemSequence( i ) + 1 );
@@ -495,7 +688,7 @@ void idSnapshotProcessor::SanityCheckDeltas() {
 	int lastDeltaBaseSequence	= -1;
 	
 	for ( int i = 0; i < deltas.Num(); i++ ) {
-		baseState.PeekDeltaSequence( (const char *)deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
+		PeekDeltaSequence( (const char *)deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
 		assert( deltaSequence == deltas.ItemSequence( i ) );	// Make sure delta stored in compressed form matches the one stored in the data queue
 		assert( deltaSequence > lastDeltaSequence );			// Make sure they are in order (we reject out of order sequences in ApplysnapshotDelta)
 		assert( deltaBaseSequence >= lastDeltaBaseSequence );	// Make sure they are in order (they can be the same, since base sequences don't change until they've been ack'd)
@@ -522,3 +715,483 @@ void idSnapshotProcessor::AddSnapObjTemplate( int objID, idBitMsg & msg ) {
 		state->expectedSequence = snapSequence;
 	}
 }
+
+/*
+========================
+idSnapshotProcessor::Test_f
+
+Sends a changing snapshot from a simulated server to a number of peers over a loopback
+stand-in and measures the snapshot job time with and without sharing the object deltas.
+Peers ack with different latencies, so they delta against different base states.
+========================
+*/
+void idSnapshotProcessor::Test_f( const idCmdArgs & args ) {
+	const int numPeers		= idMath::ClampInt( 1, 32, ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 16 );
+	const int numFrames		= idMath::ClampInt( 1, 100000, ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 300 );
+	const int numObjects	= idMath::ClampInt( 1, 1024, ( args.Argc() > 3 ) ? atoi( args.Argv( 3 ) ) : 128 );
+	const int objMemorySize	= 128 * 1024;
+	const int maxObjectSize	= 96;
+
+	uint8 * objMemory = (uint8 *)Mem_Alloc( objMemorySize, TAG_NETWORKING );
+	lzwCompressionData_t * lzwData = (lzwCompressionData_t *)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+	lzCompressionData_t * lzData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	idSnapObjDeltaCache * deltaCache = new (TAG_NETWORKING) idSnapObjDeltaCache();
+	byte buffer[ MAX_SNAP_SIZE ];
+	byte objectData[ maxObjectSize ];
+
+	int64 passBytes[2] = { 0, 0 };
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		const bool shareDeltas = ( pass == 1 );
+
+		idList< idSnapshotProcessor * > servers;
+		idList< idSnapshotProcessor * > clients;
+		for ( int p = 0; p < numPeers; p++ ) {
+			servers.Append( new (TAG_NETWORKING) idSnapshotProcessor() );
+			clients.Append( new (TAG_NETWORKING) idSnapshotProcessor() );
+		}
+
+		idRandom random( 0x5eed );
+		idSnapShot ss;
+		const int startHits = deltaCache->GetNumHits();
+		const int startMisses = deltaCache->GetNumMisses();
+		uint64 jobMicroseconds = 0;
+		int numSubmits = 0;
+		int numReceived = 0;
+
+		for ( int frame = 0; frame < numFrames; frame++ ) {
+			ss.SetTime( frame * 16 );
+
+			// move roughly a tenth of the objects every frame
+			for ( int i = 0; i < numObjects; i++ ) {
+				if ( frame > 0 && random.RandomInt( 10 ) != 0 ) {
+					continue;
+				}
+				const int size = 16 + ( i * 7 ) % ( maxObjectSize - 16 );
+				memset( objectData, 0, size );
+				for ( int b = 0; b < size; b += 4 ) {
+					objectData[b] = (byte)( i + b );
+				}
+				objectData[0] = (byte)frame;
+				objectData[size / 2] = (byte)random.RandomInt( 256 );
+				ss.S_AddObject( i, MAX_UNSIGNED_TYPE( uint32 ), objectData, size );
+			}
+
+			deltaCache->Reset();
+
+			const uint64 startMicroseconds = Sys_Microseconds();
+			for ( int p = 0; p < numPeers; p++ ) {
+				servers[p]->TrySetPendingSnapshot( ss );
+				if ( servers[p]->HasPendingSnap() ) {
+					servers[p]->SubmitPendingSnap( p + 1, objMemory, objMemorySize, lzwData, lzData, shareDeltas ? deltaCache : NULL );
+					numSubmits++;
+				}
+			}
+			jobMicroseconds += Sys_Microseconds() - startMicroseconds;
+
+			// loopback: deliver every delta and ack it after a per peer latency
+			for ( int p = 0; p < numPeers; p++ ) {
+				if ( !servers[p]->PendingSnapReadyToSend() ) {
+					continue;
+				}
+				int size = servers[p]->GetPendingSnapDelta( buffer, sizeof( buffer ) );
+				if ( size < 0 ) {
+					size = -size;
+				}
+				passBytes[pass] += size;
+
+				int sequence = 0;
+				int baseSequence = 0;
+				bool fullSnap = false;
+				idSnapShot received;
+				if ( size > 0 && clients[p]->ReceiveSnapshotDelta( buffer, size, p + 1, sequence, baseSequence, received, fullSnap ) ) {
+					numReceived++;
+					if ( frame % ( 1 + p % 4 ) == 0 ) {
+						servers[p]->ApplySnapshotDelta( p + 1, sequence );
+					}
+				}
+			}
+		}
+
+		const int hits = deltaCache->GetNumHits() - startHits;
+		const int misses = deltaCache->GetNumMisses() - startMisses;
+		idLib::Printf( "%s: %d peers, %d frames, %d objects: %.2f msec in snap jobs (%.1f usec per peer snap), %d kB sent, %d deltas received\n",
+			shareDeltas ? "shared deltas" : "per peer deltas", numPeers, numFrames, numObjects,
+			jobMicroseconds * 0.001f, numSubmits > 0 ? (float)jobMicroseconds / numSubmits : 0.0f, (int)( passBytes[pass] >> 10 ), numReceived );
+		if ( shareDeltas ) {
+			idLib::Printf( "object delta cache: %d hits, %d misses (%.1f%% shared)\n", hits, misses, ( hits + misses ) > 0 ? hits * 100.0f / ( hits + misses ) : 0.0f );
+		}
+
+		servers.DeleteContents( true );
+		clients.DeleteContents( true );
+	}
+
+	if ( passBytes[0] != passBytes[1] ) {
+		idLib::Warning( "shared object deltas changed the snapshot stream: %lld vs %lld bytes", passBytes[0], passBytes[1] );
+	}
+
+	delete deltaCache;
+	Mem_Free( lzData );
+	Mem_Free( lzwData );
+	Mem_Free( objMemory );
+}
+
+// Laid out like the game's player physics schema, for testSnapshotFields
+static const int TEST_VELOCITY_EXPONENT_BITS	= 5;
+static const int TEST_VELOCITY_MANTISSA_BITS	= 10;
+
+static const netField_t testPlayerFields[] = {
+	idNetSchema::Float( "origin.x" ),
+	idNetSchema::Float( "origin.y" ),
+	idNetSchema::Float( "origin.z" ),
+	idNetSchema::FloatBits( "velocity.x", TEST_VELOCITY_EXPONENT_BITS, TEST_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "velocity.y", TEST_VELOCITY_EXPONENT_BITS, TEST_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::FloatBits( "velocity.z", TEST_VELOCITY_EXPONENT_BITS, TEST_VELOCITY_MANTISSA_BITS ),
+	idNetSchema::Float( "localOrigin.x" ),
+	idNetSchema::Float( "localOrigin.y" ),
+	idNetSchema::Float( "localOrigin.z" )
+};
+static idNetSchema testPlayerSchema( "testSnapshotPlayer", testPlayerFields, sizeof( testPlayerFields ) / sizeof( testPlayerFields[0] ) );
+
+/*
+========================
+WriteTestPlayer
+
+Writes the state of a player running in circles: an entity header, the physics field block and the view angles.
+========================
+*/
+static int WriteTestPlayer( int playerNum, int time, byte * data, int maxSize, int & schemaOffset, idVec3 & origin ) {
+	const float radius	= 512.0f;
+	const float speed	= 320.0f;
+	const float angle	= time * 0.001f * speed / radius + playerNum;
+	origin.Set( 1024.0f * playerNum + radius * idMath::Cos( angle ), radius * idMath::Sin( angle ), 64.0f );
+	const idVec3 velocity( -speed * idMath::Sin( angle ), speed * idMath::Cos( angle ), 0.0f );
+	const idCQuat viewQuat = idAngles( 0.0f, RAD2DEG( angle ) + 90.0f, 0.0f ).ToQuat().ToCQuat();
+
+	idBitMsg msg;
+	msg.InitWrite( data, maxSize );
+	msg.WriteLong( playerNum );			// spawn id, type and predicted key
+	msg.WriteLong( 1 );
+	msg.WriteLong( 0 );
+
+	schemaOffset = ( msg.GetNumBitsWritten() + 7 ) >> 3;
+	{
+		idNetFieldWriter fields( testPlayerSchema, msg );
+		for ( int i = 0; i < 3; i++ ) {
+			fields.WriteFloat( origin[i] );
+		}
+		for ( int i = 0; i < 3; i++ ) {
+			fields.WriteFloat( velocity[i] );
+		}
+		for ( int i = 0; i < 3; i++ ) {
+			fields.WriteDeltaFloat( origin[i], origin[i] );	// localOrigin, no master
+		}
+	}
+
+	msg.WriteFloat( viewQuat.x );
+	msg.WriteFloat( viewQuat.y );
+	msg.WriteFloat( viewQuat.z );
+	msg.WriteLong( 100 );				// health, weapon, ...
+	msg.WriteLong( 0 );
+	return msg.GetSize();
+}
+
+/*
+========================
+idSnapshotProcessor::WriteTestPlayers
+========================
+*/
+void idSnapshotProcessor::WriteTestPlayers( idSnapShot & ss, int numPlayers, int time ) {
+	byte objectData[ 128 ];
+
+	ss.SetTime( time );
+	for ( int i = 0; i < numPlayers; i++ ) {
+		int schemaOffset = 0;
+		idVec3 origin;
+		const int size = WriteTestPlayer( i, time, objectData, sizeof( objectData ), schemaOffset, origin );
+		idSnapShot::objectState_t * state = ss.S_AddObject( i, MAX_UNSIGNED_TYPE( uint32 ), objectData, size );
+		state->schema = &testPlayerSchema;
+		state->schemaOffset = schemaOffset;
+		state->importance = 1.0f;
+		state->origin = origin;
+
+		// player i plays on peer i, keyed the way the lobby and netSimulate send to it
+		const int visIndex = idSnapShot::VisIndexForPeer( i );
+		if ( visIndex < idSnapShot::MAX_VIEWERS ) {
+			ss.SetViewOrigin( visIndex, origin );
+		}
+	}
+}
+
+/*
+========================
+idSnapshotProcessor::TestFields_f
+
+Sends the players of a simulated deathmatch to every player, with and without field deltas,
+checks the clients end up with the same states and reports the bytes per player per second.
+========================
+*/
+void idSnapshotProcessor::TestFields_f( const idCmdArgs & args ) {
+	const int numPlayers	= idMath::ClampInt( 1, 32, ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 16 );
+	const int numFrames		= idMath::ClampInt( 1, 100000, ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 600 );
+	const int frameMsec		= 16;
+	const int objMemorySize	= 128 * 1024;
+
+	uint8 * objMemory = (uint8 *)Mem_Alloc( objMemorySize, TAG_NETWORKING );
+	lzwCompressionData_t * lzwData = (lzwCompressionData_t *)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+	lzCompressionData_t * lzData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	byte buffer[ MAX_SNAP_SIZE ];
+
+	const bool oldFieldDeltas = net_snapFieldDeltas.GetBool();
+	const float seconds = numFrames * frameMsec * 0.001f;
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		net_snapFieldDeltas.SetBool( pass == 1 );
+
+		idList< idSnapshotProcessor * > servers;
+		idList< idSnapshotProcessor * > clients;
+		for ( int p = 0; p < numPlayers; p++ ) {
+			servers.Append( new (TAG_NETWORKING) idSnapshotProcessor() );
+			clients.Append( new (TAG_NETWORKING) idSnapshotProcessor() );
+		}
+
+		idSnapShot ss;
+		int64 bytes = 0;
+		int numChecked = 0;
+		int numMismatches = 0;
+
+		for ( int frame = 0; frame < numFrames; frame++ ) {
+			WriteTestPlayers( ss, numPlayers, frame * frameMsec );
+
+			for ( int p = 0; p < numPlayers; p++ ) {
+				servers[p]->TrySetPendingSnapshot( ss );
+				if ( servers[p]->HasPendingSnap() ) {
+					servers[p]->SubmitPendingSnap( idSnapShot::VisIndexForPeer( p ), objMemory, objMemorySize, lzwData, lzData );
+				}
+			}
+
+			for ( int p = 0; p < numPlayers; p++ ) {
+				if ( !servers[p]->PendingSnapReadyToSend() ) {
+					continue;
+				}
+				int size = servers[p]->GetPendingSnapDelta( buffer, sizeof( buffer ) );
+				if ( size < 0 ) {
+					size = -size;
+				}
+				bytes += size;
+
+				int sequence = 0;
+				int baseSequence = 0;
+				bool fullSnap = false;
+				idSnapShot received;
+				if ( size == 0 || !clients[p]->ReceiveSnapshotDelta( buffer, size, idSnapShot::VisIndexForPeer( p ), sequence, baseSequence, received, fullSnap ) ) {
+					continue;
+				}
+				servers[p]->ApplySnapshotDelta( idSnapShot::VisIndexForPeer( p ), sequence );
+
+				if ( !fullSnap || received.GetTime() != ss.GetTime() ) {
+					continue;
+				}
+				for ( int i = 0; i < numPlayers; i++ ) {
+					idBitMsg sent;
+					idBitMsg got;
+					numChecked++;
+					if ( !ss.GetObjectMsgByID( i, sent ) || !received.GetObjectMsgByID( i, got ) || sent.GetSize() != got.GetSize() || memcmp( sent.GetReadData(), got.GetReadData(), sent.GetSize() ) != 0 ) {
+						numMismatches++;
+					}
+				}
+			}
+		}
+
+		idLib::Printf( "%s: %d players, %.1f sec: %d bytes per player per second, %d of %d received states differ\n",
+			( pass == 1 ) ? "field deltas" : "byte deltas", numPlayers, seconds, (int)( bytes / numPlayers / seconds ), numMismatches, numChecked );
+
+		servers.DeleteContents( true );
+		clients.DeleteContents( true );
+	}
+
+	net_snapFieldDeltas.SetBool( oldFieldDeltas );
+
+	Mem_Free( lzData );
+	Mem_Free( lzwData );
+	Mem_Free( objMemory );
+}
+
+/*
+========================
+CaptureSimulatedDeltas
+
+Captures the deltas a simulated server sends one client, for when there is no net_snapCapture file.
+========================
+*/
+static void CaptureSimulatedDeltas( idFile * file, int numFrames, int numObjects ) {
+	const int objMemorySize	= 128 * 1024;
+	const int maxObjectSize	= 96;
+
+	uint8 * objMemory = (uint8 *)Mem_Alloc( objMemorySize, TAG_NETWORKING );
+	lzwCompressionData_t * lzwData = (lzwCompressionData_t *)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+	lzCompressionData_t * lzData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	idSnapshotProcessor * server = new (TAG_NETWORKING) idSnapshotProcessor();
+	idSnapshotProcessor * client = new (TAG_NETWORKING) idSnapshotProcessor();
+	byte buffer[ idPacketProcessor::MAX_MSG_SIZE ];
+	byte objectData[ maxObjectSize ];
+
+	idRandom random( 0x5eed );
+	idSnapShot ss;
+
+	for ( int frame = 0; frame < numFrames; frame++ ) {
+		ss.SetTime( frame * 16 );
+
+		// move roughly a tenth of the objects every frame
+		for ( int i = 0; i < numObjects; i++ ) {
+			if ( frame > 0 && random.RandomInt( 10 ) != 0 ) {
+				continue;
+			}
+			const int size = 16 + ( i * 7 ) % ( maxObjectSize - 16 );
+			memset( objectData, 0, size );
+			for ( int b = 0; b < size; b += 4 ) {
+				objectData[b] = (byte)( i + b );
+			}
+			objectData[0] = (byte)frame;
+			objectData[size / 2] = (byte)random.RandomInt( 256 );
+			ss.S_AddObject( i, MAX_UNSIGNED_TYPE( uint32 ), objectData, size );
+		}
+
+		server->TrySetPendingSnapshot( ss );
+		if ( !server->HasPendingSnap() ) {
+			continue;
+		}
+		server->SubmitPendingSnap( 1, objMemory, objMemorySize, lzwData, lzData );
+		if ( !server->PendingSnapReadyToSend() ) {
+			continue;
+		}
+
+		int size = server->GetPendingSnapDelta( buffer, sizeof( buffer ) );
+		if ( size < 0 ) {
+			size = -size;
+		}
+		if ( size == 0 ) {
+			continue;
+		}
+		WriteCapturedDelta( file, buffer, size );
+
+		int sequence = 0;
+		int baseSequence = 0;
+		bool fullSnap = false;
+		idSnapShot received;
+		if ( client->ReceiveSnapshotDelta( buffer, size, 1, sequence, baseSequence, received, fullSnap ) ) {
+			server->ApplySnapshotDelta( 1, sequence );
+		}
+	}
+
+	delete client;
+	delete server;
+	Mem_Free( lzData );
+	Mem_Free( lzwData );
+	Mem_Free( objMemory );
+}
+
+/*
+========================
+idSnapshotProcessor::TestCodecs_f
+
+Replays the delta streams captured with net_snapCapture through every snapshot codec,
+checks they decompress to the same bytes, and reports the ratio and speed of each codec.
+========================
+*/
+void idSnapshotProcessor::TestCodecs_f( const idCmdArgs & args ) {
+	const char * fileName	= ( args.Argc() > 1 ) ? args.Argv( 1 ) : SNAP_CAPTURE_FILE;
+	const int numRepeats	= idMath::ClampInt( 1, 1000, ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 10 );
+
+	idFile_Memory captured( fileName );
+
+	void * fileData = NULL;
+	const int fileLength = fileSystem->ReadFile( fileName, &fileData );
+	if ( fileData != NULL ) {
+		captured.Write( fileData, fileLength );
+		fileSystem->FreeFile( fileData );
+	} else {
+		idLib::Printf( "%s not found, using the deltas of a simulated game instead\n", fileName );
+		CaptureSimulatedDeltas( &captured, 600, 128 );
+	}
+	captured.MakeReadOnly();
+
+	idList< const uint8 * > streams;
+	idList< int > streamSizes;
+	int64 streamBytes = 0;
+	while ( captured.Tell() < captured.Length() ) {
+		int size = 0;
+		captured.ReadBig( size );
+		if ( size <= 0 || size > idLZWCompressor::LZW_BLOCK_SIZE || captured.Tell() + size > captured.Length() ) {
+			idLib::Warning( "%s is corrupt after %d deltas", fileName, streams.Num() );
+			break;
+		}
+		streams.Append( (const uint8 *)captured.GetDataPtr() + captured.Tell() );
+		streamSizes.Append( size );
+		streamBytes += size;
+		captured.Seek( size, FS_SEEK_CUR );
+	}
+
+	if ( streams.Num() == 0 ) {
+		idLib::Printf( "No snapshot deltas to test.\n" );
+		return;
+	}
+
+	idLib::Printf( "%d deltas, %d kB uncompressed, %d passes\n", streams.Num(), (int)( streamBytes >> 10 ), numRepeats );
+
+	lzwCompressionData_t * lzwData = (lzwCompressionData_t *)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+	lzCompressionData_t * lzData = (lzCompressionData_t *)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+	idLightweightCompressor * compressors[SNAP_CODEC_MAX];
+	compressors[SNAP_CODEC_LZW]	= new (TAG_NETWORKING) idLZWCompressor( lzwData );
+	compressors[SNAP_CODEC_LZ]	= new (TAG_NETWORKING) idLZCompressor( lzData );
+
+	static uint8 compressed[ idLZWCompressor::LZW_BLOCK_SIZE * 2 ];
+	static uint8 decompressed[ idLZWCompressor::LZW_BLOCK_SIZE ];
+
+	for ( int codec = 0; codec < SNAP_CODEC_MAX; codec++ ) {
+		idLightweightCompressor * compressor = compressors[codec];
+		int64 compressedBytes = 0;
+		uint64 encodeMicroseconds = 0;
+		uint64 decodeMicroseconds = 0;
+		int numFailed = 0;
+
+		for ( int pass = 0; pass < numRepeats; pass++ ) {
+			for ( int i = 0; i < streams.Num(); i++ ) {
+				const uint64 encodeStart = Sys_Microseconds();
+				compressor->Start( compressed, sizeof( compressed ) );
+				compressor->Write( streams[i], streamSizes[i] );
+				const int compressedSize = compressor->End();
+				const uint64 decodeStart = Sys_Microseconds();
+				encodeMicroseconds += decodeStart - encodeStart;
+
+				if ( compressedSize <= 0 ) {
+					numFailed++;
+					continue;
+				}
+
+				compressor->Start( compressed, compressedSize );
+				const int decompressedSize = compressor->Read( decompressed, streamSizes[i], true );
+				decodeMicroseconds += Sys_Microseconds() - decodeStart;
+
+				if ( decompressedSize != streamSizes[i] || memcmp( decompressed, streams[i], decompressedSize ) != 0 ) {
+					numFailed++;
+				}
+				compressedBytes += compressedSize;
+			}
+		}
+
+		const float megabytes = (float)( streamBytes * numRepeats ) / ( 1024.0f * 1024.0f );
+		idLib::Printf( "%-4s: ratio %.3f (%d bytes per delta), encode %.1f MB/s, decode %.1f MB/s\n", snapCodecNames[codec],
+			(float)compressedBytes / (float)( streamBytes * numRepeats ), (int)( compressedBytes / ( streams.Num() * numRepeats ) ),
+			megabytes / Max( encodeMicroseconds, (uint64)1 ) * 1000000.0f, megabytes / Max( decodeMicroseconds, (uint64)1 ) * 1000000.0f );
+		if ( numFailed > 0 ) {
+			idLib::Warning( "%s: %d deltas didn't survive the round trip", snapCodecNames[codec], numFailed / numRepeats );
+		}
+	}
+
+	for ( int codec = 0; codec < SNAP_CODEC_MAX; codec++ ) {
+		delete compressors[codec];
+	}
+	Mem_Free( lzData );
+	Mem_Free( lzwData );
+}
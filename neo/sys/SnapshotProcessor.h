@@ -45,14 +45,18 @@ public:
 	// TrySetPendingSnapshot Sets the currently pending snap.  
 	// No new snaps will be sent until this snap has been fully sent.
 	// Returns true of the newly supplied snapshot was accepted (there were no pending snaps)
-	bool TrySetPendingSnapshot( idSnapShot & ss );
-	// Peek into delta to get deltaSequence, and deltaBaseSequence
-	void PeekDeltaSequence( const char * deltaMem, int deltaSize, int & deltaSequence, int & deltaBaseSequence );
+	// On the server, visIndex and budgetBytes (the peer's share of net_maxRate for one snapshot) enable interest
+	// management: when the changes don't fit the budget, the objects that matter least to the peer are held back.
+	bool TrySetPendingSnapshot( idSnapShot & ss, int visIndex = -1, int budgetBytes = 0 );
+	// Peek into delta to get deltaSequence, and deltaBaseSequence, false if the delta can't be decompressed
+	bool PeekDeltaSequence( const char * deltaMem, int deltaSize, int & deltaSequence, int & deltaBaseSequence );
 	// Apply a delta to the supplied snapshot
 	bool ApplyDeltaToSnapshot( idSnapShot & snap, const char * deltaMem, int deltaSize, int visIndex );
 	// Attempts to write the currently pending snap to the supplied buffer, which can then be sent as an unreliable msg.
 	// SubmitPendingSnap will submit the pending snap to a job, so that it can be retrieved later for sending.
-	void SubmitPendingSnap( int visIndex, uint8 * objMemory, int objMemorySize, lzwCompressionData_t * lzwData );
+	// The deltas are compressed with net_snapCodec, the compression data of every codec must be supplied.
+	// The optional deltaCache lets peers that are submitted in the same frame share the object delta work.
+	void SubmitPendingSnap( int visIndex, uint8 * objMemory, int objMemorySize, lzwCompressionData_t * lzwData, lzCompressionData_t * lzData, idSnapObjDeltaCache * deltaCache = NULL );
 	// GetPendingSnapDelta
 	int GetPendingSnapDelta( byte * outBuffer, int maxLength );
 	// If PendingSnapReadyToSend is true, then GetPendingSnapDelta will return something to send
@@ -85,14 +89,28 @@ public:
 
 	int	GetSnapQueueSize() { return deltas.Num(); }
 
+	// Number of object changes interest management held back so far
+	int GetNumHeldChanges() const { return numHeldChanges; }
+
 	bool IsBusyConfirmingPartialSnap();
 
 	void AddSnapObjTemplate( int objID, idBitMsg & msg );
 
+	static void Test_f( const class idCmdArgs & args );
+	static void TestCodecs_f( const class idCmdArgs & args );
+	static void TestFields_f( const class idCmdArgs & args );
+
+	// Fills ss with the players of a simulated deathmatch, running in circles
+	static void WriteTestPlayers( idSnapShot & ss, int numPlayers, int time );
+
 	static const int MAX_SNAPSHOT_QUEUE		= 64;
 
 private:
 
+	void			ApplyInterest( int visIndex, int budgetBytes );
+	float &			PriorityAccumulator( int objectNum );
+	lzCompressionData_t *	GetLZReadData( const char * deltaMem );
+
 	// Internal commands to set up, and flush the compressors
 	static const int MAX_SNAP_SIZE			= idPacketProcessor::MAX_MSG_SIZE;	
 	static const int MAX_SNAPSHOT_QUEUE_MEM	= 64 * 1024;	// 64k
@@ -109,6 +127,10 @@ private:
 
 	idSnapShot		pendingSnap;		// Current snap waiting to be fully sent
 	bool			hasPendingSnap;		// true if pendingSnap is still waiting to be sent
+
+	idSnapShot		heldSnap;			// previous pending snap, held back objects keep their state from it
+	idList< float, TAG_NETWORKING >	priorityAccumulators;	// interest priority of every object, indexed by object number
+	int				numHeldChanges;
 		
 	struct jobMemory_t {
 		static const int MAX_LZW_DELTAS		= 1;			// FIXME: cleanup the old multiple delta support completely
@@ -137,6 +159,8 @@ private:
 
 	jobMemory_t *	jobMemory;
 
+	lzCompressionData_t *	lzReadData;		// window for reading SNAP_CODEC_LZ deltas, allocated with the first one
+
 	idSnapShot		submittedState;
 	
 	idSnapShot		templateStates;			// holds default snapshot states for some newly spawned object
@@ -35,6 +35,107 @@ uint32 SnapObjChecksum( const uint8 * data, int length ) {
 	return CRC32_BlockChecksum( data, length );
 }
 
+/*
+========================
+idSnapObjDeltaCache::idSnapObjDeltaCache
+========================
+*/
+idSnapObjDeltaCache::idSnapObjDeltaCache() {
+	entries	= (entry_t *)Mem_Alloc( MAX_ENTRIES * sizeof( entry_t ), TAG_NETWORKING );
+	memory	= (uint8 *)Mem_Alloc( MAX_MEMORY, TAG_NETWORKING );
+	hash.Clear( 4096, MAX_ENTRIES );
+	numHits = 0;
+	numMisses = 0;
+	Reset();
+}
+
+/*
+========================
+idSnapObjDeltaCache::~idSnapObjDeltaCache
+========================
+*/
+idSnapObjDeltaCache::~idSnapObjDeltaCache() {
+	Mem_Free( entries );
+	Mem_Free( memory );
+}
+
+/*
+========================
+idSnapObjDeltaCache::Reset
+========================
+*/
+void idSnapObjDeltaCache::Reset() {
+	hash.Clear();
+	numEntries = 0;
+	memoryUsed = 0;
+}
+
+/*
+========================
+idSnapObjDeltaCache::GetKey
+========================
+*/
+int idSnapObjDeltaCache::GetKey( const objJobState_t & newState ) const {
+	const uintptr_t ptr = (uintptr_t)newState.data;
+	return (int)( ( ptr >> 4 ) ^ ( ptr >> 20 ) ) ^ newState.size;
+}
+
+/*
+========================
+idSnapObjDeltaCache::Find
+========================
+*/
+bool idSnapObjDeltaCache::Find( const objJobState_t & newState, const objJobState_t & oldState, objHeader_t * header ) {
+	const uint8 * oldData = oldState.valid ? oldState.data : NULL;
+	const uint16 oldSize = oldState.valid ? oldState.size : 0;
+
+	for ( int i = hash.First( GetKey( newState ) ); i != -1; i = hash.Next( i ) ) {
+		const entry_t & entry = entries[i];
+		if ( entry.newData != newState.data || entry.newSize != newState.size || entry.oldSize != oldSize ) {
+			continue;
+		}
+		if ( entry.oldData != oldData && ( entry.oldData == NULL || oldData == NULL || memcmp( entry.oldData, oldData, oldSize ) != 0 ) ) {
+			continue;
+		}
+		header->csize	= entry.csize;
+		header->data	= entry.data;
+		header->flags	|= entry.flags;
+		header->schemaId		= entry.schemaId;
+		header->schemaOffset	= entry.schemaOffset;
+		numHits++;
+		return true;
+	}
+	numMisses++;
+	return false;
+}
+
+/*
+========================
+idSnapObjDeltaCache::Add
+========================
+*/
+void idSnapObjDeltaCache::Add( const objJobState_t & newState, const objJobState_t & oldState, const objHeader_t * header ) {
+	if ( header->csize < 0 || numEntries >= MAX_ENTRIES || memoryUsed + header->csize > MAX_MEMORY ) {
+		return;
+	}
+
+	entry_t & entry	= entries[numEntries];
+	entry.newData	= newState.data;
+	entry.newSize	= newState.size;
+	entry.oldData	= oldState.valid ? oldState.data : NULL;
+	entry.oldSize	= oldState.valid ? oldState.size : 0;
+	entry.csize		= header->csize;
+	entry.data		= memory + memoryUsed;
+	entry.flags		= header->flags & OBJ_FIELD_DELTA;
+	entry.schemaId		= header->schemaId;
+	entry.schemaOffset	= header->schemaOffset;
+	memcpy( entry.data, header->data, header->csize );
+	memoryUsed += header->csize;
+
+	hash.Add( GetKey( newState ), numEntries );
+	numEntries++;
+}
+
 /*
 ========================
 ObjectsSame
@@ -62,6 +163,57 @@ ID_INLINE bool ObjectsSame( objJobState_t & newState, objJobState_t & oldState )
 	return false;			// Not the same
 }
 
+/*
+========================
+WriteFieldDelta
+Writes a changed object as a byte delta of everything around its field block, and a field delta
+of the block itself, so only the changed fields are sent instead of every byte they touched.
+Only the new state needs to follow the schema, the field delta recreates the new block from any old bytes.
+========================
+*/
+static bool WriteFieldDelta( const objJobState_t & newState, const objJobState_t & oldState, objHeader_t * header, uint8 * dest ) {
+	const idNetSchema * schema = newState.schema;
+	const int fieldStart	= newState.schemaOffset;
+	const int fieldEnd		= fieldStart + schema->GetBlockSize();
+	const int maxSize		= OBJ_DEST_SIZE_ALIGN16( newState.size );
+
+	if ( newState.size != oldState.size || fieldEnd > newState.size ) {
+		return false;
+	}
+
+	idZeroRunLengthCompressor rleCompressor;
+
+	rleCompressor.Start( dest, NULL, maxSize );
+	for ( int b = 0; b < fieldStart; b++ ) {
+		rleCompressor.WriteByte( ( 0xFF + 1 + ( newState.data[b] - oldState.data[b] ) ) & 0xFF );
+	}
+	int size = rleCompressor.End();
+	if ( size == -1 ) {
+		return false;
+	}
+
+	const int fieldSize = schema->WriteDelta( oldState.data + fieldStart, newState.data + fieldStart, dest + size, maxSize - size );
+	if ( fieldSize == -1 ) {
+		return false;
+	}
+	size += fieldSize;
+
+	rleCompressor.Start( dest + size, NULL, maxSize - size );
+	for ( int b = fieldEnd; b < newState.size; b++ ) {
+		rleCompressor.WriteByte( ( 0xFF + 1 + ( newState.data[b] - oldState.data[b] ) ) & 0xFF );
+	}
+	const int suffixSize = rleCompressor.End();
+	if ( suffixSize == -1 ) {
+		return false;
+	}
+
+	header->csize			= size + suffixSize;
+	header->flags			|= OBJ_FIELD_DELTA;
+	header->schemaId		= (uint16)schema->GetId();
+	header->schemaOffset	= (uint16)fieldStart;
+	return true;
+}
+
 /*
 ========================
 SnapshotObjectJob
@@ -71,6 +223,7 @@ ready to be sent to peers.
 ========================
 */
 void SnapshotObjectJob( objParms_t * parms ) {
+	idSnapObjDeltaCache * deltaCache = parms->deltaCache;
 	int				visIndex	= parms->visIndex;
 	objJobState_t &	newState	= parms->newState;
 	objJobState_t &	oldState	= parms->oldState;
@@ -85,6 +238,8 @@ void SnapshotObjectJob( objParms_t * parms ) {
 	header->csize	= 0;
 	header->objID	= -1;			// Default to ack
 	header->data	= dataStart;
+	header->schemaId		= 0;
+	header->schemaOffset	= 0;
 
 	assert( header->size <= MAX_UNSIGNED_TYPE( objectSize_t ) );
 			
@@ -148,14 +303,20 @@ void SnapshotObjectJob( objParms_t * parms ) {
 	} else if ( !oldState.valid ) {
 		// New object, write out full state
 		assert( newState.valid );
-		// delta against an empty snap
-		rleCompressor.Start( dataStart, NULL, OBJ_DEST_SIZE_ALIGN16( newState.size ) );
-		rleCompressor.WriteBytes( newState.data, newState.size );
-		header->csize = rleCompressor.End();
 		header->flags |= OBJ_NEW;
-		if ( header->csize == -1 ) {
-			// Not enough space, don't compress, have lzw job do zrle compression instead
-			memcpy( dataStart, newState.data, newState.size );
+		if ( deltaCache != NULL && deltaCache->Find( newState, oldState, header ) ) {
+			// another peer already compressed this state
+		} else {
+			// delta against an empty snap
+			rleCompressor.Start( dataStart, NULL, OBJ_DEST_SIZE_ALIGN16( newState.size ) );
+			rleCompressor.WriteBytes( newState.data, newState.size );
+			header->csize = rleCompressor.End();
+			if ( header->csize == -1 ) {
+				// Not enough space, don't compress, have lzw job do zrle compression instead
+				memcpy( dataStart, newState.data, newState.size );
+			} else if ( deltaCache != NULL ) {
+				deltaCache->Add( newState, oldState, header );
+			}
 		}
 	} else {
 		// Compare to same obj id in different snapshot
@@ -167,7 +328,13 @@ void SnapshotObjectJob( objParms_t * parms ) {
 			header->flags |= visSendState ? OBJ_VIS_NOT_STALE : OBJ_VIS_STALE;
 		}
 	
-		if ( !visChange || visSendState ) {			
+		if ( ( !visChange || visSendState ) && deltaCache != NULL && deltaCache->Find( newState, oldState, header ) ) {
+			// another peer already delta'd this state against the same old state
+		} else if ( ( !visChange || visSendState ) && parms->fieldDeltas && newState.schema != NULL && WriteFieldDelta( newState, oldState, header, dataStart ) ) {
+			if ( deltaCache != NULL ) {
+				deltaCache->Add( newState, oldState, header );
+			}
+		} else if ( !visChange || visSendState ) {			
 			int compareSize = Min( newState.size, oldState.size );
 			rleCompressor.Start( dataStart, NULL, OBJ_DEST_SIZE_ALIGN16( newState.size ) );
 			for ( int b = 0; b < compareSize; b++ ) {
@@ -194,6 +361,8 @@ void SnapshotObjectJob( objParms_t * parms ) {
 				if ( leftOver > 0 ) {
 					memcpy( dataStart, newState.data + compareSize, leftOver );
 				}
+			} else if ( deltaCache != NULL ) {
+				deltaCache->Add( newState, oldState, header );
 			}
 		}
 	}
@@ -213,14 +382,14 @@ void SnapshotObjectJob( objParms_t * parms ) {
 FinishLZWStream
 ========================
 */
-static void FinishLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor ) {
-	if ( lzwCompressor->IsOverflowed() ) {
-		lzwCompressor->Restore();
+static void FinishLZWStream( lzwParm_t * parm, idLightweightCompressor * compressor ) {
+	if ( compressor->IsOverflowed() ) {
+		compressor->Restore();
 	}
 
 	lzwDelta_t & pendingDelta = parm->ioData->lzwDeltas[parm->ioData->numlzwDeltas];
 
-	if ( lzwCompressor->End() == -1 ) {
+	if ( compressor->End() == -1 ) {
 		// If we couldn't end the stream, notify the main thread
 		pendingDelta.offset			= -1;
 		pendingDelta.size			= -1;
@@ -230,7 +399,7 @@ static void FinishLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor )
 		return;
 	}
 
-	int size = lzwCompressor->Length();
+	int size = SNAP_CODEC_BYTES + compressor->Length();
 	
 	pendingDelta.offset			= parm->ioData->lzwBytes;		// Remember offset into buffer
 	pendingDelta.size			= size;							// Remember size
@@ -245,19 +414,23 @@ static void FinishLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor )
 NewLZWStream
 ========================
 */
-static void NewLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor ) {
+static void NewLZWStream( lzwParm_t * parm, idLightweightCompressor * compressor ) {
 	
 	// Reset compressor
 	int maxSize = parm->ioData->maxlzwMem - parm->ioData->lzwBytes;
-	lzwCompressor->Start( &parm->ioData->lzwMem[parm->ioData->lzwBytes], maxSize );
+	uint8 * stream = &parm->ioData->lzwMem[parm->ioData->lzwBytes];
+
+	// The codec goes uncompressed in front of the stream, so the reader knows how to decompress the rest
+	stream[0] = (uint8)parm->ioData->codec;
+	compressor->Start( stream + SNAP_CODEC_BYTES, maxSize - SNAP_CODEC_BYTES );
 	
 	parm->ioData->lastObjId = 0;
 
 	parm->ioData->snapSequence++;
 
-	lzwCompressor->WriteAgnostic( parm->ioData->snapSequence );
-	lzwCompressor->WriteAgnostic( parm->baseSequence );
-	lzwCompressor->WriteAgnostic( parm->curTime );
+	compressor->WriteAgnostic( parm->ioData->snapSequence );
+	compressor->WriteAgnostic( parm->baseSequence );
+	compressor->WriteAgnostic( parm->curTime );
 }
 
 /*
@@ -265,10 +438,10 @@ static void NewLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor ) {
 ContinueLZWStream
 ========================
 */
-static void ContinueLZWStream( lzwParm_t * parm, idLZWCompressor * lzwCompressor ) {
+static void ContinueLZWStream( lzwParm_t * parm, idLightweightCompressor * compressor ) {
 	// Continue compressor where we left off
 	int maxSize = parm->ioData->maxlzwMem - parm->ioData->lzwBytes;
-	lzwCompressor->Start( &parm->ioData->lzwMem[parm->ioData->lzwBytes], maxSize, true );
+	compressor->Start( &parm->ioData->lzwMem[parm->ioData->lzwBytes + SNAP_CODEC_BYTES], maxSize - SNAP_CODEC_BYTES, true );
 }
 
 /*
@@ -296,13 +469,19 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 	dmaTag = dmaTag;
 
 	ALIGN16( idLZWCompressor lzwCompressor( parm->ioData->lzwData ) );
+	ALIGN16( idLZCompressor lzCompressor( parm->ioData->lzData ) );
+
+	idLightweightCompressor * compressor = &lzwCompressor;
+	if ( parm->ioData->codec == SNAP_CODEC_LZ ) {
+		compressor = &lzCompressor;
+	}
 
 	if ( parm->fragmented ) {
 		// This packet was partially written out, we need to continue writing, using previous lzw dictionary values
-		ContinueLZWStream( parm, &lzwCompressor );
+		ContinueLZWStream( parm, compressor );
 	} else {
 		// We can start a new lzw dictionary
-		NewLZWStream( parm, &lzwCompressor );
+		NewLZWStream( parm, compressor );
 	}
 
 
@@ -312,15 +491,15 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 
 		// This will eventually be gracefully caught in SnapshotProcessor.cpp.  
 		// It's nice to know right when it happens though, so you can inspect the situation.
-		assert( !lzwCompressor.IsOverflowed() || numChangedObjProcessed > 1 );
+		assert( !compressor->IsOverflowed() || numChangedObjProcessed > 1 );
 
 		// First, see if we need to finish the current lzw stream
-		if ( lzwCompressor.IsOverflowed() || lzwCompressor.Length() >= parm->ioData->optimalLength ) {
-			FinishLZWStream( parm, &lzwCompressor );
+		if ( compressor->IsOverflowed() || compressor->Length() >= parm->ioData->optimalLength ) {
+			FinishLZWStream( parm, compressor );
 			// indicate how much needs to be DMA'ed back out
 			parm->ioData->lzwDmaOut = parm->ioData->lzwBytes;
 #ifdef ALLOW_MULTIPLE_DELTAS
-			NewLZWStream( parm, &lzwCompressor );
+			NewLZWStream( parm, compressor );
 #else
 			// Currently, we don't use fragmented deltas.
 			// We only send the first one and rely on a full snap being sent to get the whole snap across
@@ -332,7 +511,7 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 
 		if ( numChangedObjProcessed > 0 ) {
 			// We should be at a good spot in the stream if we've written at least one obj without overflowing, so save it
-			lzwCompressor.Save();
+			compressor->Save();
 		}
 
 		// Get header
@@ -346,14 +525,14 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 		numChangedObjProcessed++;
 
 		// Write obj id as delta into stream
-		lzwCompressor.WriteAgnostic<uint16>( (uint16)( header->objID - parm->ioData->lastObjId ) );
+		compressor->WriteAgnostic<uint16>( (uint16)( header->objID - parm->ioData->lastObjId ) );
 		parm->ioData->lastObjId = (uint16)header->objID;
 
 		// Check special stale/notstale flags
 		if ( header->flags & ( OBJ_VIS_STALE | OBJ_VIS_NOT_STALE ) ) {
 			// Write stale/notstale flag
 			objectSize_t value = ( header->flags & OBJ_VIS_STALE ) ? SIZE_STALE : SIZE_NOT_STALE;
-			lzwCompressor.WriteAgnostic<objectSize_t>( value );
+			compressor->WriteAgnostic<objectSize_t>( value );
 		}
 
 		if ( header->flags & OBJ_VIS_STALE ) {
@@ -362,12 +541,19 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 
 		if ( header->flags & OBJ_DELETED ) {
 			// Object was deleted
-			lzwCompressor.WriteAgnostic<objectSize_t>( 0 );
+			compressor->WriteAgnostic<objectSize_t>( 0 );
 			continue;
 		}
 
+		if ( header->flags & OBJ_FIELD_DELTA ) {
+			// Write where the field block is, so the reader can find the schema to read it with
+			compressor->WriteAgnostic<objectSize_t>( SIZE_FIELD_DELTA );
+			compressor->WriteAgnostic<uint16>( header->schemaId );
+			compressor->WriteAgnostic<uint16>( header->schemaOffset );
+		}
+
 		// Write size
-		lzwCompressor.WriteAgnostic<objectSize_t>( (objectSize_t)header->size );
+		compressor->WriteAgnostic<objectSize_t>( (objectSize_t)header->size );
 
 		// Get compressed data area
 		uint8 * compressedData = header->data;
@@ -375,30 +561,30 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 		if ( header->csize == -1 ) {
 			// Wasn't zrle compressed, zrle now while lzw'ing
 			idZeroRunLengthCompressor rleCompressor;
-			rleCompressor.Start( NULL, &lzwCompressor, 0xFFFF );
+			rleCompressor.Start( NULL, compressor, 0xFFFF );
 			rleCompressor.WriteBytes( compressedData, header->size );
 			rleCompressor.End();
 		} else {
 			// Write out zero-rle compressed data
-			lzwCompressor.Write( compressedData, header->csize );
+			compressor->Write( compressedData, header->csize );
 		}
 
 #ifdef SNAPSHOT_CHECKSUMS
 		// Write checksum
-		lzwCompressor.WriteAgnostic( header->checksum );
+		compressor->WriteAgnostic( header->checksum );
 #endif
 		// This will eventually be gracefully caught in SnapshotProcessor.cpp.  
 		// It's nice to know right when it happens though, so you can inspect the situation.
-		assert( !lzwCompressor.IsOverflowed() || numChangedObjProcessed > 1 );		
+		assert( !compressor->IsOverflowed() || numChangedObjProcessed > 1 );		
 	}
 
 	if ( !parm->saveDictionary ) {
 		// Write out terminator
 		uint16 objectDelta = 0xFFFF - parm->ioData->lastObjId;
-		lzwCompressor.WriteAgnostic( objectDelta );
+		compressor->WriteAgnostic( objectDelta );
 		
 		// Last stream
-		FinishLZWStream( parm, &lzwCompressor );
+		FinishLZWStream( parm, compressor );
 
 		// indicate how much needs to be DMA'ed back out
 		parm->ioData->lzwDmaOut = parm->ioData->lzwBytes;
@@ -408,7 +594,7 @@ void LZWJobInternal( lzwParm_t * parm, unsigned int dmaTag ) {
 		// the compressor did some work, wrote data to lzwMem, but since we didn't call FinishLZWStream to end the compression,
 		// we need to figure how much needs to be DMA'ed back out
 		assert( parm->ioData->lzwBytes == 0 ); // I don't think we ever hit this with lzwBytes != 0, but adding it just in case
-		parm->ioData->lzwDmaOut = parm->ioData->lzwBytes + lzwCompressor.Length();
+		parm->ioData->lzwDmaOut = parm->ioData->lzwBytes + SNAP_CODEC_BYTES + compressor->Length();
 	}
 
 	assert( parm->ioData->lzwBytes < parm->ioData->maxlzwMem );
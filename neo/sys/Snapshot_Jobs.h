@@ -36,6 +36,7 @@ typedef int32 objectSize_t;
 
 static const objectSize_t SIZE_STALE		= MAX_TYPE( objectSize_t );				// Special size to indicate object went stale
 static const objectSize_t SIZE_NOT_STALE	= MAX_TYPE( objectSize_t ) - 1;			// Special size to indicate object is no longer stale
+static const objectSize_t SIZE_FIELD_DELTA	= MAX_TYPE( objectSize_t ) - 2;			// Special size to indicate the object's field block is sent as a field delta
 
 static const int RLE_COMPRESSION_PADDING				= 16;			// Padding to accommodate possible enlargement due to zlre compression
 
@@ -48,6 +49,7 @@ static const uint32 OBJ_NEW				= ( 1 << 2 );			// New object (not in the last sn
 static const uint32 OBJ_DELETED			= ( 1 << 3 );			// Object was deleted (not going to be in the new snap)
 static const uint32 OBJ_DIFFERENT		= ( 1 << 4 );			// Objects are in both snaps, but different
 static const uint32 OBJ_SAME			= ( 1 << 5 );			// Objects are in both snaps, and are the same (we don't send these, which means ack)
+static const uint32 OBJ_FIELD_DELTA		= ( 1 << 6 );			// Objects are different, and the field block was written with idNetSchema::WriteDelta
 
 // This struct is used to communicate data from the obj jobs to the lzw job
 struct ALIGNTYPE16 objHeader_t {
@@ -56,6 +58,8 @@ struct ALIGNTYPE16 objHeader_t {
 	int32	csize;					// Size after zrle compression
 	uint32	flags;					// Flags used to communicate state from obj job to lzw delta job
 	uint8 * data;					// Data ptr to obj memory
+	uint16	schemaId;				// OBJ_FIELD_DELTA: schema and offset of the field block
+	uint16	schemaOffset;
 #ifdef SNAPSHOT_CHECKSUMS
 	uint32	checksum;				// Checksum before compression, used for sanity checking
 #endif
@@ -67,12 +71,68 @@ struct objJobState_t {
 	uint16				size;
 	uint16				objectNum;
 	uint32				visMask;
+	const idNetSchema *	schema;				// Field block written at schemaOffset, if not NULL
+	uint16				schemaOffset;
+};
+
+/*
+================================================
+idSnapObjDeltaCache
+
+Per frame cache of the delta'd + zrle compressed objects written by SnapshotObjectJob.
+Peers that delta the same new object state against an old state with the same contents share
+the result, so the object jobs scale with the number of distinct base states rather than peers.
+Cached data is referenced by the job headers, so Reset may only be called once every peer's
+jobs for the frame were submitted.
+================================================
+*/
+class idSnapObjDeltaCache {
+public:
+	static const int MAX_ENTRIES	= 8192;
+	static const int MAX_MEMORY		= 512 * 1024;
+
+					idSnapObjDeltaCache();
+					~idSnapObjDeltaCache();
+
+	void			Reset();
+
+	// Fills in csize and data of the header if this delta was already compressed this frame
+	bool			Find( const objJobState_t & newState, const objJobState_t & oldState, objHeader_t * header );
+	void			Add( const objJobState_t & newState, const objJobState_t & oldState, const objHeader_t * header );
+
+	int				GetNumHits() const { return numHits; }
+	int				GetNumMisses() const { return numMisses; }
+
+private:
+	struct entry_t {
+		const uint8 *	newData;
+		const uint8 *	oldData;		// NULL when the new state was compressed against nothing
+		uint16			newSize;
+		uint16			oldSize;
+		int32			csize;
+		uint8 *			data;
+		uint32			flags;			// OBJ_FIELD_DELTA
+		uint16			schemaId;
+		uint16			schemaOffset;
+	};
+
+	int				GetKey( const objJobState_t & newState ) const;
+
+	idHashIndex		hash;
+	entry_t *		entries;
+	int				numEntries;
+	uint8 *			memory;
+	int				memoryUsed;
+	int				numHits;
+	int				numMisses;
 };
 
 // Input to initial jobs that produce delta'd zrle compressed versions of all the snap obj's
 struct ALIGNTYPE16 objParms_t { 
 	// Input
 	uint8				visIndex;
+	idSnapObjDeltaCache * deltaCache;		// NULL if the compressed deltas aren't shared with other peers
+	bool				fieldDeltas;		// Send the field blocks of changed objects as field deltas
 
 	objJobState_t		newState;
 	objJobState_t		oldState;
@@ -82,6 +142,9 @@ struct ALIGNTYPE16 objParms_t {
 	uint8 *				dest;
 };
 	
+// Every delta stream starts with its uncompressed snapCodec_t
+static const int SNAP_CODEC_BYTES = 1;
+
 // Output from the job that takes the results of the delta'd zrle obj's.
 // This struct contains the start of where the final delta packet data is within lzwMem
 struct ALIGNTYPE16 lzwDelta_t { 
@@ -103,7 +166,9 @@ struct ALIGNTYPE16 lzwInOutData_t {
 	int						optimalLength;			// Optimal length of lzw streams
 	int						snapSequence;
 	uint16					lastObjId;				// Last obj id written out
+	int						codec;					// snapCodec_t the streams are compressed with
 	lzwCompressionData_t *	lzwData;
+	lzCompressionData_t *	lzData;
 };
 
 // Input to the job that takes the results of the delta'd zrle obj's, and turns them into lzw delta packets
@@ -66,6 +66,8 @@ idLobby::idLobby() {
 
 	localReadSS				= NULL;
 	objMemory				= NULL;
+	lzData					= NULL;
+	objDeltaCache			= NULL;
 	haveSubmittedSnaps		= false;
 
 	state					= STATE_IDLE;	
@@ -128,6 +130,8 @@ void idLobby::Initialize( lobbyType_t sessionType_, idSessionCallbacks * callbac
 		// only needed in multiplayer mode
 		objMemory		= (uint8*)Mem_Alloc( SNAP_OBJ_JOB_MEMORY, TAG_NETWORKING );
 		lzwData			= (lzwCompressionData_t*)Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+		lzData			= (lzCompressionData_t*)Mem_Alloc( sizeof( lzCompressionData_t ), TAG_NETWORKING );
+		objDeltaCache	= new (TAG_NETWORKING) idSnapObjDeltaCache();
 	}
 }
 
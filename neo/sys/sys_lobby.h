@@ -838,7 +838,9 @@ public:		// Turning this on for now, for the sake of getting this up and running
 	static const int SNAP_OBJ_JOB_MEMORY = 1024 * 128;			// 128k of obj memory
 
 	lzwCompressionData_t *				lzwData;				// Shared across all snapshot jobs
+	lzCompressionData_t *				lzData;					// Shared across all snapshot jobs
 	uint8 *								objMemory;				// Shared across all snapshot jobs
+	idSnapObjDeltaCache *				objDeltaCache;			// Compressed object deltas shared by the peers submitted in one UpdateSnaps
 	bool								haveSubmittedSnaps;		// True if we previously submitted snaps to jobs
 	idSnapShot *						localReadSS;
 
@@ -69,6 +69,7 @@ public:
 class idNetSessionPort {
 public:
 	idNetSessionPort();
+	~idNetSessionPort();
 
 	bool InitPort( int portNumber, bool useBackend );
 	bool ReadRawPacket( lobbyAddress_t & from, void * data, int & size, int maxSize  );
@@ -78,10 +79,35 @@ public:
 	void Close();
 	
 private:
+	static const int RECEIVE_QUEUE_SIZE		= 256;		// packets buffered between the receive thread and the session
+	static const int RECEIVE_WAIT_MSEC		= 10;		// how long the receive thread blocks on the socket before checking for termination
+
+	struct receivedPacket_t {
+		lobbyAddress_t	from;
+		int				size;
+		byte			data[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	};
+	typedef idSPSCQueue< receivedPacket_t, RECEIVE_QUEUE_SIZE > receiveQueue_t;
+
+	// Moves packets from the socket to receiveQueue so the session never waits on the socket
+	class idReceiveThread : public idSysThread {
+	public:
+		idNetSessionPort *	port;
+		virtual int			Run();
+	};
+
+	void	StartReceiveThread();
+	void	StopReceiveThread();
+
 	float	forcePacketDropCurr;	// Used with net_forceDrop and net_forceDropCorrelation
 	float	forcePacketDropPrev;
 
 	idUDP	UDP;
+
+	receiveQueue_t *		receiveQueue;			// only allocated while net_receiveThread is in use
+	idReceiveThread			receiveThread;
+	idSysInterlockedInteger	numReceiveOverflows;	// packets the receive thread dropped because receiveQueue was full
+	int						numReportedOverflows;
 };
 
 struct lobbyUser_t {
@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #include "sys_lobby.h"
 
+extern idCVar net_maxRate;
+
 idCVar net_snapshot_send_warntime( "net_snapshot_send_warntime", "500", CVAR_INTEGER, "Print warning messages if we take longer than this to send a client a snapshot." );
 
 idCVar net_queueSnapAcks( "net_queueSnapAcks", "1", CVAR_BOOL, "" );
@@ -55,6 +57,8 @@ idCVar net_pingRecoveryThrottleTimeInSeconds( "net_pingRecoveryThrottleTimeInSec
 
 idCVar net_peer_timeout_loading( "net_peer_timeout_loading", "90000", CVAR_INTEGER, "time in MS to disconnect clients during loading - production only" );
 
+idCVar net_snapObjDeltaCache( "net_snapObjDeltaCache", "1", CVAR_BOOL, "share the compressed object deltas between peers that are sent the same snapshot in a frame" );
+
 
 /*
 ========================
@@ -79,6 +83,12 @@ void idLobby::UpdateSnaps() {
 		return;
 	}
 
+	// the snap jobs of the previous frame are done with the shared object deltas, and the
+	// object buffers they were keyed on may have been freed since
+	if ( objDeltaCache != NULL ) {
+		objDeltaCache->Reset();
+	}
+
 	for ( int p = 0; p < peers.Num(); p++ ) {
 		peer_t & peer = peers[p];
 	
@@ -198,7 +208,7 @@ bool idLobby::SubmitPendingSnap( int p ) {
 	assert( !peer.snapProc->PendingSnapReadyToSend() );
 	
 	// Submit snapshot delta to jobs
-	peer.snapProc->SubmitPendingSnap( p + 1, objMemory, SNAP_OBJ_JOB_MEMORY, lzwData );
+	peer.snapProc->SubmitPendingSnap( idSnapShot::VisIndexForPeer( p ), objMemory, SNAP_OBJ_JOB_MEMORY, lzwData, lzData, net_snapObjDeltaCache.GetBool() ? objDeltaCache : NULL );
 
 	NET_VERBOSESNAPSHOT_PRINT_LEVEL( 2, va("  Submitted snapshot to jobList for peer %d. Since last jobsub: %d\n", p, timeFromLastSub ) );
 	
@@ -466,7 +476,7 @@ bool idLobby::ApplySnapshotDeltaInternal( int p, int snapshotNumber ) {
 
 	// on the server, player = peer number + 1, this only works as long as we don't support clients joining and leaving during game
 	// on the client, always 0
-	bool result = peer.snapProc->ApplySnapshotDelta( IsHost() ? p + 1 : 0, snapshotNumber );
+	bool result = peer.snapProc->ApplySnapshotDelta( IsHost() ? idSnapShot::VisIndexForPeer( p ) : 0, snapshotNumber );
 	
 	if ( result && IsHost() && peer.snapProc->HasPendingSnap() ) {
 		// Send more of the pending snap if we have one for this peer.
@@ -531,7 +541,10 @@ void idLobby::SendSnapshotToPeer( idSnapShot & ss, int p ) {
 	// TrySetPendingSnapshot will try to set the new pending snap.
 	// TrySetPendingSnapshot won't do anything until the last snap set was fully sent out.
 
-	if ( peer.snapProc->TrySetPendingSnapshot( ss ) ) {
+	// Interest management holds back the changes that don't fit in this peer's share of net_maxRate
+	const int budgetBytes = net_maxRate.GetInteger() * 1024 * common->GetSnapRate() / 1000;
+
+	if ( peer.snapProc->TrySetPendingSnapshot( ss, idSnapShot::VisIndexForPeer( p ), budgetBytes ) ) {
 		NET_VERBOSESNAPSHOT_PRINT_LEVEL( 2, va("  ^8Set next pending snapshot peer %d\n", 0 ) );
 
 		peer.numSnapsSent++;
@@ -483,6 +483,9 @@ bool			Sys_UnlockMemory( void *ptr, int bytes );
 // set amount of physical work memory
 void			Sys_SetPhysicalWorkMemory( int minBytes, int maxBytes );
 
+// current and peak physical memory in use by the process
+void			Sys_GetWorkingSetSize( int64 & currentBytes, int64 & peakBytes );
+
 // allows retrieving the call stack at execution points
 void			Sys_GetCallStack( address_t *callStack, const int callStackSize );
 const char *	Sys_GetCallStackStr( const address_t *callStack, const int callStackSize );
@@ -535,6 +538,19 @@ typedef HANDLE idFileHandle;
 
 
 ID_TIME_T		Sys_FileTimeStamp( idFileHandle fp );
+
+// read only memory mapping of a whole file
+struct sysMappedFile_t {
+	const void *	data;				// start of the mapped file
+	int64			length;				// length of the mapped file
+	intptr_t		fileHandle;			// platform file handle
+	intptr_t		mappingHandle;		// platform mapping handle
+};
+
+// maps the whole file read only into the address space, returns false if the file can't be mapped
+// NOTE: only implemented for Win32, the only platform this tree builds for
+bool			Sys_MapFile( const char *osPath, sysMappedFile_t &mappedFile );
+void			Sys_UnmapFile( sysMappedFile_t &mappedFile );
 // NOTE: do we need to guarantee the same output on all platforms?
 const char *	Sys_TimeStampToStr( ID_TIME_T timeStamp );
 const char *	Sys_SecToStr( int sec );
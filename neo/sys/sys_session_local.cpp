@@ -83,7 +83,7 @@ const char * idSessionLocal::stateToString[ NUM_STATES ] = {
 };
 
 struct netVersion_s {
-	netVersion_s() { sprintf( string, "%s.%d", ENGINE_VERSION, BUILD_NUMBER ); }
+	netVersion_s() { sprintf( string, "%s.%d.%d", ENGINE_VERSION, BUILD_NUMBER, NET_PROTOCOL_VERSION ); }
 	char	string[256];
 } netVersion;
 
@@ -1411,6 +1411,7 @@ idCVar net_forceDrop( "net_forceDrop", "0", CVAR_INTEGER, "Percentage chance of
 idCVar net_forceUpstream( "net_forceUpstream", "0", CVAR_FLOAT, "Force a maximum upstream in kB/s (256kbps <-> 32kB/s)" ); // I would much rather deal in kbps but most of the code is written in bytes ..
 idCVar net_forceUpstreamQueue( "net_forceUpstreamQueue", "64", CVAR_INTEGER, "How much data is queued when enforcing upstream (in kB)" );
 idCVar net_verboseSimulatedTraffic( "net_verboseSimulatedTraffic", "0", CVAR_BOOL, "Print some stats about simulated traffic (net_force* cvars)" );
+idCVar net_receiveThread( "net_receiveThread", "1", CVAR_BOOL, "Read packets from the socket on a separate thread and hand them to the session through a lock-free queue" );
 
 /*
 ========================
@@ -3801,8 +3802,20 @@ idNetSessionPort::idNetSessionPort
 */
 idNetSessionPort::idNetSessionPort() :
 	forcePacketDropPrev( 0.0f ),
-	forcePacketDropCurr( 0.0f )
+	forcePacketDropCurr( 0.0f ),
+	receiveQueue( NULL ),
+	numReportedOverflows( 0 )
 {
+	receiveThread.port = this;
+}
+
+/*
+========================
+idNetSessionPort::~idNetSessionPort
+========================
+*/
+idNetSessionPort::~idNetSessionPort() {
+	StopReceiveThread();
 }
 
 /*
@@ -3811,6 +3824,7 @@ idNetSessionPort::InitPort
 ========================
 */
 bool idNetSessionPort::InitPort( int portNumber, bool useBackend ) {
+	StopReceiveThread();
 	return UDP.InitForPort( portNumber );
 }
 
@@ -3820,7 +3834,31 @@ idNetSessionPort::ReadRawPacket
 ========================
 */
 bool idNetSessionPort::ReadRawPacket( lobbyAddress_t & from, void * data, int & size, int maxSize  ) {
-	bool result = UDP.GetPacket( from.netAddr, data, size, maxSize );
+	if ( net_receiveThread.GetBool() && UDP.IsOpen() ) {
+		StartReceiveThread();
+	} else if ( receiveThread.IsRunning() ) {
+		receiveThread.StopThread();
+	}
+
+	bool result = false;
+	receivedPacket_t * packet = ( receiveQueue != NULL ) ? receiveQueue->Peek() : NULL;
+	if ( packet != NULL ) {
+		// packets the thread already queued are handed out before reading the socket again
+		assert( packet->size <= maxSize );
+		size = Min( packet->size, maxSize );
+		memcpy( data, packet->data, size );
+		from = packet->from;
+		receiveQueue->Pop();
+		result = true;
+	} else if ( !receiveThread.IsRunning() ) {
+		result = UDP.GetPacket( from.netAddr, data, size, maxSize );
+	}
+
+	const int numOverflows = numReceiveOverflows.GetValue();
+	if ( numOverflows != numReportedOverflows ) {
+		NET_VERBOSE_PRINT( "NET: receive queue full, dropped %d packets\n", numOverflows - numReportedOverflows );
+		numReportedOverflows = numOverflows;
+	}
 	
 	static idRandom2 random( Sys_Milliseconds() );
 	if ( net_forceDrop.GetInteger() != 0 ) {
@@ -3863,9 +3901,66 @@ idNetSessionPort::Close
 ========================
 */
 void idNetSessionPort::Close() {
+	StopReceiveThread();
 	UDP.Close();
 }
 
+/*
+========================
+idNetSessionPort::StartReceiveThread
+========================
+*/
+void idNetSessionPort::StartReceiveThread() {
+	if ( receiveThread.IsRunning() ) {
+		return;
+	}
+	if ( receiveQueue == NULL ) {
+		receiveQueue = new (TAG_NETWORKING) receiveQueue_t;
+	}
+	receiveThread.StartThread( "NetReceive", CORE_ANY, THREAD_ABOVE_NORMAL );
+}
+
+/*
+========================
+idNetSessionPort::StopReceiveThread
+
+Packets still in the queue are dropped, this is only called when the port closes.
+========================
+*/
+void idNetSessionPort::StopReceiveThread() {
+	receiveThread.StopThread();
+	delete receiveQueue;
+	receiveQueue = NULL;
+}
+
+/*
+========================
+idNetSessionPort::idReceiveThread::Run
+
+The only producer for receiveQueue. Blocks on the socket for a short time so it
+notices StopThread, and keeps draining the socket when the queue is full so the
+packets that survive are the oldest ones the session hasn't seen yet.
+========================
+*/
+int idNetSessionPort::idReceiveThread::Run() {
+	receivedPacket_t overflow;
+	while ( !IsTerminating() ) {
+		receivedPacket_t * packet = port->receiveQueue->Alloc();
+		if ( packet == NULL ) {
+			packet = &overflow;
+		}
+		if ( !port->UDP.GetPacketBlocking( packet->from.netAddr, packet->data, packet->size, sizeof( packet->data ), RECEIVE_WAIT_MSEC ) ) {
+			continue;
+		}
+		if ( packet == &overflow ) {
+			port->numReceiveOverflows.Increment();
+			continue;
+		}
+		port->receiveQueue->Commit();
+	}
+	return 0;
+}
+
 /*
 ================================================================================================
 Commands
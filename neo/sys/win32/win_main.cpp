@@ -411,6 +411,61 @@ void Sys_Mkdir( const char *path ) {
 	_mkdir (path);
 }
 
+/*
+=================
+Sys_MapFile
+=================
+*/
+bool Sys_MapFile( const char *osPath, sysMappedFile_t &mappedFile ) {
+	LARGE_INTEGER size;
+
+	memset( &mappedFile, 0, sizeof( mappedFile ) );
+
+	HANDLE file = CreateFile( osPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	if ( !GetFileSizeEx( file, &size ) || size.QuadPart == 0 ) {
+		CloseHandle( file );
+		return false;
+	}
+	HANDLE mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	if ( mapping == NULL ) {
+		CloseHandle( file );
+		return false;
+	}
+	const void *data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	if ( data == NULL ) {
+		CloseHandle( mapping );
+		CloseHandle( file );
+		return false;
+	}
+
+	mappedFile.data = data;
+	mappedFile.length = size.QuadPart;
+	mappedFile.fileHandle = (intptr_t)file;
+	mappedFile.mappingHandle = (intptr_t)mapping;
+	return true;
+}
+
+/*
+=================
+Sys_UnmapFile
+=================
+*/
+void Sys_UnmapFile( sysMappedFile_t &mappedFile ) {
+	if ( mappedFile.data != NULL ) {
+		UnmapViewOfFile( mappedFile.data );
+	}
+	if ( mappedFile.mappingHandle != 0 ) {
+		CloseHandle( (HANDLE)mappedFile.mappingHandle );
+	}
+	if ( mappedFile.fileHandle != 0 ) {
+		CloseHandle( (HANDLE)mappedFile.fileHandle );
+	}
+	memset( &mappedFile, 0, sizeof( mappedFile ) );
+}
+
 /*
 =================
 Sys_FileTimeStamp
@@ -46,8 +46,10 @@ If you have questions concerning this license or the applicable additional terms
 #include <comdef.h>
 #include <comutil.h>
 #include <Wbemidl.h>
+#include <psapi.h>
 
 #pragma comment (lib, "wbemuuid.lib")
+#pragma comment (lib, "psapi.lib")
 
 #pragma warning(disable:4740)	// warning C4740: flow in or out of inline asm code suppresses global optimization
 
@@ -253,6 +255,22 @@ void Sys_SetPhysicalWorkMemory( int minBytes, int maxBytes ) {
 	::SetProcessWorkingSetSize( GetCurrentProcess(), minBytes, maxBytes );
 }
 
+/*
+================
+Sys_GetWorkingSetSize
+================
+*/
+void Sys_GetWorkingSetSize( int64 & currentBytes, int64 & peakBytes ) {
+	PROCESS_MEMORY_COUNTERS counters;
+	if ( !::GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+		currentBytes = 0;
+		peakBytes = 0;
+		return;
+	}
+	currentBytes = counters.WorkingSetSize;
+	peakBytes = counters.PeakWorkingSetSize;
+}
+
 /*
 ================
 Sys_GetCurrentUser